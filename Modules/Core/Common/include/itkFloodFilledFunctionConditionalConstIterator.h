@@ -123,7 +123,7 @@ public:
       this->m_Image = it.m_Image;     // copy the smart pointer
       this->m_Region = it.m_Region;
       this->m_Function = it.m_Function;
-      this->m_TemporaryPointer = it.m_TemporaryPointer;
+      this->m_TestedPixels = it.m_TestedPixels;
       this->m_Seeds = it.m_Seeds;
       this->m_ImageOrigin = it.m_ImageOrigin;
       this->m_ImageSpacing = it.m_ImageSpacing;
@@ -184,10 +184,8 @@ public:
       }
 
     this->m_IsAtEnd = true;
-    // Initialize the temporary image
-    m_TemporaryPointer->FillBuffer(
-      NumericTraits< typename TTempImage::PixelType >::Zero
-      );
+    // No pixel has been tested yet
+    m_TestedPixels.assign(m_TestedPixels.size(), false);
 
     for ( unsigned int i = 0; i < m_Seeds.size(); i++ )
       {
@@ -200,9 +198,8 @@ public:
         // Obviously, we're at the beginning
         this->m_IsAtEnd = false;
 
-        // Mark the start index in the temp image as inside the
-        // function, neighbor check incomplete
-        m_TemporaryPointer->SetPixel(m_Seeds[i], 2);
+        // Mark the start index as tested
+        m_TestedPixels[this->m_Image->ComputeOffset(m_Seeds[i])] = true;
         }
       }
   }
@@ -222,13 +219,10 @@ protected: //made protected so other iterators can access
   /** Smart pointer to the function we're evaluating */
   SmartPointer< FunctionType > m_Function;
 
-  /** A temporary image used for storing info about indices
-   * 0 = pixel has not yet been processed
-   * 1 = pixel is not inside the function
-   * 2 = pixel is inside the function, neighbor check incomplete
-   * 3 = pixel is inside the function, neighbor check complete */
-  typedef Image< unsigned char, itkGetStaticConstMacro(NDimensions) > TTempImage;
-  typename TTempImage::Pointer m_TemporaryPointer;
+  /** Whether each pixel of the buffered region has already been tested
+   * against the function, one bit per pixel, indexed by the offset of the
+   * pixel in the buffer. */
+  std::vector< bool > m_TestedPixels;
 
   /** A list of locations to start the recursive fill */
   SeedsContainerType m_Seeds;
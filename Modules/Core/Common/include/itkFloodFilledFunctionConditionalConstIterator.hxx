@@ -81,14 +81,8 @@ FloodFilledFunctionConditionalConstIterator< TImage, TFunction >
   m_ImageSpacing = this->m_Image->GetSpacing();
   m_ImageRegion  = this->m_Image->GetBufferedRegion();
 
-  // Build a temporary image of chars for use in the flood algorithm
-  m_TemporaryPointer = TTempImage::New();
-  typename TTempImage::RegionType tempRegion = this->m_Image->GetBufferedRegion();
-
-  m_TemporaryPointer->SetLargestPossibleRegion(tempRegion);
-  m_TemporaryPointer->SetBufferedRegion(tempRegion);
-  m_TemporaryPointer->SetRequestedRegion(tempRegion);
-  m_TemporaryPointer->Allocate(true); // initialize buffer to zero
+  // Keep one bit per pixel for use in the flood algorithm
+  m_TestedPixels.assign(m_ImageRegion.GetNumberOfPixels(), false);
 
   // Initialize the queue by adding the start index assuming one of
   // the m_Seeds is "inside" This might not be true, in which
@@ -173,6 +167,10 @@ FloodFilledFunctionConditionalConstIterator< TImage, TFunction >
   // Take the index in the front of the queue
   const IndexType & topIndex = m_IndexStack.front();
 
+  // The neighbors are one stride away from it in the buffer
+  const OffsetValueType   topOffset = this->m_Image->ComputeOffset(topIndex);
+  const OffsetValueType * offsetTable = this->m_Image->GetOffsetTable();
+
   // Iterate through all possible dimensions
   // NOTE: Replace this with a ShapeNeighborhoodIterator
   for ( unsigned int i = 0; i < NDimensions; i++ )
@@ -199,18 +197,15 @@ FloodFilledFunctionConditionalConstIterator< TImage, TFunction >
       // then test it.
       if ( m_ImageRegion.IsInside(tempIndex) )
         {
-        if ( m_TemporaryPointer->GetPixel(tempIndex) == 0 )
+        const OffsetValueType tempOffset = topOffset + j * offsetTable[i];
+        if ( !m_TestedPixels[tempOffset] )
           {
+          m_TestedPixels[tempOffset] = true;
+
           // if it is inside, push it into the queue
           if ( this->IsPixelIncluded(tempIndex) )
             {
             m_IndexStack.push(tempIndex);
-            m_TemporaryPointer->SetPixel(tempIndex, 2);
-            }
-          else  // If the pixel is outside
-            {
-            // Mark the pixel as outside and remove it from the queue.
-            m_TemporaryPointer->SetPixel(tempIndex, 1);
             }
           }
         }
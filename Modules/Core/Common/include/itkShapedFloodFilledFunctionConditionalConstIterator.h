@@ -175,10 +175,8 @@ public:
       }
 
     this->m_IsAtEnd = true;
-    // Initialize the temporary image
-    m_TempPtr->FillBuffer(
-      NumericTraits< typename TTempImage::PixelType >::Zero
-      );
+    // No pixel has been tested yet
+    m_TestedPixels.assign(m_TestedPixels.size(), false);
 
     for ( unsigned int i = 0; i < m_Seeds.size(); i++ )
       {
@@ -191,9 +189,8 @@ public:
         // Obviously, we're at the beginning
         this->m_IsAtEnd = false;
 
-        // Mark the start index in the temp image as inside the
-        // function, neighbor check incomplete
-        m_TempPtr->SetPixel(m_Seeds[i], 2);
+        // Mark the start index as tested
+        m_TestedPixels[this->m_Image->ComputeOffset(m_Seeds[i])] = true;
         }
       }
   }
@@ -228,14 +225,10 @@ protected: //made protected so other iterators can access
   /** Smart pointer to the function we're evaluating */
   SmartPointer< FunctionType > m_Function;
 
-  /** A temporary image used for storing info about indices
-   * 0 = pixel has not yet been processed
-   * 1 = pixel is not inside the function
-   * 2 = pixel is inside the function, neighbor check incomplete
-   * 3 = pixel is inside the function, neighbor check complete */
-  typedef Image< unsigned char, itkGetStaticConstMacro(NDimensions) > TTempImage;
-
-  typename TTempImage::Pointer m_TempPtr;
+  /** Whether each pixel of the buffered region has already been tested
+   * against the function, one bit per pixel, indexed by the offset of the
+   * pixel in the buffer. */
+  std::vector< bool > m_TestedPixels;
 
   /** A list of locations to start the recursive fill */
   SeedsContainerType m_Seeds;
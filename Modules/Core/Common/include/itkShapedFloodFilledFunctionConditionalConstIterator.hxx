@@ -89,14 +89,8 @@ ShapedFloodFilledFunctionConditionalConstIterator< TImage, TFunction >
 
   setConnectivity(&m_NeighborhoodIterator, m_FullyConnected);
 
-  // Build a temporary image of chars for use in the flood algorithm
-  m_TempPtr = TTempImage::New();
-  typename TTempImage::RegionType tempRegion = this->m_Image->GetBufferedRegion();
-
-  m_TempPtr->SetLargestPossibleRegion(tempRegion);
-  m_TempPtr->SetBufferedRegion(tempRegion);
-  m_TempPtr->SetRequestedRegion(tempRegion);
-  m_TempPtr->Allocate(true); // initialize buffer to zero
+  // Keep one bit per pixel for use in the flood algorithm
+  m_TestedPixels.assign(m_ImageRegion.GetNumberOfPixels(), false);
 
   // Initialize the queue by adding the start index assuming one of
   // the m_Seeds is "inside" This might not be true, in which
@@ -197,18 +191,15 @@ ShapedFloodFilledFunctionConditionalConstIterator< TImage, TFunction >
     // then test it.
     if ( m_ImageRegion.IsInside(tempIndex) )
       {
-      if ( m_TempPtr->GetPixel(tempIndex) == 0 )
+      const OffsetValueType tempOffset = this->m_Image->ComputeOffset(tempIndex);
+      if ( !m_TestedPixels[tempOffset] )
         {
+        m_TestedPixels[tempOffset] = true;
+
         // if it is inside, push it into the queue
         if ( this->IsPixelIncluded(tempIndex) )
           {
           m_IndexStack.push(tempIndex);
-          m_TempPtr->SetPixel(tempIndex, 2);
-          }
-        else  // If the pixel is outside
-          {
-          // Mark the pixel as outside and remove it from the queue.
-          m_TempPtr->SetPixel(tempIndex, 1);
           }
         }
       }
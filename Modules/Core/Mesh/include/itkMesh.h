@@ -36,6 +36,7 @@
 #include "itkMapContainer.h"
 #include <vector>
 #include <set>
+#include <functional>
 
 namespace itk
 {
@@ -138,7 +139,8 @@ public:
   typedef  enum {     CellsAllocationMethodUndefined,
                       CellsAllocatedAsStaticArray,
                       CellsAllocatedAsADynamicArray,
-                      CellsAllocatedDynamicallyCellByCell } CellsAllocationMethodType;
+                      CellsAllocatedDynamicallyCellByCell,
+                      CellsAllocatedInBlocks } CellsAllocationMethodType;
 
   /** Convenient typedefs obtained from TMeshTraits template parameter. */
   typedef typename MeshTraits::CoordRepType            CoordRepType;
@@ -434,6 +436,19 @@ public:
   itkSetMacro(CellsAllocationMethod, CellsAllocationMethodType);
   itkGetConstReferenceMacro(CellsAllocationMethod, CellsAllocationMethodType);
 
+  /** Allocate numberOfCells default constructed cells of type TCell in a
+   * single contiguous block owned by the cells container of the mesh and
+   * return a pointer to the first one, or ITK_NULLPTR if numberOfCells is
+   * 0. The cells are meant to be inserted with SetCell() after taking no
+   * ownership of them. This avoids one heap allocation per cell for large
+   * meshes. The blocks live as long as the cells container, whichever
+   * meshes share it (through Graft() or SetCells()), and a mesh releasing
+   * the cells of the container never deletes the cells of its blocks. The
+   * allocation method must be CellsAllocatedInBlocks, which also releases
+   * with "delete" the cells that are not part of a block. */
+  template< typename TCell >
+  TCell * AllocateCellsBlock(CellIdentifier numberOfCells);
+
 protected:
   /** Constructor for use by New() method. */
   Mesh();
@@ -454,6 +469,77 @@ private:
   void operator=(const Self &); //purposely not implemented
 
   CellsAllocationMethodType m_CellsAllocationMethod;
+
+  /** Base class of the blocks of cells allocated by AllocateCellsBlock().
+   * The virtual destructor lets each block be released with the static
+   * type it was allocated with. */
+  class CellsBlockBase
+  {
+  public:
+    virtual ~CellsBlockBase() {}
+    virtual bool Contains(const CellType *cell) const = 0;
+  };
+
+  template< typename TCell >
+  class CellsBlock:public CellsBlockBase
+  {
+  public:
+    CellsBlock(CellIdentifier numberOfCells):
+      m_Cells(new TCell[numberOfCells]), m_NumberOfCells(numberOfCells) {}
+    ~CellsBlock() { delete[] m_Cells; }
+
+    virtual bool Contains(const CellType *cell) const ITK_OVERRIDE
+    {
+      std::less< const void * > less;
+      return !less( cell, m_Cells ) && less( cell, m_Cells + m_NumberOfCells );
+    }
+
+    TCell *        m_Cells;
+    CellIdentifier m_NumberOfCells;
+  };
+
+  /** Owner of the blocks of cells. It is kept in the meta data dictionary
+   * of the cells container, so that it is released with the container. */
+  class CellsBlocks:public LightObject
+  {
+  public:
+    typedef CellsBlocks          Self;
+    typedef SmartPointer< Self > Pointer;
+    itkSimpleNewMacro(Self);
+
+    /** Whether the cell lies in one of the blocks. */
+    bool Contains(const CellType *cell) const
+    {
+      for ( size_t i = 0; i < m_Blocks.size(); ++i )
+        {
+        if ( m_Blocks[i]->Contains(cell) )
+          {
+          return true;
+          }
+        }
+      return false;
+    }
+
+    std::vector< CellsBlockBase * > m_Blocks;
+
+  protected:
+    CellsBlocks() {}
+    ~CellsBlocks()
+    {
+      for ( size_t i = 0; i < m_Blocks.size(); ++i )
+        {
+        delete m_Blocks[i];
+        }
+    }
+
+  private:
+    CellsBlocks(const Self &);     //purposely not implemented
+    void operator=(const Self &);  //purposely not implemented
+  };
+
+  /** The blocks of cells of the cells container, or ITK_NULLPTR if no
+   * block was allocated in it. */
+  CellsBlocks * GetCellsBlocks() const;
 }; // End Class: Mesh
 } // end namespace itk
 
@@ -30,6 +30,7 @@
 
 #include "itkMesh.h"
 #include "itkProcessObject.h"
+#include "itkMetaDataObject.h"
 #include <algorithm>
 #include <iterator>
 
@@ -1070,6 +1071,10 @@ Mesh< TPixelType, VDimension, TMeshTraits >
   //    the first cell in the array and calling "delete[] cells"
   // 3) the user allocated the Cells on a cell-by-cell basis
   //    so every cell has to be deleted using   "delete cell"
+  // 4) the Cells were allocated in blocks owned by the container with
+  //    AllocateCellsBlock(), possibly next to cells allocated one by
+  //    one. The blocks are released with the container. Cells of the
+  //    blocks are never deleted one by one, whatever the method.
   //
   if ( !m_CellsContainer )
     {
@@ -1109,21 +1114,30 @@ Mesh< TPixelType, VDimension, TMeshTraits >
         break;
         }
       case CellsAllocatedDynamicallyCellByCell:
+      case CellsAllocatedInBlocks:
         {
         itkDebugMacro("CellsAllocatedDynamicallyCellByCell start");
-        // It is assumed that every cell was allocated independently.
+        // It is assumed that every cell was allocated independently,
+        // except for those of the blocks of the container, that are
+        // released with the container.
         // A Cell iterator is created for going through the cells
         // deleting one by one.
+        const CellsBlocks *    blocks = this->GetCellsBlocks();
         CellsContainerIterator cell  = m_CellsContainer->Begin();
         CellsContainerIterator end   = m_CellsContainer->End();
         while ( cell != end )
           {
           const CellType *cellToBeDeleted = cell->Value();
-          itkDebugMacro(<< "Mesh destructor deleting cell = " << cellToBeDeleted);
-          delete cellToBeDeleted;
+          if ( !blocks || !blocks->Contains(cellToBeDeleted) )
+            {
+            itkDebugMacro(<< "Mesh destructor deleting cell = " << cellToBeDeleted);
+            delete cellToBeDeleted;
+            }
           ++cell;
           }
         m_CellsContainer->Initialize();
+        // No other mesh uses the blocks any more.
+        m_CellsContainer->GetMetaDataDictionary().Erase("MeshCellsBlocks");
         itkDebugMacro("CellsAllocatedDynamicallyCellByCell end");
         break;
         }
@@ -1131,6 +1145,53 @@ Mesh< TPixelType, VDimension, TMeshTraits >
     }
 }
 
+template< typename TPixelType, unsigned int VDimension, typename TMeshTraits >
+typename Mesh< TPixelType, VDimension, TMeshTraits >::CellsBlocks *
+Mesh< TPixelType, VDimension, TMeshTraits >
+::GetCellsBlocks() const
+{
+  typename CellsBlocks::Pointer blocks;
+  if ( !m_CellsContainer
+       || !ExposeMetaData< typename CellsBlocks::Pointer >( m_CellsContainer->GetMetaDataDictionary(),
+                                                             "MeshCellsBlocks", blocks ) )
+    {
+    return ITK_NULLPTR;
+    }
+  // The dictionary keeps the blocks alive.
+  return blocks.GetPointer();
+}
+
+template< typename TPixelType, unsigned int VDimension, typename TMeshTraits >
+template< typename TCell >
+TCell *
+Mesh< TPixelType, VDimension, TMeshTraits >
+::AllocateCellsBlock(CellIdentifier numberOfCells)
+{
+  if ( m_CellsAllocationMethod != CellsAllocatedInBlocks )
+    {
+    itkExceptionMacro(<< "Cells blocks require the CellsAllocatedInBlocks allocation method");
+    }
+  if ( numberOfCells == 0 )
+    {
+    return ITK_NULLPTR;
+    }
+  if ( !m_CellsContainer )
+    {
+    this->SetCells( CellsContainer::New() );
+    }
+  CellsBlocks *blocks = this->GetCellsBlocks();
+  if ( !blocks )
+    {
+    typename CellsBlocks::Pointer newBlocks = CellsBlocks::New();
+    EncapsulateMetaData< typename CellsBlocks::Pointer >( m_CellsContainer->GetMetaDataDictionary(),
+                                                          "MeshCellsBlocks", newBlocks );
+    blocks = newBlocks;
+    }
+  CellsBlock< TCell > *block = new CellsBlock< TCell >(numberOfCells);
+  blocks->m_Blocks.push_back(block);
+  return block->m_Cells;
+}
+
 template< typename TPixelType, unsigned int VDimension, typename TMeshTraits >
 void
 Mesh< TPixelType, VDimension, TMeshTraits >
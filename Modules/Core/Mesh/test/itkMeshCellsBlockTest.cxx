@@ -0,0 +1,167 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkMesh.h"
+#include "itkLineCell.h"
+#include "itkTriangleCell.h"
+
+int itkMeshCellsBlockTest(int, char* [] )
+{
+  typedef itk::Mesh< float, 3 >         MeshType;
+  typedef MeshType::CellType            CellType;
+  typedef MeshType::CellAutoPointer     CellAutoPointer;
+  typedef itk::TriangleCell< CellType > TriangleType;
+  typedef itk::LineCell< CellType >     LineType;
+
+  const unsigned int numberOfTriangles = 100;
+
+  MeshType::Pointer mesh = MeshType::New();
+
+  // Blocks require their allocation method.
+  bool caught = false;
+  try
+    {
+    mesh->AllocateCellsBlock< TriangleType >(numberOfTriangles);
+    }
+  catch ( itk::ExceptionObject & excp )
+    {
+    std::cout << "Caught expected exception: " << excp.GetDescription() << std::endl;
+    caught = true;
+    }
+  if ( !caught )
+    {
+    std::cerr << "AllocateCellsBlock() should fail with the default allocation method" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  mesh->SetCellsAllocationMethod(MeshType::CellsAllocatedInBlocks);
+  if ( mesh->AllocateCellsBlock< LineType >(0) != ITK_NULLPTR )
+    {
+    std::cerr << "Empty blocks should not be allocated" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  for ( unsigned int i = 0; i < numberOfTriangles + 2; ++i )
+    {
+    MeshType::PointType point;
+    point[0] = i;
+    point[1] = i % 2;
+    point[2] = 0.0;
+    mesh->SetPoint(i, point);
+    }
+
+  TriangleType *triangles = mesh->AllocateCellsBlock< TriangleType >(numberOfTriangles);
+  for ( unsigned int i = 0; i < numberOfTriangles; ++i )
+    {
+    CellAutoPointer cell;
+    cell.TakeNoOwnership(triangles + i);
+    cell->SetPointId(0, i);
+    cell->SetPointId(1, i + 1);
+    cell->SetPointId(2, i + 2);
+    mesh->SetCell(i, cell);
+    }
+
+  // Cells allocated one by one may be mixed with the blocks.
+  CellAutoPointer line;
+  line.TakeOwnership(new LineType);
+  line->SetPointId(0, 0);
+  line->SetPointId(1, 1);
+  mesh->SetCell(numberOfTriangles, line);
+
+  if ( mesh->GetNumberOfCells() != numberOfTriangles + 1 )
+    {
+    std::cerr << "Wrong number of cells: " << mesh->GetNumberOfCells() << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // The blocks outlive the mesh they were allocated by when it is grafted.
+  MeshType::Pointer grafted = MeshType::New();
+  grafted->Graft(mesh);
+  mesh = ITK_NULLPTR;
+
+  grafted->BuildCellLinks();
+  for ( unsigned int i = 0; i < numberOfTriangles; ++i )
+    {
+    CellAutoPointer cell;
+    if ( !grafted->GetCell(i, cell) || cell->GetType() != CellType::TRIANGLE_CELL
+         || cell->GetPointIds()[2] != i + 2 )
+      {
+      std::cerr << "Wrong cell " << i << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+  if ( grafted->GetCellLinks()->ElementAt(1).size() != 3 )
+    {
+    std::cerr << "Wrong number of cells using point 1: "
+              << grafted->GetCellLinks()->ElementAt(1).size() << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  grafted->Initialize();
+  if ( grafted->GetNumberOfCells() != 0 )
+    {
+    std::cerr << "Cells not released" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // The blocks live as long as the cells container, also when it is
+  // shared through SetCells() or held on its own and the mesh that
+  // allocated them is destroyed first.
+  const unsigned int numberOfLines = 10;
+  MeshType::Pointer allocating = MeshType::New();
+  allocating->SetCellsAllocationMethod(MeshType::CellsAllocatedInBlocks);
+  LineType *lines = allocating->AllocateCellsBlock< LineType >(numberOfLines);
+  for ( unsigned int i = 0; i < numberOfLines; ++i )
+    {
+    CellAutoPointer cell;
+    cell.TakeNoOwnership(lines + i);
+    cell->SetPointId(0, i);
+    cell->SetPointId(1, i + 1);
+    allocating->SetCell(i, cell);
+    }
+
+  MeshType::Pointer sharing = MeshType::New();
+  sharing->SetCells( allocating->GetCells() );
+  MeshType::CellsContainer::Pointer cells = allocating->GetCells();
+  allocating = ITK_NULLPTR;
+
+  for ( unsigned int i = 0; i < numberOfLines; ++i )
+    {
+    CellAutoPointer cell;
+    if ( !sharing->GetCell(i, cell) || cell->GetType() != CellType::LINE_CELL
+         || cell->GetPointIds()[1] != i + 1
+         || cells->ElementAt(i)->GetPointIds()[1] != i + 1 )
+      {
+      std::cerr << "Wrong shared cell " << i << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  // The last mesh holding the container releases its cells, whatever its
+  // allocation method, without deleting those of the blocks.
+  cells = ITK_NULLPTR;
+  sharing->Initialize();
+  if ( sharing->GetNumberOfCells() != 0 )
+    {
+    std::cerr << "Shared cells not released" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -51,158 +51,174 @@
  * @param st Superclass type.
  * @param pt Primal edge type.
  * @param dt Dual edge type.
+ *
+ * The Rot ring always alternates primal and dual edges, so the casts are
+ * static, and checked in debug builds only: these accessors are called for
+ * every step of every ring walk.
  * \todo Should this macro be added to doxygen macros?
  */
 #define itkQEAccessorsMacro(st, pt, dt)                               \
   pt * GetOnext()                                                     \
     {                                                                 \
-    return ( dynamic_cast<  pt * >( this->st::GetOnext() ) );         \
+    return ( QuadEdgeCast< pt >( this->st::GetOnext() ) );            \
     }                                                                 \
                                                                       \
   dt *GetRot()                                                        \
     {                                                                 \
-    return ( dynamic_cast<  dt * >( this->st::GetRot() ) );           \
+    return ( QuadEdgeCast< dt >( this->st::GetRot() ) );              \
     }                                                                 \
                                                                       \
   pt *GetSym()                                                        \
     {                                                                 \
-    return ( dynamic_cast<  pt * >( this->st::GetSym() ) );           \
+    return ( QuadEdgeCast< pt >( this->st::GetSym() ) );              \
     }                                                                 \
                                                                       \
   pt *GetLnext()                                                      \
     {                                                                 \
-    return ( dynamic_cast<  pt * >( this->st::GetLnext() ) );         \
+    return ( QuadEdgeCast< pt >( this->st::GetLnext() ) );            \
     }                                                                 \
                                                                       \
   pt *GetRnext()                                                      \
     {                                                                 \
-    return ( dynamic_cast<  pt * >( this->st::GetRnext() ) );         \
+    return ( QuadEdgeCast< pt >( this->st::GetRnext() ) );            \
     }                                                                 \
                                                                       \
   pt *GetDnext()                                                      \
     {                                                                 \
-    return ( dynamic_cast<  pt * >( this->st::GetDnext() ) );         \
+    return ( QuadEdgeCast< pt >( this->st::GetDnext() ) );            \
     }                                                                 \
                                                                       \
   pt *GetOprev()                                                      \
     {                                                                 \
-    return ( dynamic_cast<  pt * >( this->st::GetOprev() ) );         \
+    return ( QuadEdgeCast< pt >( this->st::GetOprev() ) );            \
     }                                                                 \
                                                                       \
   pt *GetLprev()                                                      \
     {                                                                 \
-    return ( dynamic_cast<  pt * >( this->st::GetLprev() ) );         \
+    return ( QuadEdgeCast< pt >( this->st::GetLprev() ) );            \
     }                                                                 \
                                                                       \
   pt *GetRprev()                                                      \
     {                                                                 \
-    return ( dynamic_cast<  pt * >( this->st::GetRprev() ) );         \
+    return ( QuadEdgeCast< pt >( this->st::GetRprev() ) );            \
     }                                                                 \
                                                                       \
   pt *GetDprev()                                                      \
     {                                                                 \
-    return ( dynamic_cast<  pt * >( this->st::GetDprev() ) );         \
+    return ( QuadEdgeCast< pt >( this->st::GetDprev() ) );            \
     }                                                                 \
                                                                       \
   dt *GetInvRot()                                                     \
     {                                                                 \
-    return ( dynamic_cast< dt * >( this->st::GetInvRot() ) );         \
+    return ( QuadEdgeCast< dt >( this->st::GetInvRot() ) );           \
     }                                                                 \
                                                                       \
   pt *GetInvOnext()                                                   \
     {                                                                 \
-    return ( dynamic_cast<  pt * >( this->st::GetInvOnext() ) );      \
+    return ( QuadEdgeCast< pt >( this->st::GetInvOnext() ) );         \
     }                                                                 \
                                                                       \
   pt *GetInvLnext()                                                   \
     {                                                                 \
-    return ( dynamic_cast<  pt * >( this->st::GetInvLnext() ) );      \
+    return ( QuadEdgeCast< pt >( this->st::GetInvLnext() ) );         \
     }                                                                 \
                                                                       \
   pt *GetInvRnext()                                                   \
     {                                                                 \
-    return ( dynamic_cast<  pt * >( this->st::GetInvRnext() ) );      \
+    return ( QuadEdgeCast< pt >( this->st::GetInvRnext() ) );         \
     }                                                                 \
                                                                       \
   pt *GetInvDnext()                                                   \
     {                                                                 \
-    return ( dynamic_cast<  pt * >( this->st::GetInvDnext() ) );      \
+    return ( QuadEdgeCast< pt >( this->st::GetInvDnext() ) );         \
     }                                                                 \
   const pt *GetOnext() const                                          \
     {                                                                 \
-    return ( dynamic_cast< const pt * >( this->st::GetOnext() ) );    \
+    return ( QuadEdgeCast< const pt >( this->st::GetOnext() ) );      \
     }                                                                 \
                                                                       \
   const dt *GetRot() const                                            \
     {                                                                 \
-    return ( dynamic_cast< const dt * >( this->st::GetRot() ) );      \
+    return ( QuadEdgeCast< const dt >( this->st::GetRot() ) );        \
     }                                                                 \
                                                                       \
   const pt *GetSym() const                                            \
     {                                                                 \
-    return ( dynamic_cast< const pt * >( this->st::GetSym() ) );      \
+    return ( QuadEdgeCast< const pt >( this->st::GetSym() ) );        \
     }                                                                 \
                                                                       \
   const pt *GetLnext() const                                          \
     {                                                                 \
-    return ( dynamic_cast< const pt * >( this->st::GetLnext() ) );    \
+    return ( QuadEdgeCast< const pt >( this->st::GetLnext() ) );      \
     }                                                                 \
                                                                       \
   const pt *GetRnext() const                                          \
     {                                                                 \
-    return ( dynamic_cast< const pt * >( this->st::GetRnext() ) );    \
+    return ( QuadEdgeCast< const pt >( this->st::GetRnext() ) );      \
     }                                                                 \
                                                                       \
   const pt *GetDnext() const                                          \
     {                                                                 \
-    return ( dynamic_cast< const pt * >( this->st::GetDnext() ) );    \
+    return ( QuadEdgeCast< const pt >( this->st::GetDnext() ) );      \
     }                                                                 \
                                                                       \
   const pt *GetOprev() const                                          \
     {                                                                 \
-    return ( dynamic_cast< const pt * >( this->st::GetOprev() ) );    \
+    return ( QuadEdgeCast< const pt >( this->st::GetOprev() ) );      \
     }                                                                 \
                                                                       \
   const pt *GetLprev() const                                          \
     {                                                                 \
-    return ( dynamic_cast< const pt * >( this->st::GetLprev() ) );    \
+    return ( QuadEdgeCast< const pt >( this->st::GetLprev() ) );      \
     }                                                                 \
                                                                       \
   const pt *GetRprev() const                                          \
     {                                                                 \
-    return ( dynamic_cast< const pt * >( this->st::GetRprev() ) );    \
+    return ( QuadEdgeCast< const pt >( this->st::GetRprev() ) );      \
     }                                                                 \
                                                                       \
   const pt *GetDprev() const                                          \
     {                                                                 \
-    return ( dynamic_cast< const pt * >( this->st::GetDprev() ) );    \
+    return ( QuadEdgeCast< const pt >( this->st::GetDprev() ) );      \
     }                                                                 \
                                                                       \
   const dt *GetInvRot() const                                         \
     {                                                                 \
-    return ( dynamic_cast< const dt * >( this->st::GetInvRot() ) );   \
+    return ( QuadEdgeCast< const dt >( this->st::GetInvRot() ) );     \
     }                                                                 \
                                                                       \
   const pt *GetInvOnext() const                                       \
     {                                                                 \
-    return ( dynamic_cast< const pt * >( this->st::GetInvOnext() ) ); \
+    return ( QuadEdgeCast< const pt >( this->st::GetInvOnext() ) );   \
     }                                                                 \
                                                                       \
   const pt *GetInvLnext() const                                       \
     {                                                                 \
-    return ( dynamic_cast< const pt * >( this->st::GetInvLnext() ) ); \
+    return ( QuadEdgeCast< const pt >( this->st::GetInvLnext() ) );   \
     }                                                                 \
                                                                       \
   const pt *GetInvRnext() const                                       \
     {                                                                 \
-    return ( dynamic_cast< const pt * >( this->st::GetInvRnext() ) ); \
+    return ( QuadEdgeCast< const pt >( this->st::GetInvRnext() ) );   \
     }                                                                 \
                                                                       \
   const pt *GetInvDnext() const                                       \
     {                                                                 \
-    return ( dynamic_cast< const pt * >( this->st::GetInvDnext() ) ); \
+    return ( QuadEdgeCast< const pt >( this->st::GetInvDnext() ) );   \
     }
 
+namespace itk
+{
+/** Cast a quad-edge of a Rot ring to the primal or dual type of its
+ * position in the ring, as itkQEAccessorsMacro does. */
+template< typename TEdge, typename TQuadEdge >
+inline TEdge * QuadEdgeCast(TQuadEdge *edge)
+{
+  itkAssertInDebugAndIgnoreInReleaseMacro( edge == ITK_NULLPTR || dynamic_cast< TEdge * >( edge ) != ITK_NULLPTR );
+  return static_cast< TEdge * >( edge );
+}
+}
+
 namespace itk
 {
 /** \class QuadEdge
@@ -502,6 +502,21 @@ protected:
   /** Release the memory of each one of the cells independently. */
   virtual void ClearCellsContainer();
 
+  /** Create the edge and face cells of the mesh. The memory of the cells
+   * deleted by the mesh is reused when available. */
+  EdgeCellType * NewEdgeCell();
+
+  PolygonCellType * NewFaceCell(QEPrimal *entry);
+
+  /** Destroy a cell and keep its memory for the next cell of the same
+   * type. Cells of any other type are deleted. */
+  void RecycleEdgeCell(const CellType *cell);
+
+  void RecycleFaceCell(const CellType *cell);
+
+  /** Release the memory kept for the creation of new cells. */
+  void ReleaseFreeCells();
+
   CellsContainerPointer m_EdgeCellsContainer;
 
 private:
@@ -511,6 +526,12 @@ private:
   CellIdentifier m_NumberOfFaces;
   CellIdentifier m_NumberOfEdges;
 
+  /** Memory of the deleted edge and face cells. Euler operators delete
+   * and create cells constantly, and Clear() keeps it for the next
+   * update of the mesh. */
+  std::vector< void * > m_FreeEdgeCells;
+  std::vector< void * > m_FreeFaceCells;
+
 protected:
   FreePointIndexesType m_FreePointIndexes;
   FreeCellIndexesType  m_FreeCellIndexes;
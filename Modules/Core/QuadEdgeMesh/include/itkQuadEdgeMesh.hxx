@@ -20,6 +20,7 @@
 #include "itkQuadEdgeMesh.h"
 #include "vcl_limits.h"
 #include <vector>
+#include <new>
 
 namespace itk
 {
@@ -366,8 +367,11 @@ void QuadEdgeMesh< TPixel, VDimension, TTraits >
     // NOTE ALEX: here
     this->AddEdge( qe->GetQEGeom()->GetOrigin(),
                    qe->GetQEGeom()->GetDestination() );
-    cell.ReleaseOwnership();
-    delete qe;
+    if ( cell.IsOwner() )
+      {
+      cell.ReleaseOwnership();
+      delete qe;
+      }
     }
   else if ( ( pe = dynamic_cast< PolygonCellType * >( cell.GetPointer() ) ) )
     {
@@ -381,8 +385,11 @@ void QuadEdgeMesh< TPixel, VDimension, TTraits >
       }
     // NOTE ALEX: here
     this->AddFaceWithSecurePointList(points);
-    cell.ReleaseOwnership();
-    delete pe;
+    if ( cell.IsOwner() )
+      {
+      cell.ReleaseOwnership();
+      delete pe;
+      }
     }
   else // non-QE cell, i.e. original itk cells for example
     {
@@ -411,8 +418,11 @@ void QuadEdgeMesh< TPixel, VDimension, TTraits >
       // NOTE ALEX: here
       this->AddFace(points);
       }
-    cell.ReleaseOwnership();
-    delete ( cell.GetPointer() );
+    // Cells that are not owned, e.g. allocated in a block, are left alone.
+    if ( cell.IsOwner() )
+      {
+      delete ( cell.ReleaseOwnership() );
+      }
     }
 }
 
@@ -718,7 +728,7 @@ QuadEdgeMesh< TPixel, VDimension, TTraits >
   QEPrimal *eDestination  = pDestination.GetEdge();
 
   // Ok, there's room and the points exist
-  EdgeCellType *newEdge = new EdgeCellType();
+  EdgeCellType *newEdge = this->NewEdgeCell();
   QEPrimal *    newEdgeGeom = newEdge->GetQEGeom();
 
   newEdgeGeom->SetOrigin (orgPid);
@@ -892,7 +902,7 @@ QuadEdgeMesh< TPixel, VDimension, TTraits >
   while ( dit != dend )
     {
     const CellType *cellToBeDeleted = this->GetCells()->GetElement(*dit);
-    delete cellToBeDeleted;
+    this->RecycleFaceCell(cellToBeDeleted);
     this->GetCells()->DeleteIndex(*dit);
     ++dit;
     }
@@ -900,7 +910,7 @@ QuadEdgeMesh< TPixel, VDimension, TTraits >
   // now delete the edge in the edge container
   CellType *edgeCellToDelete = this->GetEdgeCells()->ElementAt( e->GetIdent() );
   this->GetEdgeCells()->DeleteIndex( e->GetIdent() );
-  delete edgeCellToDelete;
+  this->RecycleEdgeCell(edgeCellToDelete);
   --m_NumberOfEdges;
 
   // Now, disconnect it and let the garbage collector do the rest
@@ -1009,7 +1019,7 @@ QuadEdgeMesh< TPixel, VDimension, TTraits >
     }
 
   --m_NumberOfEdges;
-  delete edgeCell;
+  this->RecycleEdgeCell(edgeCell);
   this->Modified();
 }
 
@@ -1097,7 +1107,7 @@ QuadEdgeMesh< TPixel, VDimension, TTraits >
     }
 
   cells->DeleteIndex(faceToDelete);
-  delete cellToDelete;
+  this->RecycleFaceCell(cellToDelete);
 
   --m_NumberOfFaces;
 
@@ -1357,7 +1367,7 @@ QuadEdgeMesh< TPixel, VDimension, TTraits >
 ::AddFace(QEPrimal *entry)
 {
   // Create the cell and add it to the container
-  PolygonCellType *faceCell = new PolygonCellType(entry);
+  PolygonCellType *faceCell = this->NewFaceCell(entry);
   CellIdentifier   fid = this->FindFirstUnusedCellIndex();
 
   faceCell->SetIdent(fid);
@@ -1416,6 +1426,7 @@ QuadEdgeMesh< TPixel, VDimension, TTraits >
 ::~QuadEdgeMesh()
 {
   this->ClearCellsContainer();
+  this->ReleaseFreeCells();
 }
 
 template< typename TPixel, unsigned int VDimension, typename TTraits >
@@ -1437,6 +1448,98 @@ QuadEdgeMesh< TPixel, VDimension, TTraits >
     }
 }
 
+/**
+ */
+template< typename TPixel, unsigned int VDimension, typename TTraits >
+typename QuadEdgeMesh< TPixel, VDimension, TTraits >::EdgeCellType *
+QuadEdgeMesh< TPixel, VDimension, TTraits >
+::NewEdgeCell()
+{
+  if ( m_FreeEdgeCells.empty() )
+    {
+    return new EdgeCellType;
+    }
+  void *memory = m_FreeEdgeCells.back();
+  m_FreeEdgeCells.pop_back();
+  return new( memory ) EdgeCellType;
+}
+
+/**
+ */
+template< typename TPixel, unsigned int VDimension, typename TTraits >
+typename QuadEdgeMesh< TPixel, VDimension, TTraits >::PolygonCellType *
+QuadEdgeMesh< TPixel, VDimension, TTraits >
+::NewFaceCell(QEPrimal *entry)
+{
+  if ( m_FreeFaceCells.empty() )
+    {
+    return new PolygonCellType(entry);
+    }
+  void *memory = m_FreeFaceCells.back();
+  m_FreeFaceCells.pop_back();
+  return new( memory ) PolygonCellType(entry);
+}
+
+/**
+ * The memory of a cell can only be reused for a cell of the very same
+ * type, hence the exact type check.
+ */
+template< typename TPixel, unsigned int VDimension, typename TTraits >
+void
+QuadEdgeMesh< TPixel, VDimension, TTraits >
+::RecycleEdgeCell(const CellType *cell)
+{
+  if ( cell && typeid( *cell ) == typeid( EdgeCellType ) )
+    {
+    EdgeCellType *edge = const_cast< EdgeCellType * >( static_cast< const EdgeCellType * >( cell ) );
+    edge->~EdgeCellType();
+    m_FreeEdgeCells.push_back(edge);
+    }
+  else
+    {
+    delete cell;
+    }
+}
+
+/**
+ */
+template< typename TPixel, unsigned int VDimension, typename TTraits >
+void
+QuadEdgeMesh< TPixel, VDimension, TTraits >
+::RecycleFaceCell(const CellType *cell)
+{
+  if ( cell && typeid( *cell ) == typeid( PolygonCellType ) )
+    {
+    PolygonCellType *face = const_cast< PolygonCellType * >( static_cast< const PolygonCellType * >( cell ) );
+    face->~PolygonCellType();
+    m_FreeFaceCells.push_back(face);
+    }
+  else
+    {
+    delete cell;
+    }
+}
+
+/**
+ */
+template< typename TPixel, unsigned int VDimension, typename TTraits >
+void
+QuadEdgeMesh< TPixel, VDimension, TTraits >
+::ReleaseFreeCells()
+{
+  for ( size_t i = 0; i < m_FreeEdgeCells.size(); ++i )
+    {
+    ::operator delete( m_FreeEdgeCells[i] );
+    }
+  for ( size_t i = 0; i < m_FreeFaceCells.size(); ++i )
+    {
+    ::operator delete( m_FreeFaceCells[i] );
+    }
+  // Swap with empty vectors to actually give the memory back.
+  std::vector< void * >().swap(m_FreeEdgeCells);
+  std::vector< void * >().swap(m_FreeFaceCells);
+}
+
 /**
  */
 template< typename TPixel, unsigned int VDimension, typename TTraits >
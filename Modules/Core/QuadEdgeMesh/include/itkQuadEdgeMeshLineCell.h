@@ -208,6 +208,11 @@ private:
   CellIdentifier          m_Identifier;
   QEType *                m_QuadEdgeGeom;
   mutable PointIdentifier m_PointIds[2];
+
+  /** The four quad-edges of the Rot ring are stored in the cell itself,
+   * so that creating an edge costs a single allocation. */
+  QEType m_PrimalEdges[2];
+  QEDual m_DualEdges[2];
 };
 } // end namespace itk
 
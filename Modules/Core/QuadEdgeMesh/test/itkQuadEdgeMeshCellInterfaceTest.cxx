@@ -431,29 +431,16 @@ int itkQuadEdgeMeshCellInterfaceTest(int, char* [] )
 
   mesh->Accept(   multiVisitor );
 
-  // test 4 very specific QELineCell destructor cases
+  // the Rot ring of a QELineCell is stored in the cell itself
   QELineCellType* test = new QELineCellType();
   QEType* m_QuadEdgeGeom = test->GetQEGeom( );
-  delete m_QuadEdgeGeom->GetRot( )->GetRot( )->GetRot( );
-  m_QuadEdgeGeom->GetRot( )->GetRot( )->SetRot( ITK_NULLPTR );
-  delete test;
-
-  test = new QELineCellType();
-  m_QuadEdgeGeom = test->GetQEGeom( );
-  delete m_QuadEdgeGeom->GetRot( )->GetRot( )->GetRot( );
-  m_QuadEdgeGeom->GetRot( )->GetRot( )->SetRot( ITK_NULLPTR );
-  delete m_QuadEdgeGeom->GetRot( )->GetRot( );
-  m_QuadEdgeGeom->GetRot( )->SetRot( ITK_NULLPTR );
-  delete test;
-
-  test = new QELineCellType();
-  m_QuadEdgeGeom = test->GetQEGeom( );
-  delete m_QuadEdgeGeom->GetRot( )->GetRot( )->GetRot( );
-  m_QuadEdgeGeom->GetRot( )->GetRot( )->SetRot( ITK_NULLPTR );
-  delete m_QuadEdgeGeom->GetRot( )->GetRot( );
-  m_QuadEdgeGeom->GetRot( )->SetRot( ITK_NULLPTR );
-  delete m_QuadEdgeGeom->GetRot( );
-  m_QuadEdgeGeom->SetRot( ITK_NULLPTR );
+  if( m_QuadEdgeGeom->GetRot( )->GetRot( )->GetRot( )->GetRot( ) != m_QuadEdgeGeom
+      || m_QuadEdgeGeom->GetSym( )->GetSym( ) != m_QuadEdgeGeom
+      || m_QuadEdgeGeom->GetOnext( ) != m_QuadEdgeGeom )
+    {
+    std::cerr << "QELineCell Rot ring is not consistent" << std::endl;
+    status = EXIT_FAILURE;
+    }
   delete test;
 
   return status;
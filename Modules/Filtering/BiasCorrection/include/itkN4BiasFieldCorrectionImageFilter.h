@@ -24,9 +24,12 @@
 #include "itkBSplineScatteredDataPointSetToImageFilter.h"
 #include "itkPointSet.h"
 #include "itkVector.h"
+#include "itkMultiThreader.h"
 
 #include "vnl/vnl_vector.h"
 
+#include <vector>
+
 namespace itk {
 
 /**
@@ -69,6 +72,17 @@ namespace itk {
  * the corrected input image and spatially smoothing those results with a
  * B-spline scalar field estimate of the bias field.
  *
+ * The B-spline fit is computed directly from the voxels inside the mask,
+ * with B-spline weights precomputed along each axis of the image.  The
+ * control point lattice is accumulated over the iterations and the bias
+ * field is only evaluated at the masked voxels, except at the end of each
+ * fitting level where it is reconstructed over the whole image.  All the
+ * steps are multithreaded.  The partial sums of the threads are added in
+ * thread order, so the estimate is reproducible for a given number of
+ * threads; with a different number of threads, the sums are accumulated in
+ * a different order and the control points may differ slightly (the test
+ * checks that they agree within 1e-3).
+ *
  * \author Nicholas J. Tustison
  *
  * Contributed by Nicholas J. Tustison, James C. Gee in the Insight Journal
@@ -378,6 +392,9 @@ private:
   void operator=( const Self& );                      //purposely not
                                                       // implemented
 
+  typedef typename RealImageType::RegionType RealImageRegionType;
+  typedef std::vector<RealType>              RealVectorType;
+
   // N4 algorithm functions:  The basic algorithm iterates between sharpening
   // the intensity histogram of the corrected input image and spatially
   // smoothing those results with a B-spline scalar field estimate of the
@@ -385,31 +402,115 @@ private:
   // whereas the latter is handled by the function UpdateBiasFieldEstimate().
   // Convergence is determined by the coefficient of variation of the difference
   // image between the current bias field estimate and the previous estimate.
+  // During the iterations, the images are only stored at the voxels used in
+  // the estimation (see CollectVoxels()).
+
+  /**
+   * Store the offsets, confidence weights and log intensities of the voxels
+   * used in the estimation, i.e. the voxels inside the mask with a positive
+   * confidence.
+   */
+  void CollectVoxels( RealImageType * );
+
+  /**
+   * Compute the B-spline weights along each axis of the image for a control
+   * point lattice of the given size.
+   */
+  void ComputeBSplineWeights( const ArrayType & );
 
   /**
    * Sharpen the intensity histogram of the current estimate of the corrected
-   * image and map those results to a new estimate of the unsmoothed corrected
-   * image.
+   * image and store the difference between the current estimate and its
+   * sharpened version, i.e. the residual bias field.
    */
-  RealImagePointer SharpenImage( const RealImageType * ) const;
+  void SharpenImage();
 
   /**
-   * Given the unsmoothed estimate of the bias field, this function smooths
-   * the estimate and adds the resulting control point values to the total
-   * bias field estimate.
+   * Fit the residual bias field with a B-spline, add the resulting control
+   * point values to the total bias field estimate and update the estimate at
+   * the voxels used in the estimation.  Returns the convergence measurement,
+   * i.e. the coefficient of variation of the change of the bias field.
    */
-  RealImagePointer UpdateBiasFieldEstimate( RealImageType * );
+  RealType UpdateBiasFieldEstimate();
 
   /**
-   * Reconstruct bias field given the control point lattice.
+   * Reconstruct the bias field over the whole image from the total control
+   * point lattice.
    */
-  RealImagePointer ReconstructBiasField( BiasFieldControlPointLatticeType * );
+  void ReconstructBiasField( RealImageType * );
+
+  /** The steps of the algorithm distributed over the threads. */
+  enum ThreadedStepType
+    {
+    CollectVoxelsStep,
+    HistogramRangeStep,
+    HistogramStep,
+    SharpenStep,
+    FitStep,
+    UpdateStep,
+    ReconstructStep
+    };
+
+  /** Partial results of a thread, combined in thread order. */
+  struct ThreadResults
+    {
+    std::vector<OffsetValueType> VoxelOffsets;
+    RealVectorType               VoxelWeights;
+    RealVectorType               VoxelLogInput;
+    RealType                     Minimum;
+    RealType                     Maximum;
+    vnl_vector<RealType>         Histogram;
+    RealVectorType               Omega;
+    RealVectorType               Delta;
+    double                       NumberOfVoxels;
+    double                       Mean;
+    double                       SumOfSquares;
+    };
+
+  struct ThreadStruct
+    {
+    Self *                       Filter;
+    ThreadedStepType             Step;
+    RealImageRegionType          Region;
+    RealImageType *              BiasField;
+    RealType                     BinMinimum;
+    RealType                     HistogramSlope;
+    const vnl_vector<RealType> * Mapping;
+    const ScalarType *           Lattice;
+    std::vector<ThreadResults> * Results;
+    };
+
+  /** Run a step over the voxels used in the estimation, or over pieces of
+   * the region for the CollectVoxelsStep and the ReconstructStep. */
+  void ExecuteThreadedStep( ThreadStruct & );
+
+  static ITK_THREAD_RETURN_TYPE StepThreaderCallback( void *arg );
+
+  void ThreadedCollectVoxels( const RealImageRegionType &, const RealImageType *,
+    ThreadResults & ) const;
+
+  void ThreadedComputeHistogramRange( SizeValueType, SizeValueType, ThreadResults & ) const;
+
+  void ThreadedComputeHistogram( SizeValueType, SizeValueType, RealType, RealType,
+    ThreadResults & ) const;
+
+  void ThreadedSharpenImage( SizeValueType, SizeValueType, RealType, RealType,
+    const vnl_vector<RealType> & );
+
+  void ThreadedFitBiasField( SizeValueType, SizeValueType, ThreadResults & ) const;
+
+  void ThreadedUpdateBiasField( SizeValueType, SizeValueType, const ScalarType *,
+    ThreadResults & );
+
+  void ThreadedReconstructBiasField( const RealImageRegionType &, const ScalarType *,
+    RealImageType * ) const;
 
   /**
-   * Convergence is determined by the coefficient of variation of the difference
-   * image between the current bias field estimate and the previous estimate.
+   * Compute the weights of the control points supporting the voxel at the
+   * given offset of the largest possible region and return the lattice
+   * offset of the first of them.
    */
-  RealType CalculateConvergenceMeasurement( const RealImageType *, const RealImageType * ) const;
+  OffsetValueType ComputeSupportWeights( OffsetValueType, RealType * ) const;
 
   MaskPixelType m_MaskLabel;
 
@@ -436,6 +537,24 @@ private:
   ArrayType    m_NumberOfControlPoints;
   ArrayType    m_NumberOfFittingLevels;
 
+  // Voxels used in the estimation, as offsets in the largest possible
+  // region, with the current estimates at these voxels.
+
+  std::vector<OffsetValueType> m_VoxelOffsets;
+  RealVectorType               m_VoxelWeights;
+  RealVectorType               m_VoxelLogInput;
+  RealVectorType               m_VoxelLogBiasField;
+  RealVectorType               m_VoxelResidualBiasField;
+
+  // B-spline weights of the current lattice at each position along each
+  // axis, with the lattice offset of the first supporting control point.
+
+  typename RealImageType::SizeType                    m_FieldSize;
+  typename BiasFieldControlPointLatticeType::SizeType m_BSplineLatticeSize;
+  std::vector<OffsetValueType>                        m_BSplineLatticeOffsets[ImageDimension];
+  RealVectorType                                      m_BSplineWeights[ImageDimension];
+  std::vector<OffsetValueType>                        m_BSplineSupportOffsets;
+
 };
 
 } // end namespace itk
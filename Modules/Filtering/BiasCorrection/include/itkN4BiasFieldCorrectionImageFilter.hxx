@@ -20,21 +20,22 @@
 
 #include "itkN4BiasFieldCorrectionImageFilter.h"
 
-#include "itkAddImageFilter.h"
 #include "itkBSplineControlPointImageFilter.h"
+#include "itkCoxDeBoorBSplineKernelFunction.h"
 #include "itkDivideImageFilter.h"
 #include "itkExpImageFilter.h"
-#include "itkImageRegionIterator.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
 #include "itkImageRegionIteratorWithIndex.h"
-#include "itkImportImageFilter.h"
+#include "itkImageRegionSplitterSlowDimension.h"
 #include "itkIterationReporter.h"
-#include "itkSubtractImageFilter.h"
-#include "itkVectorIndexSelectionCastImageFilter.h"
 
 #include "vnl/algo/vnl_fft_1d.h"
 #include "vnl/vnl_complex_traits.h"
 #include "vcl_complex.h"
 
+#include <algorithm>
+#include <limits>
+
 namespace itk {
 
 template <typename TInputImage, typename TMaskImage, typename TOutputImage>
@@ -69,63 +70,24 @@ N4BiasFieldCorrectionImageFilter<TInputImage, TMaskImage, TOutputImage>
   this->AllocateOutputs();
 
   const InputImageType * inputImage = this->GetInput();
-  typedef typename InputImageType::RegionType RegionType;
-  const RegionType inputRegion = inputImage->GetBufferedRegion();
-
-  // Calculate the log of the input image.
-  RealImagePointer logInputImage = RealImageType::New();
-  logInputImage->CopyInformation( inputImage );
-  logInputImage->SetRegions( inputRegion );
-  logInputImage->Allocate( false );
-
-  ImageRegionConstIterator<InputImageType> inpItr( inputImage, inputRegion );
-  ImageRegionIterator<RealImageType> outItr( logInputImage, inputRegion );
-
-  inpItr.GoToBegin();
-  outItr.GoToBegin();
-
-  while( !inpItr.IsAtEnd() )
-    {
-    outItr.Set( static_cast< RealType >( inpItr.Get() ) );
-    ++inpItr;
-    ++outItr;
-    }
-
-  const MaskImageType * maskImage = this->GetMaskImage();
-  const RealImageType * confidenceImage = this->GetConfidenceImage();
-
-  ImageRegionIteratorWithIndex<RealImageType> It( logInputImage, inputRegion );
-
-  for( It.GoToBegin(); !It.IsAtEnd(); ++It )
-    {
-    if( ( !maskImage ||
-          maskImage->GetPixel( It.GetIndex() ) == this->m_MaskLabel )
-        && ( !confidenceImage ||
-             confidenceImage->GetPixel( It.GetIndex() ) > 0.0 ) )
-      {
-      if( It.Get() > NumericTraits<typename InputImageType::PixelType>::ZeroValue() )
-        {
-        It.Set( std::log( static_cast< RealType >( It.Get() ) ) );
-        }
-      }
-    }
-
-  // Duplicate logInputImage since we reuse the original at each iteration.
 
-  typedef ImageDuplicator<RealImageType> DuplicatorType;
-  typename DuplicatorType::Pointer duplicator = DuplicatorType::New();
-  duplicator->SetInputImage( logInputImage );
-  duplicator->Update();
-
-  RealImagePointer logUncorrectedImage = duplicator->GetModifiableOutput();
-
-  // Provide an initial log bias field of zeros
+  // Provide an initial log bias field of zeros.  During the iterations, the
+  // log bias field is only updated at the voxels used in the estimation; it
+  // is reconstructed over the whole image at the end of each fitting level.
 
   RealImagePointer logBiasField = RealImageType::New();
   logBiasField->CopyInformation( inputImage );
   logBiasField->SetRegions( inputImage->GetLargestPossibleRegion() );
   logBiasField->Allocate( true ); // initialize buffer to zero
 
+  this->m_FieldSize = logBiasField->GetLargestPossibleRegion().GetSize();
+  this->m_LogBiasFieldControlPointLattice = ITK_NULLPTR;
+
+  // Calculate the log of the input image at the voxels used in the
+  // estimation.
+
+  this->CollectVoxels( logBiasField );
+
   // Iterate until convergence or iterative exhaustion.
   unsigned int maximumNumberOfLevels = 1;
   for( unsigned int d = 0; d < this->m_NumberOfFittingLevels.Size(); d++ )
@@ -146,6 +108,20 @@ N4BiasFieldCorrectionImageFilter<TInputImage, TMaskImage, TOutputImage>
     {
     IterationReporter reporter( this, 0, 1 );
 
+    // The B-spline weights only depend on the size of the control point
+    // lattice, which is constant within a level.
+
+    ArrayType numberOfControlPoints = this->m_NumberOfControlPoints;
+    if( this->m_LogBiasFieldControlPointLattice )
+      {
+      for( unsigned int d = 0; d < ImageDimension; d++ )
+        {
+        numberOfControlPoints[d] = this->m_LogBiasFieldControlPointLattice->
+          GetLargestPossibleRegion().GetSize()[d];
+        }
+      }
+    this->ComputeBSplineWeights( numberOfControlPoints );
+
     this->m_ElapsedIterations = 0;
     this->m_CurrentConvergenceMeasurement = NumericTraits<RealType>::max();
     while( this->m_ElapsedIterations++ <
@@ -155,59 +131,56 @@ N4BiasFieldCorrectionImageFilter<TInputImage, TMaskImage, TOutputImage>
 
       // Sharpen the current estimate of the uncorrected image.
 
-      RealImagePointer logSharpenedImage = this->SharpenImage( logUncorrectedImage );
-
-      typedef SubtractImageFilter<RealImageType, RealImageType, RealImageType>
-      SubtracterType;
-      typename SubtracterType::Pointer subtracter1 = SubtracterType::New();
-      subtracter1->SetInput1( logUncorrectedImage );
-      subtracter1->SetInput2( logSharpenedImage );
-
-      RealImagePointer residualBiasField = subtracter1->GetOutput();
-      residualBiasField->Update();
+      this->SharpenImage();
 
       // Smooth the residual bias field estimate and add the resulting
       // control point grid to get the new total bias field estimate.
 
-      RealImagePointer newLogBiasField = this->UpdateBiasFieldEstimate( residualBiasField );
-
-      this->m_CurrentConvergenceMeasurement =
-        this->CalculateConvergenceMeasurement( logBiasField, newLogBiasField );
-      logBiasField = newLogBiasField;
-
-      typename SubtracterType::Pointer subtracter2 = SubtracterType::New();
-      subtracter2->SetInput1( logInputImage );
-      subtracter2->SetInput2( logBiasField );
-
-      logUncorrectedImage = subtracter2->GetOutput();
-      logUncorrectedImage->Update();
+      this->m_CurrentConvergenceMeasurement = this->UpdateBiasFieldEstimate();
 
       reporter.CompletedStep();
       }
 
-    typedef BSplineControlPointImageFilter<BiasFieldControlPointLatticeType, ScalarImageType>
-      BSplineReconstructerType;
-    typename BSplineReconstructerType::Pointer reconstructer = BSplineReconstructerType::New();
-    reconstructer->SetInput( this->m_LogBiasFieldControlPointLattice );
-    reconstructer->SetOrigin( logBiasField->GetOrigin() );
-    reconstructer->SetSpacing( logBiasField->GetSpacing() );
-    reconstructer->SetDirection( logBiasField->GetDirection() );
-    reconstructer->SetSize( logBiasField->GetLargestPossibleRegion().GetSize() );
-    reconstructer->SetSplineOrder( this->m_SplineOrder );
-    reconstructer->Update();
-
-    typename BSplineReconstructerType::ArrayType numberOfLevels;
-    numberOfLevels.Fill( 1 );
-    for( unsigned int d = 0; d < ImageDimension; d++ )
+    if( this->m_LogBiasFieldControlPointLattice )
       {
-      if( this->m_NumberOfFittingLevels[d] + 1 >= this->m_CurrentLevel &&
-          this->m_CurrentLevel != maximumNumberOfLevels-1 )
+      this->ReconstructBiasField( logBiasField );
+
+      typedef BSplineControlPointImageFilter<BiasFieldControlPointLatticeType, ScalarImageType>
+        BSplineReconstructerType;
+      typename BSplineReconstructerType::Pointer reconstructer = BSplineReconstructerType::New();
+      reconstructer->SetInput( this->m_LogBiasFieldControlPointLattice );
+      reconstructer->SetOrigin( logBiasField->GetOrigin() );
+      reconstructer->SetSpacing( logBiasField->GetSpacing() );
+      reconstructer->SetDirection( logBiasField->GetDirection() );
+      reconstructer->SetSize( logBiasField->GetLargestPossibleRegion().GetSize() );
+      reconstructer->SetSplineOrder( this->m_SplineOrder );
+
+      typename BSplineReconstructerType::ArrayType numberOfLevels;
+      numberOfLevels.Fill( 1 );
+      for( unsigned int d = 0; d < ImageDimension; d++ )
         {
-        numberOfLevels[d] = 2;
+        if( this->m_NumberOfFittingLevels[d] + 1 >= this->m_CurrentLevel &&
+            this->m_CurrentLevel != maximumNumberOfLevels-1 )
+          {
+          numberOfLevels[d] = 2;
+          }
         }
+      this->m_LogBiasFieldControlPointLattice = reconstructer->
+        RefineControlPointLattice( numberOfLevels );
       }
-    this->m_LogBiasFieldControlPointLattice = reconstructer->
-      RefineControlPointLattice( numberOfLevels );
+    }
+
+  // Release the estimates at the voxels and the B-spline weights.
+
+  std::vector<OffsetValueType>().swap( this->m_VoxelOffsets );
+  RealVectorType().swap( this->m_VoxelWeights );
+  RealVectorType().swap( this->m_VoxelLogInput );
+  RealVectorType().swap( this->m_VoxelLogBiasField );
+  RealVectorType().swap( this->m_VoxelResidualBiasField );
+  for( unsigned int d = 0; d < ImageDimension; d++ )
+    {
+    std::vector<OffsetValueType>().swap( this->m_BSplineLatticeOffsets[d] );
+    RealVectorType().swap( this->m_BSplineWeights[d] );
     }
 
   typedef ExpImageFilter<RealImageType, RealImageType> ExpImageFilterType;
@@ -229,75 +202,252 @@ N4BiasFieldCorrectionImageFilter<TInputImage, TMaskImage, TOutputImage>
 }
 
 template<typename TInputImage, typename TMaskImage, typename TOutputImage>
-typename
-N4BiasFieldCorrectionImageFilter<TInputImage, TMaskImage, TOutputImage>::RealImagePointer
+void
 N4BiasFieldCorrectionImageFilter<TInputImage, TMaskImage, TOutputImage>
-::SharpenImage( const RealImageType *unsharpenedImage ) const
+::CollectVoxels( RealImageType *logBiasField )
 {
+  std::vector<ThreadResults> results;
+
+  ThreadStruct str;
+  str.Step = CollectVoxelsStep;
+  str.Region = this->GetInput()->GetBufferedRegion();
+  str.BiasField = logBiasField;
+  str.Results = &results;
+  this->ExecuteThreadedStep( str );
+
+  // Concatenate the voxels of the pieces in piece order, i.e. in buffer
+  // order.
+
+  SizeValueType numberOfVoxels = 0;
+  for( unsigned int n = 0; n < results.size(); n++ )
+    {
+    numberOfVoxels += results[n].VoxelOffsets.size();
+    }
+
+  this->m_VoxelOffsets.clear();
+  this->m_VoxelWeights.clear();
+  this->m_VoxelLogInput.clear();
+  this->m_VoxelOffsets.reserve( numberOfVoxels );
+  this->m_VoxelWeights.reserve( numberOfVoxels );
+  this->m_VoxelLogInput.reserve( numberOfVoxels );
+  for( unsigned int n = 0; n < results.size(); n++ )
+    {
+    this->m_VoxelOffsets.insert( this->m_VoxelOffsets.end(),
+      results[n].VoxelOffsets.begin(), results[n].VoxelOffsets.end() );
+    this->m_VoxelWeights.insert( this->m_VoxelWeights.end(),
+      results[n].VoxelWeights.begin(), results[n].VoxelWeights.end() );
+    this->m_VoxelLogInput.insert( this->m_VoxelLogInput.end(),
+      results[n].VoxelLogInput.begin(), results[n].VoxelLogInput.end() );
+    }
+  this->m_VoxelLogBiasField.assign( numberOfVoxels, 0.0 );
+  this->m_VoxelResidualBiasField.assign( numberOfVoxels, 0.0 );
+}
+
+template<typename TInputImage, typename TMaskImage, typename TOutputImage>
+void
+N4BiasFieldCorrectionImageFilter<TInputImage, TMaskImage, TOutputImage>
+::ThreadedCollectVoxels( const RealImageRegionType &region,
+                         const RealImageType *logBiasField,
+                         ThreadResults &results ) const
+{
+  const InputImageType * inputImage = this->GetInput();
   const MaskImageType * maskImage = this->GetMaskImage();
   const RealImageType * confidenceImage = this->GetConfidenceImage();
 
-  // Build the histogram for the uncorrected image.  Store copy
-  // in a vnl_vector to utilize vnl FFT routines.  Note that variables
-  // in real space are denoted by a single uppercase letter whereas their
-  // frequency counterparts are indicated by a trailing lowercase 'f'.
+  results.VoxelOffsets.clear();
+  results.VoxelWeights.clear();
+  results.VoxelLogInput.clear();
 
-  RealType binMaximum = NumericTraits<RealType>::NonpositiveMin();
-  RealType binMinimum = NumericTraits<RealType>::max();
-
-  ImageRegionConstIterator<RealImageType> ItU(
-    unsharpenedImage, unsharpenedImage->GetLargestPossibleRegion() );
+  ImageRegionConstIteratorWithIndex<InputImageType> It( inputImage, region );
 
-  for( ItU.GoToBegin(); !ItU.IsAtEnd(); ++ItU )
+  for( It.GoToBegin(); !It.IsAtEnd(); ++It )
     {
     if( ( !maskImage ||
-          maskImage->GetPixel( ItU.GetIndex() ) == this->m_MaskLabel )
+          maskImage->GetPixel( It.GetIndex() ) == this->m_MaskLabel )
         && ( !confidenceImage ||
-             confidenceImage->GetPixel( ItU.GetIndex() ) > 0.0 ) )
+             confidenceImage->GetPixel( It.GetIndex() ) > 0.0 ) )
       {
-      RealType pixel = ItU.Get();
-      if( pixel > binMaximum )
+      RealType logPixel = static_cast< RealType >( It.Get() );
+      if( It.Get() > NumericTraits<typename InputImageType::PixelType>::ZeroValue() )
         {
-        binMaximum = pixel;
+        logPixel = std::log( logPixel );
         }
-      else if( pixel < binMinimum )
+
+      RealType confidenceWeight = 1.0;
+      if( confidenceImage )
         {
-        binMinimum = pixel;
+        confidenceWeight = confidenceImage->GetPixel( It.GetIndex() );
         }
+
+      results.VoxelOffsets.push_back( logBiasField->ComputeOffset( It.GetIndex() ) );
+      results.VoxelWeights.push_back( confidenceWeight );
+      results.VoxelLogInput.push_back( logPixel );
       }
     }
-  RealType histogramSlope = ( binMaximum - binMinimum ) /
-    static_cast<RealType>( this->m_NumberOfHistogramBins - 1 );
+}
 
-  // Create the intensity profile (within the masked region, if applicable)
-  // using a triangular parzen windowing scheme.
+template<typename TInputImage, typename TMaskImage, typename TOutputImage>
+void
+N4BiasFieldCorrectionImageFilter<TInputImage, TMaskImage, TOutputImage>
+::ComputeBSplineWeights( const ArrayType & numberOfControlPoints )
+{
+  // Calculate the appropriate epsilon value, as the B-spline filters do.
 
-  vnl_vector<RealType> H( this->m_NumberOfHistogramBins, 0.0 );
+  unsigned int maximumNumberOfSpans = 0;
+  for( unsigned int d = 0; d < ImageDimension; d++ )
+    {
+    if( numberOfControlPoints[d] < this->m_SplineOrder + 1 )
+      {
+      itkExceptionMacro(
+        "The number of control points must be greater than the spline order." );
+      }
+    maximumNumberOfSpans = std::max( maximumNumberOfSpans,
+      static_cast<unsigned int>( numberOfControlPoints[d] - this->m_SplineOrder ) );
+    }
+  RealType epsilon = 100 * std::numeric_limits<RealType>::epsilon();
+  while( static_cast<RealType>( maximumNumberOfSpans ) ==
+    static_cast<RealType>( maximumNumberOfSpans ) - epsilon )
+    {
+    epsilon *= 10;
+    }
+
+  typedef CoxDeBoorBSplineKernelFunction<3> KernelType;
+  typename KernelType::Pointer kernel = KernelType::New();
+  kernel->SetSplineOrder( this->m_SplineOrder );
 
-  for( ItU.GoToBegin(); !ItU.IsAtEnd(); ++ItU )
+  // For each position along each axis, store the weights of the
+  // m_SplineOrder + 1 supporting control points along the axis and the
+  // lattice offset of the first of them.  The offsets of the supporting
+  // control points relative to the first one vary fastest along the first
+  // axis.
+
+  const unsigned int supportSize = this->m_SplineOrder + 1;
+  OffsetValueType latticeStride = 1;
+  this->m_BSplineSupportOffsets.assign( 1, 0 );
+
+  for( unsigned int d = 0; d < ImageDimension; d++ )
     {
-    if( ( !maskImage ||
-          maskImage->GetPixel( ItU.GetIndex() ) == this->m_MaskLabel )
-        && ( !confidenceImage ||
-             confidenceImage->GetPixel( ItU.GetIndex() ) > 0.0 ) )
+    this->m_BSplineLatticeSize[d] = numberOfControlPoints[d];
+
+    const unsigned int numberOfSpans = numberOfControlPoints[d] - this->m_SplineOrder;
+    const SizeValueType size = this->m_FieldSize[d];
+
+    this->m_BSplineLatticeOffsets[d].resize( size );
+    this->m_BSplineWeights[d].resize( size * supportSize );
+    for( SizeValueType i = 0; i < size; i++ )
       {
-      RealType pixel = ItU.Get();
+      RealType p = 0.0;
+      if( size > 1 )
+        {
+        p = static_cast<RealType>( numberOfSpans ) * static_cast<RealType>( i ) /
+          static_cast<RealType>( size - 1 );
+        }
+      if( vnl_math_abs( p - static_cast<RealType>( numberOfSpans ) ) <= epsilon )
+        {
+        p = static_cast<RealType>( numberOfSpans ) - epsilon;
+        }
+      const unsigned int span = static_cast<unsigned int>( p );
 
-      RealType cidx = ( static_cast<RealType>( pixel ) - binMinimum ) /
-        histogramSlope;
-      unsigned int idx = vnl_math_floor( cidx );
-      RealType     offset = cidx - static_cast<RealType>( idx );
+      this->m_BSplineLatticeOffsets[d][i] = span * latticeStride;
+      for( unsigned int k = 0; k < supportSize; k++ )
+        {
+        this->m_BSplineWeights[d][i * supportSize + k] = static_cast<RealType>(
+          kernel->Evaluate( p - static_cast<RealType>( span + k ) +
+            0.5 * static_cast<RealType>( this->m_SplineOrder - 1 ) ) );
+        }
+      }
 
-      if( offset == 0.0 )
+    const SizeValueType numberOfSupportOffsets = this->m_BSplineSupportOffsets.size();
+    this->m_BSplineSupportOffsets.resize( numberOfSupportOffsets * supportSize );
+    for( unsigned int k = 1; k < supportSize; k++ )
+      {
+      for( SizeValueType m = 0; m < numberOfSupportOffsets; m++ )
         {
-        H[idx] += 1.0;
+        this->m_BSplineSupportOffsets[k * numberOfSupportOffsets + m] =
+          this->m_BSplineSupportOffsets[m] + k * latticeStride;
         }
-      else if( idx < this->m_NumberOfHistogramBins - 1 )
+      }
+    latticeStride *= numberOfControlPoints[d];
+    }
+}
+
+template<typename TInputImage, typename TMaskImage, typename TOutputImage>
+OffsetValueType
+N4BiasFieldCorrectionImageFilter<TInputImage, TMaskImage, TOutputImage>
+::ComputeSupportWeights( OffsetValueType voxelOffset, RealType *weights ) const
+{
+  const unsigned int supportSize = this->m_SplineOrder + 1;
+
+  OffsetValueType latticeOffset = 0;
+  SizeValueType numberOfWeights = 1;
+  weights[0] = 1.0;
+  for( unsigned int d = 0; d < ImageDimension; d++ )
+    {
+    const OffsetValueType size = static_cast<OffsetValueType>( this->m_FieldSize[d] );
+    const OffsetValueType index = voxelOffset % size;
+    voxelOffset /= size;
+
+    latticeOffset += this->m_BSplineLatticeOffsets[d][index];
+
+    // Multiply the weights of the previous axes by the weights along this
+    // axis, the last control point first since the weights of the previous
+    // axes are overwritten by those of the first control point.
+
+    const RealType *axisWeights = &this->m_BSplineWeights[d][index * supportSize];
+    for( unsigned int k = supportSize; k-- > 0; )
+      {
+      for( SizeValueType m = 0; m < numberOfWeights; m++ )
         {
-        H[idx] += 1.0 - offset;
-        H[idx+1] += offset;
+        weights[k * numberOfWeights + m] = weights[m] * axisWeights[k];
         }
       }
+    numberOfWeights *= supportSize;
+    }
+  return latticeOffset;
+}
+
+template<typename TInputImage, typename TMaskImage, typename TOutputImage>
+void
+N4BiasFieldCorrectionImageFilter<TInputImage, TMaskImage, TOutputImage>
+::SharpenImage()
+{
+  // Build the histogram for the uncorrected image.  Store copy
+  // in a vnl_vector to utilize vnl FFT routines.  Note that variables
+  // in real space are denoted by a single uppercase letter whereas their
+  // frequency counterparts are indicated by a trailing lowercase 'f'.
+
+  std::vector<ThreadResults> results;
+
+  ThreadStruct str;
+  str.Results = &results;
+
+  str.Step = HistogramRangeStep;
+  this->ExecuteThreadedStep( str );
+
+  RealType binMaximum = NumericTraits<RealType>::NonpositiveMin();
+  RealType binMinimum = NumericTraits<RealType>::max();
+
+  for( unsigned int n = 0; n < results.size(); n++ )
+    {
+    binMinimum = std::min( binMinimum, results[n].Minimum );
+    binMaximum = std::max( binMaximum, results[n].Maximum );
+    }
+  RealType histogramSlope = ( binMaximum - binMinimum ) /
+    static_cast<RealType>( this->m_NumberOfHistogramBins - 1 );
+
+  // Create the intensity profile (within the masked region, if applicable)
+  // using a triangular parzen windowing scheme.
+
+  str.Step = HistogramStep;
+  str.BinMinimum = binMinimum;
+  str.HistogramSlope = histogramSlope;
+  this->ExecuteThreadedStep( str );
+
+  vnl_vector<RealType> H( this->m_NumberOfHistogramBins, 0.0 );
+
+  for( unsigned int n = 0; n < results.size(); n++ )
+    {
+    H += results[n].Histogram;
     }
 
   // Determine information about the intensity histogram and zero-pad
@@ -427,265 +577,435 @@ N4BiasFieldCorrectionImageFilter<TInputImage, TMaskImage, TOutputImage>
 
   E = E.extract( this->m_NumberOfHistogramBins, histogramOffset );
 
-  const InputImageType * inputImage = this->GetInput();
+  // Sharpen the image with the new mapping, E(u|v), and store the residual
+  // bias field.
 
-  // Sharpen the image with the new mapping, E(u|v)
-  RealImagePointer sharpenedImage = RealImageType::New();
-  sharpenedImage->CopyInformation( inputImage );
-  sharpenedImage->SetRegions( inputImage->GetLargestPossibleRegion() );
-  sharpenedImage->Allocate( true ); // initialize buffer to zero
+  str.Step = SharpenStep;
+  str.Mapping = &E;
+  this->ExecuteThreadedStep( str );
+}
 
-  ImageRegionIterator<RealImageType> ItC(
-    sharpenedImage, sharpenedImage->GetLargestPossibleRegion() );
+template<typename TInputImage, typename TMaskImage, typename TOutputImage>
+void
+N4BiasFieldCorrectionImageFilter<TInputImage, TMaskImage, TOutputImage>
+::ThreadedComputeHistogramRange( SizeValueType first, SizeValueType last,
+                                 ThreadResults &results ) const
+{
+  results.Minimum = NumericTraits<RealType>::max();
+  results.Maximum = NumericTraits<RealType>::NonpositiveMin();
 
-  for( ItU.GoToBegin(), ItC.GoToBegin(); !ItU.IsAtEnd(); ++ItU, ++ItC )
+  for( SizeValueType i = first; i < last; i++ )
     {
-    if( ( !maskImage ||
-          maskImage->GetPixel( ItU.GetIndex() ) == this->m_MaskLabel )
-        && ( !confidenceImage ||
-             confidenceImage->GetPixel( ItU.GetIndex() ) > 0.0 ) )
+    RealType pixel = this->m_VoxelLogInput[i] - this->m_VoxelLogBiasField[i];
+    if( pixel > results.Maximum )
+      {
+      results.Maximum = pixel;
+      }
+    if( pixel < results.Minimum )
       {
-      RealType     cidx = ( ItU.Get() - binMinimum ) / histogramSlope;
-      unsigned int idx = vnl_math_floor( cidx );
+      results.Minimum = pixel;
+      }
+    }
+}
 
-      RealType correctedPixel = 0;
-      if( idx < E.size() - 1 )
-        {
-        correctedPixel = E[idx] + ( E[idx + 1] - E[idx] )
-          * ( cidx - static_cast<RealType>( idx ) );
-        }
-      else
-        {
-        correctedPixel = E[E.size() - 1];
-        }
-      ItC.Set( correctedPixel );
+template<typename TInputImage, typename TMaskImage, typename TOutputImage>
+void
+N4BiasFieldCorrectionImageFilter<TInputImage, TMaskImage, TOutputImage>
+::ThreadedComputeHistogram( SizeValueType first, SizeValueType last,
+                            RealType binMinimum, RealType histogramSlope,
+                            ThreadResults &results ) const
+{
+  vnl_vector<RealType> & H = results.Histogram;
+  H.set_size( this->m_NumberOfHistogramBins );
+  H.fill( 0.0 );
+
+  for( SizeValueType i = first; i < last; i++ )
+    {
+    RealType pixel = this->m_VoxelLogInput[i] - this->m_VoxelLogBiasField[i];
+
+    RealType cidx = ( pixel - binMinimum ) / histogramSlope;
+    unsigned int idx = vnl_math_floor( cidx );
+    RealType     offset = cidx - static_cast<RealType>( idx );
+
+    if( offset == 0.0 )
+      {
+      H[idx] += 1.0;
+      }
+    else if( idx < this->m_NumberOfHistogramBins - 1 )
+      {
+      H[idx] += 1.0 - offset;
+      H[idx+1] += offset;
       }
     }
+}
 
-  return sharpenedImage;
+template<typename TInputImage, typename TMaskImage, typename TOutputImage>
+void
+N4BiasFieldCorrectionImageFilter<TInputImage, TMaskImage, TOutputImage>
+::ThreadedSharpenImage( SizeValueType first, SizeValueType last,
+                        RealType binMinimum, RealType histogramSlope,
+                        const vnl_vector<RealType> &E )
+{
+  for( SizeValueType i = first; i < last; i++ )
+    {
+    RealType pixel = this->m_VoxelLogInput[i] - this->m_VoxelLogBiasField[i];
+
+    RealType     cidx = ( pixel - binMinimum ) / histogramSlope;
+    unsigned int idx = vnl_math_floor( cidx );
+
+    RealType correctedPixel = 0;
+    if( idx < E.size() - 1 )
+      {
+      correctedPixel = E[idx] + ( E[idx + 1] - E[idx] )
+        * ( cidx - static_cast<RealType>( idx ) );
+      }
+    else
+      {
+      correctedPixel = E[E.size() - 1];
+      }
+    this->m_VoxelResidualBiasField[i] = pixel - correctedPixel;
+    }
 }
 
 template<typename TInputImage, typename TMaskImage, typename TOutputImage>
 typename
-N4BiasFieldCorrectionImageFilter<TInputImage, TMaskImage, TOutputImage>::RealImagePointer
+N4BiasFieldCorrectionImageFilter<TInputImage, TMaskImage, TOutputImage>::RealType
 N4BiasFieldCorrectionImageFilter<TInputImage, TMaskImage, TOutputImage>
-::UpdateBiasFieldEstimate( RealImageType* fieldEstimate )
+::UpdateBiasFieldEstimate()
 {
-  // Temporarily set the direction cosine to identity since the B-spline
-  // approximation algorithm works in parametric space and not physical
-  // space.
-  typename ScalarImageType::DirectionType identity;
-  identity.SetIdentity();
-
-  const typename ScalarImageType::RegionType & bufferedRegion = fieldEstimate->GetBufferedRegion();
-  const SizeValueType numberOfPixels = bufferedRegion.GetNumberOfPixels();
-  const bool filterHandlesMemory = false;
-
-  typedef ImportImageFilter<RealType, ImageDimension> ImporterType;
-  typename ImporterType::Pointer importer = ImporterType::New();
-  importer->SetImportPointer( fieldEstimate->GetBufferPointer(), numberOfPixels, filterHandlesMemory );
-  importer->SetRegion( fieldEstimate->GetBufferedRegion() );
-  importer->SetOrigin( fieldEstimate->GetOrigin() );
-  importer->SetSpacing( fieldEstimate->GetSpacing() );
-  importer->SetDirection( identity );
-  importer->Update();
-
-  const typename ImporterType::OutputImageType * parametricFieldEstimate = importer->GetOutput();
-
-  PointSetPointer fieldPoints = PointSetType::New();
-  fieldPoints->Initialize();
-
-  typename BSplineFilterType::WeightsContainerType::Pointer weights =
-    BSplineFilterType::WeightsContainerType::New();
-  weights->Initialize();
+  // Fit the residual bias field with the B-spline scattered data
+  // approximation of BSplineScatteredDataPointSetToImageFilter, with a
+  // single fitting level.
 
-  const MaskImageType * maskImage = this->GetMaskImage();
-  const RealImageType * confidenceImage = this->GetConfidenceImage();
+  std::vector<ThreadResults> results;
+
+  ThreadStruct str;
+  str.Results = &results;
+
+  str.Step = FitStep;
+  this->ExecuteThreadedStep( str );
 
-  ImageRegionConstIteratorWithIndex<RealImageType>
-    It( parametricFieldEstimate, parametricFieldEstimate->GetRequestedRegion() );
+  // Accumulate the delta and omega lattices of the threads to calculate the
+  // control point lattice of the residual bias field.
 
-  unsigned int index = 0;
-  for ( It.GoToBegin(); !It.IsAtEnd(); ++It )
+  RealVectorType & delta = results[0].Delta;
+  RealVectorType & omega = results[0].Omega;
+  for( unsigned int n = 1; n < results.size(); n++ )
     {
-    if( ( !maskImage ||
-          maskImage->GetPixel( It.GetIndex() ) == this->m_MaskLabel )
-        && ( !confidenceImage ||
-             confidenceImage->GetPixel( It.GetIndex() ) > 0.0 ) )
+    for( SizeValueType l = 0; l < delta.size(); l++ )
       {
-      PointType point;
-      parametricFieldEstimate->TransformIndexToPhysicalPoint( It.GetIndex(), point );
-
-      ScalarType scalar;
-      scalar[0] = It.Get();
+      delta[l] += results[n].Delta[l];
+      omega[l] += results[n].Omega[l];
+      }
+    }
 
-      fieldPoints->SetPointData( index, scalar );
-      fieldPoints->SetPoint( index, point );
+  typename BiasFieldControlPointLatticeType::Pointer phiLattice =
+    BiasFieldControlPointLatticeType::New();
+  phiLattice->SetRegions( this->m_BSplineLatticeSize );
+  phiLattice->Allocate();
 
-      RealType confidenceWeight = 1.0;
-      if( confidenceImage )
+  ScalarType *phi = phiLattice->GetBufferPointer();
+  for( SizeValueType l = 0; l < delta.size(); l++ )
+    {
+    RealType P = 0.0;
+    if( omega[l] != 0 )
+      {
+      P = delta[l] / omega[l];
+      if( vnl_math_isnan( P ) || vnl_math_isinf( P ) )
         {
-        confidenceWeight = confidenceImage->GetPixel( It.GetIndex() );
+        P = 0.0;
         }
-      weights->InsertElement( index, confidenceWeight );
-      index++;
       }
+    phi[l][0] = P;
     }
 
-  typename BSplineFilterType::Pointer bspliner = BSplineFilterType::New();
+  // Add the bias field control points to the current estimate.
 
-  typename BSplineFilterType::ArrayType numberOfControlPoints;
-  typename BSplineFilterType::ArrayType numberOfFittingLevels;
-  numberOfFittingLevels.Fill( 1 );
-  for( unsigned int d = 0; d < ImageDimension; d++ )
+  if( !this->m_LogBiasFieldControlPointLattice )
     {
-    if( !this->m_LogBiasFieldControlPointLattice )
+    // Place the lattice in the parametric domain of the image as the
+    // B-spline fitting filter does.
+    const InputImageType * inputImage = this->GetInput();
+
+    typename BiasFieldControlPointLatticeType::PointType origin;
+    typename BiasFieldControlPointLatticeType::SpacingType spacing;
+    for( unsigned int d = 0; d < ImageDimension; d++ )
       {
-      numberOfControlPoints[d] = this->m_NumberOfControlPoints[d];
+      RealType domain = inputImage->GetSpacing()[d] *
+        static_cast<RealType>( this->m_FieldSize[d] - 1 );
+      spacing[d] = domain / static_cast<RealType>(
+        this->m_BSplineLatticeSize[d] - this->m_SplineOrder );
+      origin[d] = -0.5 * spacing[d] * ( this->m_SplineOrder - 1 );
       }
-    else
+    origin = inputImage->GetDirection() * origin;
+    for( unsigned int d = 0; d < ImageDimension; d++ )
       {
-      numberOfControlPoints[d] = this->m_LogBiasFieldControlPointLattice->
-        GetLargestPossibleRegion().GetSize()[d];
+      origin[d] += inputImage->GetOrigin()[d] + inputImage->GetSpacing()[d] *
+        inputImage->GetLargestPossibleRegion().GetIndex()[d];
       }
-    }
+    phiLattice->SetOrigin( origin );
+    phiLattice->SetSpacing( spacing );
+    phiLattice->SetDirection( inputImage->GetDirection() );
 
-  typename ScalarImageType::PointType parametricOrigin =
-    fieldEstimate->GetOrigin();
-  for( unsigned int d = 0; d < ImageDimension; d++ )
+    this->m_LogBiasFieldControlPointLattice = phiLattice;
+    }
+  else
     {
-    parametricOrigin[d] += (
-        fieldEstimate->GetSpacing()[d] *
-        fieldEstimate->GetLargestPossibleRegion().GetIndex()[d] );
+    ScalarType *total = this->m_LogBiasFieldControlPointLattice->GetBufferPointer();
+    for( SizeValueType l = 0; l < delta.size(); l++ )
+      {
+      total[l] += phi[l];
+      }
+    this->m_LogBiasFieldControlPointLattice->Modified();
     }
-  bspliner->SetOrigin( parametricOrigin );
-  bspliner->SetSpacing( fieldEstimate->GetSpacing() );
-  bspliner->SetSize( fieldEstimate->GetLargestPossibleRegion().GetSize() );
-  bspliner->SetDirection( fieldEstimate->GetDirection() );
-  bspliner->SetGenerateOutputImage( false );
-  bspliner->SetNumberOfLevels( numberOfFittingLevels );
-  bspliner->SetSplineOrder( this->m_SplineOrder );
-  bspliner->SetNumberOfControlPoints( numberOfControlPoints );
-  bspliner->SetInput( fieldPoints );
-  bspliner->SetPointWeights( weights );
-  bspliner->Update();
 
-  typename BiasFieldControlPointLatticeType::Pointer phiLattice = bspliner->GetPhiLattice();
+  // Add the residual bias field to the estimate at the voxels, and
+  // calculate the statistics of the change over the voxels.
 
-  // Add the bias field control points to the current estimate.
+  str.Step = UpdateStep;
+  str.Lattice = phi;
+  this->ExecuteThreadedStep( str );
 
-  if( !this->m_LogBiasFieldControlPointLattice )
+  // Convergence is determined by the coefficient of variation of the ratio
+  // of the previous and the current bias field estimates.  The mean and the
+  // sum of squared deviations of the threads are combined pairwise, in
+  // double precision since the changes are small.
+
+  double mu = 0.0;
+  double sigma = 0.0;
+  double N = 0.0;
+
+  for( unsigned int n = 0; n < results.size(); n++ )
     {
-    this->m_LogBiasFieldControlPointLattice = phiLattice;
+    if( results[n].NumberOfVoxels > 0.0 )
+      {
+      double total = N + results[n].NumberOfVoxels;
+      double difference = results[n].Mean - mu;
+
+      sigma += results[n].SumOfSquares +
+        vnl_math_sqr( difference ) * N * results[n].NumberOfVoxels / total;
+      mu += difference * results[n].NumberOfVoxels / total;
+      N = total;
+      }
     }
-  else
-    {
-    // Ensure that the two lattices occupy the same physical space.  Not
-    // necessary for performance since the parameters of the reconstructed
-    // bias field are specified later in this function in the reconstructer.
-    phiLattice->CopyInformation( this->m_LogBiasFieldControlPointLattice );
+  sigma = std::sqrt( sigma / ( N - 1.0 ) );
 
-    typedef AddImageFilter<BiasFieldControlPointLatticeType,
-                           BiasFieldControlPointLatticeType,
-                           BiasFieldControlPointLatticeType>
-      AdderType;
-    typename AdderType::Pointer adder = AdderType::New();
-    adder->SetInput1( this->m_LogBiasFieldControlPointLattice );
-    adder->SetInput2( phiLattice );
-    adder->Update();
+  return static_cast<RealType>( sigma / mu );
+}
 
-    this->m_LogBiasFieldControlPointLattice = adder->GetOutput();
+template<typename TInputImage, typename TMaskImage, typename TOutputImage>
+void
+N4BiasFieldCorrectionImageFilter<TInputImage, TMaskImage, TOutputImage>
+::ThreadedFitBiasField( SizeValueType first, SizeValueType last,
+                        ThreadResults &results ) const
+{
+  SizeValueType numberOfControlPoints = 1;
+  for( unsigned int d = 0; d < ImageDimension; d++ )
+    {
+    numberOfControlPoints *= this->m_BSplineLatticeSize[d];
     }
+  results.Omega.assign( numberOfControlPoints, 0.0 );
+  results.Delta.assign( numberOfControlPoints, 0.0 );
+
+  const SizeValueType supportSize = this->m_BSplineSupportOffsets.size();
+  RealVectorType weights( supportSize );
+
+  for( SizeValueType i = first; i < last; i++ )
+    {
+    OffsetValueType latticeOffset =
+      this->ComputeSupportWeights( this->m_VoxelOffsets[i], &weights[0] );
 
-  RealImagePointer smoothField = this->ReconstructBiasField( this->m_LogBiasFieldControlPointLattice );
+    RealType w2Sum = 0.0;
+    for( SizeValueType j = 0; j < supportSize; j++ )
+      {
+      w2Sum += weights[j] * weights[j];
+      }
 
-  return smoothField;
+    const RealType wc = this->m_VoxelWeights[i];
+    const RealType data = this->m_VoxelResidualBiasField[i] * wc / w2Sum;
+    for( SizeValueType j = 0; j < supportSize; j++ )
+      {
+      const OffsetValueType l = latticeOffset + this->m_BSplineSupportOffsets[j];
+      const RealType t = weights[j];
+      results.Omega[l] += wc * t * t;
+      results.Delta[l] += data * t * t * t;
+      }
+    }
 }
 
 template<typename TInputImage, typename TMaskImage, typename TOutputImage>
-typename
-N4BiasFieldCorrectionImageFilter<TInputImage, TMaskImage, TOutputImage>::RealImagePointer
+void
 N4BiasFieldCorrectionImageFilter<TInputImage, TMaskImage, TOutputImage>
-::ReconstructBiasField( BiasFieldControlPointLatticeType* controlPointLattice )
+::ThreadedUpdateBiasField( SizeValueType first, SizeValueType last,
+                           const ScalarType *lattice, ThreadResults &results )
 {
-  const InputImageType * inputImage = this->GetInput();
+  results.NumberOfVoxels = 0.0;
+  results.Mean = 0.0;
+  results.SumOfSquares = 0.0;
+
+  const SizeValueType supportSize = this->m_BSplineSupportOffsets.size();
+  RealVectorType weights( supportSize );
+
+  for( SizeValueType i = first; i < last; i++ )
+    {
+    OffsetValueType latticeOffset =
+      this->ComputeSupportWeights( this->m_VoxelOffsets[i], &weights[0] );
+
+    RealType change = 0.0;
+    for( SizeValueType j = 0; j < supportSize; j++ )
+      {
+      change += weights[j] *
+        lattice[latticeOffset + this->m_BSplineSupportOffsets[j]][0];
+      }
+    this->m_VoxelLogBiasField[i] += change;
 
-  typedef BSplineControlPointImageFilter
-    <BiasFieldControlPointLatticeType, ScalarImageType> BSplineReconstructerType;
-  typename BSplineReconstructerType::Pointer reconstructer =
-    BSplineReconstructerType::New();
-  reconstructer->SetInput( controlPointLattice );
-  reconstructer->SetOrigin( inputImage->GetOrigin() );
-  reconstructer->SetSpacing( inputImage->GetSpacing() );
-  reconstructer->SetDirection( inputImage->GetDirection() );
-  reconstructer->SetSplineOrder( this->m_SplineOrder );
-  reconstructer->SetSize( inputImage->GetLargestPossibleRegion().GetSize() );
-
-  typename ScalarImageType::Pointer biasFieldBsplineImage = reconstructer->GetOutput();
-  biasFieldBsplineImage->Update();
-
-  typedef VectorIndexSelectionCastImageFilter<ScalarImageType, RealImageType>
-    SelectorType;
-  typename SelectorType::Pointer selector = SelectorType::New();
-  selector->SetInput( biasFieldBsplineImage );
-  selector->SetIndex( 0 );
-
-  RealImagePointer biasField = selector->GetOutput();
-  biasField->Update();
-
-  biasField->DisconnectPipeline();
-  biasField->SetRegions( inputImage->GetRequestedRegion() );
-
-  return biasField;
+    double pixel = std::exp( -static_cast<double>( change ) );
+    results.NumberOfVoxels += 1.0;
+
+    if( results.NumberOfVoxels > 1.0 )
+      {
+      results.SumOfSquares += vnl_math_sqr( pixel - results.Mean ) *
+        ( results.NumberOfVoxels - 1.0 ) / results.NumberOfVoxels;
+      }
+    results.Mean = results.Mean * ( 1.0 - 1.0 / results.NumberOfVoxels ) +
+      pixel / results.NumberOfVoxels;
+    }
 }
 
 template<typename TInputImage, typename TMaskImage, typename TOutputImage>
-typename
-N4BiasFieldCorrectionImageFilter<TInputImage, TMaskImage, TOutputImage>::RealType
+void
 N4BiasFieldCorrectionImageFilter<TInputImage, TMaskImage, TOutputImage>
-::CalculateConvergenceMeasurement( const RealImageType *fieldEstimate1,
-                                   const RealImageType *fieldEstimate2 ) const
+::ReconstructBiasField( RealImageType *logBiasField )
 {
-  typedef SubtractImageFilter<RealImageType, RealImageType, RealImageType>
-    SubtracterType;
-  typename SubtracterType::Pointer subtracter = SubtracterType::New();
-  subtracter->SetInput1( fieldEstimate1 );
-  subtracter->SetInput2( fieldEstimate2 );
-  subtracter->Update();
+  std::vector<ThreadResults> results;
 
-  // Calculate statistics over the mask region
+  ThreadStruct str;
+  str.Step = ReconstructStep;
+  str.Region = logBiasField->GetLargestPossibleRegion();
+  str.BiasField = logBiasField;
+  str.Lattice = this->m_LogBiasFieldControlPointLattice->GetBufferPointer();
+  str.Results = &results;
+  this->ExecuteThreadedStep( str );
 
-  RealType mu = 0.0;
-  RealType sigma = 0.0;
-  RealType N = 0.0;
+  // Start the next level from the reconstructed field.
 
-  const MaskImageType * maskImage = this->GetMaskImage();
-  const RealImageType * confidenceImage = this->GetConfidenceImage();
+  const RealType *buffer = logBiasField->GetBufferPointer();
+  for( SizeValueType i = 0; i < this->m_VoxelOffsets.size(); i++ )
+    {
+    this->m_VoxelLogBiasField[i] = buffer[this->m_VoxelOffsets[i]];
+    }
+}
+
+template<typename TInputImage, typename TMaskImage, typename TOutputImage>
+void
+N4BiasFieldCorrectionImageFilter<TInputImage, TMaskImage, TOutputImage>
+::ThreadedReconstructBiasField( const RealImageRegionType &region,
+                                const ScalarType *lattice,
+                                RealImageType *logBiasField ) const
+{
+  const SizeValueType supportSize = this->m_BSplineSupportOffsets.size();
+  RealVectorType weights( supportSize );
 
-  ImageRegionConstIteratorWithIndex<RealImageType> It(
-    subtracter->GetOutput(),
-    subtracter->GetOutput()->GetLargestPossibleRegion() );
+  ImageRegionIteratorWithIndex<RealImageType> It( logBiasField, region );
 
   for( It.GoToBegin(); !It.IsAtEnd(); ++It )
     {
-    if( ( !maskImage ||
-          maskImage->GetPixel( It.GetIndex() ) == this->m_MaskLabel )
-        && ( !confidenceImage ||
-             confidenceImage->GetPixel( It.GetIndex() ) > 0.0 ) )
+    OffsetValueType latticeOffset = this->ComputeSupportWeights(
+      logBiasField->ComputeOffset( It.GetIndex() ), &weights[0] );
+
+    RealType value = 0.0;
+    for( SizeValueType j = 0; j < supportSize; j++ )
       {
-      RealType pixel = std::exp( It.Get() );
-      N += 1.0;
+      value += weights[j] *
+        lattice[latticeOffset + this->m_BSplineSupportOffsets[j]][0];
+      }
+    It.Set( value );
+    }
+}
+
+template<typename TInputImage, typename TMaskImage, typename TOutputImage>
+void
+N4BiasFieldCorrectionImageFilter<TInputImage, TMaskImage, TOutputImage>
+::ExecuteThreadedStep( ThreadStruct &str )
+{
+  str.Filter = this;
 
-      if( N > 1.0 )
+  this->GetMultiThreader()->SetNumberOfThreads( this->GetNumberOfThreads() );
+  str.Results->resize( this->GetMultiThreader()->GetNumberOfThreads() );
+
+  this->GetMultiThreader()->SetSingleMethod( Self::StepThreaderCallback, &str );
+  this->GetMultiThreader()->SingleMethodExecute();
+}
+
+template<typename TInputImage, typename TMaskImage, typename TOutputImage>
+ITK_THREAD_RETURN_TYPE
+N4BiasFieldCorrectionImageFilter<TInputImage, TMaskImage, TOutputImage>
+::StepThreaderCallback( void *arg )
+{
+  typedef MultiThreader::ThreadInfoStruct ThreadInfoType;
+  ThreadInfoType *info = static_cast< ThreadInfoType * >( arg );
+  ThreadStruct *  str = static_cast< ThreadStruct * >( info->UserData );
+
+  const ThreadIdType threadId = info->ThreadID;
+  const ThreadIdType numberOfThreads = info->NumberOfThreads;
+
+  Self *          filter = str->Filter;
+  ThreadResults & results = ( *str->Results )[threadId];
+
+  if( str->Step == CollectVoxelsStep || str->Step == ReconstructStep )
+    {
+    // Split the region along its slowest dimension.
+    ImageRegionSplitterSlowDimension::Pointer splitter =
+      ImageRegionSplitterSlowDimension::New();
+    const unsigned int numberOfPieces =
+      splitter->GetNumberOfSplits( str->Region, numberOfThreads );
+    if( threadId < numberOfPieces )
+      {
+      RealImageRegionType region = str->Region;
+      splitter->GetSplit( threadId, numberOfPieces, region );
+      if( str->Step == CollectVoxelsStep )
         {
-        sigma = sigma + vnl_math_sqr( pixel - mu ) * ( N - 1.0 ) / N;
+        filter->ThreadedCollectVoxels( region, str->BiasField, results );
+        }
+      else
+        {
+        filter->ThreadedReconstructBiasField( region, str->Lattice, str->BiasField );
         }
-      mu = mu * ( 1.0 - 1.0 / N ) + pixel / N;
       }
+    return ITK_THREAD_RETURN_VALUE;
+    }
+
+  // Split the voxels used in the estimation in contiguous chunks.
+  const SizeValueType numberOfVoxels = filter->m_VoxelOffsets.size();
+  const SizeValueType first = numberOfVoxels / numberOfThreads * threadId
+    + std::min( static_cast<SizeValueType>( threadId ), numberOfVoxels % numberOfThreads );
+  const SizeValueType last = first + numberOfVoxels / numberOfThreads
+    + ( threadId < numberOfVoxels % numberOfThreads ? 1 : 0 );
+
+  switch( str->Step )
+    {
+    case HistogramRangeStep:
+      filter->ThreadedComputeHistogramRange( first, last, results );
+      break;
+    case HistogramStep:
+      filter->ThreadedComputeHistogram( first, last, str->BinMinimum,
+        str->HistogramSlope, results );
+      break;
+    case SharpenStep:
+      filter->ThreadedSharpenImage( first, last, str->BinMinimum,
+        str->HistogramSlope, *str->Mapping );
+      break;
+    case FitStep:
+      filter->ThreadedFitBiasField( first, last, results );
+      break;
+    case UpdateStep:
+      filter->ThreadedUpdateBiasField( first, last, str->Lattice, results );
+      break;
+    default:
+      break;
     }
-  sigma = std::sqrt( sigma / ( N - 1.0 ) );
 
-  return ( sigma / mu );
+  return ITK_THREAD_RETURN_VALUE;
 }
 
 template<typename TInputImage, typename TMaskImage, typename TOutputImage>
@@ -18,6 +18,7 @@
 #include "itkConstantPadImageFilter.h"
 #include "itkImageFileReader.h"
 #include "itkImageFileWriter.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
 #include "itkN4BiasFieldCorrectionImageFilter.h"
 #include "itkOtsuThresholdImageFilter.h"
 #include "itkShrinkImageFilter.h"
@@ -284,6 +285,10 @@ int N4( int argc, char *argv[] )
   correcter->SetInput( inputImage );
   correcter->SetMaskImage( maskImage );
 
+  // run with several threads first, whatever the number of cores, to
+  // compare with a single thread below
+  correcter->SetNumberOfThreads( 4 );
+
   typedef CommandIterationUpdate<CorrecterType> CommandType;
   typename CommandType::Pointer observer = CommandType::New();
   correcter->AddObserver( itk::IterationEvent(), observer );
@@ -326,6 +331,51 @@ int N4( int argc, char *argv[] )
   writer->SetInput( correcter->GetLogBiasFieldControlPointLattice() );
   writer->Update();
 
+  // The number of threads only changes the order of the floating point
+  // accumulations: the control points found with 4 threads and with 1
+  // thread have to agree within 1e-3.
+  typedef typename CorrecterType::BiasFieldControlPointLatticeType LatticeType;
+  typename LatticeType::Pointer lattice =
+    correcter->GetLogBiasFieldControlPointLattice();
+
+  correcter->RemoveAllObservers();
+  correcter->SetNumberOfThreads( 1 );
+  try
+    {
+    correcter->Update();
+    }
+  catch( itk::ExceptionObject &excep )
+    {
+    std::cerr << "Exception caught !" << std::endl;
+    std::cerr << excep << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  const LatticeType * singleThreadLattice =
+    correcter->GetLogBiasFieldControlPointLattice();
+  if( singleThreadLattice->GetLargestPossibleRegion() !=
+      lattice->GetLargestPossibleRegion() )
+    {
+    std::cerr << "The control point lattice size depends on the number of threads."
+              << std::endl;
+    return EXIT_FAILURE;
+    }
+  itk::ImageRegionConstIteratorWithIndex<LatticeType> ItL(
+    lattice, lattice->GetLargestPossibleRegion() );
+  for( ItL.GoToBegin(); !ItL.IsAtEnd(); ++ItL )
+    {
+    const RealType difference = ItL.Get()[0] -
+      singleThreadLattice->GetPixel( ItL.GetIndex() )[0];
+    if( std::fabs( difference ) > 1e-3 )
+      {
+      std::cerr << "The control point " << ItL.GetIndex() << " is "
+                << ItL.Get() << " with several threads and "
+                << singleThreadLattice->GetPixel( ItL.GetIndex() )
+                << " with one thread." << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
   return EXIT_SUCCESS;
 }
 
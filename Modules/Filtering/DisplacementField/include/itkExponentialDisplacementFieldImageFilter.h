@@ -23,6 +23,7 @@
 #include "itkWarpVectorImageFilter.h"
 #include "itkVectorLinearInterpolateNearestNeighborExtrapolateImageFunction.h"
 #include "itkAddImageFilter.h"
+#include "itkWarpAndAddDisplacementFieldImageFilter.h"
 
 namespace itk
 {
@@ -47,6 +48,13 @@ namespace itk
  *      exp(\Phi) = exp( \frac{\Phi}{2^N} )^{2^N}
  *    \f]
  *
+ * Each squaring is computed in a single threaded pass by
+ * WarpAndAddDisplacementFieldImageFilter, alternating between the output
+ * buffer and one scratch buffer. Unless the ReleaseDataBeforeUpdateFlag is
+ * turned on, both buffers are kept from one update to the next, so that
+ * repeated updates of a field of constant size, as in
+ * DiffeomorphicDemonsRegistrationFilter, allocate nothing.
+ *
  *
  * This filter expects both the input and output images to be of pixel type
  * Vector.
@@ -168,6 +176,9 @@ protected:
   typedef typename FieldInterpolatorType::OutputType FieldInterpolatorOutputType;
   typedef typename AdderType::Pointer                AdderPointer;
 
+  typedef WarpAndAddDisplacementFieldImageFilter< OutputImageType > ComposerType;
+  typedef typename ComposerType::Pointer                            ComposerPointer;
+
 private:
   ExponentialDisplacementFieldImageFilter(const Self &); //purposely not
                                                         // implemented
@@ -181,8 +192,8 @@ private:
 
   DivideByConstantPointer m_Divider;
   CasterPointer           m_Caster;
-  VectorWarperPointer     m_Warper;
-  AdderPointer            m_Adder;
+  ComposerPointer         m_Composer;
+  OutputImagePointer      m_ScratchField;
 };
 } // end namespace itk
 
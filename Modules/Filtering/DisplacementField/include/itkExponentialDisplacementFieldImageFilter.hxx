@@ -36,14 +36,19 @@ ExponentialDisplacementFieldImageFilter< TInputImage, TOutputImage >
   m_ComputeInverse = false;
   m_Divider = DivideByConstantType::New();
   m_Caster = CasterType::New();
-  m_Warper = VectorWarperType::New();
+  m_Composer = ComposerType::New();
+  m_ScratchField = OutputImageType::New();
 
   FieldInterpolatorPointer VectorInterpolator =
     FieldInterpolatorType::New();
-  m_Warper->SetInterpolator(VectorInterpolator);
-
-  m_Adder = AdderType::New();
-  m_Adder->InPlaceOn();
+  m_Composer->SetInterpolator(VectorInterpolator);
+
+  // The internal filters write into grafted buffers, which must not be
+  // released before they run or they would be reallocated at each step.
+  // This is the default for image filters, but is relied upon here.
+  m_Divider->ReleaseDataBeforeUpdateFlagOff();
+  m_Caster->ReleaseDataBeforeUpdateFlagOff();
+  m_Composer->ReleaseDataBeforeUpdateFlagOff();
 }
 
 /**
@@ -183,42 +188,44 @@ ExponentialDisplacementFieldImageFilter< TInputImage, TOutputImage >
 
   progress.CompletedPixel();
 
-  // Do the iterative composition of the vector field
-  m_Warper->SetOutputOrigin( inputPtr->GetOrigin() );
-  m_Warper->SetOutputSpacing( inputPtr->GetSpacing() );
-  m_Warper->SetOutputDirection( inputPtr->GetDirection() );
-
-  for ( unsigned int i = 0; i < numiter; i++ )
-    {
-    m_Warper->SetInput( this->GetOutput() );
-    m_Warper->SetDisplacementField( this->GetOutput() );
-
-    m_Warper->GetOutput()->SetRequestedRegion(
-      this->GetOutput()->GetRequestedRegion() );
-
-    m_Warper->Update();
-
-    OutputImagePointer warpedIm = m_Warper->GetOutput();
-    warpedIm->DisconnectPipeline();
+  // Do the iterative composition of the vector field. Each composition
+  // writes into the scratch field, whose buffer is then swapped with the
+  // output buffer, so that no field is allocated within the loop.
+  OutputImagePointer outputPtr = this->GetOutput();
+  m_ScratchField->CopyInformation( outputPtr );
+  m_ScratchField->SetRequestedRegion( outputPtr->GetRequestedRegion() );
+  m_ScratchField->SetBufferedRegion( outputPtr->GetBufferedRegion() );
+  m_ScratchField->Allocate();
 
-    // Remember we chose to use an inplace adder
-    m_Adder->SetInput1( this->GetOutput() );
+  typedef typename OutputImageType::PixelContainerPointer PixelContainerPointer;
 
-    m_Adder->SetInput2(warpedIm);
-    m_Adder->GetOutput()->SetRequestedRegion(
-      this->GetOutput()->GetRequestedRegion() );
+  m_Composer->SetNumberOfThreads( this->GetNumberOfThreads() );
 
-    m_Adder->Update();
+  for ( unsigned int i = 0; i < numiter; i++ )
+    {
+    // Compose the field with itself: Phi <- Phi o (Id + Phi)
+    m_Composer->SetInput( outputPtr );
+    m_Composer->SetDisplacementField( outputPtr );
+    m_Composer->GraftOutput( m_ScratchField );
+    m_Composer->Modified();
 
-    // Region passing stuff
-    this->GraftOutput( m_Adder->GetOutput() );
+    m_Composer->Update();
 
-    // Make a call to modified. This seems only necessary for
-    // a non-inplace adder but it doesn't hurt anyhow.
-    this->GetOutput()->Modified();
+    // swap the containers
+    PixelContainerPointer swapPtr = m_Composer->GetOutput()->GetPixelContainer();
+    m_ScratchField->SetPixelContainer( outputPtr->GetPixelContainer() );
+    outputPtr->SetPixelContainer( swapPtr );
+    outputPtr->Modified();
 
     progress.CompletedPixel();
     }
+
+  // Keep the scratch buffer for the next update only if the output buffer
+  // is kept too.
+  if ( this->GetReleaseDataBeforeUpdateFlag() )
+    {
+    m_ScratchField->Initialize();
+    }
 }
 } // end namespace itk
 
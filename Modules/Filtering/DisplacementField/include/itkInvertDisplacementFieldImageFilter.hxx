@@ -21,6 +21,7 @@
 #include "itkInvertDisplacementFieldImageFilter.h"
 
 #include "itkComposeDisplacementFieldsImageFilter.h"
+#include "itkImageAlgorithm.h"
 #include "itkImageDuplicator.h"
 #include "itkImageRegionIterator.h"
 #include "itkMutexLockHolder.h"
@@ -86,7 +87,19 @@ InvertDisplacementFieldImageFilter<TInputImage, TOutputImage>
 
   typename InverseDisplacementFieldType::Pointer inverseDisplacementField;
 
-  if( this->GetInverseFieldInitialEstimate() )
+  const InverseDisplacementFieldType *inverseFieldInitialEstimate = this->GetInverseFieldInitialEstimate();
+  if( inverseFieldInitialEstimate &&
+    inverseFieldInitialEstimate->GetBufferedRegion() == this->GetOutput()->GetBufferedRegion() &&
+    inverseFieldInitialEstimate->GetOrigin() == this->GetOutput()->GetOrigin() &&
+    inverseFieldInitialEstimate->GetSpacing() == this->GetOutput()->GetSpacing() &&
+    inverseFieldInitialEstimate->GetDirection() == this->GetOutput()->GetDirection() )
+    {
+    // copy the estimate into the already allocated output
+    inverseDisplacementField = this->GetOutput();
+    ImageAlgorithm::Copy( inverseFieldInitialEstimate, inverseDisplacementField.GetPointer(),
+      inverseDisplacementField->GetBufferedRegion(), inverseDisplacementField->GetBufferedRegion() );
+    }
+  else if( inverseFieldInitialEstimate )
     {
     typedef ImageDuplicator<InverseDisplacementFieldType> DuplicatorType;
     typename DuplicatorType::Pointer duplicator = DuplicatorType::New();
@@ -119,6 +132,19 @@ InvertDisplacementFieldImageFilter<TInputImage, TOutputImage>
   this->m_MeanErrorNorm = NumericTraits<RealType>::max();
   unsigned int iteration = 0;
 
+  // The composition is written at every iteration into the composed field,
+  // which is grafted onto the composer output. Its buffer is allocated
+  // once and is kept from one update to the next.
+  this->m_ComposedField->CopyInformation( displacementField );
+  this->m_ComposedField->SetRegions( displacementField->GetRequestedRegion() );
+  this->m_ComposedField->Allocate();
+
+  typedef ComposeDisplacementFieldsImageFilter<DisplacementFieldType> ComposerType;
+  typename ComposerType::Pointer composer = ComposerType::New();
+  composer->SetDisplacementField( displacementField );
+  composer->SetWarpingField( inverseDisplacementField );
+  composer->ReleaseDataBeforeUpdateFlagOff();
+
   while( iteration++ < this->m_MaximumNumberOfIterations &&
     this->m_MaxErrorNorm > this->m_MaxErrorToleranceThreshold &&
     this->m_MeanErrorNorm > this->m_MeanErrorToleranceThreshold )
@@ -126,14 +152,11 @@ InvertDisplacementFieldImageFilter<TInputImage, TOutputImage>
     itkDebugMacro( "Iteration " << iteration << ": mean error norm = " << this->m_MeanErrorNorm
       << ", max error norm = " << this->m_MaxErrorNorm );
 
-    typedef ComposeDisplacementFieldsImageFilter<DisplacementFieldType> ComposerType;
-    typename ComposerType::Pointer composer = ComposerType::New();
-    composer->SetDisplacementField( displacementField );
-    composer->SetWarpingField( inverseDisplacementField );
-
-    this->m_ComposedField = composer->GetOutput();
-    this->m_ComposedField->Update();
-    this->m_ComposedField->DisconnectPipeline();
+    // The inverse field is updated in place below, so the composer has
+    // to be told that its warping field has changed.
+    composer->GraftOutput( this->m_ComposedField );
+    composer->Modified();
+    composer->Update();
 
     /**
      * Multithread processing to multiply each element of the composed field by 1 / spacing
@@ -166,6 +189,11 @@ InvertDisplacementFieldImageFilter<TInputImage, TOutputImage>
     this->GetMultiThreader()->SetSingleMethod( this->ThreaderCallback, &str1 );
     this->GetMultiThreader()->SingleMethodExecute();
     }
+
+  if( this->GetReleaseDataBeforeUpdateFlag() )
+    {
+    this->m_ComposedField->Initialize();
+    }
 }
 
 template<typename TInputImage, typename TOutputImage>
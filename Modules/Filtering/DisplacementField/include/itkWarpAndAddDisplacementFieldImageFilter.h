@@ -0,0 +1,148 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkWarpAndAddDisplacementFieldImageFilter_h
+#define itkWarpAndAddDisplacementFieldImageFilter_h
+
+#include "itkImageToImageFilter.h"
+#include "itkVectorInterpolateImageFunction.h"
+
+namespace itk
+{
+
+/**
+ * \class WarpAndAddDisplacementFieldImageFilter
+ *
+ * \brief Compose a displacement field with another one in a single pass.
+ *
+ * Given the field \f$ s \f$ set with SetInput() and the field \f$ u \f$
+ * set with SetDisplacementField(), this filter computes at each point
+ * \f$ x \f$ of the displacement field grid
+ *
+ *    \f[
+ *      s \circ (Id + u)(x) - x = s( x + u(x) ) + u(x)
+ *    \f]
+ *
+ * The result is the same as warping \f$ s \f$ by \f$ u \f$ with
+ * WarpVectorImageFilter and adding \f$ u \f$ with AddImageFilter, but the
+ * warped field is never stored. Points that fall outside of the buffer of
+ * \f$ s \f$ use a zero displacement, as the edge padding value of
+ * WarpVectorImageFilter does. The output has the geometry of the
+ * displacement field and must not share its buffer with either input, but
+ * a preallocated buffer can be grafted onto it to avoid reallocations when
+ * the filter is run repeatedly, e.g. in ExponentialDisplacementFieldImageFilter
+ * and DiffeomorphicDemonsRegistrationFilter. The ReleaseDataBeforeUpdateFlag
+ * must then stay off, as it is by default, otherwise the grafted buffer is
+ * released and a new one is allocated at each update.
+ *
+ * Both inputs and the output are expected to be images of Vector pixels of
+ * the image dimension.
+ *
+ * \ingroup ITKDisplacementField
+ */
+template< typename TDisplacementField >
+class WarpAndAddDisplacementFieldImageFilter:
+  public ImageToImageFilter< TDisplacementField, TDisplacementField >
+{
+public:
+  /** Standard class typedefs. */
+  typedef WarpAndAddDisplacementFieldImageFilter                        Self;
+  typedef ImageToImageFilter< TDisplacementField, TDisplacementField >  Superclass;
+  typedef SmartPointer< Self >                                          Pointer;
+  typedef SmartPointer< const Self >                                    ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods) */
+  itkTypeMacro(WarpAndAddDisplacementFieldImageFilter, ImageToImageFilter);
+
+  /** Extract dimension from the field type. */
+  itkStaticConstMacro(ImageDimension, unsigned int,
+                      TDisplacementField::ImageDimension);
+
+  /** Field typedef support. */
+  typedef TDisplacementField                          DisplacementFieldType;
+  typedef typename DisplacementFieldType::PixelType   VectorType;
+  typedef typename VectorType::ValueType              ValueType;
+  typedef typename DisplacementFieldType::RegionType  RegionType;
+  typedef typename DisplacementFieldType::IndexType   IndexType;
+  typedef typename DisplacementFieldType::PointType   PointType;
+
+  /** Interpolator typedef support. */
+  typedef double                                                                CoordRepType;
+  typedef VectorInterpolateImageFunction< DisplacementFieldType, CoordRepType > InterpolatorType;
+  typedef typename InterpolatorType::Pointer                                    InterpolatorPointer;
+
+  /** Set the displacement field \f$ u \f$, which defines the warp and
+   * the output grid. */
+  void SetDisplacementField(const DisplacementFieldType *field)
+  {
+    this->SetNthInput( 1, const_cast< DisplacementFieldType * >( field ) );
+  }
+
+  /** Get the displacement field. */
+  const DisplacementFieldType * GetDisplacementField() const
+  {
+    return static_cast< const DisplacementFieldType * >( this->ProcessObject::GetInput(1) );
+  }
+
+  /** Get/Set the interpolator used to evaluate \f$ s \f$. The default is a
+   * VectorLinearInterpolateNearestNeighborExtrapolateImageFunction. */
+  itkSetObjectMacro(Interpolator, InterpolatorType);
+  itkGetModifiableObjectMacro(Interpolator, InterpolatorType);
+
+#ifdef ITK_USE_CONCEPT_CHECKING
+  // Begin concept checking
+  itkConceptMacro( SameDimensionCheck,
+                   ( Concept::SameDimension< ImageDimension, VectorType::Dimension > ) );
+  // End concept checking
+#endif
+
+protected:
+  WarpAndAddDisplacementFieldImageFilter();
+  virtual ~WarpAndAddDisplacementFieldImageFilter() {}
+
+  virtual void PrintSelf(std::ostream & os, Indent indent) const ITK_OVERRIDE;
+
+  /** The field that is warped needs its largest possible region, while
+   * the displacement field only needs the output requested region. */
+  virtual void GenerateInputRequestedRegion() ITK_OVERRIDE;
+
+  /** The output takes the geometry of the displacement field. */
+  virtual void GenerateOutputInformation() ITK_OVERRIDE;
+
+  /** Connect the interpolator to the field that is warped. */
+  virtual void BeforeThreadedGenerateData() ITK_OVERRIDE;
+
+  /** Warp and add over the region of one thread. */
+  virtual void ThreadedGenerateData(const RegionType & outputRegionForThread,
+                                    ThreadIdType threadId) ITK_OVERRIDE;
+
+private:
+  WarpAndAddDisplacementFieldImageFilter(const Self &); //purposely not implemented
+  void operator=(const Self &);                         //purposely not implemented
+
+  InterpolatorPointer m_Interpolator;
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkWarpAndAddDisplacementFieldImageFilter.hxx"
+#endif
+
+#endif
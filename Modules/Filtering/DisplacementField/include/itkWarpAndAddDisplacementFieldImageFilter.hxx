@@ -0,0 +1,160 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkWarpAndAddDisplacementFieldImageFilter_hxx
+#define itkWarpAndAddDisplacementFieldImageFilter_hxx
+
+#include "itkWarpAndAddDisplacementFieldImageFilter.h"
+
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkProgressReporter.h"
+#include "itkVectorLinearInterpolateNearestNeighborExtrapolateImageFunction.h"
+
+namespace itk
+{
+
+template< typename TDisplacementField >
+WarpAndAddDisplacementFieldImageFilter< TDisplacementField >
+::WarpAndAddDisplacementFieldImageFilter()
+{
+  this->SetNumberOfRequiredInputs(2);
+
+  typedef VectorLinearInterpolateNearestNeighborExtrapolateImageFunction<
+    DisplacementFieldType, CoordRepType >                  DefaultInterpolatorType;
+  m_Interpolator = DefaultInterpolatorType::New();
+}
+
+template< typename TDisplacementField >
+void
+WarpAndAddDisplacementFieldImageFilter< TDisplacementField >
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  itkPrintSelfObjectMacro( Interpolator );
+}
+
+template< typename TDisplacementField >
+void
+WarpAndAddDisplacementFieldImageFilter< TDisplacementField >
+::GenerateInputRequestedRegion()
+{
+  // call the superclass's implementation
+  Superclass::GenerateInputRequestedRegion();
+
+  // request the largest possible region for the field that is warped
+  DisplacementFieldType *inputPtr = const_cast< DisplacementFieldType * >( this->GetInput() );
+  if ( inputPtr )
+    {
+    inputPtr->SetRequestedRegionToLargestPossibleRegion();
+    }
+
+  // just propagate up the output requested region for the
+  // displacement field.
+  DisplacementFieldType *fieldPtr = const_cast< DisplacementFieldType * >( this->GetDisplacementField() );
+  if ( fieldPtr )
+    {
+    fieldPtr->SetRequestedRegion( this->GetOutput()->GetRequestedRegion() );
+    }
+}
+
+template< typename TDisplacementField >
+void
+WarpAndAddDisplacementFieldImageFilter< TDisplacementField >
+::GenerateOutputInformation()
+{
+  // call the superclass's implementation of this method
+  Superclass::GenerateOutputInformation();
+
+  const DisplacementFieldType *fieldPtr = this->GetDisplacementField();
+  if ( fieldPtr )
+    {
+    this->GetOutput()->CopyInformation( fieldPtr );
+    }
+}
+
+template< typename TDisplacementField >
+void
+WarpAndAddDisplacementFieldImageFilter< TDisplacementField >
+::BeforeThreadedGenerateData()
+{
+  if ( !m_Interpolator )
+    {
+    itkExceptionMacro(<< "Interpolator not set");
+    }
+
+  m_Interpolator->SetInputImage( this->GetInput() );
+}
+
+template< typename TDisplacementField >
+void
+WarpAndAddDisplacementFieldImageFilter< TDisplacementField >
+::ThreadedGenerateData(const RegionType & outputRegionForThread,
+                       ThreadIdType threadId)
+{
+  DisplacementFieldType *       outputPtr = this->GetOutput();
+  const DisplacementFieldType * fieldPtr = this->GetDisplacementField();
+
+  // support progress methods/callbacks
+  ProgressReporter progress( this, threadId, outputRegionForThread.GetNumberOfPixels() );
+
+  ImageRegionIteratorWithIndex< DisplacementFieldType > outputIt(outputPtr, outputRegionForThread);
+  ImageRegionConstIterator< DisplacementFieldType >     fieldIt(fieldPtr, outputRegionForThread);
+
+  PointType  point;
+  VectorType displacement;
+  VectorType outputValue;
+
+  while ( !outputIt.IsAtEnd() )
+    {
+    outputPtr->TransformIndexToPhysicalPoint(outputIt.GetIndex(), point);
+
+    displacement = fieldIt.Get();
+
+    for ( unsigned int j = 0; j < ImageDimension; j++ )
+      {
+      point[j] += displacement[j];
+      }
+
+    // s( x + u(x) ), computed and rounded exactly as WarpVectorImageFilter
+    // does, then + u(x) as AddImageFilter does.
+    if ( m_Interpolator->IsInsideBuffer(point) )
+      {
+      typedef typename InterpolatorType::OutputType InterpolatorOutputType;
+      const InterpolatorOutputType interpolatedValue = m_Interpolator->Evaluate(point);
+
+      for ( unsigned int k = 0; k < ImageDimension; k++ )
+        {
+        outputValue[k] = static_cast< ValueType >( interpolatedValue[k] );
+        }
+      outputValue += displacement;
+      }
+    else
+      {
+      outputValue.Fill( NumericTraits< ValueType >::ZeroValue() );
+      outputValue += displacement;
+      }
+
+    outputIt.Set(outputValue);
+    ++outputIt;
+    ++fieldIt;
+    progress.CompletedPixel();
+    }
+}
+} // end namespace itk
+
+#endif
@@ -19,6 +19,7 @@
 #include "itkExponentialDisplacementFieldImageFilter.h"
 
 #include "vnl/vnl_random.h"
+#include <set>
 
 
 int itkExponentialDisplacementFieldImageFilterTest(int, char* [] )
@@ -283,6 +284,19 @@ int itkExponentialDisplacementFieldImageFilterTest(int, char* [] )
     ++ot6;
     }
 
+  // Repeated updates alternate between the output and the scratch buffers
+  // instead of allocating new ones.
+  std::set< const PixelType * > buffers;
+  for (unsigned int n = 0; n < 4; ++n)
+    {
+    inputImage->Modified();
+    filter->Update();
+    buffers.insert( filter->GetOutput()->GetBufferPointer() );
+    }
+
+  std::cout << "Number of buffers used by repeated updates: " << buffers.size() << std::endl;
+  testpassed &= ( buffers.size() <= 2 );
+
   if (!testpassed)
     {
     std::cout<<"Test failed"<<std::endl;
@@ -122,6 +122,41 @@ int itkInvertDisplacementFieldImageFilterTest( int, char * [] )
     return EXIT_FAILURE;
     }
 
+  // Start again from the estimated inverse. The estimate is copied into
+  // the output, whose buffer is kept by repeated updates.
+  DisplacementFieldType::Pointer estimate = inverter->GetOutput();
+  estimate->DisconnectPipeline();
+  inverter->SetInverseFieldInitialEstimate( estimate );
+
+  const VectorType *buffer = ITK_NULLPTR;
+  for( unsigned int n = 0; n < 2; n++ )
+    {
+    field->Modified();
+    try
+      {
+      inverter->Update();
+      }
+    catch( itk::ExceptionObject & excp )
+      {
+      std::cerr << "Exception thrown " << std::endl;
+      std::cerr << excp << std::endl;
+      return EXIT_FAILURE;
+      }
+    if( n > 0 && inverter->GetOutput()->GetBufferPointer() != buffer )
+      {
+      std::cerr << "The output buffer was reallocated." << std::endl;
+      return EXIT_FAILURE;
+      }
+    buffer = inverter->GetOutput()->GetBufferPointer();
+
+    delta = inverter->GetOutput()->GetPixel( index ) + ones;
+    if( delta.GetNorm() > 0.05 )
+      {
+      std::cerr << "Failed to find proper inverse from the initial estimate." << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
   inverter->Print( std::cout, 3 );
 
   return EXIT_SUCCESS;
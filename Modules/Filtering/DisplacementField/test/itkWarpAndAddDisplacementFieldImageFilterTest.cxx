@@ -0,0 +1,170 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkWarpAndAddDisplacementFieldImageFilter.h"
+#include "itkWarpVectorImageFilter.h"
+#include "itkAddImageFilter.h"
+#include "itkVectorLinearInterpolateImageFunction.h"
+#include "itkImageRegionIteratorWithIndex.h"
+
+#include "vnl/vnl_random.h"
+
+/**
+ * Checks that WarpAndAddDisplacementFieldImageFilter produces exactly the
+ * field computed by a WarpVectorImageFilter followed by an AddImageFilter,
+ * including near the border where part of the warped points fall outside
+ * of the buffer.
+ */
+int itkWarpAndAddDisplacementFieldImageFilterTest(int, char* [] )
+{
+  const unsigned int ImageDimension = 2;
+
+  typedef itk::Vector< double, ImageDimension >           PixelType;
+  typedef itk::Image< PixelType, ImageDimension >         ImageType;
+  typedef itk::ImageRegionIteratorWithIndex< ImageType >  IteratorType;
+
+  ImageType::SizeType size;
+  size[0] = 17;
+  size[1] = 13;
+  ImageType::RegionType region;
+  region.SetSize( size );
+
+  ImageType::SpacingType spacing;
+  spacing[0] = 1.5;
+  spacing[1] = 0.75;
+  ImageType::PointType origin;
+  origin[0] = -3.0;
+  origin[1] = 2.0;
+
+  ImageType::Pointer field = ImageType::New();
+  ImageType::Pointer update = ImageType::New();
+  ImageType * images[2] = { field.GetPointer(), update.GetPointer() };
+
+  vnl_random randomGenerator( 12345 );
+  for( unsigned int n = 0; n < 2; ++n )
+    {
+    images[n]->SetRegions( region );
+    images[n]->SetSpacing( spacing );
+    images[n]->SetOrigin( origin );
+    images[n]->Allocate();
+
+    IteratorType it( images[n], region );
+    for( it.GoToBegin(); !it.IsAtEnd(); ++it )
+      {
+      PixelType value;
+      for( unsigned int d = 0; d < ImageDimension; ++d )
+        {
+        value[d] = randomGenerator.drand64( -2.5, 2.5 );
+        }
+      it.Set( value );
+      }
+    }
+
+  typedef itk::VectorLinearInterpolateImageFunction< ImageType, double > InterpolatorType;
+
+  // Reference: separate warp and add
+  typedef itk::WarpVectorImageFilter< ImageType, ImageType, ImageType > WarperType;
+  WarperType::Pointer warper = WarperType::New();
+  warper->SetInterpolator( InterpolatorType::New() );
+  warper->SetOutputOrigin( update->GetOrigin() );
+  warper->SetOutputSpacing( update->GetSpacing() );
+  warper->SetOutputDirection( update->GetDirection() );
+  warper->SetInput( field );
+  warper->SetDisplacementField( update );
+
+  typedef itk::AddImageFilter< ImageType, ImageType, ImageType > AdderType;
+  AdderType::Pointer adder = AdderType::New();
+  adder->SetInput1( warper->GetOutput() );
+  adder->SetInput2( update );
+  adder->Update();
+
+  // Fused composition
+  typedef itk::WarpAndAddDisplacementFieldImageFilter< ImageType > ComposerType;
+  ComposerType::Pointer composer = ComposerType::New();
+  composer->SetInterpolator( InterpolatorType::New() );
+  composer->SetInput( field );
+  composer->SetDisplacementField( update );
+  composer->SetNumberOfThreads( 3 );
+  composer->Print( std::cout );
+
+  try
+    {
+    composer->Update();
+    }
+  catch( itk::ExceptionObject & excp )
+    {
+    std::cerr << "Exception thrown " << std::endl;
+    std::cerr << excp << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  ImageType::Pointer output = composer->GetOutput();
+  if( output->GetLargestPossibleRegion() != region
+      || output->GetSpacing() != spacing
+      || output->GetOrigin() != origin )
+    {
+    std::cerr << "Test failed: wrong output information" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  IteratorType ot( output, region );
+  IteratorType rt( adder->GetOutput(), region );
+  for( ot.GoToBegin(), rt.GoToBegin(); !ot.IsAtEnd(); ++ot, ++rt )
+    {
+    if( ot.Get() != rt.Get() )
+      {
+      std::cerr << "Test failed at index " << ot.GetIndex() << std::endl;
+      std::cerr << "Expected " << rt.Get() << " but got " << ot.Get() << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  // Graft a preallocated buffer and update twice: with the
+  // ReleaseDataBeforeUpdateFlag off, the buffer must be reused.
+  ImageType::Pointer buffer = ImageType::New();
+  buffer->CopyInformation( update );
+  buffer->SetRegions( region );
+  buffer->Allocate();
+  const PixelType * bufferPointer = buffer->GetBufferPointer();
+
+  composer->ReleaseDataBeforeUpdateFlagOff();
+  for( unsigned int n = 0; n < 2; ++n )
+    {
+    composer->GraftOutput( buffer );
+    composer->Modified();
+    composer->Update();
+    if( composer->GetOutput()->GetBufferPointer() != bufferPointer )
+      {
+      std::cerr << "Test failed: the grafted buffer was reallocated" << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  IteratorType bt( composer->GetOutput(), region );
+  for( bt.GoToBegin(), rt.GoToBegin(); !bt.IsAtEnd(); ++bt, ++rt )
+    {
+    if( bt.Get() != rt.Get() )
+      {
+      std::cerr << "Test failed with the grafted buffer at index " << bt.GetIndex() << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
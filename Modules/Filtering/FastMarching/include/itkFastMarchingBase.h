@@ -238,7 +238,29 @@ protected:
     NodeType,
     HeapContainerType,
     NodeComparerType >
-    PriorityQueueType;
+    StandardPriorityQueueType;
+
+  /** \class PriorityQueueType
+   * \brief std::priority_queue which can release its storage at once.
+   *
+   * The heap keeps stale entries (nodes whose value has since been
+   * lowered) until they are popped, so it may hold many more entries than
+   * trial nodes when the front stops early. Popping them one by one only to
+   * empty the queue costs O(N log N); Clear() drops them in one go instead.
+   * Insertion and extraction order are those of std::priority_queue. */
+  class PriorityQueueType : public StandardPriorityQueueType
+  {
+  public:
+    void Clear()
+    {
+      HeapContainerType().swap( this->c );
+    }
+
+    void Reserve( const typename HeapContainerType::size_type iSize )
+    {
+      this->c.reserve( iSize );
+    }
+  };
 
   PriorityQueueType m_Heap;
 
@@ -103,16 +103,11 @@ Initialize( OutputDomainType* oDomain )
     }
 
   // make sure the heap is empty
-  while ( !m_Heap.empty() )
+  m_Heap.Clear();
+  if( m_TrialPoints.IsNotNull() )
     {
-    m_Heap.pop();
+    m_Heap.Reserve( m_TrialPoints->Size() );
     }
-  /*
-  while ( !m_Heap->Empty() )
-    {
-    m_Heap->Pop();
-    }
-  */
 
   this->InitializeOutput( oDomain );
 
@@ -194,14 +189,7 @@ GenerateData()
     // it.
     //
     // RELEASE MEMORY!!!
-    while( !m_Heap.empty() )
-      {
-      m_Heap.pop();
-      }
-    /*while( !m_Heap->Empty() )
-      {
-      m_Heap->Pop();
-      }*/
+    m_Heap.Clear();
 
     throw ProcessAborted(__FILE__, __LINE__);
     }
@@ -209,14 +197,7 @@ GenerateData()
   m_TargetReachedValue = current_value;
 
   // let's release some useless memory...
-  while( !m_Heap.empty() )
-    {
-    m_Heap.pop();
-    }
-  /*while( !m_Heap->Empty() )
-    {
-    m_Heap->Pop();
-    }*/
+  m_Heap.Clear();
   }
 // -----------------------------------------------------------------------------
 
@@ -134,6 +134,10 @@ protected:
 
   virtual void UpdateValue( OutputImageType* oImage, const NodeType& iValue ) ITK_OVERRIDE;
 
+  /** The auxiliary values are computed as the front is propagated with the
+   * heap. */
+  virtual bool CanUseFastIterativeMethod() const ITK_OVERRIDE { return false; }
+
   /** Generate the output image meta information */
   virtual void GenerateOutputInformation() ITK_OVERRIDE;
 
@@ -399,7 +399,18 @@ private:
   typedef std::vector< AxisNodeType >  HeapContainer;
   typedef std::greater< AxisNodeType > NodeComparer;
   typedef std::priority_queue< AxisNodeType, HeapContainer, NodeComparer >
-  HeapType;
+  StandardHeapType;
+
+  /** Min-heap whose (possibly stale) entries can be dropped at once
+   * rather than popped one by one. */
+  class HeapType : public StandardHeapType
+  {
+  public:
+    void Clear()
+    {
+      HeapContainer().swap( this->c );
+    }
+  };
 
   HeapType m_TrialHeap;
 
@@ -238,10 +238,7 @@ FastMarchingImageFilter< TLevelSet, TSpeedImage >
     }
 
   // make sure the heap is empty
-  while ( !m_TrialHeap.empty() )
-    {
-    m_TrialHeap.pop();
-    }
+  m_TrialHeap.Clear();
 
   // process the input trial points
   if ( m_TrialPoints )
@@ -343,6 +340,7 @@ FastMarchingImageFilter< TLevelSet, TSpeedImage >
             {
             this->InvokeEvent( AbortEvent() );
             this->ResetPipeline();
+            m_TrialHeap.Clear();
             ProcessAborted e(__FILE__, __LINE__);
             e.SetDescription("Process aborted.");
             e.SetLocation(ITK_LOCATION);
@@ -352,6 +350,9 @@ FastMarchingImageFilter< TLevelSet, TSpeedImage >
         }
       }
     }
+
+  // release the trial points left over when the front stopped early
+  m_TrialHeap.Clear();
 }
 
 template< typename TLevelSet, typename TSpeedImage >
@@ -24,6 +24,8 @@
 #include "itkNeighborhoodIterator.h"
 #include "itkArray.h"
 #include <bitset>
+#include <vector>
+#include <string>
 
 namespace itk
 {
@@ -61,6 +63,12 @@ namespace itk
  * "Level Set Methods and Fast Marching Methods", J.A. Sethian,
  * Cambridge Press, Second edition, 1999.
  *
+ * The front can also be propagated in parallel with the fast iterative
+ * method described in
+ * W.-K. Jeong, R.T. Whitaker. "A Fast Iterative Method for Eikonal
+ * Equations", SIAM Journal on Scientific Computing, 30(5):2512-2534, 2008.
+ * See SetUseFastIterativeMethod().
+ *
  * \tparam TTraits traits
  *
  * \sa ImageFastMarchingTraits
@@ -151,6 +159,36 @@ public:
   itkGetConstReferenceMacro(OverrideOutputInformation, bool);
   itkBooleanMacro(OverrideOutputInformation);
 
+  /** Set/Get whether the front is propagated with the fast iterative
+   * method instead of the heap. All the nodes of the front are then updated
+   * in parallel, with the number of threads of the filter, until their
+   * arrival times no longer decrease. The nodes are then accepted in
+   * increasing order of arrival time, ties being broken by position, and
+   * the stopping criterion is evaluated for each of them as with the heap.
+   * The nodes beyond the one that satisfies it are reset, and the trial
+   * nodes around the accepted ones are given the values the heap would
+   * have given them.
+   *
+   * Every node reachable from the trial points is solved before the
+   * stopping criterion is evaluated, and a node is usually solved several
+   * times before it converges, so this only pays off with several threads
+   * and when the front sweeps most of the image. The arrival times are
+   * those of the heap, except:
+   * - next to the image boundary: the heap does not update the neighbors of
+   * a node along the directions in which the node lies on the boundary,
+   * while the fast iterative method does;
+   * - around alive points which are not surrounded by trial points: the
+   * heap only uses their values once the front reaches them, while the
+   * fast iterative method propagates the front back from them.
+   * When the whole image is processed, the target reached value is the
+   * largest arrival time.
+   *
+   * The heap is still used when a topology check is requested, and by the
+   * subclasses that compute more than the arrival times. Off by default. */
+  itkSetMacro(UseFastIterativeMethod, bool);
+  itkGetConstReferenceMacro(UseFastIterativeMethod, bool);
+  itkBooleanMacro(UseFastIterativeMethod);
+
 protected:
 
   /** Constructor */
@@ -169,6 +207,8 @@ protected:
   OutputDirectionType m_OutputDirection;
   bool                m_OverrideOutputInformation;
 
+  bool                m_UseFastIterativeMethod;
+
   /** Generate the output image meta information. */
   virtual void GenerateOutputInformation() ITK_OVERRIDE;
 
@@ -218,6 +258,68 @@ protected:
                const NodeType& iNode,
                InternalNodeStructureArray& ioNeighbors ) const;
 
+  /** Propagate the front with the heap, or with the fast iterative method
+   * if requested and possible. */
+  void GenerateData() ITK_OVERRIDE;
+
+  /** Whether the fast iterative method can be used. Subclasses which
+   * compute more than the arrival times while the nodes are accepted must
+   * return false. */
+  virtual bool CanUseFastIterativeMethod() const;
+
+  void PrintSelf( std::ostream & os, Indent indent ) const ITK_OVERRIDE;
+
+  // --------------------------------------------------------------------------
+  // --------------------------------------------------------------------------
+
+  /**
+   * Functions and variables of the fast iterative method.
+   */
+
+  /** Arrival time and offset of a node in the output buffer, ordered by
+   * time then by offset. */
+  typedef std::pair< OutputPixelType, OffsetValueType > ArrivalType;
+  typedef std::vector< ArrivalType >                    ArrivalContainerType;
+
+  /** Work done by the threads at each step of the fast iterative method. */
+  enum FastIterativeStepType {
+    SolveActiveNodes = 0,
+    CheckConvergedNodeNeighbors,
+    SortArrivals };
+
+  struct FastIterativeThreadStruct
+    {
+    Self *Filter;
+    };
+
+  /** Solve the arrival time of the active nodes, check the neighbors of
+   * the converged nodes, then accept the nodes in order of arrival. */
+  void FastIterativeGenerateData( OutputImageType* oImage );
+
+  /** Run the current step, with the threads of the filter if the number
+   * of nodes involved is worth it. */
+  void ExecuteFastIterativeStep( FastIterativeStepType iStep,
+                                 SizeValueType iNumberOfNodes );
+
+  static ITK_THREAD_RETURN_TYPE FastIterativeThreaderCallback( void *arg );
+
+  void ThreadedFastIterativeStep( ThreadIdType iThreadId,
+                                  ThreadIdType iNumberOfThreads );
+
+  /** Arrival time at a node, given by its index and its buffer offset, from
+   * the current values of all its neighbors, reached or not. Returns
+   * m_LargeValue if none of them has been reached. */
+  OutputPixelType SolveWithNeighborValues( const OutputImageType* oImage,
+                                           const NodeType& iNode,
+                                           OffsetValueType iOffset ) const;
+
+  FastIterativeStepType                 m_FastIterativeStep;
+  std::vector< OffsetValueType >        m_ActiveNodes;
+  std::vector< OutputPixelType >        m_ActiveNodeValues;
+  std::vector< OffsetValueType >        m_ConvergedNodes;
+  std::vector< ArrivalContainerType >   m_ThreadArrivals;
+  std::vector< std::string >            m_ThreadExceptionDescription;
+
   // --------------------------------------------------------------------------
   // --------------------------------------------------------------------------
 
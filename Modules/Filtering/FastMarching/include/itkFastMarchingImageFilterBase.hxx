@@ -24,6 +24,11 @@
 #include "itkImageRegionIterator.h"
 #include "itkConnectedComponentImageFilter.h"
 #include "itkRelabelComponentImageFilter.h"
+#include "itkProgressReporter.h"
+
+#include <algorithm>
+#include <functional>
+#include <queue>
 
 namespace itk
 {
@@ -67,6 +72,9 @@ FastMarchingImageFilterBase()
   m_OutputDirection.SetIdentity();
   m_OverrideOutputInformation = false;
 
+  m_UseFastIterativeMethod = false;
+  m_FastIterativeStep = SolveActiveNodes;
+
   m_InputCache = ITK_NULLPTR;
   m_LabelImage = LabelImageType::New();
   }
@@ -386,6 +394,473 @@ Solve( OutputImageType* oImage,
   }
 // -----------------------------------------------------------------------------
 
+// -----------------------------------------------------------------------------
+template< typename TInput, typename TOutput >
+void
+FastMarchingImageFilterBase< TInput, TOutput >::
+PrintSelf( std::ostream & os, Indent indent ) const
+  {
+  Superclass::PrintSelf( os, indent );
+  os << indent << "Use fast iterative method: " << m_UseFastIterativeMethod << std::endl;
+  }
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+template< typename TInput, typename TOutput >
+bool
+FastMarchingImageFilterBase< TInput, TOutput >::
+CanUseFastIterativeMethod() const
+  {
+  return true;
+  }
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+template< typename TInput, typename TOutput >
+void
+FastMarchingImageFilterBase< TInput, TOutput >::
+GenerateData()
+  {
+  if( !m_UseFastIterativeMethod ||
+      this->m_TopologyCheck != Superclass::Nothing ||
+      !this->CanUseFastIterativeMethod() )
+    {
+    Superclass::GenerateData();
+    return;
+    }
+
+  OutputImageType* output = this->GetOutput();
+
+  this->Initialize( output );
+
+  // the trial points have been pushed onto the heap, which is not used
+  this->m_Heap.Clear();
+
+  this->FastIterativeGenerateData( output );
+  }
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+template< typename TInput, typename TOutput >
+typename
+FastMarchingImageFilterBase< TInput, TOutput >::
+OutputPixelType
+FastMarchingImageFilterBase< TInput, TOutput >::
+SolveWithNeighborValues( const OutputImageType* oImage,
+                         const NodeType& iNode,
+                         OffsetValueType iOffset ) const
+  {
+  const OutputPixelType *values = oImage->GetBufferPointer();
+  const unsigned char *label = m_LabelImage->GetBufferPointer();
+  const typename LabelImageType::OffsetValueType *offsetTable = m_LabelImage->GetOffsetTable();
+
+  InternalNodeStructureArray nodesUsed;
+  InternalNodeStructure temp_node;
+  bool reached = false;
+
+  for ( unsigned int j = 0; j < ImageDimension; j++ )
+    {
+    temp_node.m_Value = this->m_LargeValue;
+    temp_node.m_Node = iNode;
+
+    // find smallest valued neighbor in this dimension, whatever its label
+    for ( int s = -1; s < 2; s = s + 2 )
+      {
+      const typename NodeType::IndexValueType temp = iNode[j] + s;
+
+      if ( ( temp <= m_LastIndex[j] ) && ( temp >= m_StartIndex[j] ) )
+        {
+        const OffsetValueType neighborOffset = iOffset + s * offsetTable[j];
+
+        if ( label[neighborOffset] != Traits::Forbidden &&
+             temp_node.m_Value > values[neighborOffset] )
+          {
+          temp_node.m_Value = values[neighborOffset];
+          temp_node.m_Node = iNode;
+          temp_node.m_Node[j] = temp;
+          }
+        }
+      }
+
+    reached = reached || ( temp_node.m_Value < this->m_LargeValue );
+
+    temp_node.m_Axis = j;
+    nodesUsed[j] = temp_node;
+    }
+
+  if ( !reached )
+    {
+    return this->m_LargeValue;
+    }
+
+  const double solution = this->Solve( const_cast< OutputImageType * >( oImage ), iNode, nodesUsed );
+
+  if ( solution < static_cast< double >( this->m_LargeValue ) )
+    {
+    return static_cast< OutputPixelType >( solution );
+    }
+  return this->m_LargeValue;
+  }
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+template< typename TInput, typename TOutput >
+void
+FastMarchingImageFilterBase< TInput, TOutput >::
+FastIterativeGenerateData( OutputImageType* oImage )
+  {
+  OutputPixelType *values = oImage->GetBufferPointer();
+  unsigned char *label = m_LabelImage->GetBufferPointer();
+
+  // The trial points are the first converged nodes: their neighbors are
+  // the first active nodes.
+  m_ActiveNodes.clear();
+  m_ConvergedNodes.clear();
+  if ( this->m_TrialPoints )
+    {
+    NodePairContainerConstIterator pointsIter = this->m_TrialPoints->Begin();
+    NodePairContainerConstIterator pointsEnd = this->m_TrialPoints->End();
+
+    for( ; pointsIter != pointsEnd; ++pointsIter )
+      {
+      const NodeType idx = pointsIter->Value().GetNode();
+      if ( m_BufferedRegion.IsInside( idx ) &&
+           m_LabelImage->GetPixel( idx ) == Traits::InitialTrial )
+        {
+        m_ConvergedNodes.push_back( m_LabelImage->ComputeOffset( idx ) );
+        }
+      }
+    }
+
+  // While a node is active, its label is Trial. Reached nodes which are
+  // not active keep the Far label.
+  while( !m_ConvergedNodes.empty() )
+    {
+    // the neighbors of the converged nodes whose arrival time decreases
+    // become active
+    this->ExecuteFastIterativeStep( CheckConvergedNodeNeighbors, m_ConvergedNodes.size() );
+    m_ConvergedNodes.clear();
+
+    for( typename std::vector< ArrivalContainerType >::const_iterator
+         it = m_ThreadArrivals.begin(); it != m_ThreadArrivals.end(); ++it )
+      {
+      for( typename ArrivalContainerType::const_iterator
+           nIt = it->begin(); nIt != it->end(); ++nIt )
+        {
+        // a node may be the neighbor of several converged nodes
+        if ( label[nIt->second] == Traits::Far )
+          {
+          label[nIt->second] = Traits::Trial;
+          values[nIt->second] = nIt->first;
+          m_ActiveNodes.push_back( nIt->second );
+          }
+        }
+      }
+
+    // solve the active nodes until some of them converge
+    while( !m_ActiveNodes.empty() && m_ConvergedNodes.empty() )
+      {
+      m_ActiveNodeValues.resize( m_ActiveNodes.size() );
+      this->ExecuteFastIterativeStep( SolveActiveNodes, m_ActiveNodes.size() );
+
+      // the nodes whose arrival time did not decrease have converged
+      SizeValueType numberOfActiveNodes = 0;
+      for( SizeValueType i = 0; i < m_ActiveNodes.size(); i++ )
+        {
+        const OffsetValueType offset = m_ActiveNodes[i];
+        if ( m_ActiveNodeValues[i] < values[offset] )
+          {
+          values[offset] = m_ActiveNodeValues[i];
+          m_ActiveNodes[numberOfActiveNodes++] = offset;
+          }
+        else
+          {
+          label[offset] = Traits::Far;
+          m_ConvergedNodes.push_back( offset );
+          }
+        }
+      m_ActiveNodes.resize( numberOfActiveNodes );
+      }
+    }
+
+  // Accept the reached nodes in increasing order of arrival time, by
+  // merging the runs sorted by the threads.
+  this->ExecuteFastIterativeStep( SortArrivals, this->GetTotalNumberOfNodes() );
+
+  typedef std::pair< ArrivalType, SizeValueType >  RunHeadType;
+  std::priority_queue< RunHeadType, std::vector< RunHeadType >,
+    std::greater< RunHeadType > > runHeads;
+  std::vector< SizeValueType > runPositions( m_ThreadArrivals.size(), 0 );
+  for( SizeValueType r = 0; r < m_ThreadArrivals.size(); r++ )
+    {
+    if ( !m_ThreadArrivals[r].empty() )
+      {
+      runHeads.push( RunHeadType( m_ThreadArrivals[r][0], r ) );
+      }
+    }
+
+  ProgressReporter progress( this, 0, this->GetTotalNumberOfNodes() );
+
+  this->m_StoppingCriterion->Reinitialize();
+
+  OutputPixelType current_value = 0.;
+  bool stopped = false;
+
+  while( !runHeads.empty() )
+    {
+    const RunHeadType head = runHeads.top();
+
+    const NodeType current_node = m_LabelImage->ComputeIndex( head.first.second );
+    current_value = head.first.first;
+    const NodePairType current_node_pair( current_node, current_value );
+
+    this->m_StoppingCriterion->SetCurrentNodePair( current_node_pair );
+
+    if( this->m_StoppingCriterion->IsSatisfied() )
+      {
+      stopped = true;
+      break;
+      }
+
+    if ( this->m_CollectPoints )
+      {
+      this->m_ProcessedPoints->push_back( current_node_pair );
+      }
+
+    label[head.first.second] = Traits::Alive;
+
+    progress.CompletedPixel();
+
+    runHeads.pop();
+    if ( ++runPositions[head.second] < m_ThreadArrivals[head.second].size() )
+      {
+      runHeads.push( RunHeadType( m_ThreadArrivals[head.second][runPositions[head.second]], head.second ) );
+      }
+    }
+
+  this->m_TargetReachedValue = current_value;
+
+  if ( stopped )
+    {
+    // The nodes which have not been accepted get back the values they
+    // would have had with the heap: the trial points keep their initial
+    // values, the other nodes are not reached unless they are neighbors of
+    // accepted nodes.
+    for( SizeValueType r = 0; r < m_ThreadArrivals.size(); r++ )
+      {
+      for( SizeValueType i = runPositions[r]; i < m_ThreadArrivals[r].size(); i++ )
+        {
+        const OffsetValueType offset = m_ThreadArrivals[r][i].second;
+        if ( label[offset] != Traits::InitialTrial )
+          {
+          label[offset] = Traits::Far;
+          values[offset] = this->m_LargeValue;
+          }
+        }
+      }
+    for( SizeValueType r = 0; r < m_ThreadArrivals.size(); r++ )
+      {
+      for( SizeValueType i = 0; i < runPositions[r]; i++ )
+        {
+        this->UpdateNeighbors( oImage, m_LabelImage->ComputeIndex( m_ThreadArrivals[r][i].second ) );
+        }
+      }
+    this->m_Heap.Clear();
+    }
+
+  // release the memory of the fast iterative method
+  std::vector< OffsetValueType >().swap( m_ActiveNodes );
+  std::vector< OutputPixelType >().swap( m_ActiveNodeValues );
+  std::vector< OffsetValueType >().swap( m_ConvergedNodes );
+  std::vector< ArrivalContainerType >().swap( m_ThreadArrivals );
+  }
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+template< typename TInput, typename TOutput >
+void
+FastMarchingImageFilterBase< TInput, TOutput >::
+ExecuteFastIterativeStep( FastIterativeStepType iStep,
+                          SizeValueType iNumberOfNodes )
+  {
+  m_FastIterativeStep = iStep;
+
+  // Small fronts are not worth starting the threads. The result does not
+  // depend on the number of threads.
+  const SizeValueType minimumNumberOfNodesPerThread = 256;
+  ThreadIdType numberOfThreads = this->GetNumberOfThreads();
+  if ( iNumberOfNodes < minimumNumberOfNodesPerThread * numberOfThreads )
+    {
+    numberOfThreads = std::max( static_cast< ThreadIdType >( 1 ),
+      static_cast< ThreadIdType >( iNumberOfNodes / minimumNumberOfNodesPerThread ) );
+    }
+  if ( numberOfThreads > 1 )
+    {
+    this->GetMultiThreader()->SetNumberOfThreads( numberOfThreads );
+    numberOfThreads = this->GetMultiThreader()->GetNumberOfThreads();
+    }
+
+  if ( iStep != SolveActiveNodes )
+    {
+    m_ThreadArrivals.resize( numberOfThreads );
+    }
+  m_ThreadExceptionDescription.assign( numberOfThreads, std::string() );
+
+  if ( numberOfThreads == 1 )
+    {
+    this->ThreadedFastIterativeStep( 0, 1 );
+    }
+  else
+    {
+    FastIterativeThreadStruct str;
+    str.Filter = this;
+    this->GetMultiThreader()->SetSingleMethod( this->FastIterativeThreaderCallback, &str );
+    this->GetMultiThreader()->SingleMethodExecute();
+    }
+
+  for( ThreadIdType t = 0; t < m_ThreadExceptionDescription.size(); t++ )
+    {
+    if ( !m_ThreadExceptionDescription[t].empty() )
+      {
+      itkExceptionMacro( << m_ThreadExceptionDescription[t] );
+      }
+    }
+  }
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+template< typename TInput, typename TOutput >
+ITK_THREAD_RETURN_TYPE
+FastMarchingImageFilterBase< TInput, TOutput >::
+FastIterativeThreaderCallback( void *arg )
+  {
+  MultiThreader::ThreadInfoStruct *info = static_cast< MultiThreader::ThreadInfoStruct * >( arg );
+  FastIterativeThreadStruct *str = static_cast< FastIterativeThreadStruct * >( info->UserData );
+
+  str->Filter->ThreadedFastIterativeStep( info->ThreadID, info->NumberOfThreads );
+
+  return ITK_THREAD_RETURN_VALUE;
+  }
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+template< typename TInput, typename TOutput >
+void
+FastMarchingImageFilterBase< TInput, TOutput >::
+ThreadedFastIterativeStep( ThreadIdType iThreadId, ThreadIdType iNumberOfThreads )
+  {
+  const OutputImageType *output = this->GetOutput();
+  const OutputPixelType *values = output->GetBufferPointer();
+  const unsigned char *label = m_LabelImage->GetBufferPointer();
+
+  SizeValueType numberOfNodes;
+  switch( m_FastIterativeStep )
+    {
+    case SolveActiveNodes:
+      numberOfNodes = m_ActiveNodes.size();
+      break;
+    case CheckConvergedNodeNeighbors:
+      numberOfNodes = m_ConvergedNodes.size();
+      break;
+    default:
+      numberOfNodes = m_BufferedRegion.GetNumberOfPixels();
+      break;
+    }
+
+  // contiguous range of nodes of this thread, so that the results do not
+  // depend on the number of threads
+  SizeValueType count = numberOfNodes / iNumberOfThreads;
+  const SizeValueType remainder = numberOfNodes % iNumberOfThreads;
+  const SizeValueType first = iThreadId * count + std::min( static_cast< SizeValueType >( iThreadId ), remainder );
+  if ( iThreadId < remainder )
+    {
+    count++;
+    }
+
+  try
+    {
+    switch( m_FastIterativeStep )
+      {
+      case SolveActiveNodes:
+        {
+        for( SizeValueType i = first; i < first + count; i++ )
+          {
+          m_ActiveNodeValues[i] = this->SolveWithNeighborValues( output,
+            m_LabelImage->ComputeIndex( m_ActiveNodes[i] ), m_ActiveNodes[i] );
+          }
+        break;
+        }
+      case CheckConvergedNodeNeighbors:
+        {
+        ArrivalContainerType & arrivals = m_ThreadArrivals[iThreadId];
+        arrivals.clear();
+
+        const typename LabelImageType::OffsetValueType *offsetTable = m_LabelImage->GetOffsetTable();
+
+        for( SizeValueType i = first; i < first + count; i++ )
+          {
+          const OffsetValueType offset = m_ConvergedNodes[i];
+          const NodeType node = m_LabelImage->ComputeIndex( offset );
+
+          for ( unsigned int j = 0; j < ImageDimension; j++ )
+            {
+            for ( int s = -1; s < 2; s = s + 2 )
+              {
+              const typename NodeType::IndexValueType temp = node[j] + s;
+
+              if ( ( temp <= m_LastIndex[j] ) && ( temp >= m_StartIndex[j] ) )
+                {
+                const OffsetValueType neighborOffset = offset + s * offsetTable[j];
+
+                // only the nodes which are not active, whose value is not
+                // fixed and which may be reached earlier through this node
+                // are checked
+                if ( label[neighborOffset] == Traits::Far &&
+                     values[offset] < values[neighborOffset] )
+                  {
+                  NodeType neighbor = node;
+                  neighbor[j] = temp;
+
+                  const OutputPixelType value =
+                    this->SolveWithNeighborValues( output, neighbor, neighborOffset );
+                  if ( value < values[neighborOffset] )
+                    {
+                    arrivals.push_back( ArrivalType( value, neighborOffset ) );
+                    }
+                  }
+                }
+              }
+            }
+          }
+        break;
+        }
+      case SortArrivals:
+        {
+        ArrivalContainerType & arrivals = m_ThreadArrivals[iThreadId];
+        arrivals.clear();
+
+        // the nodes to accept are the reached nodes and the trial points
+        for( SizeValueType offset = first; offset < first + count; offset++ )
+          {
+          if ( ( label[offset] == Traits::Far && values[offset] < this->m_LargeValue ) ||
+               label[offset] == Traits::InitialTrial )
+            {
+            arrivals.push_back( ArrivalType( values[offset], offset ) );
+            }
+          }
+
+        std::sort( arrivals.begin(), arrivals.end() );
+        break;
+        }
+      }
+    }
+  catch( ExceptionObject & e )
+    {
+    m_ThreadExceptionDescription[iThreadId] = e.GetDescription();
+    }
+  }
+// -----------------------------------------------------------------------------
+
 // -----------------------------------------------------------------------------
 template< typename TInput, typename TOutput >
 bool
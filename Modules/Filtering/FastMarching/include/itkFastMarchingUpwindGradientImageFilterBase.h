@@ -99,6 +99,9 @@ protected:
   virtual void UpdateNeighbors( OutputImageType* oImage,
                                const NodeType& iNode ) ITK_OVERRIDE;
 
+  /** The gradient is computed as the front is propagated with the heap. */
+  virtual bool CanUseFastIterativeMethod() const ITK_OVERRIDE { return false; }
+
   virtual void ComputeGradient(OutputImageType* oImage,
                                const NodeType& iNode );
 
@@ -21,6 +21,7 @@
 #include "itkFastMarchingThresholdStoppingCriterion.h"
 #include "itkTextOutput.h"
 #include "itkCommand.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
 
 
 namespace{
@@ -35,6 +36,41 @@ public:
     {std::cout << "Progress " << m_Process->GetProgress() << std::endl;}
   itk::ProcessObject::Pointer m_Process;
 };
+
+// Compare the arrival times and the labels of two marchers.
+template< typename TMarcher >
+bool CompareMarchers( TMarcher *reference, TMarcher *test )
+{
+  typedef typename TMarcher::OutputImageType OutputImageType;
+  typedef typename TMarcher::LabelImageType  LabelImageType;
+
+  const typename OutputImageType::RegionType region =
+    reference->GetOutput()->GetBufferedRegion();
+
+  itk::ImageRegionConstIteratorWithIndex< OutputImageType >
+    refIt( reference->GetOutput(), region );
+  itk::ImageRegionConstIterator< OutputImageType >
+    testIt( test->GetOutput(), region );
+  itk::ImageRegionConstIterator< LabelImageType >
+    refLabelIt( reference->GetLabelImage(), region );
+  itk::ImageRegionConstIterator< LabelImageType >
+    testLabelIt( test->GetLabelImage(), region );
+
+  bool same = true;
+  for ( ; !refIt.IsAtEnd(); ++refIt, ++testIt, ++refLabelIt, ++testLabelIt )
+    {
+    if ( vnl_math_abs( refIt.Get() - testIt.Get() ) > 1e-4 ||
+         refLabelIt.Get() != testLabelIt.Get() )
+      {
+      std::cout << refIt.GetIndex() << " " << refIt.Get() << " ("
+                << static_cast< int >( refLabelIt.Get() ) << ") != "
+                << testIt.Get() << " ("
+                << static_cast< int >( testLabelIt.Get() ) << ")" << std::endl;
+      same = false;
+      }
+    }
+  return same;
+}
 }
 
 int itkFastMarchingImageFilterRealTest1(int argc, char* argv[] )
@@ -193,6 +229,43 @@ int itkFastMarchingImageFilterRealTest1(int argc, char* argv[] )
     ++iterator;
     }
 
+  // The fast iterative method reaches the same arrival times as the heap.
+  CriterionType::Pointer iterativeCriterion = CriterionType::New();
+  iterativeCriterion->SetThreshold( 100. );
+
+  FastMarchingType::Pointer iterativeMarcher = FastMarchingType::New();
+  iterativeMarcher->SetStoppingCriterion( iterativeCriterion );
+  iterativeMarcher->SetAlivePoints( alive );
+  iterativeMarcher->SetTrialPoints( trial );
+  iterativeMarcher->SetOutputSize( size );
+  iterativeMarcher->SetInput( speedImage );
+  iterativeMarcher->UseFastIterativeMethodOn();
+  iterativeMarcher->SetNumberOfThreads( 4 );
+  iterativeMarcher->Update();
+
+  if ( !CompareMarchers< FastMarchingType >( marcher, iterativeMarcher ) )
+    {
+    std::cout << "Fast iterative method differs from the heap" << std::endl;
+    passed = false;
+    }
+
+  // When the front is stopped, the accepted nodes and the trial band are
+  // the ones of the heap.
+  criterion->SetThreshold( 20. );
+  marcher->Modified();
+  marcher->Update();
+
+  iterativeCriterion->SetThreshold( 20. );
+  iterativeMarcher->Modified();
+  iterativeMarcher->Update();
+
+  if ( !CompareMarchers< FastMarchingType >( marcher, iterativeMarcher ) ||
+       marcher->GetTargetReachedValue() != iterativeMarcher->GetTargetReachedValue() )
+    {
+    std::cout << "Fast iterative method stopped differently from the heap" << std::endl;
+    passed = false;
+    }
+
   std::cout << "SpeedConstant: " << marcher->GetSpeedConstant() << std::endl;
   std::cout << "StoppingValue: " << marcher->GetTargetReachedValue() << std::endl;
   std::cout << "SpeedImage: " << marcher->GetInput() << std::endl;
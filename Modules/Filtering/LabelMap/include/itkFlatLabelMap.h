@@ -0,0 +1,322 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkFlatLabelMap_h
+#define itkFlatLabelMap_h
+
+#include "itkObject.h"
+#include "itkObjectFactory.h"
+#include <vector>
+
+namespace itk
+{
+/** \class FlatLabelMap
+ * \brief A compact, read-only copy of the lines of a LabelMap.
+ *
+ * LabelMap stores each label object in its own reference counted object,
+ * with its own line container. FlatLabelMap stores the lines of all the
+ * objects in a single array, sorted by label, and by index inside a
+ * label. The labels are kept in a sorted array, and the lines of the
+ * object in slot i are at positions [ offset[i], offset[i+1] ) of the line
+ * array. This costs a few bytes per object instead of a few hundred, and
+ * a walk over all the lines is a linear scan of memory.
+ *
+ * The content is set with SetLabelMap() and can be written back to a
+ * LabelMap with UpdateLabelMap(). Only the labels and the lines are kept:
+ * the attributes of the label objects are not.
+ *
+ * The lines of an object can be read with the same ConstLineIterator and
+ * ConstIndexIterator interfaces as LabelObject's:
+ * \code
+ * FlatLabelMapType::ConstIndexIterator it( flat, label );
+ * while( !it.IsAtEnd() )
+ *   {
+ *   std::cout << it.GetIndex() << std::endl;
+ *   ++it;
+ *   }
+ * \endcode
+ *
+ * \sa LabelMap, LabelObject
+ * \ingroup DataRepresentation
+ * \ingroup LabeledImageObject
+ * \ingroup ITKLabelMap
+ */
+template< typename TLabelMap >
+class FlatLabelMap:public Object
+{
+public:
+  /** Standard class typedefs */
+  typedef FlatLabelMap               Self;
+  typedef Object                     Superclass;
+  typedef SmartPointer< Self >       Pointer;
+  typedef SmartPointer< const Self > ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(FlatLabelMap, Object);
+
+  typedef TLabelMap                                LabelMapType;
+  typedef typename LabelMapType::LabelObjectType   LabelObjectType;
+  typedef typename LabelObjectType::LabelType      LabelType;
+  typedef typename LabelObjectType::LineType       LineType;
+  typedef typename LabelObjectType::IndexType      IndexType;
+  typedef typename LabelObjectType::LengthType     LengthType;
+  typedef itk::SizeValueType                       SizeValueType;
+
+  itkStaticConstMacro(ImageDimension, unsigned int, LabelMapType::ImageDimension);
+
+  /** Copy the labels and the lines of all the objects of labelMap. */
+  void SetLabelMap(const LabelMapType *labelMap);
+
+  /** Replace the label objects of labelMap by new objects built from the
+   * lines stored here. The attributes of the new objects are left to
+   * their default values. */
+  void UpdateLabelMap(LabelMapType *labelMap) const;
+
+  /** Remove all the labels and lines. */
+  void Clear();
+
+  /** Return the number of label objects. */
+  SizeValueType GetNumberOfLabelObjects() const
+  {
+    return static_cast< SizeValueType >( m_Labels.size() );
+  }
+
+  /** Return the number of lines of all the objects. */
+  SizeValueType GetNumberOfLines() const
+  {
+    return static_cast< SizeValueType >( m_Lines.size() );
+  }
+
+  /** Return true if an object has the given label. */
+  bool HasLabel(const LabelType & label) const;
+
+  /** Return the slot of the object with the given label, in
+   * [0, GetNumberOfLabelObjects()). Slots are ordered by label. An
+   * exception is thrown if there is no object with that label. */
+  SizeValueType GetSlot(const LabelType & label) const;
+
+  /** Return the label of the object in the given slot. */
+  const LabelType & GetLabel(SizeValueType slot) const
+  {
+    return m_Labels[slot];
+  }
+
+  /** Return the number of lines of the object in the given slot. */
+  SizeValueType GetNumberOfLines(SizeValueType slot) const
+  {
+    return m_LineOffsets[slot + 1] - m_LineOffsets[slot];
+  }
+
+  /** Return the ith line of the object in the given slot. */
+  const LineType & GetLine(SizeValueType slot, SizeValueType i) const
+  {
+    return m_Lines[m_LineOffsets[slot] + i];
+  }
+
+  /** Return the number of pixels of the object in the given slot. */
+  SizeValueType GetNumberOfPixels(SizeValueType slot) const;
+
+  /** Return a pointer to the first line of the object in the given slot,
+   * or past the last line when slot is the number of objects. */
+  const LineType * GetLineBegin(SizeValueType slot) const
+  {
+    return m_Lines.empty() ? ITK_NULLPTR : &m_Lines[0] + m_LineOffsets[slot];
+  }
+
+  /** \class ConstLineIterator
+   * \brief A forward iterator over the lines of an object of a FlatLabelMap
+   * \ingroup ITKLabelMap
+   */
+  class ConstLineIterator
+  {
+  public:
+
+    ConstLineIterator():
+      m_Iterator(ITK_NULLPTR),
+      m_Begin(ITK_NULLPTR),
+      m_End(ITK_NULLPTR)
+    {}
+
+    ConstLineIterator(const Self *flat, const LabelType & label)
+    {
+      const SizeValueType slot = flat->GetSlot(label);
+      m_Begin = flat->GetLineBegin(slot);
+      m_End = flat->GetLineBegin(slot + 1);
+      m_Iterator = m_Begin;
+    }
+
+    const LineType & GetLine() const
+    {
+      return *m_Iterator;
+    }
+
+    ConstLineIterator operator++(int)
+    {
+      ConstLineIterator tmp = *this;
+      ++(*this);
+      return tmp;
+    }
+
+    ConstLineIterator & operator++()
+    {
+      ++m_Iterator;
+      return *this;
+    }
+
+    bool operator==(const ConstLineIterator & iter) const
+    {
+      return m_Iterator == iter.m_Iterator && m_Begin == iter.m_Begin && m_End == iter.m_End;
+    }
+
+    bool operator!=(const ConstLineIterator & iter) const
+    {
+      return !( *this == iter );
+    }
+
+    void GoToBegin()
+    {
+      m_Iterator = m_Begin;
+    }
+
+    bool IsAtEnd() const
+    {
+      return m_Iterator == m_End;
+    }
+
+  private:
+    const LineType *m_Iterator;
+    const LineType *m_Begin;
+    const LineType *m_End;
+  };
+
+  /** \class ConstIndexIterator
+   * \brief A forward iterator over the indexes of an object of a FlatLabelMap
+   * \ingroup ITKLabelMap
+   */
+  class ConstIndexIterator
+  {
+  public:
+
+    ConstIndexIterator():
+      m_Iterator(ITK_NULLPTR),
+      m_Begin(ITK_NULLPTR),
+      m_End(ITK_NULLPTR)
+    {
+      m_Index.Fill(0);
+    }
+
+    ConstIndexIterator(const Self *flat, const LabelType & label)
+    {
+      const SizeValueType slot = flat->GetSlot(label);
+      m_Begin = flat->GetLineBegin(slot);
+      m_End = flat->GetLineBegin(slot + 1);
+      GoToBegin();
+    }
+
+    const IndexType & GetIndex() const
+    {
+      return m_Index;
+    }
+
+    ConstIndexIterator & operator++()
+    {
+      m_Index[0]++;
+      if( m_Index[0] >= m_Iterator->GetIndex()[0] + (OffsetValueType)m_Iterator->GetLength() )
+        {
+        // we've reached the end of the line - go to the next one
+        ++m_Iterator;
+        NextValidLine();
+        }
+      return *this;
+    }
+
+    ConstIndexIterator operator++(int)
+    {
+      ConstIndexIterator tmp = *this;
+      ++(*this);
+      return tmp;
+    }
+
+    bool operator==(const ConstIndexIterator & iter) const
+    {
+      return m_Index == iter.m_Index && m_Iterator == iter.m_Iterator && m_Begin == iter.m_Begin && m_End == iter.m_End;
+    }
+
+    bool operator!=(const ConstIndexIterator & iter) const
+    {
+      return !( *this == iter );
+    }
+
+    void GoToBegin()
+    {
+      m_Iterator = m_Begin;
+      m_Index.Fill(0);
+      NextValidLine();
+    }
+
+    bool IsAtEnd() const
+    {
+      return m_Iterator == m_End;
+    }
+
+  private:
+    void NextValidLine()
+    {
+      // search for the next valid position
+      while( m_Iterator != m_End && m_Iterator->GetLength() == 0 )
+        {
+        ++m_Iterator;
+        }
+      if( m_Iterator != m_End )
+        {
+        m_Index = m_Iterator->GetIndex();
+        }
+    }
+
+    const LineType *m_Iterator;
+    const LineType *m_Begin;
+    const LineType *m_End;
+    IndexType       m_Index;
+  };
+
+protected:
+  FlatLabelMap() {}
+  ~FlatLabelMap() {}
+  virtual void PrintSelf(std::ostream & os, Indent indent) const ITK_OVERRIDE;
+
+private:
+  FlatLabelMap(const Self &);   //purposely not implemented
+  void operator=(const Self &); //purposely not implemented
+
+  typedef std::vector< LabelType >     LabelContainerType;
+  typedef std::vector< SizeValueType > OffsetContainerType;
+  typedef std::vector< LineType >      LineContainerType;
+
+  LabelContainerType  m_Labels;
+  OffsetContainerType m_LineOffsets;
+  LineContainerType   m_Lines;
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkFlatLabelMap.hxx"
+#endif
+
+#endif
@@ -0,0 +1,146 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkFlatLabelMap_hxx
+#define itkFlatLabelMap_hxx
+
+#include "itkFlatLabelMap.h"
+#include "itkLabelObjectLineComparator.h"
+#include "itkNumericTraits.h"
+#include <algorithm>
+
+namespace itk
+{
+template< typename TLabelMap >
+void
+FlatLabelMap< TLabelMap >
+::SetLabelMap(const LabelMapType *labelMap)
+{
+  this->Clear();
+
+  const SizeValueType numberOfLabelObjects = labelMap->GetNumberOfLabelObjects();
+  SizeValueType       numberOfLines = 0;
+  for ( typename LabelMapType::ConstIterator it(labelMap); !it.IsAtEnd(); ++it )
+    {
+    numberOfLines += it.GetLabelObject()->GetNumberOfLines();
+    }
+
+  m_Labels.reserve(numberOfLabelObjects);
+  m_LineOffsets.reserve(numberOfLabelObjects + 1);
+  m_Lines.reserve(numberOfLines);
+
+  // the label objects are visited in label order, so the slots are sorted
+  // by label
+  typename Functor::LabelObjectLineComparator< LineType > comparator;
+  m_LineOffsets.push_back(0);
+  for ( typename LabelMapType::ConstIterator it(labelMap); !it.IsAtEnd(); ++it )
+    {
+    const LabelObjectType *labelObject = it.GetLabelObject();
+    const SizeValueType    first = m_Lines.size();
+    for ( typename LabelObjectType::ConstLineIterator lit(labelObject); !lit.IsAtEnd(); ++lit )
+      {
+      m_Lines.push_back( lit.GetLine() );
+      }
+    std::sort(m_Lines.begin() + first, m_Lines.end(), comparator);
+
+    m_Labels.push_back( it.GetLabel() );
+    m_LineOffsets.push_back( m_Lines.size() );
+    }
+
+  this->Modified();
+}
+
+template< typename TLabelMap >
+void
+FlatLabelMap< TLabelMap >
+::UpdateLabelMap(LabelMapType *labelMap) const
+{
+  labelMap->ClearLabels();
+
+  for ( SizeValueType slot = 0; slot < m_Labels.size(); slot++ )
+    {
+    typename LabelObjectType::Pointer labelObject = LabelObjectType::New();
+    labelObject->SetLabel(m_Labels[slot]);
+    for ( SizeValueType i = m_LineOffsets[slot]; i < m_LineOffsets[slot + 1]; i++ )
+      {
+      labelObject->AddLine(m_Lines[i]);
+      }
+    labelMap->AddLabelObject(labelObject);
+    }
+}
+
+template< typename TLabelMap >
+void
+FlatLabelMap< TLabelMap >
+::Clear()
+{
+  m_Labels.clear();
+  m_LineOffsets.clear();
+  m_Lines.clear();
+  this->Modified();
+}
+
+template< typename TLabelMap >
+bool
+FlatLabelMap< TLabelMap >
+::HasLabel(const LabelType & label) const
+{
+  return std::binary_search(m_Labels.begin(), m_Labels.end(), label);
+}
+
+template< typename TLabelMap >
+typename FlatLabelMap< TLabelMap >::SizeValueType
+FlatLabelMap< TLabelMap >
+::GetSlot(const LabelType & label) const
+{
+  typename LabelContainerType::const_iterator it =
+    std::lower_bound(m_Labels.begin(), m_Labels.end(), label);
+  if ( it == m_Labels.end() || *it != label )
+    {
+    itkExceptionMacro(<< "No label object with label "
+                      << static_cast< typename NumericTraits< LabelType >::PrintType >( label )
+                      << ".");
+    }
+  return static_cast< SizeValueType >( it - m_Labels.begin() );
+}
+
+template< typename TLabelMap >
+typename FlatLabelMap< TLabelMap >::SizeValueType
+FlatLabelMap< TLabelMap >
+::GetNumberOfPixels(SizeValueType slot) const
+{
+  SizeValueType size = 0;
+  for ( SizeValueType i = m_LineOffsets[slot]; i < m_LineOffsets[slot + 1]; i++ )
+    {
+    size += m_Lines[i].GetLength();
+    }
+  return size;
+}
+
+template< typename TLabelMap >
+void
+FlatLabelMap< TLabelMap >
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "NumberOfLabelObjects: " << this->GetNumberOfLabelObjects() << std::endl;
+  os << indent << "NumberOfLines: " << this->GetNumberOfLines() << std::endl;
+}
+} // end namespace itk
+
+#endif
@@ -30,6 +30,8 @@
 
 #include "itkImageToImageFilter.h"
 #include "itkFastMutexLock.h"
+#include <vector>
+#include <utility>
 
 namespace itk
 {
@@ -42,6 +44,11 @@ namespace itk
  * With that class, the developer doesn't need to take care of iterating over all the objects in
  * the image, or to manage by hand the threads.
  *
+ * The label objects are collected in a vector before the threads start.
+ * When several threads are used, the largest objects come first, and the
+ * threads take the objects by chunks, so the lock shared by the threads is
+ * taken once per chunk rather than once per object.
+ *
  * \author Gaetan Lehmann. Biologie du Developpement et de la Reproduction, INRA de Jouy-en-Josas, France.
  *
  * This implementation was taken from the Insight Journal paper:
@@ -124,9 +131,20 @@ private:
   LabelMapFilter(const Self &); //purposely not implemented
   void operator=(const Self &); //purposely not implemented
 
-  typename InputImageType::Iterator m_LabelObjectIterator;
-  float                             m_InverseNumberOfLabelObjects;
-  SizeValueType                     m_NumberOfLabelObjectsProcessed;
+  typedef std::pair< SizeValueType, LabelObjectType * > SizedLabelObjectType;
+
+  static bool LargerLabelObject(const SizedLabelObjectType & a, const SizedLabelObjectType & b)
+  {
+    return a.first > b.first;
+  }
+
+  std::vector< LabelObjectType * > m_LabelObjects;
+  SizeValueType                    m_NextLabelObject;
+  SizeValueType                    m_LabelObjectChunkSize;
+  float                            m_InverseNumberOfLabelObjects;
+  // objects whose processing has returned, updated and read under
+  // m_LabelObjectContainerLock
+  SizeValueType                    m_NumberOfLabelObjectsProcessed;
 };
 } // end namespace itk
 
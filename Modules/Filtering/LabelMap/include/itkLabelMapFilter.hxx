@@ -29,12 +29,15 @@
 #define itkLabelMapFilter_hxx
 #include "itkLabelMapFilter.h"
 #include "itkMutexLockHolder.h"
+#include <algorithm>
 
 namespace itk
 {
 template< typename TInputImage, typename TOutputImage >
 LabelMapFilter< TInputImage, TOutputImage >
 ::LabelMapFilter():
+  m_NextLabelObject( 0 ),
+  m_LabelObjectChunkSize( 1 ),
   m_InverseNumberOfLabelObjects( 1.0f ),
   m_NumberOfLabelObjectsProcessed( 1 )
 {
@@ -76,14 +79,49 @@ void
 LabelMapFilter< TInputImage, TOutputImage >
 ::BeforeThreadedGenerateData()
 {
-  // initialize the iterator
-  m_LabelObjectIterator =  typename InputImageType::Iterator(this->GetLabelMap());
-//  m_LabelObjectIterator = typename InputImageType::Iterator(this->GetLabelMap());
+  InputImageType *    labelMap = this->GetLabelMap();
+  const SizeValueType numberOfLabelObjects = labelMap->GetNumberOfLabelObjects();
+  const ThreadIdType  numberOfThreads = this->GetNumberOfThreads();
+
+  // collect the objects, so the threads don't have to walk the map
+  m_LabelObjects.clear();
+  m_LabelObjects.reserve(numberOfLabelObjects);
+  if ( numberOfThreads > 1 )
+    {
+    // the largest objects go first, so they don't end up on a single thread
+    // at the end of the run
+    std::vector< SizedLabelObjectType > sizedLabelObjects;
+    sizedLabelObjects.reserve(numberOfLabelObjects);
+    for ( typename InputImageType::Iterator it(labelMap); !it.IsAtEnd(); ++it )
+      {
+      LabelObjectType *labelObject = it.GetLabelObject();
+      sizedLabelObjects.push_back( SizedLabelObjectType(labelObject->Size(), labelObject) );
+      }
+    std::stable_sort(sizedLabelObjects.begin(), sizedLabelObjects.end(), Self::LargerLabelObject);
+    for ( size_t i = 0; i < sizedLabelObjects.size(); i++ )
+      {
+      m_LabelObjects.push_back(sizedLabelObjects[i].second);
+      }
+    }
+  else
+    {
+    for ( typename InputImageType::Iterator it(labelMap); !it.IsAtEnd(); ++it )
+      {
+      m_LabelObjects.push_back( it.GetLabelObject() );
+      }
+    }
+
+  // a few dozen chunks per thread balance the load while keeping the lock
+  // rarely taken
+  m_LabelObjectChunkSize = numberOfLabelObjects / ( 32 * numberOfThreads );
+  m_LabelObjectChunkSize = std::max( m_LabelObjectChunkSize, static_cast< SizeValueType >( 1 ) );
+  m_LabelObjectChunkSize = std::min( m_LabelObjectChunkSize, static_cast< SizeValueType >( 1024 ) );
+  m_NextLabelObject = 0;
 
   // and the mutex
   m_LabelObjectContainerLock = FastMutexLock::New();
 
-  m_InverseNumberOfLabelObjects = 1.0f/this->GetLabelMap()->GetNumberOfLabelObjects();
+  m_InverseNumberOfLabelObjects = 1.0f/numberOfLabelObjects;
   m_NumberOfLabelObjectsProcessed = 0;
 }
 
@@ -92,6 +130,9 @@ void
 LabelMapFilter< TInputImage, TOutputImage >
 ::AfterThreadedGenerateData()
 {
+  // release the memory of the object list
+  std::vector< LabelObjectType * >().swap(m_LabelObjects);
+
   this->UpdateProgress(1.0);
 }
 
@@ -100,51 +141,59 @@ void
 LabelMapFilter< TInputImage, TOutputImage >
 ::ThreadedGenerateData( const OutputImageRegionType &, ThreadIdType threadId )
 {
+  // the objects of the previous chunk, counted once they are all processed
+  SizeValueType numberOfProcessedInChunk = 0;
+
   while ( true )
     {
-    LabelObjectType *labelObject;
+    SizeValueType begin;
+    SizeValueType end;
+    SizeValueType numberOfLabelObjectsProcessed;
     // begin mutex lock
     {
     MutexLockHolder< FastMutexLock > lock(*m_LabelObjectContainerLock );
 
-    if ( m_LabelObjectIterator.IsAtEnd() )
+    m_NumberOfLabelObjectsProcessed += numberOfProcessedInChunk;
+    numberOfLabelObjectsProcessed = m_NumberOfLabelObjectsProcessed;
+
+    if ( m_NextLabelObject >= m_LabelObjects.size() )
       {
       // mutex lock holder deleted
       return;
       }
 
-    // get the label object
-    labelObject = m_LabelObjectIterator.GetLabelObject();
+    // take the next chunk of objects. The object pointers are kept in
+    // m_LabelObjects, so an object removed from the map by
+    // ThreadedProcessLabelObject() doesn't invalidate the others.
+    begin = m_NextLabelObject;
+    end = std::min( begin + m_LabelObjectChunkSize, static_cast< SizeValueType >( m_LabelObjects.size() ) );
+    m_NextLabelObject = end;
 
-    // increment the iterator now, so it will not be invalidated if the object
-    // is destroyed
-    ++m_LabelObjectIterator;
-    ++m_NumberOfLabelObjectsProcessed;
-
-    // unlock the mutex, so the other threads can get an object
+    // unlock the mutex, so the other threads can get a chunk
     }
     // end mutex lock
 
-
-    // and run the user defined method for that object
-    this->ThreadedProcessLabelObject(labelObject);
-
-    if (threadId==0)
+    if ( threadId == 0 )
       {
-      const float progress = m_InverseNumberOfLabelObjects*m_NumberOfLabelObjectsProcessed;
-      this->UpdateProgress(progress);
+      this->UpdateProgress( m_InverseNumberOfLabelObjects * numberOfLabelObjectsProcessed );
       }
 
-    // all threads needs to check the abort flag
-    if ( this->GetAbortGenerateData() )
+    for ( SizeValueType i = begin; i < end; i++ )
       {
-      std::string    msg;
-      ProcessAborted e(__FILE__, __LINE__);
-      msg += "Object " + std::string(this->GetNameOfClass() ) + ": AbortGenerateDataOn";
-      e.SetDescription(msg);
-      throw e;
+      // and run the user defined method for that object
+      this->ThreadedProcessLabelObject(m_LabelObjects[i]);
+
+      // all threads needs to check the abort flag
+      if ( this->GetAbortGenerateData() )
+        {
+        std::string    msg;
+        ProcessAborted e(__FILE__, __LINE__);
+        msg += "Object " + std::string(this->GetNameOfClass() ) + ": AbortGenerateDataOn";
+        e.SetDescription(msg);
+        throw e;
+        }
       }
-
+    numberOfProcessedInChunk = end - begin;
     }
 }
 
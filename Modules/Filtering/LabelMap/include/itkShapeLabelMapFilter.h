@@ -19,6 +19,7 @@
 #define itkShapeLabelMapFilter_h
 
 #include "itkInPlaceLabelMapFilter.h"
+#include <vector>
 
 namespace itk
 {
@@ -28,15 +29,14 @@ namespace itk
  * ShapeLabelMapFilter can be used to set the attributes values of the
  * ShapeLabelObject in a LabelMap.
  *
- * ShapeLabelMapFilter takes an optional parameter, used only to
- * optimize the computation time and the memory usage when the
- * perimeter or the feret diameter is used: the exact copy of the
- * input LabelMap is stored in an Image.
- * It can be set with SetLabelImage(). It is cleared at the end of the
- * computation, so must be reset before running Update() again. It is
- * not part of the pipeline management design, to let the subclasses
- * of ShapeLabelMapFilter use the pipeline design to specify truly
- * required inputs.
+ * The Feret diameter is computed from the lines of the objects only: the
+ * farthest pixels of an object are among the ends of its lines, and
+ * among the vertices of their convex hull in each plane of the first two
+ * axes. In 2D, the diameter of the hull is found by rotating calipers.
+ *
+ * ShapeLabelMapFilter used to take a copy of the input LabelMap stored in
+ * an Image to compute the Feret diameter. That image is not needed
+ * anymore, and SetLabelImage() is kept only for backward compatibility.
  *
  * \author Gaetan Lehmann. Biologie du Developpement et de la Reproduction, INRA de Jouy-en-Josas, France.
  *
@@ -115,7 +115,7 @@ public:
   itkGetConstReferenceMacro(ComputePerimeter, bool);
   itkBooleanMacro(ComputePerimeter);
 
-  /** Set the label image */
+  /** Set the label image. It is not used anymore. */
   void SetLabelImage(const TLabelImage *input)
   {
     m_LabelImage = input;
@@ -144,6 +144,43 @@ private:
   void ComputeFeretDiameter(LabelObjectType *labelObject);
   void ComputePerimeter(LabelObjectType *labelObject);
 
+  typedef typename ImageType::SpacingType SpacingType;
+  typedef std::vector< IndexType >        IndexListType;
+
+  /** Orders the indexes by plane of the first two axes, and by the first
+   * then the second coordinate inside a plane. */
+  struct PlaneIndexCompare
+    {
+    bool operator()(const IndexType & a, const IndexType & b) const
+    {
+      for ( int i = ImageDimension - 1; i >= 2; i-- )
+        {
+        if ( a[i] != b[i] )
+          {
+          return a[i] < b[i];
+          }
+        }
+      for ( unsigned int i = 0; i < 2 && i < ImageDimension; i++ )
+        {
+        if ( a[i] != b[i] )
+          {
+          return a[i] < b[i];
+          }
+        }
+      return false;
+    }
+    };
+
+  /** Appends to hull the vertices, in counterclockwise order, of the
+   * convex hull of the indexes in [begin, end) in the plane of the first
+   * two axes. The indexes must be in the same plane, sorted with
+   * PlaneIndexCompare and without duplicates. */
+  static void PlaneConvexHull(typename IndexListType::const_iterator begin,
+                              typename IndexListType::const_iterator end,
+                              IndexListType & hull);
+
+  static double SquaredDistance(const IndexType & a, const IndexType & b, const SpacingType & spacing);
+
   typedef itk::Offset<2>                                                          Offset2Type;
   typedef itk::Offset<3>                                                          Offset3Type;
   typedef itk::Vector<double, 2>                                                  Spacing2Type;
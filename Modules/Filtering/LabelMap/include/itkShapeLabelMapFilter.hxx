@@ -29,7 +29,7 @@
 #include "vnl/algo/vnl_real_eigensystem.h"
 #include "vnl/algo/vnl_symmetric_eigensystem.h"
 #include "vnl/vnl_math.h"
-#include <deque>
+#include <algorithm>
 #include <map>
 
 namespace itk
@@ -48,22 +48,6 @@ ShapeLabelMapFilter< TImage, TLabelImage >
 ::BeforeThreadedGenerateData()
 {
   Superclass::BeforeThreadedGenerateData();
-
-  // Generate the label image, if needed
-  if ( m_ComputeFeretDiameter )
-    {
-    if ( !m_LabelImage )
-      {
-      // generate an image of the labelized image
-      typedef LabelMapToLabelImageFilter< TImage, LabelImageType > LCI2IType;
-      typename LCI2IType::Pointer lci2i = LCI2IType::New();
-      lci2i->SetInput( this->GetOutput() );
-      // Respect the number of threads of the filter
-      lci2i->SetNumberOfThreads( this->GetNumberOfThreads() );
-      lci2i->Update();
-      m_LabelImage = lci2i->GetOutput();
-      }
-    }
 }
 
 template< typename TImage, typename TLabelImage >
@@ -382,45 +366,134 @@ ShapeLabelMapFilter< TImage, TLabelImage >
     }
 }
 
+template< typename TImage, typename TLabelImage >
+double
+ShapeLabelMapFilter< TImage, TLabelImage >
+::SquaredDistance(const IndexType & a, const IndexType & b, const SpacingType & spacing)
+{
+  double length = 0;
+  for ( unsigned int i = 0; i < ImageDimension; i++ )
+    {
+    const OffsetValueType indexDifference = ( a[i] - b[i] );
+    length += std::pow(indexDifference * spacing[i], 2);
+    }
+  return length;
+}
+
 template< typename TImage, typename TLabelImage >
 void
 ShapeLabelMapFilter< TImage, TLabelImage >
-::ComputeFeretDiameter(LabelObjectType *labelObject)
+::PlaneConvexHull(typename IndexListType::const_iterator begin,
+                  typename IndexListType::const_iterator end,
+                  IndexListType & hull)
 {
-  const LabelPixelType & label = labelObject->GetLabel();
+  // Andrew's monotone chain. The cross products are computed with doubles,
+  // which are exact for the index values found in images.
+  const SizeValueType numberOfIndexes = end - begin;
+  if ( numberOfIndexes < 3 )
+    {
+    hull.insert(hull.end(), begin, end);
+    return;
+    }
 
-  typedef typename std::deque< IndexType > IndexListType;
-  IndexListType idxList;
+  const SizeValueType first = hull.size();
+  hull.resize( first + 2 * numberOfIndexes );
+  SizeValueType k = first;
 
-  typedef typename itk::ConstNeighborhoodIterator< LabelImageType > NeighborIteratorType;
-  SizeType neighborHoodRadius;
-  neighborHoodRadius.Fill(1);
-  NeighborIteratorType                        it( neighborHoodRadius, m_LabelImage, m_LabelImage->GetBufferedRegion() );
-  ConstantBoundaryCondition< LabelImageType > lcbc;
-  // Use label + 1 to have a label different of the current label on the border
-  lcbc.SetConstant(label + 1);
-  it.OverrideBoundaryCondition(&lcbc);
-  it.GoToBegin();
-
-  typedef typename NeighborIteratorType::NeighborIndexType   NeighborIndexType;
-
-  // Iterate over all the indexes
-  typename LabelObjectType::ConstIndexIterator iit( labelObject );
-  while( ! iit.IsAtEnd() )
+  // lower hull, then upper hull
+  for ( int pass = 0; pass < 2; pass++ )
     {
-    // Move the iterator to the new location
-    it += iit.GetIndex() - it.GetIndex();
+    const SizeValueType start = k;
+    for ( SizeValueType n = 0; n < numberOfIndexes; n++ )
+      {
+      const IndexType & idx = pass == 0 ? begin[n] : begin[numberOfIndexes - 1 - n];
+      if ( pass == 1 && n == 0 )
+        {
+        // the last index is already in the lower hull
+        continue;
+        }
+      while ( k >= start + ( pass == 0 ? 2 : 1 ) )
+        {
+        const IndexType & o = hull[k - 2];
+        const IndexType & a = hull[k - 1];
+        const double cross = static_cast< double >( a[0] - o[0] ) * static_cast< double >( idx[1] - o[1] )
+                             - static_cast< double >( a[1] - o[1] ) * static_cast< double >( idx[0] - o[0] );
+        if ( cross > 0 )
+          {
+          break;
+          }
+        --k;
+        }
+      hull[k++] = idx;
+      }
+    }
 
-    // Push the pixel in the list if it is on the border of the object
-    for ( NeighborIndexType i = 0; i < it.Size(); i++ )
+  // the first index has been added again at the end of the upper hull
+  hull.resize(k - 1);
+}
+
+template< typename TImage, typename TLabelImage >
+void
+ShapeLabelMapFilter< TImage, TLabelImage >
+::ComputeFeretDiameter(LabelObjectType *labelObject)
+{
+  // The farthest pixels of the object are extreme points of the object:
+  // they are not between two other pixels of the object. Only the ends of
+  // the lines can be extreme points, so they are the only candidates.
+  IndexListType idxList;
+  idxList.reserve( 2 * labelObject->GetNumberOfLines() );
+  typename LabelObjectType::ConstLineIterator lit( labelObject );
+  while( ! lit.IsAtEnd() )
+    {
+    const typename LabelObjectType::LineType & line = lit.GetLine();
+    if ( line.GetLength() > 0 )
+      {
+      IndexType idx = line.GetIndex();
+      idxList.push_back(idx);
+      idx[0] += line.GetLength() - 1;
+      idxList.push_back(idx);
+      }
+    ++lit;
+    }
+
+  std::sort( idxList.begin(), idxList.end(), PlaneIndexCompare() );
+  idxList.erase( std::unique( idxList.begin(), idxList.end() ), idxList.end() );
+
+  // An extreme point of the object is also an extreme point of its
+  // intersection with the plane of the first two axes going through it,
+  // so the candidates are reduced to the convex hull of each plane.
+  IndexListType hull;
+  if ( ImageDimension >= 2 )
+    {
+    hull.reserve( idxList.size() );
+    typename IndexListType::const_iterator planeBegin = idxList.begin();
+    while ( planeBegin != idxList.end() )
       {
-      if ( it.GetPixel(i) != label )
+      typename IndexListType::const_iterator planeEnd = planeBegin + 1;
+      while ( planeEnd != idxList.end() )
         {
-        idxList.push_back( iit.GetIndex() );
-        break;
+        bool samePlane = true;
+        for ( unsigned int i = 2; i < ImageDimension; i++ )
+          {
+          if ( ( *planeEnd )[i] != ( *planeBegin )[i] )
+            {
+            samePlane = false;
+            break;
+            }
+          }
+        if ( !samePlane )
+          {
+          break;
+          }
+        ++planeEnd;
         }
+      this->PlaneConvexHull(planeBegin, planeEnd, hull);
+      planeBegin = planeEnd;
       }
-    ++iit;
+    }
+  else
+    {
+    hull.swap(idxList);
     }
 
   ImageType *output = this->GetOutput();
@@ -429,23 +502,49 @@ ShapeLabelMapFilter< TImage, TLabelImage >
 
   // We can now search the feret diameter
   double feretDiameter = 0;
-  for ( typename IndexListType::const_iterator iIt1 = idxList.begin();
-        iIt1 != idxList.end();
-        iIt1++ )
+  const SizeValueType numberOfVertices = hull.size();
+  if ( ImageDimension == 2 && numberOfVertices > 2 )
     {
-    typename IndexListType::const_iterator iIt2 = iIt1;
-    for ( iIt2++; iIt2 != idxList.end(); iIt2++ )
+    // Rotating calipers: for each edge of the hull, the farthest vertex
+    // from the edge is antipodal to both ends of the edge, and the
+    // diameter is reached between two antipodal vertices. Being antipodal
+    // doesn't depend on the spacing, so the vertices are walked in index
+    // space.
+    SizeValueType j = 1;
+    for ( SizeValueType i = 0; i < numberOfVertices; i++ )
       {
-      // Compute the length between the 2 indexes
-      double length = 0;
-      for ( unsigned int i = 0; i < ImageDimension; i++ )
+      const IndexType & a = hull[i];
+      const IndexType & b = hull[( i + 1 ) % numberOfVertices];
+      while ( true )
         {
-        const OffsetValueType indexDifference = ( iIt1->operator[](i) - iIt2->operator[](i) );
-        length += std::pow(indexDifference * spacing[i], 2);
+        const IndexType & c = hull[j];
+        const IndexType & d = hull[( j + 1 ) % numberOfVertices];
+        // compare the distances of c and d to the line (a, b)
+        const double areaC = static_cast< double >( b[0] - a[0] ) * static_cast< double >( c[1] - a[1] )
+                             - static_cast< double >( b[1] - a[1] ) * static_cast< double >( c[0] - a[0] );
+        const double areaD = static_cast< double >( b[0] - a[0] ) * static_cast< double >( d[1] - a[1] )
+                             - static_cast< double >( b[1] - a[1] ) * static_cast< double >( d[0] - a[0] );
+        if ( areaD <= areaC )
+          {
+          break;
+          }
+        j = ( j + 1 ) % numberOfVertices;
         }
-      if ( feretDiameter < length )
+      feretDiameter = std::max( feretDiameter, Self::SquaredDistance(a, hull[j], spacing) );
+      feretDiameter = std::max( feretDiameter, Self::SquaredDistance(b, hull[j], spacing) );
+      }
+    }
+  else
+    {
+    for ( SizeValueType i = 0; i < numberOfVertices; i++ )
+      {
+      for ( SizeValueType j = i + 1; j < numberOfVertices; j++ )
         {
-        feretDiameter = length;
+        const double length = Self::SquaredDistance(hull[i], hull[j], spacing);
+        if ( feretDiameter < length )
+          {
+          feretDiameter = length;
+          }
         }
       }
     }
@@ -462,7 +561,7 @@ ShapeLabelMapFilter< TImage, TLabelImage >
 ::ComputePerimeter(LabelObjectType *labelObject)
 {
   // store the lines in a N-1D image of vectors
-  typedef std::deque< typename LabelObjectType::LineType > VectorLineType;
+  typedef std::vector< typename LabelObjectType::LineType > VectorLineType;
   typedef itk::Image< VectorLineType, ImageDimension - 1 > LineImageType;
   typename LineImageType::Pointer lineImage = LineImageType::New();
   typename LineImageType::IndexType lIdx;
@@ -0,0 +1,173 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include <iostream>
+#include "itkLabelMap.h"
+#include "itkLabelObject.h"
+#include "itkFlatLabelMap.h"
+
+int itkFlatLabelMapTest(int argc, char * argv[])
+{
+  if( argc != 1 )
+    {
+    std::cerr << "usage: " << argv[0] << "" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  const unsigned int dim = 2;
+
+  typedef itk::LabelObject< unsigned long, dim > LabelObjectType;
+  typedef LabelObjectType::IndexType             IndexType;
+  typedef itk::LabelMap< LabelObjectType >       LabelMapType;
+  typedef itk::FlatLabelMap< LabelMapType >      FlatLabelMapType;
+
+  LabelMapType::Pointer map = LabelMapType::New();
+  LabelMapType::SizeType size;
+  size.Fill(20);
+  map->SetRegions( size );
+  map->Allocate();
+
+  // label 7 is added first, and its lines are not in index order
+  IndexType idx;
+  idx[0] = 2;
+  idx[1] = 5;
+  map->SetLine( idx, 3, 7 );
+  idx[0] = 1;
+  idx[1] = 4;
+  map->SetLine( idx, 2, 7 );
+  idx[0] = 10;
+  idx[1] = 10;
+  map->SetLine( idx, 4, 3 );
+  idx[0] = 0;
+  idx[1] = 19;
+  map->SetPixel( idx, 12 );
+
+  FlatLabelMapType::Pointer flat = FlatLabelMapType::New();
+  flat->SetLabelMap( map );
+  flat->Print( std::cout );
+
+  if( flat->GetNumberOfLabelObjects() != 3 || flat->GetNumberOfLines() != 4 )
+    {
+    std::cerr << "Wrong number of objects or lines." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // the slots are sorted by label
+  if( flat->GetLabel(0) != 3 || flat->GetLabel(1) != 7 || flat->GetLabel(2) != 12 )
+    {
+    std::cerr << "The labels are not sorted." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  if( !flat->HasLabel(7) || flat->HasLabel(5) || flat->GetSlot(12) != 2 )
+    {
+    std::cerr << "Wrong label lookup." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // the lines of an object are sorted by index
+  if( flat->GetNumberOfLines(1) != 2 || flat->GetLine(1, 0).GetIndex()[1] != 4
+    || flat->GetNumberOfPixels(1) != 5 )
+    {
+    std::cerr << "Wrong lines for label 7." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // the iterators give the same pixels as the label objects
+  for( LabelMapType::ConstIterator it( map ); !it.IsAtEnd(); ++it )
+    {
+    const LabelObjectType * lo = it.GetLabelObject();
+    FlatLabelMapType::ConstIndexIterator fit( flat, it.GetLabel() );
+    itk::SizeValueType count = 0;
+    while( !fit.IsAtEnd() )
+      {
+      if( map->GetPixel( fit.GetIndex() ) != it.GetLabel() )
+        {
+        std::cerr << "Wrong index " << fit.GetIndex() << " for label " << it.GetLabel() << std::endl;
+        return EXIT_FAILURE;
+        }
+      ++count;
+      ++fit;
+      }
+    if( count != lo->Size() )
+      {
+      std::cerr << "Wrong number of indexes for label " << it.GetLabel() << std::endl;
+      return EXIT_FAILURE;
+      }
+
+    itk::SizeValueType lines = 0;
+    for( FlatLabelMapType::ConstLineIterator lit( flat, it.GetLabel() ); !lit.IsAtEnd(); ++lit )
+      {
+      ++lines;
+      }
+    if( lines != lo->GetNumberOfLines() )
+      {
+      std::cerr << "Wrong number of lines for label " << it.GetLabel() << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  // an unknown label throws
+  bool caught = false;
+  try
+    {
+    flat->GetSlot(5);
+    }
+  catch( itk::ExceptionObject & excp )
+    {
+    std::cout << "Caught expected exception: " << excp.GetDescription() << std::endl;
+    caught = true;
+    }
+  if( !caught )
+    {
+    std::cerr << "No exception for an unknown label." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // back to a label map
+  LabelMapType::Pointer map2 = LabelMapType::New();
+  map2->SetRegions( size );
+  map2->Allocate();
+  flat->UpdateLabelMap( map2 );
+
+  if( map2->GetNumberOfLabelObjects() != map->GetNumberOfLabelObjects() )
+    {
+    std::cerr << "Wrong number of objects after conversion." << std::endl;
+    return EXIT_FAILURE;
+    }
+  for( LabelMapType::ConstIterator it( map ); !it.IsAtEnd(); ++it )
+    {
+    for( LabelObjectType::ConstIndexIterator iit( it.GetLabelObject() ); !iit.IsAtEnd(); ++iit )
+      {
+      if( map2->GetPixel( iit.GetIndex() ) != it.GetLabel() )
+        {
+        std::cerr << "Wrong pixel after conversion at " << iit.GetIndex() << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+    }
+
+  flat->Clear();
+  if( flat->GetNumberOfLabelObjects() != 0 || flat->GetNumberOfLines() != 0 )
+    {
+    std::cerr << "Clear() did not remove the content." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
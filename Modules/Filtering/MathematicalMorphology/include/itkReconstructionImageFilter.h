@@ -23,6 +23,7 @@
 #include "itkImageRegionIterator.h"
 #include "itkProgressReporter.h"
 #include <queue>
+#include <vector>
 
 //#define BASIC
 #define COPY
@@ -43,6 +44,12 @@ namespace itk
  * applications and efficient algorithms" -- IEEE Transactions on
  * Image processing, Vol 2, No 2, pp 176-201, April 1993
  *
+ * The raster and antiraster steps are run concurrently on pieces of the
+ * image, each piece ignoring its neighbors. The pixels along the cuts are
+ * then checked against their full neighborhood before the FIFO step, which
+ * completes the propagation across the pieces. As the reconstruction is
+ * unique, the output does not depend on the number of threads.
+ *
  * \author Richard Beare. Department of Medicine, Monash University,
  * Melbourne, Australia.
  *
@@ -151,6 +158,10 @@ protected:
 
   void GenerateData() ITK_OVERRIDE;
 
+  /** Run the raster and antiraster steps on a piece of the image. */
+  void ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
+                            ThreadIdType threadId) ITK_OVERRIDE;
+
   /**
    * the value of the border - used in boundary condition.
    */
@@ -163,18 +174,43 @@ private:
   bool m_FullyConnected;
   bool m_UseInternalCopy;
 
-  typedef typename itk::NeighborhoodAlgorithm::ImageBoundaryFacesCalculator< OutputImageType > FaceCalculatorType;
-
-  typedef typename FaceCalculatorType::FaceListType           FaceListType;
-  typedef typename FaceCalculatorType::FaceListType::iterator FaceListTypeIt;
-
   typedef ImageRegionConstIterator< InputImageType > InputIteratorType;
   typedef ImageRegionIterator< OutputImageType >     OutputIteratorType;
 
   typedef typename OutputImageType::IndexType               OutIndexType;
   typedef typename InputImageType::IndexType                InIndexType;
-  typedef ConstShapedNeighborhoodIterator< InputImageType > CNInputIterator;
+  typedef typename InputImageType::OffsetType               InOffsetType;
   typedef ShapedNeighborhoodIterator< OutputImageType >     NOutputIterator;
+
+  typedef std::vector< InOffsetType >    NeighborOffsetsType;
+  typedef std::vector< OffsetValueType > NeighborBufferOffsetsType;
+  typedef std::vector< OffsetValueType > BufferOffsetsType;
+
+  /** Collect the offsets activated on \a it, both as neighborhood offsets
+   * and as offsets in the buffer of the working marker image. */
+  void GetActiveOffsets(const NOutputIterator & it,
+                        NeighborOffsetsType & offsets,
+                        NeighborBufferOffsetsType & bufferOffsets) const;
+
+  /** Whether some neighbors of the pixel at \a index lie outside \a region,
+   * ignoring the dimensions below \a firstDimension. */
+  static bool IsOnRegionBorder(const OutputImageRegionType & region, const InIndexType & index,
+                               unsigned int firstDimension = 0);
+
+  /** Index of the first pixel of the line number \a line of \a region, the
+   * lines being along the first dimension and counted in raster order. */
+  static InIndexType GetLineStart(const OutputImageRegionType & region, SizeValueType line);
+
+  // The marker being reconstructed and the mask, possibly padded copies of
+  // the inputs, shared with ThreadedGenerateData(). Both have the same
+  // buffered region, so a pixel has the same offset in the two buffers.
+  MarkerImagePointer    m_WorkingMarkerImage;
+  MaskImageConstPointer m_WorkingMaskImage;
+
+  // pixels queued for the FIFO step by each thread, and whether a thread
+  // found a marker pixel beyond its mask pixel
+  std::vector< BufferOffsetsType > m_ThreadQueues;
+  std::vector< unsigned char >     m_ThreadFoundInvalidMarker;
 }; // end of class
 } // end namespace itk
 
@@ -19,8 +19,8 @@
 #define itkReconstructionImageFilter_hxx
 
 #include "itkReconstructionImageFilter.h"
-#include "itkConstantBoundaryCondition.h"
 #include "itkConnectedComponentAlgorithm.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
 
 #include "itkConstantPadImageFilter.h"
 #include "itkCropImageFilter.h"
@@ -106,11 +106,6 @@ ReconstructionImageFilter< TInputImage, TOutputImage, TCompare >
 {
   // Allocate the output
   this->AllocateOutputs();
-  // there are 2 passes that use all pixels and a 3rd that uses some
-  // subset of the pixels. We'll just pretend that the third pass
-  // takes the same as each of the others. Is it OK to update more
-  // often than pixels?
-  ProgressReporter progress(this, 0, this->GetOutput()->GetRequestedRegion().GetNumberOfPixels() * 3);
 
   TCompare compare;
 
@@ -127,9 +122,6 @@ ReconstructionImageFilter< TInputImage, TOutputImage, TCompare >
   // create padded versions of the marker image and the mask image
   typedef typename itk::ConstantPadImageFilter< InputImageType, InputImageType > PadType;
 
-  MarkerImageConstPointer markerImageP;
-  MaskImageConstPointer   maskImageP;
-
   ISizeType padSize;
 
   if ( m_UseInternalCopy )
@@ -150,12 +142,12 @@ ReconstructionImageFilter< TInputImage, TOutputImage, TCompare >
     MaskPad->Update();
     MarkerPad->Update();
 
-    markerImageP = MarkerPad->GetOutput();
-    maskImageP = MaskPad->GetOutput();
+    m_WorkingMarkerImage = MarkerPad->GetOutput();
+    m_WorkingMaskImage = MaskPad->GetOutput();
     }
   else
     {
-    maskImageP = this->GetMaskImage();
+    m_WorkingMaskImage = this->GetMaskImage();
     InputIteratorType inIt( markerImage,
                             output->GetRequestedRegion() );
     OutputIteratorType outIt( output,
@@ -168,75 +160,36 @@ ReconstructionImageFilter< TInputImage, TOutputImage, TCompare >
       ++inIt;
       ++outIt;
       }
-    markerImageP = output;
+    m_WorkingMarkerImage = output;
     }
 
-  // declare our queue type
-  typedef typename std::queue< OutputImageIndexType > FifoType;
-  FifoType IndexFifo;
+  // The padding, like the pixels outside of the image, holds m_MarkerValue
+  // in both the marker and the mask. Such a neighbor can neither raise a
+  // pixel nor be raised, so only the pixels of the requested region are
+  // processed and the neighbors outside of it are skipped.
+  const OutputImageRegionType region = output->GetRequestedRegion();
 
-  NOutputIterator   outNIt;
-  InputIteratorType mskIt;
-  CNInputIterator   mskNIt;
-  ISizeType         kernelRadius;
-  kernelRadius.Fill(1);
-  if ( m_UseInternalCopy )
-    {
-    FaceCalculatorType faceCalculator;
-
-    FaceListType   faceList;
-    FaceListTypeIt fit;
-
-    faceList = faceCalculator(maskImageP, maskImageP->GetLargestPossibleRegion(),
-                              kernelRadius);
-    // we will only be processing the body region
-    fit = faceList.begin();
-    // must be a better way of doing this
-    NOutputIterator tt(kernelRadius,
-                       markerImageP,
-                       *fit);
-    outNIt = tt;
-
-    InputIteratorType ttt(maskImageP,
-                          *fit);
-    mskIt = ttt;
-    CNInputIterator tttt(kernelRadius,
-                         maskImageP,
-                         *fit);
-    mskNIt = tttt;
-    }
-  else
-    {
-    NOutputIterator tt( kernelRadius,
-                        markerImageP,
-                        output->GetRequestedRegion() );
-    outNIt = tt;
-
-    InputIteratorType ttt( maskImageP,
-                           output->GetRequestedRegion() );
-    mskIt = ttt;
-    CNInputIterator tttt( kernelRadius,
-                          maskImageP,
-                          output->GetRequestedRegion() );
-    mskNIt = tttt;
-    }
+  // raster and antiraster steps, run on pieces of the region
+  const ThreadIdType numberOfThreads = this->GetNumberOfThreads();
+  m_ThreadQueues.assign( numberOfThreads, BufferOffsetsType() );
+  m_ThreadFoundInvalidMarker.assign( numberOfThreads, 0 );
 
-  setConnectivityPrevious(&outNIt, m_FullyConnected);
+  typename ImageSource< OutputImageType >::ThreadStruct str;
+  str.Filter = this;
 
-  ConstantBoundaryCondition< OutputImageType > oBC;
-  oBC.SetConstant(m_MarkerValue);
-  outNIt.OverrideBoundaryCondition(&oBC);
+  MultiThreader *multiThreader = this->GetMultiThreader();
+  multiThreader->SetNumberOfThreads(numberOfThreads);
+  multiThreader->SetSingleMethod(this->ThreaderCallback, &str);
+  multiThreader->SingleMethodExecute();
 
-  mskIt.GoToBegin();
-  // scan in forward raster order
-  for ( outNIt.GoToBegin(), mskIt.GoToBegin(); !outNIt.IsAtEnd(); ++outNIt, ++mskIt )
+  // be sure that the pixels in the images follow the preconditions
+  for ( ThreadIdType t = 0; t < numberOfThreads; ++t )
     {
-    InputImagePixelType V = outNIt.GetCenterPixel();
-    InputImagePixelType iV = static_cast< OutputImagePixelType >( mskIt.Get() );
-
-    // be sure that the pixels in the images follow the preconditions
-    if ( compare(V, iV) )
+    if ( m_ThreadFoundInvalidMarker[t] )
       {
+      m_ThreadQueues.clear();
+      m_WorkingMarkerImage = ITK_NULLPTR;
+      m_WorkingMaskImage = ITK_NULLPTR;
       if ( compare(0, 1) )
         {
         itkExceptionMacro(<< "Marker pixels must be <= mask pixels.");
@@ -246,125 +199,114 @@ ReconstructionImageFilter< TInputImage, TOutputImage, TCompare >
         itkExceptionMacro(<< "Marker pixels must be >= mask pixels.");
         }
       }
-
-    // visit the previous neighbours
-    typename NOutputIterator::ConstIterator sIt;
-    for ( sIt = outNIt.Begin(); !sIt.IsAtEnd(); ++sIt )
-      {
-      InputImagePixelType VN = sIt.Get();
-      if ( compare(VN, V) )
-        {
-        outNIt.SetCenterPixel(VN);
-        V = VN;
-        }
-      }
-
-    // this step clamps to the mask
-    if ( compare(V, iV) )
-      {
-      outNIt.SetCenterPixel(iV);
-      }
-
-    progress.CompletedPixel();
     }
 
-  // now for the reverse raster order pass
-  // reset the neighborhood
-  setConnectivityLater(&outNIt, m_FullyConnected);
-  outNIt.OverrideBoundaryCondition(&oBC);
-  outNIt.GoToEnd();
-  //mskIt.GoToEnd();
-
-  ConstantBoundaryCondition< InputImageType > iBC;
-  iBC.SetConstant(m_MarkerValue);
-
-  setConnectivityLater(&mskNIt, m_FullyConnected);
-  mskNIt.OverrideBoundaryCondition(&iBC);
-
-  typename NOutputIterator::IndexListType oIndexList, mIndexList;
-  typename NOutputIterator::IndexListType::const_iterator oLIt, mLIt;
+  OutputImagePixelType *     markerBuffer = m_WorkingMarkerImage->GetBufferPointer();
+  const InputImagePixelType *maskBuffer = m_WorkingMaskImage->GetBufferPointer();
 
-  oIndexList = outNIt.GetActiveIndexList();
-  mIndexList = mskNIt.GetActiveIndexList();
+  // Now we want to check the full neighborhood
+  NeighborOffsetsType       offsets;
+  NeighborBufferOffsetsType bufferOffsets;
+  {
+  ISizeType kernelRadius;
+  kernelRadius.Fill(1);
+  NOutputIterator outNIt(kernelRadius, m_WorkingMarkerImage, region);
+  setConnectivity(&outNIt, m_FullyConnected);
+  this->GetActiveOffsets(outNIt, offsets, bufferOffsets);
+  }
+  const unsigned int numberOfNeighbors = static_cast< unsigned int >( offsets.size() );
 
-  mskNIt.GoToEnd();
-  while ( !outNIt.IsAtBegin() )
+  // declare our queue type
+  typedef typename std::deque< OffsetValueType > FifoType;
+  FifoType IndexFifo;
+  for ( ThreadIdType t = 0; t < numberOfThreads; ++t )
     {
-    --outNIt;
-    --mskNIt;
-    InputImagePixelType V = outNIt.GetCenterPixel();
-    typename NOutputIterator::ConstIterator sIt;
-    for ( sIt = outNIt.Begin(); !sIt.IsAtEnd(); ++sIt )
-      {
-      InputImagePixelType VN = sIt.Get();
-      if ( compare(VN, V) )
-        {
-        outNIt.SetCenterPixel(VN);
-        V = VN;
-        }
-      }
-    InputImagePixelType iV = mskNIt.GetCenterPixel();
-    if ( compare(V, iV) )
-      {
-      outNIt.SetCenterPixel(iV);
-      V = iV;
-      }
-
-    // now put indexes in the fifo
-    //typename CNInputIterator::ConstIterator mIt;
-    for ( oLIt = oIndexList.begin(), mLIt = mIndexList.begin(); oLIt != oIndexList.end(); ++oLIt, ++mLIt )
+    IndexFifo.insert( IndexFifo.end(), m_ThreadQueues[t].begin(), m_ThreadQueues[t].end() );
+    }
+  m_ThreadQueues.clear();
+
+  // The pieces ignored each other, so the pixels along a cut between two
+  // pieces may not have been propagated across it. Queue those which can
+  // still raise a neighbor.
+  const unsigned int numberOfPieces =
+    this->GetImageRegionSplitter()->GetNumberOfSplits( region, multiThreader->GetNumberOfThreads() );
+  for ( unsigned int i = 0; i < numberOfPieces && numberOfPieces > 1; ++i )
+    {
+    OutputImageRegionType piece;
+    this->SplitRequestedRegion(i, numberOfPieces, piece);
+    for ( unsigned int d = 0; d < OutputImageDimension; ++d )
       {
-      InputImagePixelType VN = outNIt.GetPixel(*oLIt);
-      InputImagePixelType iN = mskNIt.GetPixel(*mLIt);
-      if ( compare(V, VN) && compare(iN, VN) )
+      const OffsetValueType pieceFirst = piece.GetIndex(d);
+      const OffsetValueType pieceLast = pieceFirst + static_cast< OffsetValueType >( piece.GetSize(d) ) - 1;
+      for ( unsigned int side = 0; side < 2; ++side )
         {
-        IndexFifo.push( outNIt.GetIndex() );
-        break;
+        const OffsetValueType position = side == 0 ? pieceFirst : pieceLast;
+        if ( ( side == 0 && pieceFirst == region.GetIndex(d) )
+             || ( side == 1 && pieceLast == region.GetIndex(d) + static_cast< OffsetValueType >( region.GetSize(d) ) - 1 ) )
+          {
+          continue;
+          }
+        OutputImageRegionType cut = piece;
+        cut.SetIndex(d, position);
+        cut.SetSize(d, 1);
+        for ( ImageRegionConstIteratorWithIndex< OutputImageType > cIt(output, cut); !cIt.IsAtEnd(); ++cIt )
+          {
+          const InIndexType     idx = cIt.GetIndex();
+          const OffsetValueType o = m_WorkingMarkerImage->ComputeOffset(idx);
+          const bool            onBorder = IsOnRegionBorder(region, idx);
+          const InputImagePixelType V = markerBuffer[o];
+          for ( unsigned int n = 0; n < numberOfNeighbors; ++n )
+            {
+            if ( onBorder && !region.IsInside( idx + offsets[n] ) )
+              {
+              continue;
+              }
+            InputImagePixelType VN = markerBuffer[o + bufferOffsets[n]];
+            InputImagePixelType iN = maskBuffer[o + bufferOffsets[n]];
+            if ( compare(V, VN) && compare(iN, VN) )
+              {
+              IndexFifo.push_back(o);
+              break;
+              }
+            }
+          }
         }
       }
-    progress.CompletedPixel();
     }
 
-  // Now we want to check the full neighborhood
-  setConnectivity(&outNIt, m_FullyConnected);
-  setConnectivity(&mskNIt, m_FullyConnected);
-  mskNIt.OverrideBoundaryCondition(&iBC);
-  outNIt.OverrideBoundaryCondition(&oBC);
-  oIndexList = outNIt.GetActiveIndexList();
-  mIndexList = mskNIt.GetActiveIndexList();
   // now process the fifo - this fill the parts that weren't dealt
   // with by the raster and anti-raster passes
-  //typename NOutputIterator::Iterator sIt;
-  typename CNInputIterator::ConstIterator mIt;
-
+  ProgressReporter progress(this, 0, region.GetNumberOfPixels(), 100, 2.0f / 3.0f, 1.0f / 3.0f);
   while ( !IndexFifo.empty() )
     {
-    InputImageIndexType I = IndexFifo.front();
-    IndexFifo.pop();
-    // reposition the iterators
-    outNIt += I - outNIt.GetIndex();
-    mskNIt += I - mskNIt.GetIndex();
-    InputImagePixelType V = outNIt.GetCenterPixel();
-    for ( oLIt = oIndexList.begin(), mLIt = mIndexList.begin();
-          oLIt != oIndexList.end();
-          ++oLIt, ++mLIt )
+    const OffsetValueType o = IndexFifo.front();
+    IndexFifo.pop_front();
+    const InIndexType idx = m_WorkingMarkerImage->ComputeIndex(o);
+    const bool        onBorder = IsOnRegionBorder(region, idx);
+    InputImagePixelType V = markerBuffer[o];
+    for ( unsigned int n = 0; n < numberOfNeighbors; ++n )
       {
-      InputImagePixelType VN = outNIt.GetPixel(*oLIt);
-      InputImagePixelType iN = mskNIt.GetPixel(*mLIt);
+      if ( onBorder && !region.IsInside( idx + offsets[n] ) )
+        {
+        continue;
+        }
+      const OffsetValueType no = o + bufferOffsets[n];
+      InputImagePixelType   VN = markerBuffer[no];
+      InputImagePixelType   iN = maskBuffer[no];
       // candidate for dilation via flooding
       if ( compare(V, VN) && ( iN != VN ) )
         {
         if ( compare(iN, V) )
           {
           // not clamped by the mask, propagate the center value
-          outNIt.SetPixel(*oLIt, V);
+          markerBuffer[no] = V;
           }
         else
           {
           // apply the clamping
-          outNIt.SetPixel(*oLIt, iN);
+          markerBuffer[no] = iN;
           }
-        IndexFifo.push( outNIt.GetIndex(*oLIt) );
+        IndexFifo.push_back(no);
         }
       }
     progress.CompletedPixel();
@@ -375,7 +317,7 @@ ReconstructionImageFilter< TInputImage, TOutputImage, TCompare >
     typedef typename itk::CropImageFilter< InputImageType, OutputImageType > CropType;
     typename CropType::Pointer crop = CropType::New();
 
-    crop->SetInput(markerImageP);
+    crop->SetInput(m_WorkingMarkerImage);
     crop->SetUpperBoundaryCropSize(padSize);
     crop->SetLowerBoundaryCropSize(padSize);
     crop->GraftOutput( this->GetOutput() );
@@ -385,6 +327,204 @@ ReconstructionImageFilter< TInputImage, TOutputImage, TCompare >
     /** graft the minipipeline output back into this filter's output */
     this->GraftOutput( crop->GetOutput() );
     }
+
+  m_WorkingMarkerImage = ITK_NULLPTR;
+  m_WorkingMaskImage = ITK_NULLPTR;
+}
+
+template< typename TInputImage, typename TOutputImage, typename TCompare >
+void
+ReconstructionImageFilter< TInputImage, TOutputImage, TCompare >
+::ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
+                       ThreadIdType threadId)
+{
+  // there are 2 passes that use all pixels and a 3rd that uses some
+  // subset of the pixels. We'll just pretend that the third pass
+  // takes the same as each of the others.
+  ProgressReporter progress(this, threadId, outputRegionForThread.GetNumberOfPixels() * 2,
+                            100, 0.0f, 2.0f / 3.0f);
+
+  TCompare compare;
+
+  OutputImagePixelType *     markerBuffer = m_WorkingMarkerImage->GetBufferPointer();
+  const InputImagePixelType *maskBuffer = m_WorkingMaskImage->GetBufferPointer();
+  BufferOffsetsType &        IndexFifo = m_ThreadQueues[threadId];
+
+  // neighbors outside of this piece are ignored: they are dealt with
+  // once all the pieces are done
+  const OutputImageRegionType & region = outputRegionForThread;
+
+  ISizeType kernelRadius;
+  kernelRadius.Fill(1);
+  NOutputIterator outNIt(kernelRadius, m_WorkingMarkerImage, region);
+
+  NeighborOffsetsType       offsets;
+  NeighborBufferOffsetsType bufferOffsets;
+  setConnectivityPrevious(&outNIt, m_FullyConnected);
+  this->GetActiveOffsets(outNIt, offsets, bufferOffsets);
+  unsigned int numberOfNeighbors = static_cast< unsigned int >( offsets.size() );
+
+  // the region is scanned line by line; only the pixels at the ends of
+  // the lines, or on lines along the border, need their neighbors checked
+  const OffsetValueType lineLength = static_cast< OffsetValueType >( region.GetSize(0) );
+  const SizeValueType   numberOfLines = region.GetNumberOfPixels() / region.GetSize(0);
+
+  // scan in forward raster order
+  for ( SizeValueType line = 0; line < numberOfLines; ++line )
+    {
+    InIndexType           idx = GetLineStart(region, line);
+    const OffsetValueType lineOffset = m_WorkingMarkerImage->ComputeOffset(idx);
+    const bool            lineOnBorder = IsOnRegionBorder(region, idx, 1);
+    for ( OffsetValueType x = 0; x < lineLength; ++x )
+      {
+      const OffsetValueType o = lineOffset + x;
+      InputImagePixelType   V = markerBuffer[o];
+      InputImagePixelType   iV = static_cast< OutputImagePixelType >( maskBuffer[o] );
+
+      // be sure that the pixels in the images follow the preconditions
+      if ( compare(V, iV) )
+        {
+        m_ThreadFoundInvalidMarker[threadId] = 1;
+        return;
+        }
+
+      // visit the previous neighbours
+      const bool onBorder = lineOnBorder || x == 0 || x == lineLength - 1;
+      idx[0] = region.GetIndex(0) + x;
+      for ( unsigned int n = 0; n < numberOfNeighbors; ++n )
+        {
+        if ( onBorder && !region.IsInside( idx + offsets[n] ) )
+          {
+          continue;
+          }
+        InputImagePixelType VN = markerBuffer[o + bufferOffsets[n]];
+        if ( compare(VN, V) )
+          {
+          V = VN;
+          }
+        }
+
+      // this step clamps to the mask
+      if ( compare(V, iV) )
+        {
+        V = iV;
+        }
+      markerBuffer[o] = V;
+
+      progress.CompletedPixel();
+      }
+    }
+
+  // now for the reverse raster order pass
+  setConnectivityLater(&outNIt, m_FullyConnected);
+  this->GetActiveOffsets(outNIt, offsets, bufferOffsets);
+  numberOfNeighbors = static_cast< unsigned int >( offsets.size() );
+
+  for ( SizeValueType line = numberOfLines; line > 0; --line )
+    {
+    InIndexType           idx = GetLineStart(region, line - 1);
+    const OffsetValueType lineOffset = m_WorkingMarkerImage->ComputeOffset(idx);
+    const bool            lineOnBorder = IsOnRegionBorder(region, idx, 1);
+    for ( OffsetValueType x = lineLength - 1; x >= 0; --x )
+      {
+      const OffsetValueType o = lineOffset + x;
+      const bool            onBorder = lineOnBorder || x == 0 || x == lineLength - 1;
+      idx[0] = region.GetIndex(0) + x;
+      InputImagePixelType V = markerBuffer[o];
+      for ( unsigned int n = 0; n < numberOfNeighbors; ++n )
+        {
+        if ( onBorder && !region.IsInside( idx + offsets[n] ) )
+          {
+          continue;
+          }
+        InputImagePixelType VN = markerBuffer[o + bufferOffsets[n]];
+        if ( compare(VN, V) )
+          {
+          V = VN;
+          }
+        }
+      InputImagePixelType iV = maskBuffer[o];
+      if ( compare(V, iV) )
+        {
+        V = iV;
+        }
+      markerBuffer[o] = V;
+
+      // now put indexes in the fifo
+      for ( unsigned int n = 0; n < numberOfNeighbors; ++n )
+        {
+        if ( onBorder && !region.IsInside( idx + offsets[n] ) )
+          {
+          continue;
+          }
+        InputImagePixelType VN = markerBuffer[o + bufferOffsets[n]];
+        InputImagePixelType iN = maskBuffer[o + bufferOffsets[n]];
+        if ( compare(V, VN) && compare(iN, VN) )
+          {
+          IndexFifo.push_back(o);
+          break;
+          }
+        }
+      progress.CompletedPixel();
+      }
+    }
+}
+
+template< typename TInputImage, typename TOutputImage, typename TCompare >
+void
+ReconstructionImageFilter< TInputImage, TOutputImage, TCompare >
+::GetActiveOffsets(const NOutputIterator & it,
+                   NeighborOffsetsType & offsets,
+                   NeighborBufferOffsetsType & bufferOffsets) const
+{
+  const OffsetValueType *offsetTable = m_WorkingMarkerImage->GetOffsetTable();
+
+  offsets.clear();
+  bufferOffsets.clear();
+  // ShapedNeighborhoodIterator::Begin() hides the const one of its superclass
+  const typename NOutputIterator::Superclass & constIt = it;
+  for ( typename NOutputIterator::ConstIterator sIt = constIt.Begin(); !sIt.IsAtEnd(); ++sIt )
+    {
+    const InOffsetType offset = sIt.GetNeighborhoodOffset();
+    OffsetValueType    bufferOffset = 0;
+    for ( unsigned int d = 0; d < OutputImageDimension; ++d )
+      {
+      bufferOffset += offset[d] * offsetTable[d];
+      }
+    offsets.push_back(offset);
+    bufferOffsets.push_back(bufferOffset);
+    }
+}
+
+template< typename TInputImage, typename TOutputImage, typename TCompare >
+typename ReconstructionImageFilter< TInputImage, TOutputImage, TCompare >::InIndexType
+ReconstructionImageFilter< TInputImage, TOutputImage, TCompare >
+::GetLineStart(const OutputImageRegionType & region, SizeValueType line)
+{
+  InIndexType index = region.GetIndex();
+  for ( unsigned int d = 1; d < OutputImageDimension; ++d )
+    {
+    index[d] += static_cast< OffsetValueType >( line % region.GetSize(d) );
+    line /= region.GetSize(d);
+    }
+  return index;
+}
+
+template< typename TInputImage, typename TOutputImage, typename TCompare >
+bool
+ReconstructionImageFilter< TInputImage, TOutputImage, TCompare >
+::IsOnRegionBorder(const OutputImageRegionType & region, const InIndexType & index,
+                   unsigned int firstDimension)
+{
+  for ( unsigned int d = firstDimension; d < OutputImageDimension; ++d )
+    {
+    if ( index[d] == region.GetIndex(d)
+         || index[d] == region.GetIndex(d) + static_cast< OffsetValueType >( region.GetSize(d) ) - 1 )
+      {
+      return true;
+      }
+    }
+  return false;
 }
 
 template< typename TInputImage, typename TOutputImage, typename TCompare >
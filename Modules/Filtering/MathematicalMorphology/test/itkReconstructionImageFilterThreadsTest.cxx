@@ -0,0 +1,147 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkReconstructionByDilationImageFilter.h"
+#include "itkReconstructionByErosionImageFilter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkImageRegionConstIterator.h"
+#include <cmath>
+
+namespace
+{
+typedef unsigned char                   PixelType;
+typedef itk::Image< PixelType, 3 >      ImageType;
+
+// Run the reconstruction with 1 and 4 threads, for both connectivities and
+// with and without the internal copy: all the outputs have to be the same,
+// and have to change the marker.
+template< typename TFilter >
+bool TestThreads( const char * name, const ImageType * marker, const ImageType * mask )
+{
+  for ( unsigned int fullyConnected = 0; fullyConnected < 2; ++fullyConnected )
+    {
+    for ( unsigned int useInternalCopy = 0; useInternalCopy < 2; ++useInternalCopy )
+      {
+      ImageType::Pointer outputs[2];
+      const itk::ThreadIdType threads[2] = { 1, 4 };
+      for ( unsigned int t = 0; t < 2; ++t )
+        {
+        typename TFilter::Pointer filter = TFilter::New();
+        filter->SetMarkerImage( marker );
+        filter->SetMaskImage( mask );
+        filter->SetFullyConnected( fullyConnected != 0 );
+        filter->SetUseInternalCopy( useInternalCopy != 0 );
+        filter->SetNumberOfThreads( threads[t] );
+        filter->Update();
+        outputs[t] = filter->GetOutput();
+        outputs[t]->DisconnectPipeline();
+        }
+
+      itk::SizeValueType differences = 0;
+      itk::SizeValueType changed = 0;
+      itk::ImageRegionConstIterator< ImageType > it1( outputs[0], outputs[0]->GetLargestPossibleRegion() );
+      itk::ImageRegionConstIterator< ImageType > it4( outputs[1], outputs[1]->GetLargestPossibleRegion() );
+      itk::ImageRegionConstIterator< ImageType > mit( marker, marker->GetLargestPossibleRegion() );
+      for ( ; !it1.IsAtEnd(); ++it1, ++it4, ++mit )
+        {
+        differences += ( it1.Get() != it4.Get() );
+        changed += ( it1.Get() != mit.Get() );
+        }
+      std::cout << name << ", fully connected " << fullyConnected << ", internal copy "
+                << useInternalCopy << ": " << changed << " pixels changed, "
+                << differences << " differences between 1 and 4 threads" << std::endl;
+      if ( differences != 0 || changed == 0 )
+        {
+        std::cerr << name << " gives different outputs with 1 and 4 threads" << std::endl;
+        return false;
+        }
+      }
+    }
+  return true;
+}
+}
+
+int itkReconstructionImageFilterThreadsTest( int, char* [] )
+{
+  typedef itk::ReconstructionByDilationImageFilter< ImageType, ImageType > DilationType;
+  typedef itk::ReconstructionByErosionImageFilter< ImageType, ImageType >  ErosionType;
+
+  ImageType::SizeType size = {{ 37, 29, 23 }};
+  ImageType::RegionType region( size );
+
+  ImageType::Pointer mask = ImageType::New();
+  mask->SetRegions( region );
+  mask->Allocate();
+
+  // bumps and thin ridges, which the reconstruction has to follow across
+  // the pieces of the threads
+  unsigned int seed = 33;
+  itk::ImageRegionIteratorWithIndex< ImageType > it( mask, region );
+  for ( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    const ImageType::IndexType index = it.GetIndex();
+    seed = seed * 1103515245u + 12345u;
+    double value = 100.0
+      + 50.0 * std::sin( 0.45 * index[0] ) * std::sin( 0.35 * index[1] ) * std::cos( 0.3 * index[2] )
+      + static_cast< double >( ( seed >> 16 ) % 21 ) - 10.0;
+    if ( ( index[0] + 2 * index[1] + 3 * index[2] ) % 11 == 0 )
+      {
+      value += 60.0;
+      }
+    it.Set( static_cast< PixelType >( value ) );
+    }
+
+  // h-maxima and h-minima style markers, and sparse seeds
+  ImageType::Pointer lower = ImageType::New();
+  lower->SetRegions( region );
+  lower->Allocate();
+  ImageType::Pointer upper = ImageType::New();
+  upper->SetRegions( region );
+  upper->Allocate();
+  ImageType::Pointer seeds = ImageType::New();
+  seeds->SetRegions( region );
+  seeds->Allocate();
+  ImageType::Pointer inverseSeeds = ImageType::New();
+  inverseSeeds->SetRegions( region );
+  inverseSeeds->Allocate();
+
+  itk::ImageRegionConstIterator< ImageType > maskIt( mask, region );
+  itk::ImageRegionIterator< ImageType > lowerIt( lower, region );
+  itk::ImageRegionIterator< ImageType > upperIt( upper, region );
+  itk::ImageRegionIterator< ImageType > seedsIt( seeds, region );
+  itk::ImageRegionIterator< ImageType > inverseSeedsIt( inverseSeeds, region );
+  for ( unsigned int i = 0; !maskIt.IsAtEnd(); ++maskIt, ++lowerIt, ++upperIt, ++seedsIt, ++inverseSeedsIt, ++i )
+    {
+    const PixelType value = maskIt.Get();
+    lowerIt.Set( value > 20 ? value - 20 : 0 );
+    upperIt.Set( value < 235 ? value + 20 : 255 );
+    seedsIt.Set( i % 997 == 0 ? value / 2 : 0 );
+    inverseSeedsIt.Set( i % 997 == 0 ? ( value + 255 ) / 2 : 255 );
+    }
+
+  if ( !TestThreads< DilationType >( "Dilation", lower, mask )
+       || !TestThreads< DilationType >( "Dilation from seeds", seeds, mask )
+       || !TestThreads< ErosionType >( "Erosion", upper, mask )
+       || !TestThreads< ErosionType >( "Erosion from seeds", inverseSeeds, mask ) )
+    {
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -22,7 +22,9 @@
 #include "itkPriorityQueueContainer.h"
 #include "itkQuadEdgeMeshToQuadEdgeMeshFilter.h"
 #include "itkQuadEdgeMeshEulerOperatorFlipEdgeFunction.h"
+#include "itkMultiThreader.h"
 #include "vnl/vnl_math.h"
+#include <vector>
 
 namespace itk
 {
@@ -136,6 +138,8 @@ protected:
 
   void GenerateData() ITK_OVERRIDE;
 
+  /** The criterion of all the edges is computed on the threads, then the
+   * edges are queued in the order of the edge cells container. */
   void InitializePriorityQueue();
 
   void Process();
@@ -204,6 +208,15 @@ protected:
   }
 
 private:
+  struct ThreadStruct
+    {
+    Self *Filter;
+    OutputMeshType *Output;
+    const std::vector< OutputEdgeCellType * > *Edges;
+    std::vector< CriterionValueType > *Values;
+    };
+
+  static ITK_THREAD_RETURN_TYPE CriterionThreaderCallback(void *arg);
 
   DelaunayConformingQuadEdgeMeshFilter(const Self &); // Purposely not
                                                       // implemented
@@ -59,6 +59,9 @@ void DelaunayConformingQuadEdgeMeshFilter< TInputMesh, TOutputMesh >::Initialize
 
   CriterionValueType value = 0.;
 
+  std::vector< OutputEdgeCellType * > edges;
+  edges.reserve( output->GetEdgeCells()->Size() );
+
   for ( OutputCellsContainerIterator
         outCellIterator = output->GetEdgeCells()->Begin();
         outCellIterator != output->GetEdgeCells()->End();
@@ -67,15 +70,41 @@ void DelaunayConformingQuadEdgeMeshFilter< TInputMesh, TOutputMesh >::Initialize
     if ( ( edge = dynamic_cast< OutputEdgeCellType * >(
              outCellIterator.Value() ) ) )
       {
-      value = Dyer07Criterion( output, edge->GetQEGeom() );
+      edges.push_back(edge);
+      }
+    }
 
-      if ( value > 0.0 )
-        {
-        PriorityQueueItemType *qi =
-          new PriorityQueueItemType( edge, PriorityType(true, value) );
-        m_QueueMapper[edge] = qi;
-        m_PriorityQueue->Push(qi);
-        }
+  std::vector< CriterionValueType > values( edges.size() );
+
+  if ( !edges.empty() )
+    {
+    ThreadStruct str;
+    str.Filter = this;
+    str.Output = output;
+    str.Edges = &edges;
+    str.Values = &values;
+
+    ThreadIdType numberOfThreads = this->GetNumberOfThreads();
+    if ( static_cast< SizeValueType >( numberOfThreads ) > edges.size() )
+      {
+      numberOfThreads = static_cast< ThreadIdType >( edges.size() );
+      }
+    this->GetMultiThreader()->SetNumberOfThreads(numberOfThreads);
+    this->GetMultiThreader()->SetSingleMethod(Self::CriterionThreaderCallback, &str);
+    this->GetMultiThreader()->SingleMethodExecute();
+    }
+
+  for ( size_t i = 0; i < edges.size(); ++i )
+    {
+    edge = edges[i];
+    value = values[i];
+
+    if ( value > 0.0 )
+      {
+      PriorityQueueItemType *qi =
+        new PriorityQueueItemType( edge, PriorityType(true, value) );
+      m_QueueMapper[edge] = qi;
+      m_PriorityQueue->Push(qi);
       }
     }
 
@@ -103,6 +132,33 @@ void DelaunayConformingQuadEdgeMeshFilter< TInputMesh, TOutputMesh >::Initialize
     }
 }
 
+// ---------------------------------------------------------------------
+template< typename TInputMesh, typename TOutputMesh >
+ITK_THREAD_RETURN_TYPE
+DelaunayConformingQuadEdgeMeshFilter< TInputMesh, TOutputMesh >::CriterionThreaderCallback(void *arg)
+{
+  typedef MultiThreader::ThreadInfoStruct ThreadInfoType;
+  ThreadInfoType *info = static_cast< ThreadInfoType * >( arg );
+  ThreadStruct *  str = static_cast< ThreadStruct * >( info->UserData );
+
+  const SizeValueType numberOfEdges = str->Edges->size();
+  const SizeValueType numberOfThreads = info->NumberOfThreads;
+  const SizeValueType threadId = info->ThreadID;
+
+  const SizeValueType first = numberOfEdges / numberOfThreads * threadId
+                              + std::min( threadId, numberOfEdges % numberOfThreads );
+  const SizeValueType last = first + numberOfEdges / numberOfThreads
+                             + ( threadId < numberOfEdges % numberOfThreads ? 1 : 0 );
+
+  for ( SizeValueType i = first; i < last; ++i )
+    {
+    ( *str->Values )[i] =
+      str->Filter->Dyer07Criterion( str->Output, ( *str->Edges )[i]->GetQEGeom() );
+    }
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
 // ---------------------------------------------------------------------
 template< typename TInputMesh, typename TOutputMesh >
 void DelaunayConformingQuadEdgeMeshFilter< TInputMesh, TOutputMesh >::Process()
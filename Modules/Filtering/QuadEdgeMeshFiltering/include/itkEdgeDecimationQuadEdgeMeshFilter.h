@@ -20,6 +20,8 @@
 
 #include <list>
 #include <map>
+#include <set>
+#include <vector>
 #include <algorithm>
 
 #include "itkQuadEdgeMeshEulerOperatorJoinVertexFunction.h"
@@ -28,12 +30,31 @@
 #include "itkDecimationQuadEdgeMeshFilter.h"
 #include "itkPriorityQueueContainer.h"
 #include "itkTriangleHelper.h"
+#include "itkMultiThreader.h"
 
 namespace itk
 {
 /**
  * \class EdgeDecimationQuadEdgeMeshFilter
  * \brief
+ *
+ * By default the edges are collapsed one at a time, always taking the best
+ * edge of a global priority queue. With ParallelDecimation on, the
+ * decimation is done by rounds instead: the measure of every edge is
+ * computed on NumberOfThreads threads, then the edges are visited in
+ * priority order and each one is collapsed unless one of its points was
+ * already touched by a collapse of the same round. The collapses of a
+ * round thus form an independent set, and the measures computed at the
+ * beginning of the round stay valid for all of them. A round only goes
+ * through the best quarter of the edges, unless none of them could be
+ * collapsed, so that the result stays close to the sequential one.
+ *
+ * When an edge cannot be collapsed, the edges that JoinVertexFailed()
+ * would tag out of the queue are left out of the following rounds as
+ * well. The edges around a samosa, which the queue only drops until one
+ * of their points moves, are simply tried again in the next round.
+ * JoinVertexFailed() itself is not called in this mode.
+ *
  * \ingroup ITKQuadEdgeMeshFiltering
  */
 template< typename TInput, typename TOutput, typename TCriterion >
@@ -85,6 +106,12 @@ public:
   typedef QuadEdgeMeshEulerOperatorJoinVertexFunction< OutputMeshType, OutputQEType > OperatorType;
   typedef typename OperatorType::Pointer                                              OperatorPointer;
 
+  /** Set/Get whether the edges are collapsed by rounds of independent
+   * edges, whose measures are computed on several threads. */
+  itkSetMacro(ParallelDecimation, bool);
+  itkGetConstMacro(ParallelDecimation, bool);
+  itkBooleanMacro(ParallelDecimation);
+
 protected:
 
   EdgeDecimationQuadEdgeMeshFilter();
@@ -93,16 +120,24 @@ protected:
   bool m_Relocate;
   bool m_CheckOrientation;
 
+  bool m_ParallelDecimation;
+
   PriorityQueuePointer m_PriorityQueue;
   QueueMapType         m_QueueMapper;
   OutputQEType *       m_Element;
   PriorityType         m_Priority;
   OperatorPointer      m_JoinVertexFunction;
 
+  void GenerateData() ITK_OVERRIDE;
+
+  void PrintSelf(std::ostream & os, Indent indent) const ITK_OVERRIDE;
+
   /**
   * \brief Compute the measure value for iEdge
   * \param[in] iEdge
   * \return measure value
+  * \note With ParallelDecimation on, it is called from several threads at
+  * once and must only read the output mesh and the filter state.
   */
   virtual MeasureType MeasureEdge(OutputQEType *iEdge) = 0;
 
@@ -298,10 +333,58 @@ protected:
    */
   bool IsCriterionSatisfied() ITK_OVERRIDE;
 
+  /**
+   * \brief Decimate the output mesh by rounds of independent edge
+   * collapses (ParallelDecimation).
+   */
+  void DecimateByIndependentSets();
+
+  /**
+   * \brief Collapse iEdge into its origin or destination and relocate the
+   * remaining point. The priority queue is left untouched.
+   * \param[in] iEdge
+   * \return true if the edge has been collapsed
+   */
+  bool CollapseEdge(OutputQEType *iEdge);
+
+  /**
+   * \brief Leave out of the following rounds the edges that
+   * JoinVertexFailed() tags out when iEdge cannot be collapsed.
+   * \param[in] iEdge
+   */
+  void TagEdgesOutOfRounds(OutputQEType *iEdge);
+
 private:
   EdgeDecimationQuadEdgeMeshFilter(const Self &);
   void operator=(const Self &);
 
+  /** Edges whose measures are computed by the threads. */
+  struct ThreadStruct
+    {
+    Self *Filter;
+    const std::vector< OutputQEType * > *Edges;
+    std::vector< MeasureType > *Measures;
+    };
+
+  static ITK_THREAD_RETURN_TYPE MeasureEdgesThreaderCallback(void *arg);
+
+  /** Orders the candidates of a round as the priority queue would. */
+  struct CandidateCompare
+    {
+    const std::vector< PriorityQueueItemType > *Items;
+
+    bool operator()(SizeValueType a, SizeValueType b) const
+    {
+      const PriorityQueueItemType & item = ( *Items )[a];
+
+      return item.is_less( item, ( *Items )[b] );
+    }
+    };
+
+  /** Ends, ordered, of the edges left out of the rounds. */
+  typedef std::pair< OutputPointIdentifier, OutputPointIdentifier > EdgeEndsType;
+  std::set< EdgeEndsType > m_EdgesOutOfRounds;
+
 };
 }
 
@@ -28,6 +28,7 @@ EdgeDecimationQuadEdgeMeshFilter() :
   Superclass(),
   m_Relocate(true),
   m_CheckOrientation(false),
+  m_ParallelDecimation(false),
   m_Element(ITK_NULLPTR)
 
 {
@@ -52,6 +53,21 @@ EdgeDecimationQuadEdgeMeshFilter< TInput, TOutput, TCriterion >::
     }
 }
 
+template< typename TInput, typename TOutput, typename TCriterion >
+void
+EdgeDecimationQuadEdgeMeshFilter< TInput, TOutput, TCriterion >::GenerateData()
+{
+  if ( !m_ParallelDecimation )
+    {
+    Superclass::GenerateData();
+    return;
+    }
+
+  this->CopyInputMeshToOutputMesh();
+  this->Initialize();
+  this->DecimateByIndependentSets();
+}
+
 template< typename TInput, typename TOutput, typename TCriterion >
 void
 EdgeDecimationQuadEdgeMeshFilter< TInput, TOutput, TCriterion >::FillPriorityQueue()
@@ -599,5 +615,335 @@ EdgeDecimationQuadEdgeMeshFilter< TInput, TOutput, TCriterion >::IsCriterionSati
     return this->m_Criterion->is_satisfied(this->GetOutput(), 0, m_Priority.second);
     }
 }
+
+template< typename TInput, typename TOutput, typename TCriterion >
+void
+EdgeDecimationQuadEdgeMeshFilter< TInput, TOutput, TCriterion >::DecimateByIndependentSets()
+{
+  OutputMeshType *output = this->GetOutput();
+
+  this->m_OutputMesh = output;
+  m_JoinVertexFunction->SetInput(output);
+
+  // Point ids are not reused while decimating, the points touched during a
+  // round can thus be marked in a vector indexed by point id.
+  OutputPointIdentifier numberOfIds = 0;
+  for ( typename OutputMeshType::PointsContainerConstIterator pIt = output->GetPoints()->Begin();
+        pIt != output->GetPoints()->End(); ++pIt )
+    {
+    numberOfIds = std::max( numberOfIds, pIt->Index() + 1 );
+    }
+  std::vector< bool > touched(numberOfIds);
+
+  m_EdgesOutOfRounds.clear();
+
+  std::vector< OutputQEType * >        edges;
+  std::vector< OutputCellIdentifier >  cellIds;
+  std::vector< MeasureType >           measures;
+  std::vector< SizeValueType >         toBeMeasured;
+  std::vector< OutputQEType * >        toBeMeasuredEdges;
+  std::vector< MeasureType >           toBeMeasuredValues;
+  std::vector< MeasureType >           cellMeasures;
+  std::vector< PriorityQueueItemType > items;
+  std::vector< EdgeEndsType >          ends;
+  std::vector< SizeValueType >         order;
+
+  this->m_Iteration = 0;
+  bool firstRound = true;
+  bool done = false;
+
+  while ( !done )
+    {
+    edges.clear();
+    cellIds.clear();
+    for ( OutputCellsContainerIterator it = output->GetEdgeCells()->Begin();
+          it != output->GetEdgeCells()->End(); ++it )
+      {
+      OutputEdgeCellType *edge = dynamic_cast< OutputEdgeCellType * >( it.Value() );
+      if ( edge )
+        {
+        OutputQEType *qe = edge->GetQEGeom();
+        if ( qe->GetOrigin() > qe->GetDestination() )
+          {
+          qe = qe->GetSym();
+          }
+        if ( m_EdgesOutOfRounds.find( EdgeEndsType( qe->GetOrigin(), qe->GetDestination() ) )
+             != m_EdgesOutOfRounds.end() )
+          {
+          continue;
+          }
+        edges.push_back(qe);
+        cellIds.push_back( it.Index() );
+        }
+      }
+
+    if ( edges.empty() )
+      {
+      break;
+      }
+
+    // An edge whose points were not touched by the previous round keeps its
+    // edge cell and its measure, the other ones are measured on the threads.
+    measures.resize( edges.size() );
+    toBeMeasured.clear();
+    toBeMeasuredEdges.clear();
+    for ( SizeValueType i = 0; i < edges.size(); ++i )
+      {
+      if ( firstRound
+           || touched[edges[i]->GetOrigin()] || touched[edges[i]->GetDestination()]
+           || cellIds[i] >= cellMeasures.size() )
+        {
+        toBeMeasured.push_back(i);
+        toBeMeasuredEdges.push_back(edges[i]);
+        }
+      else
+        {
+        measures[i] = cellMeasures[cellIds[i]];
+        }
+      }
+    firstRound = false;
+
+    if ( !toBeMeasured.empty() )
+      {
+      toBeMeasuredValues.resize( toBeMeasured.size() );
+
+      ThreadStruct str;
+      str.Filter = this;
+      str.Edges = &toBeMeasuredEdges;
+      str.Measures = &toBeMeasuredValues;
+
+      ThreadIdType numberOfThreads = this->GetNumberOfThreads();
+      if ( static_cast< SizeValueType >( numberOfThreads ) > toBeMeasured.size() )
+        {
+        numberOfThreads = static_cast< ThreadIdType >( toBeMeasured.size() );
+        }
+      this->GetMultiThreader()->SetNumberOfThreads(numberOfThreads);
+      this->GetMultiThreader()->SetSingleMethod(Self::MeasureEdgesThreaderCallback, &str);
+      this->GetMultiThreader()->SingleMethodExecute();
+
+      for ( SizeValueType j = 0; j < toBeMeasured.size(); ++j )
+        {
+        measures[toBeMeasured[j]] = toBeMeasuredValues[j];
+        }
+      }
+
+    for ( SizeValueType i = 0; i < edges.size(); ++i )
+      {
+      if ( cellIds[i] >= cellMeasures.size() )
+        {
+        cellMeasures.resize(cellIds[i] + 1);
+        }
+      cellMeasures[cellIds[i]] = measures[i];
+      }
+
+    // Visit them in priority order. The queue order is kept for equal
+    // priorities so that the result does not depend on the threads.
+    items.clear();
+    ends.clear();
+    order.clear();
+    for ( SizeValueType i = 0; i < edges.size(); ++i )
+      {
+      items.push_back( PriorityQueueItemType( edges[i], PriorityType(false, measures[i]) ) );
+      ends.push_back( EdgeEndsType( edges[i]->GetOrigin(), edges[i]->GetDestination() ) );
+      order.push_back(i);
+      }
+
+    CandidateCompare compare;
+    compare.Items = &items;
+    std::stable_sort(order.begin(), order.end(), compare);
+
+    std::fill(touched.begin(), touched.end(), false);
+
+    // A round stops after the best quarter of the edges once it has
+    // collapsed some of them: the sequential decimation would only reach
+    // the following ones after re-measuring their neighborhoods.
+    const SizeValueType roundSize = std::max< SizeValueType >(order.size() / 4, 1);
+
+    SizeValueType numberOfCollapses = 0;
+
+    for ( SizeValueType k = 0; k < order.size(); ++k )
+      {
+      if ( k >= roundSize && numberOfCollapses > 0 )
+        {
+        break;
+        }
+
+      const EdgeEndsType & e = ends[order[k]];
+      if ( touched[e.first] || touched[e.second] )
+        {
+        continue;
+        }
+
+      // The edge may not be dereferenced directly: edges deleted by the
+      // previous collapses of the round are recycled by the mesh.
+      OutputQEType *qe = output->FindEdge(e.first, e.second);
+      if ( qe == ITK_NULLPTR )
+        {
+        continue;
+        }
+      if ( !this->CollapseEdge(qe) )
+        {
+        this->TagEdgesOutOfRounds(qe);
+        continue;
+        }
+
+      touched[e.first] = true;
+      touched[e.second] = true;
+
+      OutputPointIdentifier remaining =
+        ( m_JoinVertexFunction->GetOldPointID() == e.second ) ? e.first : e.second;
+      OutputQEType *ring = output->FindEdge(remaining);
+      if ( ring != ITK_NULLPTR )
+        {
+        OutputQEType *ring_it = ring;
+        do
+          {
+          touched[ring_it->GetDestination()] = true;
+          ring_it = ring_it->GetOnext();
+          }
+        while ( ring_it != ring );
+        }
+
+      ++numberOfCollapses;
+      ++this->m_Iteration;
+
+      m_Priority = items[order[k]].m_Priority;
+      if ( this->m_Criterion->is_satisfied(output, 0, m_Priority.second) )
+        {
+        done = true;
+        break;
+        }
+      }
+
+    if ( numberOfCollapses == 0 )
+      {
+      done = true;
+      }
+    }
+
+  output->SqueezePointsIds();
+}
+
+template< typename TInput, typename TOutput, typename TCriterion >
+bool
+EdgeDecimationQuadEdgeMeshFilter< TInput, TOutput, TCriterion >::CollapseEdge(OutputQEType *iEdge)
+{
+  OutputPointIdentifier id_org = iEdge->GetOrigin();
+  OutputPointIdentifier id_dest = iEdge->GetDestination();
+  OutputPointIdentifier idx = ( id_org < id_dest ) ? id_org : id_dest;
+
+  OutputPointType pt;
+
+  if ( m_Relocate )
+    {
+    pt = Relocate(iEdge);
+    }
+  else
+    {
+    pt = this->m_OutputMesh->GetPoint(idx);
+    }
+
+  if ( !m_JoinVertexFunction->Evaluate(iEdge) )
+    {
+    return false;
+    }
+
+  OutputPointIdentifier old_id = m_JoinVertexFunction->GetOldPointID();
+  OutputPointIdentifier new_id = ( old_id == id_dest ) ? id_org : id_dest;
+  DeletePoint(old_id, new_id);
+
+  OutputQEType *edge = this->m_OutputMesh->FindEdge(new_id);
+  if ( edge != ITK_NULLPTR && m_Relocate )
+    {
+    pt.SetEdge(edge);
+    this->m_OutputMesh->SetPoint(new_id, pt);
+    }
+  return true;
+}
+
+template< typename TInput, typename TOutput, typename TCriterion >
+void
+EdgeDecimationQuadEdgeMeshFilter< TInput, TOutput, TCriterion >::TagEdgesOutOfRounds(OutputQEType *iEdge)
+{
+  std::vector< OutputQEType * > out;
+
+  switch ( m_JoinVertexFunction->GetEdgeStatus() )
+    {
+    default:
+    case OperatorType::EDGE_NULL:
+    case OperatorType::MESH_NULL:
+    case OperatorType::FACE_ISOLATED:
+    case OperatorType::SAMOSA_CONFIG:
+      break;
+    case OperatorType::EDGE_ISOLATED:
+    case OperatorType::TOO_MANY_COMMON_VERTICES:
+    case OperatorType::EDGE_JOINING_DIFFERENT_BORDERS:
+      out.push_back(iEdge);
+      break;
+    case OperatorType::TETRAHEDRON_CONFIG:
+      out.push_back(iEdge);
+      out.push_back( iEdge->GetOnext() );
+      out.push_back( iEdge->GetOprev() );
+      out.push_back( iEdge->GetSym() );
+      out.push_back( iEdge->GetSym()->GetOnext() );
+      out.push_back( iEdge->GetSym()->GetOprev() );
+      out.push_back( iEdge->GetOnext()->GetLnext() );
+      break;
+    case OperatorType::EYE_CONFIG:
+      {
+      OutputQEType *qe = iEdge;
+      if ( qe->GetSym()->GetOrder() == 2 )
+        {
+        qe = qe->GetSym();
+        }
+      out.push_back(qe);
+      out.push_back( qe->GetOnext() );
+      out.push_back( qe->GetSym()->GetOnext() );
+      out.push_back( qe->GetSym()->GetOprev() );
+      break;
+      }
+    }
+
+  for ( size_t i = 0; i < out.size(); ++i )
+    {
+    const OutputPointIdentifier org = out[i]->GetOrigin();
+    const OutputPointIdentifier dest = out[i]->GetDestination();
+    m_EdgesOutOfRounds.insert( EdgeEndsType( std::min(org, dest), std::max(org, dest) ) );
+    }
+}
+
+template< typename TInput, typename TOutput, typename TCriterion >
+ITK_THREAD_RETURN_TYPE
+EdgeDecimationQuadEdgeMeshFilter< TInput, TOutput, TCriterion >::MeasureEdgesThreaderCallback(void *arg)
+{
+  typedef MultiThreader::ThreadInfoStruct ThreadInfoType;
+  ThreadInfoType *info = static_cast< ThreadInfoType * >( arg );
+  ThreadStruct *  str = static_cast< ThreadStruct * >( info->UserData );
+
+  const SizeValueType numberOfEdges = str->Edges->size();
+  const SizeValueType numberOfThreads = info->NumberOfThreads;
+  const SizeValueType threadId = info->ThreadID;
+
+  const SizeValueType first = numberOfEdges / numberOfThreads * threadId
+                              + std::min( threadId, numberOfEdges % numberOfThreads );
+  const SizeValueType last = first + numberOfEdges / numberOfThreads
+                             + ( threadId < numberOfEdges % numberOfThreads ? 1 : 0 );
+
+  for ( SizeValueType i = first; i < last; ++i )
+    {
+    ( *str->Measures )[i] = str->Filter->MeasureEdge( ( *str->Edges )[i] );
+    }
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+template< typename TInput, typename TOutput, typename TCriterion >
+void
+EdgeDecimationQuadEdgeMeshFilter< TInput, TOutput, TCriterion >::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "ParallelDecimation: "
+     << ( m_ParallelDecimation ? "On" : "Off" ) << std::endl;
+}
 }
 #endif
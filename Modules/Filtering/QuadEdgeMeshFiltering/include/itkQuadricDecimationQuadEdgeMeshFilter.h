@@ -113,6 +113,21 @@ protected:
     oQ.AddTriangle(p[0], p[1], p[2]);
   }
 
+  /** \brief Quadric of a point, looked up without inserting it so that
+   * MeasureEdge can be called from several threads.
+   *  \param[in] iId point identifier
+   */
+  inline QuadricElementType GetQuadric(const OutputPointIdentifier & iId) const
+  {
+    typename QuadricElementMapType::const_iterator it = m_Quadric.find(iId);
+
+    if ( it != m_Quadric.end() )
+      {
+      return it->second;
+      }
+    return QuadricElementType();
+  }
+
   /** \brief Compute the measure value for iEdge
    * \param[in] iEdge input edge
    * \return measure value, here the corresponding quadric error
@@ -121,7 +136,7 @@ protected:
   {
     OutputPointIdentifier id_org = iEdge->GetOrigin();
     OutputPointIdentifier id_dest = iEdge->GetDestination();
-    QuadricElementType    Q = m_Quadric[id_org] + m_Quadric[id_dest];
+    QuadricElementType    Q = GetQuadric(id_org) + GetQuadric(id_dest);
 
     OutputPointType org = this->m_OutputMesh->GetPoint(id_org);
     OutputPointType dest = this->m_OutputMesh->GetPoint(id_dest);
@@ -20,6 +20,8 @@
 
 #include "itkDelaunayConformingQuadEdgeMeshFilter.h"
 #include "itkQuadEdgeMeshParamMatrixCoefficients.h"
+#include "itkMultiThreader.h"
+#include <vector>
 
 namespace itk
 {
@@ -40,7 +42,17 @@ namespace itk
  * CoefficientsComputation
  *
  * This process is then repeated for m_NumberOfIterations (the more iterations,
- * the smoother the output mesh will be).
+ * the smoother the output mesh will be). All the points of one iteration are
+ * moved from the positions of the previous iteration (Jacobi updates), which
+ * lets the points be split among NumberOfThreads threads and makes the output
+ * independent of the number of threads.
+ *
+ * \note Earlier versions moved the points in place from the second iteration
+ * on when DelaunayConforming was off, so that a point could see neighbors
+ * already moved in the same iteration (Gauss-Seidel updates). With more than
+ * one iteration and without DelaunayConforming, the output now differs
+ * slightly from the one of these versions; a single iteration, or any number
+ * of iterations with DelaunayConforming on, gives the same points as before.
  *
  * At each iteration, one can run DelaunayConformingQuadEdgeMeshFilter
  * resulting a more regular (in terms of connectivity) and smoother mesh.
@@ -130,7 +142,23 @@ protected:
 
   void GenerateData() ITK_OVERRIDE;
 
+  /** Compute the new positions of the points ids[first, last) of iMesh. */
+  void ThreadedSmooth(const OutputMeshType *iMesh,
+                      const std::vector< OutputPointIdentifier > & ids,
+                      std::vector< OutputPointType > & oPoints,
+                      SizeValueType first, SizeValueType last) const;
+
 private:
+  struct ThreadStruct
+    {
+    const Self *Filter;
+    const OutputMeshType *Mesh;
+    const std::vector< OutputPointIdentifier > *Ids;
+    std::vector< OutputPointType > *Points;
+    };
+
+  static ITK_THREAD_RETURN_TYPE SmoothThreaderCallback(void *arg);
+
   SmoothingQuadEdgeMeshFilter(const Self &);
   void operator=(const Self &);
 };
@@ -52,29 +52,16 @@ SetCoefficientsMethod(CoefficientsComputation *iMethod)
 template< typename TInputMesh, typename TOutputMesh >
 void SmoothingQuadEdgeMeshFilter< TInputMesh, TOutputMesh >::GenerateData()
 {
-  OutputPointIdentifier numberOfPoints = this->GetInput()->GetNumberOfPoints();
-
-  ProgressReporter progress( this, 0, m_NumberOfIterations * ( numberOfPoints + 1 ), 100 );
+  ProgressReporter progress( this, 0, m_NumberOfIterations, 100 );
 
   OutputMeshPointer mesh = OutputMeshType::New();
 
-  OutputPointsContainerPointer temp = OutputPointsContainer::New();
-  temp->Reserve( numberOfPoints );
-
   OutputPointsContainerPointer  points;
+  OutputPointsContainerPointer  temp;
   OutputPointsContainerIterator it;
 
-  OutputPointType  p;
-  OutputPointType  q;
-  OutputPointType  r;
-  OutputVectorType v;
-
-  OutputCoordType coeff;
-  OutputCoordType sum_coeff;
-  OutputCoordType den;
-
-  OutputQEType *qe;
-  OutputQEType *qe_it;
+  std::vector< OutputPointIdentifier > ids;
+  std::vector< OutputPointType >       smoothed;
 
   if ( this->m_DelaunayConforming )
     {
@@ -107,41 +94,35 @@ void SmoothingQuadEdgeMeshFilter< TInputMesh, TOutputMesh >::GenerateData()
     {
     points = mesh->GetPoints();
 
+    ids.clear();
     for ( it = points->Begin(); it != points->End(); ++it )
       {
-      p = it.Value();
-      qe = p.GetEdge();
-      if ( qe != ITK_NULLPTR )
-        {
-        r = p;
-        v.Fill(0.0);
-        qe_it = qe;
-        sum_coeff = 0.;
-        do
-          {
-          q = mesh->GetPoint( qe_it->GetDestination() );
-
-          coeff = ( *m_CoefficientsMethod )( mesh, qe_it );
-          sum_coeff += coeff;
-
-          v += coeff * ( q - p );
-          qe_it = qe_it->GetOnext();
-          }
-        while ( qe_it != qe );
-
-        den = 1.0 / static_cast< OutputCoordType >( sum_coeff );
-        v *= den;
-
-        r += m_RelaxationFactor * v;
-        r.SetEdge(qe);
-        temp->SetElement(it.Index(), r);
-        }
-      else
+      ids.push_back( it.Index() );
+      }
+    smoothed.resize( ids.size() );
+
+    if ( !ids.empty() )
+      {
+      ThreadStruct str;
+      str.Filter = this;
+      str.Mesh = mesh.GetPointer();
+      str.Ids = &ids;
+      str.Points = &smoothed;
+
+      ThreadIdType numberOfThreads = this->GetNumberOfThreads();
+      if ( static_cast< SizeValueType >( numberOfThreads ) > ids.size() )
         {
-        temp->SetElement(it.Index(), p);
+        numberOfThreads = static_cast< ThreadIdType >( ids.size() );
         }
+      this->GetMultiThreader()->SetNumberOfThreads(numberOfThreads);
+      this->GetMultiThreader()->SetSingleMethod(Self::SmoothThreaderCallback, &str);
+      this->GetMultiThreader()->SingleMethodExecute();
+      }
 
-      progress.CompletedPixel();
+    temp = OutputPointsContainer::New();
+    for ( size_t i = 0; i < ids.size(); ++i )
+      {
+      temp->InsertElement(ids[i], smoothed[i]);
       }
 
     mesh->SetPoints(temp);
@@ -173,6 +154,83 @@ void SmoothingQuadEdgeMeshFilter< TInputMesh, TOutputMesh >::GenerateData()
     }
 }
 
+template< typename TInputMesh, typename TOutputMesh >
+ITK_THREAD_RETURN_TYPE
+SmoothingQuadEdgeMeshFilter< TInputMesh, TOutputMesh >::SmoothThreaderCallback(void *arg)
+{
+  typedef MultiThreader::ThreadInfoStruct ThreadInfoType;
+  ThreadInfoType *info = static_cast< ThreadInfoType * >( arg );
+  ThreadStruct *  str = static_cast< ThreadStruct * >( info->UserData );
+
+  const SizeValueType numberOfPoints = str->Ids->size();
+  const SizeValueType numberOfThreads = info->NumberOfThreads;
+  const SizeValueType threadId = info->ThreadID;
+
+  const SizeValueType first = numberOfPoints / numberOfThreads * threadId
+                              + std::min( threadId, numberOfPoints % numberOfThreads );
+  const SizeValueType last = first + numberOfPoints / numberOfThreads
+                             + ( threadId < numberOfPoints % numberOfThreads ? 1 : 0 );
+
+  str->Filter->ThreadedSmooth(str->Mesh, *str->Ids, *str->Points, first, last);
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+template< typename TInputMesh, typename TOutputMesh >
+void SmoothingQuadEdgeMeshFilter< TInputMesh, TOutputMesh >
+::ThreadedSmooth(const OutputMeshType *iMesh,
+                 const std::vector< OutputPointIdentifier > & ids,
+                 std::vector< OutputPointType > & oPoints,
+                 SizeValueType first, SizeValueType last) const
+{
+  OutputPointType  p;
+  OutputPointType  q;
+  OutputPointType  r;
+  OutputVectorType v;
+
+  OutputCoordType coeff;
+  OutputCoordType sum_coeff;
+  OutputCoordType den;
+
+  OutputQEType *qe;
+  OutputQEType *qe_it;
+
+  for ( SizeValueType i = first; i < last; ++i )
+    {
+    p = iMesh->GetPoint( ids[i] );
+    qe = p.GetEdge();
+    if ( qe != ITK_NULLPTR )
+      {
+      r = p;
+      v.Fill(0.0);
+      qe_it = qe;
+      sum_coeff = 0.;
+      do
+        {
+        q = iMesh->GetPoint( qe_it->GetDestination() );
+
+        coeff = ( *m_CoefficientsMethod )( iMesh, qe_it );
+        sum_coeff += coeff;
+
+        v += coeff * ( q - p );
+        qe_it = qe_it->GetOnext();
+        }
+      while ( qe_it != qe );
+
+      den = 1.0 / static_cast< OutputCoordType >( sum_coeff );
+      v *= den;
+
+      r += m_RelaxationFactor * v;
+      r.SetEdge(qe);
+      oPoints[i] = r;
+      }
+    else
+      {
+      oPoints[i] = p;
+      }
+    }
+}
+
 template< typename TInputMesh, typename TOutputMesh >
 void SmoothingQuadEdgeMeshFilter< TInputMesh, TOutputMesh >
 ::PrintSelf(std::ostream & os, Indent indent) const
@@ -0,0 +1,152 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkDecimationQuadEdgeMeshFilterTestHelper_h
+#define itkDecimationQuadEdgeMeshFilterTestHelper_h
+
+#include "itkTriangleHelper.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+// Total area of the triangles of the mesh.
+template< typename TMesh >
+double ComputeSurfaceArea( const TMesh * mesh )
+{
+  typedef itk::TriangleHelper< typename TMesh::PointType > TriangleType;
+
+  double area = 0.;
+  for( typename TMesh::CellsContainer::ConstIterator it = mesh->GetCells()->Begin();
+       it != mesh->GetCells()->End(); ++it )
+    {
+    const typename TMesh::CellType * cell = it.Value();
+    if( cell->GetNumberOfPoints() == 3 )
+      {
+      typename TMesh::CellType::PointIdConstIterator pIt = cell->PointIdsBegin();
+      const typename TMesh::PointType a = mesh->GetPoint( *pIt++ );
+      const typename TMesh::PointType b = mesh->GetPoint( *pIt++ );
+      const typename TMesh::PointType c = mesh->GetPoint( *pIt );
+      area += TriangleType::ComputeArea( a, b, c );
+      }
+    }
+  return area;
+}
+
+// The parallel decimation has to reach the criterion, to keep the topology
+// of the sequential one and to approximate the input surface about as well.
+template< typename TMesh >
+bool CompareWithSequentialDecimation( const TMesh * input, const TMesh * sequential, const TMesh * parallel,
+                                      long N )
+{
+  typedef typename TMesh::CellIdentifier CellIdentifier;
+
+  if( parallel->GetNumberOfFaces() > static_cast< CellIdentifier >( N ) )
+    {
+    std::cerr << "Parallel decimation stopped at " << parallel->GetNumberOfFaces()
+              << " faces instead of " << N << std::endl;
+    return false;
+    }
+
+  const long sequentialEuler = static_cast< long >( sequential->GetNumberOfPoints() )
+    - static_cast< long >( sequential->GetNumberOfEdges() )
+    + static_cast< long >( sequential->GetNumberOfFaces() );
+  const long parallelEuler = static_cast< long >( parallel->GetNumberOfPoints() )
+    - static_cast< long >( parallel->GetNumberOfEdges() )
+    + static_cast< long >( parallel->GetNumberOfFaces() );
+  if( parallelEuler != sequentialEuler )
+    {
+    std::cerr << "Euler characteristic " << parallelEuler << " instead of "
+              << sequentialEuler << " with the sequential decimation" << std::endl;
+    return false;
+    }
+
+  const double inputArea = ComputeSurfaceArea( input );
+  const double sequentialArea = ComputeSurfaceArea( sequential );
+  const double parallelArea = ComputeSurfaceArea( parallel );
+  if( std::fabs( parallelArea - inputArea )
+      > std::fabs( sequentialArea - inputArea ) + 0.1 * inputArea )
+    {
+    std::cerr << "Surface area " << parallelArea << " instead of "
+              << sequentialArea << " with the sequential decimation, input area "
+              << inputArea << std::endl;
+    return false;
+    }
+
+  std::cout << "Input: " << input->GetNumberOfFaces()
+            << " faces, area " << inputArea << std::endl;
+  std::cout << "Sequential decimation: " << sequential->GetNumberOfFaces()
+            << " faces, area " << sequentialArea << std::endl;
+  std::cout << "Parallel decimation: " << parallel->GetNumberOfFaces()
+            << " faces, area " << parallelArea << std::endl;
+  return true;
+}
+
+// The parallel decimation only measures the edges on several threads, so
+// its output must not depend on the number of threads: same points, same
+// cells with the same point ids.
+template< typename TMesh >
+bool CompareDecimationsWithDifferentThreads( const TMesh * oneThread, const TMesh * severalThreads )
+{
+  typedef typename TMesh::PointsContainer::ConstIterator PointIterator;
+  typedef typename TMesh::CellsContainer::ConstIterator  CellIterator;
+
+  if( oneThread->GetNumberOfPoints() != severalThreads->GetNumberOfPoints()
+      || oneThread->GetNumberOfCells() != severalThreads->GetNumberOfCells() )
+    {
+    std::cerr << "Decimation with several threads has " << severalThreads->GetNumberOfPoints()
+              << " points and " << severalThreads->GetNumberOfCells() << " cells instead of "
+              << oneThread->GetNumberOfPoints() << " and " << oneThread->GetNumberOfCells() << std::endl;
+    return false;
+    }
+
+  PointIterator p1 = oneThread->GetPoints()->Begin();
+  PointIterator pN = severalThreads->GetPoints()->Begin();
+  for( ; p1 != oneThread->GetPoints()->End(); ++p1, ++pN )
+    {
+    if( p1.Index() != pN.Index() || p1.Value() != pN.Value() )
+      {
+      std::cerr << "Point " << p1.Index() << " " << p1.Value() << " is " << pN.Index()
+                << " " << pN.Value() << " with several threads" << std::endl;
+      return false;
+      }
+    }
+
+  CellIterator c1 = oneThread->GetCells()->Begin();
+  CellIterator cN = severalThreads->GetCells()->Begin();
+  for( ; c1 != oneThread->GetCells()->End(); ++c1, ++cN )
+    {
+    if( c1.Index() != cN.Index()
+        || c1.Value()->GetNumberOfPoints() != cN.Value()->GetNumberOfPoints() )
+      {
+      std::cerr << "Cell " << c1.Index() << " differs with several threads" << std::endl;
+      return false;
+      }
+    // the polygon cells fill their point ids in PointIdsBegin()
+    typedef typename TMesh::CellType::PointIdIterator PointIdIterator;
+    const PointIdIterator ids1 = c1.Value()->PointIdsBegin();
+    const PointIdIterator idsN = cN.Value()->PointIdsBegin();
+    if( !std::equal( ids1, ids1 + c1.Value()->GetNumberOfPoints(), idsN ) )
+      {
+      std::cerr << "Cell " << c1.Index() << " differs with several threads" << std::endl;
+      return false;
+      }
+    }
+
+  return true;
+}
+
+#endif
@@ -0,0 +1,152 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkQuadEdgeMesh.h"
+#include "itkRegularSphereMeshSource.h"
+#include "itkSmoothingQuadEdgeMeshFilter.h"
+
+#include <cmath>
+#include <map>
+
+// Smooth a bumpy sphere with 1 and 4 threads: both runs have to give the
+// same points, which have to be the ones of Jacobi updates computed here.
+int itkSmoothingQuadEdgeMeshFilterThreadsTest( int, char* [] )
+{
+  typedef float Coord;
+  const unsigned int Dimension = 3;
+
+  typedef itk::QuadEdgeMesh< Coord, Dimension >            MeshType;
+  typedef MeshType::PointType                              PointType;
+  typedef MeshType::PointIdentifier                        PointIdentifier;
+  typedef MeshType::QEType                                 QEType;
+  typedef MeshType::PointsContainer::ConstIterator         PointIterator;
+  typedef itk::RegularSphereMeshSource< MeshType >         SphereType;
+  typedef itk::SmoothingQuadEdgeMeshFilter< MeshType, MeshType > SmoothingType;
+
+  SphereType::Pointer sphere = SphereType::New();
+  sphere->SetResolution( 3 );
+  sphere->Update();
+
+  MeshType::Pointer mesh = sphere->GetOutput();
+  mesh->DisconnectPipeline();
+
+  // move the points along the radius, so that the smoothing has work to do
+  for ( PointIterator it = mesh->GetPoints()->Begin(); it != mesh->GetPoints()->End(); ++it )
+    {
+    PointType & p = mesh->GetPoints()->ElementAt( it.Index() );
+    const Coord factor = 1.0 + 0.2 * std::sin( 3.0 * p[0] + 2.0 * p[1] ) * std::cos( 5.0 * p[2] );
+    for ( unsigned int d = 0; d < Dimension; ++d )
+      {
+      p[d] *= factor;
+      }
+    }
+
+  const unsigned int numberOfIterations = 4;
+  const Coord        relaxationFactor = 0.3;
+
+  itk::OnesMatrixCoefficients< MeshType > coefficients;
+
+  MeshType::Pointer outputs[2];
+  const itk::ThreadIdType threads[2] = { 1, 4 };
+  for ( unsigned int t = 0; t < 2; ++t )
+    {
+    SmoothingType::Pointer filter = SmoothingType::New();
+    filter->SetInput( mesh );
+    filter->SetNumberOfIterations( numberOfIterations );
+    filter->SetRelaxationFactor( relaxationFactor );
+    filter->SetDelaunayConforming( false );
+    filter->SetCoefficientsMethod( &coefficients );
+    filter->SetNumberOfThreads( threads[t] );
+    filter->Update();
+    outputs[t] = filter->GetOutput();
+    outputs[t]->DisconnectPipeline();
+    }
+
+  // Jacobi updates: each iteration only reads the points of the previous one
+  std::map< PointIdentifier, PointType > current;
+  for ( PointIterator it = mesh->GetPoints()->Begin(); it != mesh->GetPoints()->End(); ++it )
+    {
+    current[it.Index()] = it.Value();
+    }
+  for ( unsigned int iter = 0; iter < numberOfIterations; ++iter )
+    {
+    std::map< PointIdentifier, PointType > next = current;
+    for ( PointIterator it = mesh->GetPoints()->Begin(); it != mesh->GetPoints()->End(); ++it )
+      {
+      QEType *qe = it.Value().GetEdge();
+      if ( qe == ITK_NULLPTR )
+        {
+        continue;
+        }
+      const PointType & p = current[it.Index()];
+      MeshType::VectorType v;
+      v.Fill( 0.0 );
+      Coord sum = 0.0;
+      QEType *qe_it = qe;
+      do
+        {
+        v += current[qe_it->GetDestination()] - p;
+        sum += 1.0;
+        qe_it = qe_it->GetOnext();
+        }
+      while ( qe_it != qe );
+      v *= 1.0 / sum;
+      for ( unsigned int d = 0; d < Dimension; ++d )
+        {
+        next[it.Index()][d] = p[d] + relaxationFactor * v[d];
+        }
+      }
+    current = next;
+    }
+
+  if ( outputs[0]->GetNumberOfPoints() != mesh->GetNumberOfPoints()
+       || outputs[1]->GetNumberOfPoints() != mesh->GetNumberOfPoints() )
+    {
+    std::cerr << "Wrong number of points" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  double maxError = 0.0;
+  double maxMove = 0.0;
+  for ( PointIterator it = mesh->GetPoints()->Begin(); it != mesh->GetPoints()->End(); ++it )
+    {
+    const PointType p1 = outputs[0]->GetPoint( it.Index() );
+    const PointType p4 = outputs[1]->GetPoint( it.Index() );
+    for ( unsigned int d = 0; d < Dimension; ++d )
+      {
+      if ( p1[d] != p4[d] )
+        {
+        std::cerr << "Point " << it.Index() << " differs between 1 and 4 threads: "
+                  << p1 << " != " << p4 << std::endl;
+        return EXIT_FAILURE;
+        }
+      maxError = std::max( maxError, static_cast< double >( std::fabs( p1[d] - current[it.Index()][d] ) ) );
+      maxMove = std::max( maxMove, static_cast< double >( std::fabs( p1[d] - it.Value()[d] ) ) );
+      }
+    }
+
+  std::cout << "Largest move: " << maxMove << ", largest error: " << maxError << std::endl;
+  if ( maxError > 1e-5 || maxMove < 1e-2 )
+    {
+    std::cerr << "The smoothed points are not the expected ones" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
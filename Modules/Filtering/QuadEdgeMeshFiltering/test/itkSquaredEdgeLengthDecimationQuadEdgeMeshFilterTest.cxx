@@ -22,6 +22,7 @@
 
 #include "itkQuadEdgeMeshDecimationCriteria.h"
 #include "itkSquaredEdgeLengthDecimationQuadEdgeMeshFilter.h"
+#include "itkDecimationQuadEdgeMeshFilterTestHelper.h"
 
 int itkSquaredEdgeLengthDecimationQuadEdgeMeshFilterTest( int argc, char* argv[] )
 {
@@ -32,6 +33,7 @@ int itkSquaredEdgeLengthDecimationQuadEdgeMeshFilterTest( int argc, char* argv[]
     std::cout << "1-Input file name " << std::endl;
     std::cout << "2-Number of Faces " << std::endl;
     std::cout << "3-Output file name " << std::endl;
+    std::cout << "4-Parallel decimation (optional, default 0)" << std::endl;
     return EXIT_FAILURE;
     }
 
@@ -75,8 +77,47 @@ int itkSquaredEdgeLengthDecimationQuadEdgeMeshFilterTest( int argc, char* argv[]
   DecimationType::Pointer decimate = DecimationType::New();
   decimate->SetInput( mesh );
   decimate->SetCriterion( criterion );
+
+  bool parallel = false;
+  if( argc > 4 )
+    {
+    std::stringstream ssout2( argv[4] );
+    ssout2 >> parallel;
+    }
+  decimate->SetParallelDecimation( parallel );
+  if( parallel )
+    {
+    decimate->SetNumberOfThreads( 4 );
+    }
   decimate->Update();
 
+  if( parallel )
+    {
+    DecimationType::Pointer oneThread = DecimationType::New();
+    oneThread->SetInput( mesh );
+    oneThread->SetCriterion( criterion );
+    oneThread->SetParallelDecimation( true );
+    oneThread->SetNumberOfThreads( 1 );
+    oneThread->Update();
+
+    if( !CompareDecimationsWithDifferentThreads< MeshType >( oneThread->GetOutput(),
+                                                             decimate->GetOutput() ) )
+      {
+      return EXIT_FAILURE;
+      }
+
+    DecimationType::Pointer sequential = DecimationType::New();
+    sequential->SetInput( mesh );
+    sequential->SetCriterion( criterion );
+    sequential->Update();
+
+    if( !CompareWithSequentialDecimation< MeshType >( mesh, sequential->GetOutput(),
+                                                      decimate->GetOutput(), N ) )
+      {
+      return EXIT_FAILURE;
+      }
+    }
+
   // ** WRITE OUTPUT **
   WriterType::Pointer writer = WriterType::New( );
   writer->SetInput( decimate->GetOutput( ) );
@@ -199,6 +199,28 @@ private:
   MeshFileReader(const Self &); // purposely not implemented
   void operator=(const Self &); // purposely not implemented
 
+  /** Whether TMesh stores the cells given to SetCell(). A QuadEdgeMesh,
+   * recognized by its QEPrimal type, builds its own edges and faces from
+   * them and deletes them instead, so they cannot live in cells blocks. */
+  template< typename TMesh >
+  class StoresCells
+  {
+    typedef char Yes;
+    typedef char No[2];
+    template< typename U >
+    static No & Test(typename U::QEPrimal *);
+    template< typename U >
+    static Yes & Test(...);
+
+public:
+    static const bool Value = sizeof( Test< TMesh >(0) ) == sizeof( Yes );
+  };
+
+  /** Hand the next cell of block over to cell without ownership, or a new
+   * cell with ownership if block is null, and return it. */
+  template< typename TCell >
+  static TCell * NextCell(TCell * & block, OutputCellAutoPointer & cell);
+
   std::string m_ExceptionMessage;
 };
 } // namespace ITK
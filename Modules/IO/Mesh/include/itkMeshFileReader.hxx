@@ -29,6 +29,7 @@
 
 #include <itksys/SystemTools.hxx>
 #include <fstream>
+#include <algorithm>
 
 namespace itk
 {
@@ -134,6 +135,23 @@ MeshFileReader< TOutputMesh, ConvertPointPixelTraits, ConvertCellPixelTraits >
     }
 }
 
+template< typename TOutputMesh, typename ConvertPointPixelTraits, typename ConvertCellPixelTraits >
+template< typename TCell >
+TCell *
+MeshFileReader< TOutputMesh, ConvertPointPixelTraits, ConvertCellPixelTraits >
+::NextCell(TCell * & block, OutputCellAutoPointer & cell)
+{
+  if ( block )
+    {
+    TCell *next = block++;
+    cell.TakeNoOwnership(next);
+    return next;
+    }
+  TCell *next = new TCell;
+  cell.TakeOwnership(next);
+  return next;
+}
+
 template< typename TOutputMesh, typename ConvertPointPixelTraits, typename ConvertCellPixelTraits >
 template< typename T >
 void
@@ -142,7 +160,73 @@ MeshFileReader< TOutputMesh, ConvertPointPixelTraits, ConvertCellPixelTraits >
 {
   typename TOutputMesh::Pointer output = this->GetOutput();
 
-  SizeValueType        index = NumericTraits< SizeValueType >::ZeroValue();
+  // Count the cells of each type first, so that they are allocated in one
+  // block per type rather than one by one. Polylines are split into lines
+  // and polygons with three points are loaded as triangles. Meshes that do
+  // not store their cells keep allocating them one by one.
+  OutputVertexCellType *           vertexCells = ITK_NULLPTR;
+  OutputLineCellType *             lineCells = ITK_NULLPTR;
+  OutputTriangleCellType *         triangleCells = ITK_NULLPTR;
+  OutputQuadrilateralCellType *    quadrilateralCells = ITK_NULLPTR;
+  OutputPolygonCellType *          polygonCells = ITK_NULLPTR;
+  OutputTetrahedronCellType *      tetrahedronCells = ITK_NULLPTR;
+  OutputHexahedronCellType *       hexahedronCells = ITK_NULLPTR;
+  OutputQuadraticEdgeCellType *    quadraticEdgeCells = ITK_NULLPTR;
+  OutputQuadraticTriangleCellType *quadraticTriangleCells = ITK_NULLPTR;
+
+  SizeValueType index = NumericTraits< SizeValueType >::ZeroValue();
+  if ( StoresCells< TOutputMesh >::Value )
+    {
+    SizeValueType numberOfCells[MeshIOBase::LAST_ITK_CELL];
+    std::fill(numberOfCells, numberOfCells + MeshIOBase::LAST_ITK_CELL, NumericTraits< SizeValueType >::ZeroValue());
+
+    while ( index < m_MeshIO->GetCellBufferSize() )
+      {
+      int          type = static_cast< int >( buffer[index++] );
+      unsigned int numberOfPoints = static_cast< unsigned int >( buffer[index++] );
+      if ( type < 0 || type >= MeshIOBase::LAST_ITK_CELL )
+        {
+        // Reported below.
+        break;
+        }
+      if ( type == MeshIOBase::LINE_CELL )
+        {
+        numberOfCells[type] += numberOfPoints > 1 ? numberOfPoints - 1 : 0;
+        }
+      else if ( type == MeshIOBase::POLYGON_CELL && numberOfPoints == OutputTriangleCellType::NumberOfPoints )
+        {
+        ++numberOfCells[MeshIOBase::TRIANGLE_CELL];
+        }
+      else
+        {
+        ++numberOfCells[type];
+        }
+      index += numberOfPoints;
+      }
+
+    output->SetCellsAllocationMethod(TOutputMesh::CellsAllocatedInBlocks);
+    vertexCells =
+      output->template AllocateCellsBlock< OutputVertexCellType >(numberOfCells[MeshIOBase::VERTEX_CELL]);
+    lineCells =
+      output->template AllocateCellsBlock< OutputLineCellType >(numberOfCells[MeshIOBase::LINE_CELL]);
+    triangleCells =
+      output->template AllocateCellsBlock< OutputTriangleCellType >(numberOfCells[MeshIOBase::TRIANGLE_CELL]);
+    quadrilateralCells =
+      output->template AllocateCellsBlock< OutputQuadrilateralCellType >(numberOfCells[MeshIOBase::QUADRILATERAL_CELL]);
+    polygonCells =
+      output->template AllocateCellsBlock< OutputPolygonCellType >(numberOfCells[MeshIOBase::POLYGON_CELL]);
+    tetrahedronCells =
+      output->template AllocateCellsBlock< OutputTetrahedronCellType >(numberOfCells[MeshIOBase::TETRAHEDRON_CELL]);
+    hexahedronCells =
+      output->template AllocateCellsBlock< OutputHexahedronCellType >(numberOfCells[MeshIOBase::HEXAHEDRON_CELL]);
+    quadraticEdgeCells =
+      output->template AllocateCellsBlock< OutputQuadraticEdgeCellType >(numberOfCells[MeshIOBase::QUADRATIC_EDGE_CELL]);
+    quadraticTriangleCells =
+      output->template AllocateCellsBlock< OutputQuadraticTriangleCellType >(
+        numberOfCells[MeshIOBase::QUADRATIC_TRIANGLE_CELL]);
+    }
+
+  index = NumericTraits< SizeValueType >::ZeroValue();
   OutputCellIdentifier id = NumericTraits< OutputCellIdentifier >::ZeroValue();
   while ( index < m_MeshIO->GetCellBufferSize() )
     {
@@ -157,13 +241,12 @@ MeshFileReader< TOutputMesh, ConvertPointPixelTraits, ConvertCellPixelTraits >
           itkExceptionMacro(<< "Invalid Vertex Cell with number of points = " << numberOfPoints);
           }
         OutputCellAutoPointer cell;
-        OutputVertexCellType *vertexCell = new OutputVertexCellType;
+        OutputVertexCellType *vertexCell = NextCell(vertexCells, cell);
         for ( unsigned int jj = 0; jj < OutputVertexCellType::NumberOfPoints; jj++ )
           {
           vertexCell->SetPointId( jj, static_cast< OutputPointIdentifier >( buffer[index++] ) );
           }
 
-        cell.TakeOwnership(vertexCell);
         output->SetCell(id++, cell);
         break;
         }
@@ -179,11 +262,10 @@ MeshFileReader< TOutputMesh, ConvertPointPixelTraits, ConvertCellPixelTraits >
         for ( unsigned int jj = 1; jj < numberOfPoints; ++jj )
           {
           OutputCellAutoPointer cell;
-          OutputLineCellType *  lineCell = new OutputLineCellType;
+          OutputLineCellType *  lineCell = NextCell(lineCells, cell);
           lineCell->SetPointId(0, pointIDBuffer);
           pointIDBuffer = static_cast< OutputPointIdentifier >( buffer[index++] );
           lineCell->SetPointId(1, pointIDBuffer);
-          cell.TakeOwnership(lineCell);
           output->SetCell(id++, cell);
           }
         break;
@@ -197,13 +279,12 @@ MeshFileReader< TOutputMesh, ConvertPointPixelTraits, ConvertCellPixelTraits >
           }
 
         OutputCellAutoPointer   cell;
-        OutputTriangleCellType *triangleCell = new OutputTriangleCellType;
+        OutputTriangleCellType *triangleCell = NextCell(triangleCells, cell);
         for ( unsigned int jj = 0; jj < OutputTriangleCellType::NumberOfPoints; jj++ )
           {
           triangleCell->SetPointId( jj, static_cast< OutputPointIdentifier >( buffer[index++] ) );
           }
 
-        cell.TakeOwnership(triangleCell);
         output->SetCell(id++, cell);
         break;
         }
@@ -216,13 +297,12 @@ MeshFileReader< TOutputMesh, ConvertPointPixelTraits, ConvertCellPixelTraits >
           }
 
         OutputCellAutoPointer        cell;
-        OutputQuadrilateralCellType *quadrilateralCell = new OutputQuadrilateralCellType;
+        OutputQuadrilateralCellType *quadrilateralCell = NextCell(quadrilateralCells, cell);
         for ( unsigned int jj = 0; jj < OutputQuadrilateralCellType::NumberOfPoints; jj++ )
           {
           quadrilateralCell->SetPointId( jj, static_cast< OutputPointIdentifier >( buffer[index++] ) );
           }
 
-        cell.TakeOwnership(quadrilateralCell);
         output->SetCell(id++, cell);
         break;
         }
@@ -234,21 +314,19 @@ MeshFileReader< TOutputMesh, ConvertPointPixelTraits, ConvertCellPixelTraits >
         unsigned int          numberOfPoints = static_cast< unsigned int >( buffer[index++] );
         if ( numberOfPoints == OutputTriangleCellType::NumberOfPoints )
           {
-          OutputTriangleCellType *triangleCell = new OutputTriangleCellType;
+          OutputTriangleCellType *triangleCell = NextCell(triangleCells, cell);
           for ( unsigned int jj = 0; jj < OutputTriangleCellType::NumberOfPoints; jj++ )
             {
             triangleCell->SetPointId( jj, static_cast< OutputPointIdentifier >( buffer[index++] ) );
             }
-          cell.TakeOwnership(triangleCell);
           }
         else
           {
-          OutputPolygonCellType *polygonCell = new OutputPolygonCellType;
+          OutputPolygonCellType *polygonCell = NextCell(polygonCells, cell);
           for ( unsigned int jj = 0; jj < numberOfPoints; jj++ )
             {
             polygonCell->SetPointId( jj, static_cast< OutputPointIdentifier >( buffer[index++] ) );
             }
-          cell.TakeOwnership(polygonCell);
           }
 
         output->SetCell(id++, cell);
@@ -263,13 +341,12 @@ MeshFileReader< TOutputMesh, ConvertPointPixelTraits, ConvertCellPixelTraits >
           }
 
         OutputCellAutoPointer      cell;
-        OutputTetrahedronCellType *tetrahedronCell = new OutputTetrahedronCellType;
+        OutputTetrahedronCellType *tetrahedronCell = NextCell(tetrahedronCells, cell);
         for ( unsigned int jj = 0; jj < OutputTetrahedronCellType::NumberOfPoints; jj++ )
           {
           tetrahedronCell->SetPointId( jj, static_cast< OutputPointIdentifier >( buffer[index++] ) );
           }
 
-        cell.TakeOwnership(tetrahedronCell);
         output->SetCell(id++, cell);
         break;
         }
@@ -282,13 +359,12 @@ MeshFileReader< TOutputMesh, ConvertPointPixelTraits, ConvertCellPixelTraits >
           }
 
         OutputCellAutoPointer     cell;
-        OutputHexahedronCellType *hexahedronCell = new OutputHexahedronCellType;
+        OutputHexahedronCellType *hexahedronCell = NextCell(hexahedronCells, cell);
         for ( unsigned int jj = 0; jj < OutputHexahedronCellType::NumberOfPoints; jj++ )
           {
           hexahedronCell->SetPointId( jj, static_cast< OutputPointIdentifier >( buffer[index++] ) );
           }
 
-        cell.TakeOwnership(hexahedronCell);
         output->SetCell(id++, cell);
         break;
         }
@@ -301,13 +377,12 @@ MeshFileReader< TOutputMesh, ConvertPointPixelTraits, ConvertCellPixelTraits >
           }
 
         OutputCellAutoPointer        cell;
-        OutputQuadraticEdgeCellType *quadraticEdgeCell = new OutputQuadraticEdgeCellType;
+        OutputQuadraticEdgeCellType *quadraticEdgeCell = NextCell(quadraticEdgeCells, cell);
         for ( unsigned int jj = 0; jj < OutputQuadraticEdgeCellType::NumberOfPoints; jj++ )
           {
           quadraticEdgeCell->SetPointId( jj, static_cast< OutputPointIdentifier >( buffer[index++] ) );
           }
 
-        cell.TakeOwnership(quadraticEdgeCell);
         output->SetCell(id++, cell);
         break;
         }
@@ -320,13 +395,12 @@ MeshFileReader< TOutputMesh, ConvertPointPixelTraits, ConvertCellPixelTraits >
           }
 
         OutputCellAutoPointer            cell;
-        OutputQuadraticTriangleCellType *quadraticTriangleCell = new OutputQuadraticTriangleCellType;
+        OutputQuadraticTriangleCellType *quadraticTriangleCell = NextCell(quadraticTriangleCells, cell);
         for ( unsigned int jj = 0; jj < OutputQuadraticTriangleCellType::NumberOfPoints; jj++ )
           {
           quadraticTriangleCell->SetPointId( jj, static_cast< OutputPointIdentifier >( buffer[index++] ) );
           }
 
-        cell.TakeOwnership(quadraticTriangleCell);
         output->SetCell(id++, cell);
         break;
         }
@@ -147,10 +147,11 @@ public:
         typename TreeType::InstanceIdentifierVectorType neighbors;
         this->m_KdTree->Search(queryPoint, this->m_NumberOfNeighbors, neighbors);
 
+        // Keep only the neighbors whose domain contains this pixel.
         ListPixelType L;
-        for ( unsigned int i = 0; i < this->m_NumberOfNeighbors; i++ )
+        for ( unsigned int i = 0; i < neighbors.size(); i++ )
           {
-          if ( this->m_LevelSetDataPointerVector[i]->VerifyInsideRegion(ind) )
+          if ( this->m_LevelSetDataPointerVector[neighbors[i]]->VerifyInsideRegion(ind) )
             {
             L.push_back(neighbors[i]);
             }
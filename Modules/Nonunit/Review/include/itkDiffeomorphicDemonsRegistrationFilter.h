@@ -23,6 +23,7 @@
 
 #include "itkMultiplyImageFilter.h"
 #include "itkExponentialDisplacementFieldImageFilter.h"
+#include "itkWarpAndAddDisplacementFieldImageFilter.h"
 
 namespace itk
 {
@@ -61,6 +62,15 @@ namespace itk
  * This class make use of the finite difference solver hierarchy. Update
  * for each iteration is computed in DemonsRegistrationFunction.
  *
+ * The composition of the current field with the exponential of the update
+ * is computed in a single threaded pass by
+ * WarpAndAddDisplacementFieldImageFilter, into a field that is allocated
+ * once per registration and whose buffer is swapped with the output buffer.
+ * With the first order approximation of the exponential and no smoothing of
+ * the update field, the composition is computed for each pixel right after
+ * its update, in the same threaded pass. The buffers of the exponential are
+ * also kept from one iteration to the next.
+ *
  * \author Tom Vercauteren, INRIA & Mauna Kea Technologies
  *
  * \warning This filter assumes that the fixed image type, moving image type
@@ -170,6 +180,18 @@ protected:
   /** Apply update. */
   virtual void ApplyUpdate(const TimeStepType& dt) ITK_OVERRIDE;
 
+  typedef typename Superclass::ThreadRegionType ThreadRegionType;
+
+  /** Compute the update over the region of one thread. When the
+   * composition is fused, the composition of the current field with the
+   * update is computed for each pixel as well. */
+  virtual TimeStepType ThreadedCalculateChange(const ThreadRegionType & regionToProcess,
+                                               ThreadIdType threadId) ITK_OVERRIDE;
+
+  /** This method is called after the solution has been generated. In this
+   * case, the filter releases the memory of the composition buffer. */
+  virtual void PostProcessOutput() ITK_OVERRIDE;
+
 private:
   DiffeomorphicDemonsRegistrationFilter(const Self &); //purposely not
                                                        // implemented
@@ -209,11 +231,17 @@ private:
   typedef typename FieldInterpolatorType::OutputType FieldInterpolatorOutputType;
   typedef typename AdderType::Pointer                AdderPointer;
 
+  typedef WarpAndAddDisplacementFieldImageFilter<
+    DisplacementFieldType >                               ComposerType;
+  typedef typename ComposerType::Pointer             ComposerPointer;
+
   MultiplyByConstantPointer m_Multiplier;
   FieldExponentiatorPointer m_Exponentiator;
-  VectorWarperPointer       m_Warper;
-  AdderPointer              m_Adder;
+  ComposerPointer           m_Composer;
+  FieldInterpolatorPointer  m_FieldInterpolator;
+  DisplacementFieldPointer  m_ComposedField;
   bool                      m_UseFirstOrderExp;
+  bool                      m_FuseComposition;
 };
 } // end namespace itk
 
@@ -20,6 +20,8 @@
 
 #include "itkDiffeomorphicDemonsRegistrationFilter.h"
 #include "itkSmoothingRecursiveGaussianImageFilter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkNeighborhoodAlgorithm.h"
 
 namespace itk
 {
@@ -29,7 +31,8 @@ namespace itk
 template< typename TFixedImage, typename TMovingImage, typename TDisplacementField >
 DiffeomorphicDemonsRegistrationFilter< TFixedImage, TMovingImage, TDisplacementField >
 ::DiffeomorphicDemonsRegistrationFilter():
-  m_UseFirstOrderExp(false)
+  m_UseFirstOrderExp(false),
+  m_FuseComposition(false)
 {
   typename DemonsRegistrationFunctionType::Pointer drfp;
   drfp = DemonsRegistrationFunctionType::New();
@@ -41,13 +44,17 @@ DiffeomorphicDemonsRegistrationFilter< TFixedImage, TMovingImage, TDisplacementF
 
   m_Exponentiator = FieldExponentiatorType::New();
 
-  m_Warper = VectorWarperType::New();
-  FieldInterpolatorPointer VectorInterpolator =
-    FieldInterpolatorType::New();
-  m_Warper->SetInterpolator(VectorInterpolator);
+  m_Composer = ComposerType::New();
+  m_FieldInterpolator = FieldInterpolatorType::New();
+  m_Composer->SetInterpolator(m_FieldInterpolator);
 
-  m_Adder = AdderType::New();
-  m_Adder->InPlaceOn();
+  // The exponential and the composition are written into buffers that are
+  // kept from one iteration to the next. This is the default for image
+  // filters, but is relied upon here.
+  m_Exponentiator->ReleaseDataBeforeUpdateFlagOff();
+  m_Composer->ReleaseDataBeforeUpdateFlagOff();
+
+  m_ComposedField = DisplacementFieldType::New();
 }
 
 /**
@@ -111,6 +118,102 @@ DiffeomorphicDemonsRegistrationFilter< TFixedImage, TMovingImage, TDisplacementF
 
   // call the superclass  implementation ( initializes f )
   Superclass::InitializeIteration();
+
+  // With the first order approximation and no smoothing of the update, the
+  // composition only needs the update at the pixel itself, so it is
+  // computed along with the update in ThreadedCalculateChange().
+  m_FuseComposition = m_UseFirstOrderExp && !this->GetSmoothUpdateField();
+  if ( m_FuseComposition )
+    {
+    m_FieldInterpolator->SetInputImage( this->GetOutput() );
+    }
+}
+
+/**
+ * Compute the update, and the composition when it is fused
+ */
+template< typename TFixedImage, typename TMovingImage, typename TDisplacementField >
+typename DiffeomorphicDemonsRegistrationFilter< TFixedImage, TMovingImage, TDisplacementField >::TimeStepType
+DiffeomorphicDemonsRegistrationFilter< TFixedImage, TMovingImage, TDisplacementField >
+::ThreadedCalculateChange(const ThreadRegionType & regionToProcess, ThreadIdType threadId)
+{
+  if ( !m_FuseComposition )
+    {
+    return Superclass::ThreadedCalculateChange(regionToProcess, threadId);
+    }
+
+  typedef typename DisplacementFieldType::PixelType               VectorType;
+  typedef typename VectorType::ValueType                          ValueType;
+  typedef typename DisplacementFieldType::PointType               PointType;
+  typedef typename FiniteDifferenceFunctionType::NeighborhoodType NeighborhoodIteratorType;
+  typedef ImageRegionIterator< DisplacementFieldType >            UpdateIteratorType;
+  typedef ImageRegionIteratorWithIndex< DisplacementFieldType >   ComposedIteratorType;
+
+  DisplacementFieldType *output = this->GetOutput();
+  DisplacementFieldType *update = this->GetUpdateBuffer();
+
+  const typename FiniteDifferenceFunctionType::Pointer df = this->GetDifferenceFunction();
+  const typename DisplacementFieldType::SizeType radius = df->GetRadius();
+
+  void *globalData = df->GetGlobalDataPointer();
+
+  // Process the non-boundary region and the boundary faces, as
+  // DenseFiniteDifferenceImageFilter does.
+  typedef NeighborhoodAlgorithm::ImageBoundaryFacesCalculator< DisplacementFieldType >
+  FaceCalculatorType;
+  typedef typename FaceCalculatorType::FaceListType FaceListType;
+
+  FaceCalculatorType faceCalculator;
+  FaceListType       faceList = faceCalculator(output, regionToProcess, radius);
+
+  PointType  point;
+  VectorType updateValue;
+  VectorType composedValue;
+
+  for ( typename FaceListType::iterator fIt = faceList.begin(); fIt != faceList.end(); ++fIt )
+    {
+    NeighborhoodIteratorType nD(radius, output, *fIt);
+    UpdateIteratorType       nU(update, *fIt);
+    ComposedIteratorType     nC(m_ComposedField, *fIt);
+
+    while ( !nD.IsAtEnd() )
+      {
+      updateValue = df->ComputeUpdate(nD, globalData);
+      nU.Value() = updateValue;
+
+      // s( x + u(x) ) + u(x), computed exactly as
+      // WarpAndAddDisplacementFieldImageFilter does.
+      m_ComposedField->TransformIndexToPhysicalPoint(nC.GetIndex(), point);
+      for ( unsigned int j = 0; j < ImageDimension; j++ )
+        {
+        point[j] += updateValue[j];
+        }
+
+      if ( m_FieldInterpolator->IsInsideBuffer(point) )
+        {
+        const FieldInterpolatorOutputType interpolatedValue = m_FieldInterpolator->Evaluate(point);
+        for ( unsigned int k = 0; k < ImageDimension; k++ )
+          {
+          composedValue[k] = static_cast< ValueType >( interpolatedValue[k] );
+          }
+        }
+      else
+        {
+        composedValue.Fill( NumericTraits< ValueType >::ZeroValue() );
+        }
+      composedValue += updateValue;
+      nC.Set(composedValue);
+
+      ++nD;
+      ++nU;
+      ++nC;
+      }
+    }
+
+  TimeStepType timeStep = df->ComputeGlobalTimeStep(globalData);
+  df->ReleaseGlobalDataPointer(globalData);
+
+  return timeStep;
 }
 
 /*
@@ -237,6 +340,24 @@ DiffeomorphicDemonsRegistrationFilter< TFixedImage, TMovingImage, TDisplacementF
   upbuf->SetSpacing( output->GetSpacing() );
   upbuf->SetDirection( output->GetDirection() );
   upbuf->Allocate();
+
+  // The composition buffer looks just like the output too.
+  m_ComposedField->CopyInformation( output );
+  m_ComposedField->SetRequestedRegion( output->GetRequestedRegion() );
+  m_ComposedField->SetBufferedRegion( output->GetBufferedRegion() );
+  m_ComposedField->Allocate();
+}
+
+/**
+ * Release the memory of the composition buffer
+ */
+template< typename TFixedImage, typename TMovingImage, typename TDisplacementField >
+void
+DiffeomorphicDemonsRegistrationFilter< TFixedImage, TMovingImage, TDisplacementField >
+::PostProcessOutput()
+{
+  this->Superclass::PostProcessOutput();
+  m_ComposedField->Initialize();
 }
 
 /**
@@ -247,99 +368,95 @@ void
 DiffeomorphicDemonsRegistrationFilter< TFixedImage, TMovingImage, TDisplacementField >
 ::ApplyUpdate(const TimeStepType& dt)
 {
-  // If we smooth the update buffer before applying it, then the are
-  // approximating a viscuous problem as opposed to an elastic problem
-  if ( this->GetSmoothUpdateField() )
-    {
-    this->SmoothUpdateField();
-    }
-
-  // Use time step if necessary. In many cases
-  // the time step is one so this will be skipped
-  if ( std::fabs(dt - 1.0) > 1.0e-4 )
-    {
-    itkDebugMacro("Using timestep: " << dt);
-    m_Multiplier->SetInput2(dt);
-    m_Multiplier->SetInput( this->GetUpdateBuffer() );
-    m_Multiplier->GraftOutput( this->GetUpdateBuffer() );
-    // in place update
-    m_Multiplier->Update();
-    // graft output back to this->GetUpdateBuffer()
-    this->GetUpdateBuffer()->Graft( m_Multiplier->GetOutput() );
-    }
-
-  if ( this->m_UseFirstOrderExp )
-    {
-    // use s <- s o (Id +u)
-
-    // skip exponential and compose the vector fields
-    m_Warper->SetOutputOrigin( this->GetUpdateBuffer()->GetOrigin() );
-    m_Warper->SetOutputSpacing( this->GetUpdateBuffer()->GetSpacing() );
-    m_Warper->SetOutputDirection( this->GetUpdateBuffer()->GetDirection() );
-    m_Warper->SetInput( this->GetOutput() );
-    m_Warper->SetDisplacementField( this->GetUpdateBuffer() );
-
-    m_Adder->SetInput1( m_Warper->GetOutput() );
-    m_Adder->SetInput2( this->GetUpdateBuffer() );
-
-    m_Adder->GetOutput()->SetRequestedRegion(
-      this->GetOutput()->GetRequestedRegion() );
-    }
-  else
+  // When the composition was fused with the computation of the update,
+  // it is already in the composition buffer unless a time step other than
+  // one has to be applied.
+  if ( !m_FuseComposition || std::fabs(dt - 1.0) > 1.0e-4 )
     {
-    // use s <- s o exp(u)
+    // If we smooth the update buffer before applying it, then the are
+    // approximating a viscuous problem as opposed to an elastic problem
+    if ( this->GetSmoothUpdateField() )
+      {
+      this->SmoothUpdateField();
+      }
 
-    // compute the exponential
-    m_Exponentiator->SetInput( this->GetUpdateBuffer() );
+    // Use time step if necessary. In many cases
+    // the time step is one so this will be skipped
+    if ( std::fabs(dt - 1.0) > 1.0e-4 )
+      {
+      itkDebugMacro("Using timestep: " << dt);
+      m_Multiplier->SetInput2(dt);
+      m_Multiplier->SetInput( this->GetUpdateBuffer() );
+      m_Multiplier->GraftOutput( this->GetUpdateBuffer() );
+      // in place update
+      m_Multiplier->Update();
+      // graft output back to this->GetUpdateBuffer()
+      this->GetUpdateBuffer()->Graft( m_Multiplier->GetOutput() );
+      }
 
-    const double imposedMaxUpStep = this->GetMaximumUpdateStepLength();
-    if ( imposedMaxUpStep > 0.0 )
+    if ( this->m_UseFirstOrderExp )
       {
-      // max(norm(Phi))/2^N <= 0.25*pixelspacing
-      const double numiterfloat = 2.0 + std::log(imposedMaxUpStep) / vnl_math::ln2;
-      unsigned int numiter = 0;
-      if ( numiterfloat > 0.0 )
-        {
-        numiter = Math::Ceil< unsigned int >(numiterfloat);
-        }
+      // use s <- s o (Id +u)
 
-      m_Exponentiator->AutomaticNumberOfIterationsOff();
-      m_Exponentiator->SetMaximumNumberOfIterations(numiter);
+      // skip exponential and compose the vector fields
+      m_Composer->SetDisplacementField( this->GetUpdateBuffer() );
       }
     else
       {
-      m_Exponentiator->AutomaticNumberOfIterationsOn();
-      // just set a high value so that automatic number of step
-      // is not thresholded
-      m_Exponentiator->SetMaximumNumberOfIterations(2000u);
-      }
+      // use s <- s o exp(u)
 
-    m_Exponentiator->GetOutput()->SetRequestedRegion(
-      this->GetOutput()->GetRequestedRegion() );
+      // compute the exponential
+      m_Exponentiator->SetInput( this->GetUpdateBuffer() );
 
-    m_Exponentiator->Update();
+      const double imposedMaxUpStep = this->GetMaximumUpdateStepLength();
+      if ( imposedMaxUpStep > 0.0 )
+        {
+        // max(norm(Phi))/2^N <= 0.25*pixelspacing
+        const double numiterfloat = 2.0 + std::log(imposedMaxUpStep) / vnl_math::ln2;
+        unsigned int numiter = 0;
+        if ( numiterfloat > 0.0 )
+          {
+          numiter = Math::Ceil< unsigned int >(numiterfloat);
+          }
+
+        m_Exponentiator->AutomaticNumberOfIterationsOff();
+        m_Exponentiator->SetMaximumNumberOfIterations(numiter);
+        }
+      else
+        {
+        m_Exponentiator->AutomaticNumberOfIterationsOn();
+        // just set a high value so that automatic number of step
+        // is not thresholded
+        m_Exponentiator->SetMaximumNumberOfIterations(2000u);
+        }
 
-    // compose the vector fields
-    m_Warper->SetOutputOrigin( this->GetUpdateBuffer()->GetOrigin() );
-    m_Warper->SetOutputSpacing( this->GetUpdateBuffer()->GetSpacing() );
-    m_Warper->SetOutputDirection( this->GetUpdateBuffer()->GetDirection() );
-    m_Warper->SetInput( this->GetOutput() );
-    m_Warper->SetDisplacementField( m_Exponentiator->GetOutput() );
+      m_Exponentiator->GetOutput()->SetRequestedRegion(
+        this->GetOutput()->GetRequestedRegion() );
 
-    m_Warper->Update();
+      m_Exponentiator->Update();
 
-    m_Adder->SetInput1( m_Warper->GetOutput() );
-    m_Adder->SetInput2( m_Exponentiator->GetOutput() );
+      // compose the vector fields
+      m_Composer->SetDisplacementField( m_Exponentiator->GetOutput() );
+      }
 
-    m_Adder->GetOutput()->SetRequestedRegion(
+    // The composition is written to the composition buffer, whose container
+    // is then swapped with the output one.
+    m_Composer->SetInput( this->GetOutput() );
+    m_Composer->GraftOutput( m_ComposedField );
+    m_Composer->GetOutput()->SetRequestedRegion(
       this->GetOutput()->GetRequestedRegion() );
-    }
+    m_Composer->SetNumberOfThreads( this->GetNumberOfThreads() );
+    m_Composer->Modified();
 
-  // Triggers update
-  m_Adder->Update();
+    // Triggers update
+    m_Composer->Update();
+    }
 
-  // Region passing stuff
-  this->GraftOutput( m_Adder->GetOutput() );
+  typedef typename DisplacementFieldType::PixelContainerPointer PixelContainerPointer;
+  PixelContainerPointer swapPtr = m_ComposedField->GetPixelContainer();
+  m_ComposedField->SetPixelContainer( this->GetOutput()->GetPixelContainer() );
+  this->GetOutput()->SetPixelContainer( swapPtr );
+  this->GetOutput()->Modified();
 
   DemonsRegistrationFunctionType *drfp = this->DownCastDifferenceFunctionType();
 
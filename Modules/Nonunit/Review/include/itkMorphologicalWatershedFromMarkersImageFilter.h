@@ -19,6 +19,8 @@
 #define itkMorphologicalWatershedFromMarkersImageFilter_h
 
 #include "itkImageToImageFilter.h"
+#include <utility>
+#include <vector>
 
 namespace itk
 {
@@ -172,7 +174,10 @@ protected:
    * \sa ProcessObject::EnlargeOutputRequestedRegion() */
   void EnlargeOutputRequestedRegion( DataObject *itkNotUsed(output) ) ITK_OVERRIDE;
 
-  /** The filter is single threaded. */
+  /** Without watershed line, the pixels reached from each flooding front
+   * are searched with the threads of the filter. The labels do not depend
+   * on the number of threads. With watershed line, the filter is single
+   * threaded. */
   void GenerateData() ITK_OVERRIDE;
 
 private:
@@ -180,9 +185,40 @@ private:
   MorphologicalWatershedFromMarkersImageFilter(const Self &);
   void operator=(const Self &); //purposely not implemented
 
+  /** Whether some neighbors of the pixel at \a index lie outside \a region. */
+  static bool IsOnRegionBorder(const LabelImageRegionType & region, const IndexType & index);
+
+  /** An unlabeled neighbor of a pixel of the flooding front, given by its
+   * buffer offset, and the label of that pixel. */
+  typedef std::pair< OffsetValueType, LabelImagePixelType > FrontNeighborType;
+  typedef std::vector< FrontNeighborType >                  FrontNeighborContainerType;
+
+  struct ThreadStruct
+    {
+    Self *Filter;
+    };
+
+  /** Search the unlabeled neighbors of the pixels of m_Front, with the
+   * threads of the filter if the front is large enough. */
+  void FindFrontNeighbors();
+
+  static ITK_THREAD_RETURN_TYPE FindFrontNeighborsThreaderCallback(void *arg);
+
+  /** Search the unlabeled neighbors of a contiguous part of m_Front, in
+   * order. */
+  void ThreadedFindFrontNeighbors(ThreadIdType threadId, ThreadIdType numberOfThreads);
+
   bool m_FullyConnected;
 
   bool m_MarkWatershedLine;
+
+  // the neighbors of a pixel, in the order of the connectivity iterator
+  std::vector< typename LabelImageType::OffsetType > m_NeighborOffsets;
+  std::vector< OffsetValueType >                     m_NeighborBufferOffsets;
+
+  // the flooding front and the neighbors found by each thread
+  std::vector< OffsetValueType >            m_Front;
+  std::vector< FrontNeighborContainerType > m_ThreadFrontNeighbors;
 }; // end of class
 } // end namespace itk
 
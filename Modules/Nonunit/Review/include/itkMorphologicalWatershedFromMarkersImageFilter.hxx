@@ -19,14 +19,12 @@
 #define itkMorphologicalWatershedFromMarkersImageFilter_hxx
 
 #include <algorithm>
-#include <queue>
-#include <list>
+#include <deque>
+#include <map>
+#include <vector>
 #include "itkMorphologicalWatershedFromMarkersImageFilter.h"
 #include "itkProgressReporter.h"
-#include "itkImageRegionIterator.h"
-#include "itkImageRegionConstIteratorWithIndex.h"
 #include "itkConstShapedNeighborhoodIterator.h"
-#include "itkConstantBoundaryCondition.h"
 #include "itkSize.h"
 #include "itkConnectedComponentAlgorithm.h"
 
@@ -125,40 +123,53 @@ MorphologicalWatershedFromMarkersImageFilter< TInputImage, TLabelImage >
     itkExceptionMacro(<< "Marker and input must have the same size.");
     }
 
+  // The three images share the same buffered region, so a pixel is
+  // addressed by its offset in the buffers. The hierarchical queue stores
+  // these offsets rather than indexes, and the neighbors are reached through
+  // precomputed buffer offsets instead of shaped neighborhood iterators.
+  const LabelImageRegionType region = outputImage->GetBufferedRegion();
+  const SizeValueType        numberOfPixels = region.GetNumberOfPixels();
+
+  const InputImagePixelType *inputBuffer = inputImage->GetBufferPointer();
+  const LabelImagePixelType *markerBuffer = markerImage->GetBufferPointer();
+  LabelImagePixelType *      outputBuffer = outputImage->GetBufferPointer();
+
   // FAH (in french: File d'Attente Hierarchique)
-  typedef std::queue< IndexType >                    QueueType;
+  typedef std::deque< OffsetValueType >              QueueType;
   typedef std::map< InputImagePixelType, QueueType > MapType;
   MapType fah;
 
-  // the radius which will be used for all the shaped iterators
+  // the neighbors, in the order the connectivity iterator visits them
+  typedef typename LabelImageType::OffsetType OffsetType;
+  std::vector< OffsetType > &      neighborOffsets = m_NeighborOffsets;
+  std::vector< OffsetValueType > & neighborBufferOffsets = m_NeighborBufferOffsets;
+  neighborOffsets.clear();
+  neighborBufferOffsets.clear();
+  {
   Size< ImageDimension > radius;
   radius.Fill(1);
+  typedef ConstShapedNeighborhoodIterator< LabelImageType > NeighborhoodIteratorType;
+  NeighborhoodIteratorType nIt( radius, outputImage, region );
+  setConnectivity(&nIt, m_FullyConnected);
+  const OffsetValueType *offsetTable = outputImage->GetOffsetTable();
+  for ( typename NeighborhoodIteratorType::ConstIterator it = nIt.Begin(); it != nIt.End(); ++it )
+    {
+    const OffsetType offset = it.GetNeighborhoodOffset();
+    OffsetValueType  bufferOffset = 0;
+    for ( unsigned int d = 0; d < ImageDimension; ++d )
+      {
+      bufferOffset += offset[d] * offsetTable[d];
+      }
+    neighborOffsets.push_back(offset);
+    neighborBufferOffsets.push_back(bufferOffset);
+    }
+  }
+  const unsigned int numberOfNeighbors = static_cast< unsigned int >( neighborOffsets.size() );
 
-  // iterator for the marker image
-  typedef ConstShapedNeighborhoodIterator< LabelImageType > MarkerIteratorType;
-  typename MarkerIteratorType::ConstIterator nmIt;
-  MarkerIteratorType
-  markerIt( radius, markerImage, markerImage->GetRequestedRegion() );
-  // add a boundary constant to avoid adding pixels on the border in the fah
-  ConstantBoundaryCondition< LabelImageType > lcbc;
-  lcbc.SetConstant( NumericTraits< LabelImagePixelType >::max() );
-  markerIt.OverrideBoundaryCondition(&lcbc);
-  setConnectivity(&markerIt, m_FullyConnected);
-
-  // iterator for the input image
-  typedef ConstShapedNeighborhoodIterator< InputImageType > InputIteratorType;
-  InputIteratorType
-  inputIt( radius, inputImage, inputImage->GetRequestedRegion() );
-  typename InputIteratorType::ConstIterator niIt;
-  setConnectivity(&inputIt, m_FullyConnected);
-
-  // iterator for the output image
-  typedef ShapedNeighborhoodIterator< LabelImageType > OutputIteratorType;
-  typedef typename OutputIteratorType::OffsetType      OffsetType;
-  typename OutputIteratorType::Iterator noIt;
-  OutputIteratorType
-  outputIt( radius, outputImage, outputImage->GetRequestedRegion() );
-  setConnectivity(&outputIt, m_FullyConnected);
+  // Pixels outside the image are never labeled nor flooded, so only the
+  // neighbors of the pixels on the border of the region have to be checked.
+  IndexType index;
+  bool      onBorder;
 
   //---------------------------------------------------------------------------
   // Meyer's algorithm
@@ -171,72 +182,44 @@ MorphologicalWatershedFromMarkersImageFilter< TInputImage, TLabelImage >
     //  - init FAH with indexes of background pixels with marker pixel(s) in
     //    their neighborhood
 
-    ConstantBoundaryCondition< LabelImageType > lcbc2;
-    // outside pixel are watershed so they won't be use to find real watershed
-    // pixels
-    lcbc2.SetConstant(wsLabel);
-    outputIt.OverrideBoundaryCondition(&lcbc2);
-
-    // create a temporary image to store the state of each pixel (processed or
-    // not)
-    typedef Image< bool, ImageDimension > StatusImageType;
-    typename StatusImageType::Pointer statusImage = StatusImageType::New();
-    statusImage->SetRegions( markerImage->GetLargestPossibleRegion() );
-    statusImage->Allocate();
-
-    // iterator for the status image
-    typedef ShapedNeighborhoodIterator< StatusImageType > StatusIteratorType;
-    typename StatusIteratorType::Iterator nsIt;
-    StatusIteratorType
-                                                 statusIt( radius, statusImage, outputImage->GetRequestedRegion() );
-    ConstantBoundaryCondition< StatusImageType > bcbc;
-    bcbc.SetConstant(true);    // outside pixel are already processed
-    statusIt.OverrideBoundaryCondition(&bcbc);
-    setConnectivity(&statusIt, m_FullyConnected);
-
-    // the status image must be initialized before the first stage. In the
-    // first stage, the set to true are the neighbors of the marker (and the
-    // marker) so it's difficult (impossible ?) to init the status image at
-    // the same time
-    // the overhead should be small
-    statusImage->FillBuffer(false);
-
-    for ( markerIt.GoToBegin(), statusIt.GoToBegin(), outputIt.GoToBegin(), inputIt.GoToBegin();
-          !markerIt.IsAtEnd();
-          ++markerIt, ++outputIt )
+    // a temporary buffer to store the state of each pixel (processed or
+    // not). Outside pixels are considered already processed.
+    // The status must be initialized before the first stage. In the first
+    // stage, the set to true are the neighbors of the marker (and the marker)
+    // so it's difficult (impossible ?) to init the status at the same time
+    std::vector< bool > status( numberOfPixels, false );
+
+    for ( OffsetValueType o = 0; o < static_cast< OffsetValueType >( numberOfPixels ); ++o )
       {
-      LabelImagePixelType markerPixel = markerIt.GetCenterPixel();
+      const LabelImagePixelType markerPixel = markerBuffer[o];
       if ( markerPixel != bgLabel )
         {
-        IndexType idx = markerIt.GetIndex();
-
-        // move the iterators to the right place
-        OffsetType shift = idx - statusIt.GetIndex();
-        statusIt += shift;
-        inputIt += shift;
-
         // this pixel belongs to a marker
         // mark it as already processed
-        statusIt.SetCenterPixel(true);
+        status[o] = true;
         // copy it to the output image
-        outputIt.SetCenterPixel(markerPixel);
+        outputBuffer[o] = markerPixel;
         // and increase progress because this pixel will not be used in the
         // flooding stage.
         progress.CompletedPixel();
 
         // search the background pixels in the neighborhood
-        for ( nmIt = markerIt.Begin(), nsIt = statusIt.Begin(), niIt = inputIt.Begin();
-              nmIt != markerIt.End();
-              nmIt++, nsIt++, niIt++ )
+        index = outputImage->ComputeIndex(o);
+        onBorder = IsOnRegionBorder(region, index);
+        for ( unsigned int n = 0; n < numberOfNeighbors; ++n )
           {
-          if ( !nsIt.Get() && nmIt.Get() == bgLabel )
+          if ( onBorder && !region.IsInside( index + neighborOffsets[n] ) )
+            {
+            continue;
+            }
+          const OffsetValueType no = o + neighborBufferOffsets[n];
+          if ( !status[no] && markerBuffer[no] == bgLabel )
             {
             // this neighbor is a background pixel and is not already
             // processed; add its index to fah
-            fah[niIt.Get()].push( markerIt.GetIndex()
-                                  + nmIt.GetNeighborhoodOffset() );
+            fah[inputBuffer[no]].push_back(no);
             // mark it as already in the fah to avoid adding it several times
-            nsIt.Set(true);
+            status[no] = true;
             }
           }
         }
@@ -244,88 +227,79 @@ MorphologicalWatershedFromMarkersImageFilter< TInputImage, TLabelImage >
         {
         // Some pixels may be never processed so, by default, non marked pixels
         // must be marked as watershed
-        outputIt.SetCenterPixel(wsLabel);
+        outputBuffer[o] = wsLabel;
         }
       // one more pixel done in the init stage
       progress.CompletedPixel();
       }
-    // fill the borders of the status image with "true"
-    //FillSides<StatusImageType>(statusImage, true);
-    // Now disable the boundary checks
-    //outputIt.NeedToUseBoundaryConditionOff();
-    //statusIt.NeedToUseBoundaryConditionOff();
-    //inputIt.NeedToUseBoundaryConditionOff();
     // end of init stage
 
     // flooding
-    // init all the iterators
-    outputIt.GoToBegin();
-    statusIt.GoToBegin();
-    inputIt.GoToBegin();
-
-    // and start flooding
+    QueueType currentQueue;
     while ( !fah.empty() )
       {
       // store the current vars
       InputImagePixelType currentValue = fah.begin()->first;
-      QueueType           currentQueue = fah.begin()->second;
+      currentQueue.swap( fah.begin()->second );
       // and remove them from the fah
       fah.erase( fah.begin() );
 
       while ( !currentQueue.empty() )
         {
-        IndexType idx = currentQueue.front();
-        currentQueue.pop();
+        const OffsetValueType o = currentQueue.front();
+        currentQueue.pop_front();
 
-        // move the iterators to the right place
-        OffsetType shift = idx - outputIt.GetIndex();
-        outputIt += shift;
-        statusIt += shift;
-        inputIt += shift;
+        index = outputImage->ComputeIndex(o);
+        onBorder = IsOnRegionBorder(region, index);
 
         // iterate over the neighbors. If there is only one marker value, give
         // that value to the pixel, else keep it as is (watershed line)
         LabelImagePixelType marker = wsLabel;
         bool                collision = false;
-        for ( noIt = outputIt.Begin(); noIt != outputIt.End(); noIt++ )
+        for ( unsigned int n = 0; n < numberOfNeighbors; ++n )
           {
-          LabelImagePixelType o = noIt.Get();
-          if ( o != wsLabel )
+          if ( onBorder && !region.IsInside( index + neighborOffsets[n] ) )
             {
-            if ( marker != wsLabel && o != marker )
+            continue;
+            }
+          LabelImagePixelType no = outputBuffer[o + neighborBufferOffsets[n]];
+          if ( no != wsLabel )
+            {
+            if ( marker != wsLabel && no != marker )
               {
               collision = true;
               break;
               }
             else
-                  { marker = o; }
+                  { marker = no; }
             }
           }
         if ( !collision )
           {
           // set the marker value
-          outputIt.SetCenterPixel(marker);
+          outputBuffer[o] = marker;
           // and propagate to the neighbors
-          for ( niIt = inputIt.Begin(), nsIt = statusIt.Begin();
-                niIt != inputIt.End();
-                niIt++, nsIt++ )
+          for ( unsigned int n = 0; n < numberOfNeighbors; ++n )
             {
-            if ( !nsIt.Get() )
+            if ( onBorder && !region.IsInside( index + neighborOffsets[n] ) )
+              {
+              continue;
+              }
+            const OffsetValueType no = o + neighborBufferOffsets[n];
+            if ( !status[no] )
               {
               // the pixel is not yet processed. add it to the fah
-              InputImagePixelType GrayVal = niIt.Get();
+              InputImagePixelType GrayVal = inputBuffer[no];
               if ( GrayVal <= currentValue )
                 {
-                currentQueue.push( inputIt.GetIndex()
-                                   + niIt.GetNeighborhoodOffset() );
+                currentQueue.push_back(no);
                 }
               else
                 {
-                fah[GrayVal].push( inputIt.GetIndex()
-                                   + niIt.GetNeighborhoodOffset() );
+                fah[GrayVal].push_back(no);
                 }
               // mark it as already in the fah
-              nsIt.Set(true);
+              status[no] = true;
               }
             }
           }
@@ -345,31 +319,25 @@ MorphologicalWatershedFromMarkersImageFilter< TInputImage, TLabelImage >
     //  - init FAH with indexes of pixels with background pixel in their
     //    neighborhood
 
-    ConstantBoundaryCondition< LabelImageType > lcbc2;
-    // outside pixel are watershed so they won't be use to find real watershed
-    // pixels
-    lcbc2.SetConstant( NumericTraits< LabelImagePixelType >::max() );
-    outputIt.OverrideBoundaryCondition(&lcbc2);
-
-    for ( markerIt.GoToBegin(), outputIt.GoToBegin(), inputIt.GoToBegin();
-          !markerIt.IsAtEnd();
-          ++markerIt, ++outputIt )
+    for ( OffsetValueType o = 0; o < static_cast< OffsetValueType >( numberOfPixels ); ++o )
       {
-      LabelImagePixelType markerPixel = markerIt.GetCenterPixel();
+      const LabelImagePixelType markerPixel = markerBuffer[o];
       if ( markerPixel != bgLabel )
         {
-        IndexType  idx = markerIt.GetIndex();
-        OffsetType shift = idx - inputIt.GetIndex();
-        inputIt += shift;
-
         // this pixels belongs to a marker
         // copy it to the output image
-        outputIt.SetCenterPixel(markerPixel);
+        outputBuffer[o] = markerPixel;
         // search if it has background pixel in its neighborhood
+        index = outputImage->ComputeIndex(o);
+        onBorder = IsOnRegionBorder(region, index);
         bool haveBgNeighbor = false;
-        for ( nmIt = markerIt.Begin(); nmIt != markerIt.End(); nmIt++ )
+        for ( unsigned int n = 0; n < numberOfNeighbors; ++n )
           {
-          if ( nmIt.Get() == bgLabel )
+          if ( onBorder && !region.IsInside( index + neighborOffsets[n] ) )
+            {
+            continue;
+            }
+          if ( markerBuffer[o + neighborBufferOffsets[n]] == bgLabel )
             {
             haveBgNeighbor = true;
             break;
@@ -378,7 +346,7 @@ MorphologicalWatershedFromMarkersImageFilter< TInputImage, TLabelImage >
         if ( haveBgNeighbor )
           {
           // there is a background pixel in the neighborhood; add to fah
-          fah[inputIt.GetCenterPixel()].push( markerIt.GetIndex() );
+          fah[inputBuffer[o]].push_back(o);
           }
         else
           {
@@ -389,65 +357,181 @@ MorphologicalWatershedFromMarkersImageFilter< TInputImage, TLabelImage >
         }
       else
         {
-        outputIt.SetCenterPixel(wsLabel);
+        outputBuffer[o] = wsLabel;
         }
       progress.CompletedPixel();
       }
     // end of init stage
 
     // flooding
-    // init all the iterators
-    outputIt.GoToBegin();
-    inputIt.GoToBegin();
-
-    // and start flooding
+    // The queue of a level is processed front by front: the pixels reached
+    // from a front form the next one, in the order of the queue. The
+    // threads search the unlabeled neighbors of contiguous parts of the
+    // front, which are then labeled in order, the first pixel of the front
+    // to reach a neighbor giving it its label. The pixels are thus labeled
+    // and queued as with a single queue, whatever the number of threads.
+    std::vector< OffsetValueType > nextFront;
     while ( !fah.empty() )
       {
       // store the current vars
       InputImagePixelType currentValue = fah.begin()->first;
-      QueueType           currentQueue = fah.begin()->second;
+      m_Front.assign( fah.begin()->second.begin(), fah.begin()->second.end() );
       // and remove them from the fah
       fah.erase( fah.begin() );
 
-      while ( !currentQueue.empty() )
+      while ( !m_Front.empty() )
         {
-        IndexType idx = currentQueue.front();
-        currentQueue.pop();
-
-        // move the iterators to the right place
-        OffsetType shift = idx - outputIt.GetIndex();
-        outputIt += shift;
-        inputIt += shift;
-
-        LabelImagePixelType currentMarker = outputIt.GetCenterPixel();
-        // get the current value of the pixel
-        // iterate over neighbors to propagate the marker
-        for ( noIt = outputIt.Begin(), niIt = inputIt.Begin();
-              noIt != outputIt.End();
-              noIt++, niIt++ )
+        this->FindFrontNeighbors();
+
+        nextFront.clear();
+        for ( ThreadIdType t = 0; t < m_ThreadFrontNeighbors.size(); ++t )
           {
-          if ( noIt.Get() == wsLabel )
+          const FrontNeighborContainerType & neighbors = m_ThreadFrontNeighbors[t];
+          for ( typename FrontNeighborContainerType::const_iterator it = neighbors.begin();
+                it != neighbors.end(); ++it )
             {
-            // the pixel is not yet processed. It can be labeled with the
-            // current label
-            noIt.Set(currentMarker);
-            InputImagePixelType GrayVal = niIt.Get();
-            if ( GrayVal <= currentValue )
+            const OffsetValueType no = it->first;
+            if ( outputBuffer[no] == wsLabel )
               {
-              currentQueue.push( inputIt.GetIndex()
-                                 + noIt.GetNeighborhoodOffset() );
-              }
-            else
-              {
-              fah[GrayVal].push( inputIt.GetIndex()
-                                 + noIt.GetNeighborhoodOffset() );
+              // the pixel is not yet processed. It can be labeled with the
+              // label of the pixel of the front which reached it
+              outputBuffer[no] = it->second;
+              InputImagePixelType GrayVal = inputBuffer[no];
+              if ( GrayVal <= currentValue )
+                {
+                nextFront.push_back(no);
+                }
+              else
+                {
+                fah[GrayVal].push_back(no);
+                }
+              progress.CompletedPixel();
               }
-            progress.CompletedPixel();
             }
           }
+        m_Front.swap(nextFront);
         }
       }
+
+    // release the memory of the flooding
+    std::vector< OffsetValueType >().swap(m_Front);
+    std::vector< FrontNeighborContainerType >().swap(m_ThreadFrontNeighbors);
+    }
+
+  std::vector< OffsetType >().swap(m_NeighborOffsets);
+  std::vector< OffsetValueType >().swap(m_NeighborBufferOffsets);
+}
+
+template< typename TInputImage, typename TLabelImage >
+void
+MorphologicalWatershedFromMarkersImageFilter< TInputImage, TLabelImage >
+::FindFrontNeighbors()
+{
+  // Small fronts are not worth starting the threads.
+  const SizeValueType minimumFrontSizePerThread = 1024;
+  ThreadIdType numberOfThreads = this->GetNumberOfThreads();
+  if ( m_Front.size() < minimumFrontSizePerThread * numberOfThreads )
+    {
+    numberOfThreads = std::max( static_cast< ThreadIdType >( 1 ),
+      static_cast< ThreadIdType >( m_Front.size() / minimumFrontSizePerThread ) );
+    }
+  if ( numberOfThreads > 1 )
+    {
+    this->GetMultiThreader()->SetNumberOfThreads(numberOfThreads);
+    numberOfThreads = this->GetMultiThreader()->GetNumberOfThreads();
+    }
+
+  m_ThreadFrontNeighbors.resize(numberOfThreads);
+
+  if ( numberOfThreads == 1 )
+    {
+    this->ThreadedFindFrontNeighbors(0, 1);
+    }
+  else
+    {
+    ThreadStruct str;
+    str.Filter = this;
+    this->GetMultiThreader()->SetSingleMethod(this->FindFrontNeighborsThreaderCallback, &str);
+    this->GetMultiThreader()->SingleMethodExecute();
+    }
+}
+
+template< typename TInputImage, typename TLabelImage >
+ITK_THREAD_RETURN_TYPE
+MorphologicalWatershedFromMarkersImageFilter< TInputImage, TLabelImage >
+::FindFrontNeighborsThreaderCallback(void *arg)
+{
+  MultiThreader::ThreadInfoStruct *info = static_cast< MultiThreader::ThreadInfoStruct * >( arg );
+  ThreadStruct *str = static_cast< ThreadStruct * >( info->UserData );
+
+  str->Filter->ThreadedFindFrontNeighbors(info->ThreadID, info->NumberOfThreads);
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+template< typename TInputImage, typename TLabelImage >
+void
+MorphologicalWatershedFromMarkersImageFilter< TInputImage, TLabelImage >
+::ThreadedFindFrontNeighbors(ThreadIdType threadId, ThreadIdType numberOfThreads)
+{
+  static const LabelImagePixelType wsLabel =
+    NumericTraits< LabelImagePixelType >::ZeroValue();
+
+  const LabelImageType *      outputImage = this->GetOutput();
+  const LabelImageRegionType  region = outputImage->GetBufferedRegion();
+  const LabelImagePixelType * outputBuffer = outputImage->GetBufferPointer();
+  const unsigned int          numberOfNeighbors = static_cast< unsigned int >( m_NeighborOffsets.size() );
+
+  // contiguous part of the front, so that the neighbors are found in the
+  // order of the front
+  SizeValueType       count = m_Front.size() / numberOfThreads;
+  const SizeValueType remainder = m_Front.size() % numberOfThreads;
+  const SizeValueType first = threadId * count + std::min( static_cast< SizeValueType >( threadId ), remainder );
+  if ( threadId < remainder )
+    {
+    ++count;
+    }
+
+  FrontNeighborContainerType & neighbors = m_ThreadFrontNeighbors[threadId];
+  neighbors.clear();
+
+  for ( SizeValueType i = first; i < first + count; ++i )
+    {
+    const OffsetValueType     o = m_Front[i];
+    const IndexType           index = outputImage->ComputeIndex(o);
+    const bool                onBorder = IsOnRegionBorder(region, index);
+    const LabelImagePixelType currentMarker = outputBuffer[o];
+
+    // the neighbors not yet labeled can be labeled with the current label
+    for ( unsigned int n = 0; n < numberOfNeighbors; ++n )
+      {
+      if ( onBorder && !region.IsInside( index + m_NeighborOffsets[n] ) )
+        {
+        continue;
+        }
+      const OffsetValueType no = o + m_NeighborBufferOffsets[n];
+      if ( outputBuffer[no] == wsLabel )
+        {
+        neighbors.push_back( FrontNeighborType(no, currentMarker) );
+        }
+      }
+    }
+}
+
+template< typename TInputImage, typename TLabelImage >
+bool
+MorphologicalWatershedFromMarkersImageFilter< TInputImage, TLabelImage >
+::IsOnRegionBorder(const LabelImageRegionType & region, const IndexType & index)
+{
+  for ( unsigned int d = 0; d < ImageDimension; ++d )
+    {
+    if ( index[d] == region.GetIndex(d)
+         || index[d] == region.GetIndex(d) + static_cast< OffsetValueType >( region.GetSize(d) ) - 1 )
+      {
+      return true;
+      }
     }
+  return false;
 }
 
 template< typename TInputImage, typename TLabelImage >
@@ -271,6 +271,13 @@ public:
   void SetFunctionId(const unsigned int & iFid)
   { this->m_FunctionId = iFid; }
 
+  /** Number of threads used to accumulate the region statistics. The
+   * multiphase filters set this to their own number of threads. */
+  void SetNumberOfThreads(const ThreadIdType & n)
+  { this->m_NumberOfThreads = n; }
+  ThreadIdType GetNumberOfThreads() const
+  { return this->m_NumberOfThreads; }
+
   virtual void ReleaseGlobalDataPointer(void *GlobalData) const ITK_OVERRIDE
   { delete (GlobalDataStruct *)GlobalData; }
 
@@ -340,6 +347,8 @@ protected:
 
   unsigned int m_FunctionId;
 
+  ThreadIdType m_NumberOfThreads;
+
   std::slice x_slice[itkGetStaticConstMacro(ImageDimension)];
   OffsetValueType m_Center;
   OffsetValueType m_xStride[itkGetStaticConstMacro(ImageDimension)];
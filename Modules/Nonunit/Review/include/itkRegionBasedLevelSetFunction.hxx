@@ -56,6 +56,7 @@ RegionBasedLevelSetFunction< TInput,
   m_Volume = NumericTraits< ScalarValueType >::ZeroValue();
 
   m_FunctionId = 0;
+  m_NumberOfThreads = 1;
 
   m_SharedData = ITK_NULLPTR;
   m_InitialImage = ITK_NULLPTR;
@@ -163,6 +163,27 @@ public:
     this->m_NearestNeighborListImage->CopyInformation(featureImage);
     this->m_NearestNeighborListImage->SetRegions( featureImage->GetLargestPossibleRegion() );
     this->m_NearestNeighborListImage->Allocate();
+
+    // The domain of each level-set function may be a sub-region of the
+    // feature image, placed by its origin. Express its start and end in the
+    // index space of the feature image, which the list image shares.
+    for ( unsigned int j = 0; j < this->m_FunctionCount; j++ )
+      {
+      LevelSetDataType *data = this->m_LevelSetDataPointerVector[j];
+      if ( data->m_HeavisideFunctionOfLevelSetImage.IsNull() )
+        {
+        continue;
+        }
+
+      const InputSizeType size =
+        data->m_HeavisideFunctionOfLevelSetImage->GetLargestPossibleRegion().GetSize();
+      featureImage->TransformPhysicalPointToIndex(
+        data->m_HeavisideFunctionOfLevelSetImage->GetOrigin(), data->m_Start);
+      for ( unsigned int i = 0; i < ImageDimension; i++ )
+        {
+        data->m_End[i] = data->m_Start[i] + static_cast< InputIndexValueType >( size[i] ) - 1;
+        }
+      }
   }
 
   virtual void PopulateListImage() = 0;
@@ -67,6 +67,7 @@ ScalarChanAndVeseDenseLevelSetImageFilter< TInputImage, TFeatureImage, TOutputIm
   for ( unsigned int fId = 0; fId < this->m_FunctionCount; ++fId )
     {
     this->m_DifferenceFunctions[fId]->SetFunctionId(fId);
+    this->m_DifferenceFunctions[fId]->SetNumberOfThreads( this->GetNumberOfThreads() );
 
     this->m_SharedData->CreateHeavisideFunctionOfLevelSetImage (fId, this->m_LevelSet[fId]);
 
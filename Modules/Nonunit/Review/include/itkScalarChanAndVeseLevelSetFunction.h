@@ -21,6 +21,7 @@
 #include "itkScalarRegionBasedLevelSetFunction.h"
 #include "itkScalarChanAndVeseLevelSetFunctionData.h"
 #include "itkConstrainedRegionBasedLevelSetFunctionSharedData.h"
+#include "itkMultiThreader.h"
 
 namespace itk
 {
@@ -154,6 +155,28 @@ protected:
 private:
   ScalarChanAndVeseLevelSetFunction(const Self &); //purposely not implemented
   void operator=(const Self &);                    //purposely not implemented
+
+  /** Sums accumulated by one thread of ComputeParameters. */
+  struct RegionSumsType
+    {
+    double WeightedSumInside;
+    double WeightedNumberInside;
+    double WeightedSumOutside;
+    double WeightedNumberOutside;
+    };
+
+  struct ThreadStruct
+    {
+    Self *Function;
+    typename FeatureImageType::RegionType Region;
+    ThreadIdType NumberOfPieces;
+    std::vector< RegionSumsType > Sums;
+    };
+
+  static ITK_THREAD_RETURN_TYPE ComputeParametersThreaderCallback(void *arg);
+
+  void ThreadedComputeParameters(const typename FeatureImageType::RegionType & region,
+                                 RegionSumsType & sums);
 };
 }
 
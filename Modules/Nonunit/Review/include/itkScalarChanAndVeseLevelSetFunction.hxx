@@ -19,6 +19,7 @@
 #define itkScalarChanAndVeseLevelSetFunction_hxx
 
 #include "itkScalarChanAndVeseLevelSetFunction.h"
+#include "itkImageRegionSplitterSlowDimension.h"
 
 namespace itk
 {
@@ -86,7 +87,8 @@ ScalarChanAndVeseLevelSetFunction< TInputImage, TFeatureImage, TSharedData >
 /* Calculates the numerator and denominator for c_i for each region. As part of
 the optimization, it is called once at the beginning of the code, and then the
 cNum and cDen are updated during the evolution without iterating through the
-entire image. */
+entire image. The domain is split in slabs that are accumulated in separate
+threads, and the partial sums are added in thread order. */
 template< typename TInputImage, typename TFeatureImage, typename TSharedData >
 void
 ScalarChanAndVeseLevelSetFunction< TInputImage, TFeatureImage, TSharedData >
@@ -94,20 +96,87 @@ ScalarChanAndVeseLevelSetFunction< TInputImage, TFeatureImage, TSharedData >
 {
   unsigned int fId = this->m_FunctionId;
 
-  this->m_SharedData->m_LevelSetDataPointerVector[fId]->m_WeightedNumberOfPixelsInsideLevelSet = 0;
-  this->m_SharedData->m_LevelSetDataPointerVector[fId]->m_WeightedSumOfPixelValuesInsideLevelSet = 0;
+  ThreadStruct str;
+  str.Function = this;
+  str.Region = this->m_FeatureImage->GetLargestPossibleRegion();
+
+  ImageRegionSplitterSlowDimension::Pointer splitter =
+    ImageRegionSplitterSlowDimension::New();
+  str.NumberOfPieces = splitter->GetNumberOfSplits( str.Region, std::max( this->m_NumberOfThreads, ThreadIdType(1) ) );
+
+  RegionSumsType zero;
+  zero.WeightedSumInside = 0;
+  zero.WeightedNumberInside = 0;
+  zero.WeightedSumOutside = 0;
+  zero.WeightedNumberOutside = 0;
+  str.Sums.resize(str.NumberOfPieces, zero);
+
+  if ( str.NumberOfPieces > 1 )
+    {
+    MultiThreader::Pointer threader = MultiThreader::New();
+    threader->SetNumberOfThreads(str.NumberOfPieces);
+    threader->SetSingleMethod(Self::ComputeParametersThreaderCallback, &str);
+    threader->SingleMethodExecute();
+    }
+  else
+    {
+    this->ThreadedComputeParameters(str.Region, str.Sums[0]);
+    }
+
+  RegionSumsType total = zero;
+  for ( ThreadIdType i = 0; i < str.NumberOfPieces; ++i )
+    {
+    total.WeightedSumInside += str.Sums[i].WeightedSumInside;
+    total.WeightedNumberInside += str.Sums[i].WeightedNumberInside;
+    total.WeightedSumOutside += str.Sums[i].WeightedSumOutside;
+    total.WeightedNumberOutside += str.Sums[i].WeightedNumberOutside;
+    }
+
+  this->m_SharedData->m_LevelSetDataPointerVector[fId]->m_WeightedNumberOfPixelsInsideLevelSet = total.WeightedNumberInside;
+  this->m_SharedData->m_LevelSetDataPointerVector[fId]->m_WeightedSumOfPixelValuesInsideLevelSet = total.WeightedSumInside;
   this->m_SharedData->m_LevelSetDataPointerVector[fId]->m_ForegroundConstantValues = 0;
-  this->m_SharedData->m_LevelSetDataPointerVector[fId]->m_WeightedNumberOfPixelsOutsideLevelSet = 0;
-  this->m_SharedData->m_LevelSetDataPointerVector[fId]->m_WeightedSumOfPixelValuesOutsideLevelSet = 0;
+  this->m_SharedData->m_LevelSetDataPointerVector[fId]->m_WeightedNumberOfPixelsOutsideLevelSet = total.WeightedNumberOutside;
+  this->m_SharedData->m_LevelSetDataPointerVector[fId]->m_WeightedSumOfPixelValuesOutsideLevelSet = total.WeightedSumOutside;
   this->m_SharedData->m_LevelSetDataPointerVector[fId]->m_BackgroundConstantValues = 0;
+}
+
+template< typename TInputImage, typename TFeatureImage, typename TSharedData >
+ITK_THREAD_RETURN_TYPE
+ScalarChanAndVeseLevelSetFunction< TInputImage, TFeatureImage, TSharedData >
+::ComputeParametersThreaderCallback(void *arg)
+{
+  typedef MultiThreader::ThreadInfoStruct ThreadInfoType;
+  ThreadInfoType *info = static_cast< ThreadInfoType * >( arg );
+  ThreadStruct *  str = static_cast< ThreadStruct * >( info->UserData );
+
+  if ( info->ThreadID >= str->NumberOfPieces )
+    {
+    return ITK_THREAD_RETURN_VALUE;
+    }
+
+  typename FeatureImageType::RegionType region = str->Region;
+  ImageRegionSplitterSlowDimension::Pointer splitter =
+    ImageRegionSplitterSlowDimension::New();
+  splitter->GetSplit(info->ThreadID, str->NumberOfPieces, region);
+
+  str->Function->ThreadedComputeParameters(region, str->Sums[info->ThreadID]);
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+template< typename TInputImage, typename TFeatureImage, typename TSharedData >
+void
+ScalarChanAndVeseLevelSetFunction< TInputImage, TFeatureImage, TSharedData >
+::ThreadedComputeParameters(const typename FeatureImageType::RegionType & region, RegionSumsType & sums)
+{
+  const unsigned int fId = this->m_FunctionId;
 
-  ConstFeatureIteratorType fIt( this->m_FeatureImage, this->m_FeatureImage->GetLargestPossibleRegion() );
+  ConstFeatureIteratorType fIt(this->m_FeatureImage, region);
 
   FeaturePixelType featureVal;
   FeatureIndexType globalIndex;
   InputIndexType   itInputIndex, inputIndex;
   InputPixelType   hVal;
-  ListPixelType    L;
 
   fIt.GoToBegin();
 
@@ -119,7 +188,7 @@ ScalarChanAndVeseLevelSetFunction< TInputImage, TFeatureImage, TSharedData >
 
     globalIndex = this->m_SharedData->m_LevelSetDataPointerVector[fId]->GetFeatureIndex(inputIndex);
 
-    L = this->m_SharedData->m_NearestNeighborListImage->GetPixel(globalIndex);
+    const ListPixelType & L = this->m_SharedData->m_NearestNeighborListImage->GetPixel(globalIndex);
 
     for ( ListPixelConstIterator it = L.begin(); it != L.end(); ++it )
       {
@@ -130,15 +199,13 @@ ScalarChanAndVeseLevelSetFunction< TInputImage, TFeatureImage, TSharedData >
 
       if ( *it == fId )
         {
-        this->m_SharedData->m_LevelSetDataPointerVector[*it]->m_WeightedSumOfPixelValuesInsideLevelSet += featureVal
-                                                                                                          * hVal;
-        this->m_SharedData->m_LevelSetDataPointerVector[*it]->m_WeightedNumberOfPixelsInsideLevelSet += hVal;
+        sums.WeightedSumInside += featureVal * hVal;
+        sums.WeightedNumberInside += hVal;
         }
       }
 
-    this->m_SharedData->m_LevelSetDataPointerVector[fId]->m_WeightedSumOfPixelValuesOutsideLevelSet += featureVal
-                                                                                                       * prod;
-    this->m_SharedData->m_LevelSetDataPointerVector[fId]->m_WeightedNumberOfPixelsOutsideLevelSet += prod;
+    sums.WeightedSumOutside += featureVal * prod;
+    sums.WeightedNumberOutside += prod;
 
     ++fIt;
     }
@@ -70,6 +70,7 @@ ScalarChanAndVeseSparseLevelSetImageFilter< TInputImage, TFeatureImage, TOutputI
     FunctionPtr typedPointer = this->m_DifferenceFunctions[fId];
 
     typedPointer->SetFunctionId(fId);
+    typedPointer->SetNumberOfThreads( this->GetNumberOfThreads() );
 
     this->m_SharedData->CreateHeavisideFunctionOfLevelSetImage (fId, this->m_LevelSet[fId]);
 
@@ -38,13 +38,12 @@ ScalarRegionBasedLevelSetFunction< TInputImage, TFeatureImage, TSharedData >
 
   product = 1.;
 
-  ListPixelType L;
-  L = this->m_SharedData->m_NearestNeighborListImage->GetPixel(globalIndex);
+  const ListPixelType & L = this->m_SharedData->m_NearestNeighborListImage->GetPixel(globalIndex);
 
   InputPixelType hVal;
   InputIndexType otherIndex;
 
-  for ( ListPixelIterator it = L.begin(); it != L.end(); ++it )
+  for ( ListPixelConstIterator it = L.begin(); it != L.end(); ++it )
     {
     if ( *it != fId )
       {
@@ -88,8 +87,8 @@ ScalarRegionBasedLevelSetFunction< TInputImage, TFeatureImage, TSharedData >
   UpdateSharedDataInsideParameters(fId, featureVal, change);
 
   // Compute the product factor
-  ListPixelType   L = this->m_SharedData->m_NearestNeighborListImage->GetPixel(globalIndex);
-  InputIndexType  itInputIndex;
+  const ListPixelType & L = this->m_SharedData->m_NearestNeighborListImage->GetPixel(globalIndex);
+  InputIndexType        itInputIndex;
   ScalarValueType hVal;
 
   InputPixelType product = 1;
@@ -22,6 +22,8 @@
 #include "itkSimpleFilterWatcher.h"
 #include "itkMorphologicalWatershedFromMarkersImageFilter.h"
 #include "itkLabelOverlayImageFilter.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionIteratorWithIndex.h"
 
 int itkMorphologicalWatershedFromMarkersImageFilterTest(int argc, char * argv[])
 {
@@ -125,6 +127,64 @@ int itkMorphologicalWatershedFromMarkersImageFilterTest(int argc, char * argv[])
 
     }
 
+  // Without watershed line, the flooding fronts are processed in parallel.
+  // The labels must not depend on the number of threads, including on
+  // plateaus where several markers reach a pixel at the same level.
+  typedef itk::Image< PType, 3 >                                         Image3DType;
+  typedef itk::Image< unsigned short, 3 >                                LabelImage3DType;
+  typedef itk::MorphologicalWatershedFromMarkersImageFilter< Image3DType, LabelImage3DType >
+    Filter3DType;
+
+  Image3DType::SizeType size3D;
+  size3D.Fill( 64 );
+  Image3DType::Pointer input3D = Image3DType::New();
+  input3D->SetRegions( size3D );
+  input3D->Allocate();
+  for ( itk::ImageRegionIteratorWithIndex< Image3DType > it( input3D, input3D->GetBufferedRegion() );
+        !it.IsAtEnd(); ++it )
+    {
+    it.Set( static_cast< PType >( ( it.GetIndex()[0] + 2 * it.GetIndex()[1] ) / 16 ) );
+    }
+
+  LabelImage3DType::Pointer markers3D = LabelImage3DType::New();
+  markers3D->SetRegions( size3D );
+  markers3D->Allocate();
+  markers3D->FillBuffer( 0 );
+  const Image3DType::IndexType marker1 = {{ 10, 5, 32 }};
+  const Image3DType::IndexType marker2 = {{ 50, 5, 20 }};
+  const Image3DType::IndexType marker3 = {{ 31, 40, 45 }};
+  markers3D->SetPixel( marker1, 1 );
+  markers3D->SetPixel( marker2, 2 );
+  markers3D->SetPixel( marker3, 3 );
+
+  LabelImage3DType::Pointer labels3D[2];
+  for ( unsigned int fullyConnected = 0; fullyConnected < 2; ++fullyConnected )
+    {
+    for ( unsigned int t = 0; t < 2; ++t )
+      {
+      Filter3DType::Pointer filter3D = Filter3DType::New();
+      filter3D->SetInput( input3D );
+      filter3D->SetMarkerImage( markers3D );
+      filter3D->SetMarkWatershedLine( false );
+      filter3D->SetFullyConnected( fullyConnected );
+      filter3D->SetNumberOfThreads( t == 0 ? 1 : 4 );
+      filter3D->Update();
+      labels3D[t] = filter3D->GetOutput();
+      }
+
+    itk::ImageRegionConstIterator< LabelImage3DType > it1( labels3D[0], labels3D[0]->GetBufferedRegion() );
+    itk::ImageRegionConstIterator< LabelImage3DType > it4( labels3D[1], labels3D[1]->GetBufferedRegion() );
+    for ( ; !it1.IsAtEnd(); ++it1, ++it4 )
+      {
+      if ( it1.Get() == 0 || it1.Get() != it4.Get() )
+        {
+        std::cerr << "Labels differ with the number of threads: " << it1.Get()
+                  << " != " << it4.Get() << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+    }
+
   return EXIT_SUCCESS;
 
 }
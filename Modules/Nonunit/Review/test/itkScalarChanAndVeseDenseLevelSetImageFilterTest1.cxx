@@ -17,6 +17,126 @@
  *=========================================================================*/
 
 #include "itkScalarChanAndVeseDenseLevelSetImageFilter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkAtanRegularizedHeavisideStepFunction.h"
+
+namespace
+{
+// Evolves eight phases whose domains tile the feature image, placed by
+// their origins, and returns the final level sets.
+template< typename TFilter >
+bool
+RunSubDomainPhases( bool useKdTree, std::vector< typename TFilter::InputImagePointer > & levelSets )
+{
+  typedef typename TFilter::InputImageType   ImageType;
+  typedef typename TFilter::FeatureImageType FeatureImageType;
+
+  // The feature image holds two bright cubes on a dark background.
+  typename FeatureImageType::RegionType featureRegion;
+  featureRegion.SetSize( 0, 48 );
+  featureRegion.SetSize( 1, 24 );
+  featureRegion.SetSize( 2, 12 );
+  typename FeatureImageType::Pointer feature = FeatureImageType::New();
+  feature->SetRegions( featureRegion );
+  feature->Allocate();
+  itk::ImageRegionIteratorWithIndex< FeatureImageType > fIt( feature, featureRegion );
+  for ( fIt.GoToBegin(); !fIt.IsAtEnd(); ++fIt )
+    {
+    const typename FeatureImageType::IndexType index = fIt.GetIndex();
+    const bool inFirstCube = index[0] >= 3 && index[0] < 9 && index[1] >= 3 && index[1] < 9
+      && index[2] >= 3 && index[2] < 9;
+    const bool inSecondCube = index[0] >= 15 && index[0] < 21 && index[1] >= 3 && index[1] < 9
+      && index[2] >= 3 && index[2] < 9;
+    fIt.Set( ( inFirstCube || inSecondCube ) ? 100.0 : 10.0 );
+    }
+
+  typedef itk::AtanRegularizedHeavisideStepFunction< typename ImageType::PixelType,
+    typename ImageType::PixelType > DomainFunctionType;
+  typename DomainFunctionType::Pointer domainFunction = DomainFunctionType::New();
+  domainFunction->SetEpsilon( 1. );
+
+  typename TFilter::Pointer filter = TFilter::New();
+  const unsigned int numberOfPhases = 8;
+  filter->SetFunctionCount( numberOfPhases );
+  filter->SetFeatureImage( feature );
+  filter->SetNumberOfIterations( 5 );
+  filter->SetMaximumRMSError( 0. );
+  filter->SetUseImageSpacing( 0 );
+  filter->SetInPlace( false );
+
+  // The phases tile the feature image with 12 x 12 x 12 domains, so that
+  // only the domain of the first phase starts at index zero.
+  typename TFilter::SampleType::Pointer centroids = TFilter::SampleType::New();
+  for ( unsigned int i = 0; i < numberOfPhases; i++ )
+    {
+    typename ImageType::RegionType region;
+    region.SetSize( 0, 12 );
+    region.SetSize( 1, 12 );
+    region.SetSize( 2, 12 );
+    typename ImageType::PointType origin;
+    origin[0] = 12.0 * ( i % 4 );
+    origin[1] = 12.0 * ( i / 4 );
+    origin[2] = 0.0;
+
+    typename ImageType::Pointer levelSet = ImageType::New();
+    levelSet->SetRegions( region );
+    levelSet->SetOrigin( origin );
+    levelSet->Allocate();
+    itk::ImageRegionIteratorWithIndex< ImageType > lIt( levelSet, region );
+    for ( lIt.GoToBegin(); !lIt.IsAtEnd(); ++lIt )
+      {
+      double distance = 0.0;
+      for ( unsigned int j = 0; j < ImageType::ImageDimension; j++ )
+        {
+        distance += vnl_math_sqr( lIt.GetIndex()[j] - 5.5 );
+        }
+      lIt.Set( 4.0 - std::sqrt( distance ) );
+      }
+    filter->SetLevelSet( i, levelSet );
+
+    typename TFilter::CentroidVectorType centroid;
+    for ( unsigned int j = 0; j < ImageType::ImageDimension; j++ )
+      {
+      centroid[j] = origin[j] + 5.5;
+      }
+    centroids->PushBack( centroid );
+
+    typename TFilter::FunctionType * function = filter->GetDifferenceFunction( i );
+    function->SetDomainFunction( domainFunction );
+    function->SetLambda1( 1. );
+    function->SetLambda2( 1. );
+    }
+
+  // The kd-tree returns the six nearest domains, which are not in the
+  // order of the phases.
+  if ( useKdTree )
+    {
+    typename TFilter::KdTreeGeneratorType::Pointer treeGenerator =
+      TFilter::KdTreeGeneratorType::New();
+    treeGenerator->SetSample( centroids );
+    treeGenerator->SetBucketSize( 2 );
+    treeGenerator->Update();
+    filter->SetKdTree( treeGenerator->GetOutput() );
+    }
+
+  try
+    {
+    filter->Update();
+    }
+  catch ( itk::ExceptionObject & e )
+    {
+    std::cerr << e << std::endl;
+    return false;
+    }
+
+  levelSets.clear();
+  for ( unsigned int i = 0; i < numberOfPhases; i++ )
+    {
+    levelSets.push_back( filter->GetLevelSet( i ) );
+    }
+  return true;
+}
+}
 
 int itkScalarChanAndVeseDenseLevelSetImageFilterTest1( int, char* [] )
 {
@@ -50,5 +170,32 @@ int itkScalarChanAndVeseDenseLevelSetImageFilterTest1( int, char* [] )
   std::cout << "GetNameOfClass() = " << filter->GetNameOfClass() << std::endl;
   filter->Print( std::cout );
 
+  // Domains smaller than the feature image must be read at their own place,
+  // and a kd-tree must list the same phases at each pixel as a search over
+  // all the phases.
+  std::vector< ImageType::Pointer > levelSets;
+  std::vector< ImageType::Pointer > kdTreeLevelSets;
+  if ( !RunSubDomainPhases< FilterType >( false, levelSets )
+       || !RunSubDomainPhases< FilterType >( true, kdTreeLevelSets ) )
+    {
+    return EXIT_FAILURE;
+    }
+  for ( unsigned int i = 0; i < levelSets.size(); i++ )
+    {
+    itk::ImageRegionIteratorWithIndex< ImageType >
+      it( levelSets[i], levelSets[i]->GetLargestPossibleRegion() );
+    itk::ImageRegionIteratorWithIndex< ImageType >
+      kdIt( kdTreeLevelSets[i], kdTreeLevelSets[i]->GetLargestPossibleRegion() );
+    for ( ; !it.IsAtEnd(); ++it, ++kdIt )
+      {
+      if ( it.Get() != kdIt.Get() )
+        {
+        std::cerr << "Phase " << i << " differs with a kd-tree at "
+                  << it.GetIndex() << ": " << it.Get() << " != " << kdIt.Get() << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+    }
+
   return EXIT_SUCCESS;
 }
@@ -20,6 +20,8 @@
 
 #include "itkIntTypes.h"
 #include "itkObjectToObjectOptimizerBase.h"
+#include "itkThreadedIndexedContainerPartitioner.h"
+#include "itkDomainThreader.h"
 
 namespace itk
 {
@@ -76,6 +78,14 @@ namespace itk
  * the number of steps along each dimension, a side of the region is
  * stepLength*(2*numberOfSteps[d]+1)*scaling[d].
  *
+ * The grid can be sampled concurrently by giving a list of independent
+ * metric instances with SetMetricList(). The grid positions are then split
+ * into contiguous ranges over up to min( NumberOfThreads, number of metrics )
+ * threads, each metric being limited to an equal share of the optimizer
+ * threads. Once all the positions are sampled, the grid is walked again in
+ * the serial order from the calling thread, so that the extrema and the
+ * IterationEvents are the same as with the serial walk.
+ *
  * \ingroup ITKOptimizersv4
  */
 template<typename TInternalComputationValueType>
@@ -107,6 +117,15 @@ public:
   /** Scales type */
   typedef typename Superclass::ScalesType       ScalesType;
 
+  /** Metric type */
+  typedef typename Superclass::MetricType        MetricType;
+  typedef typename Superclass::MetricTypePointer MetricTypePointer;
+
+  /** List of metric instances used for concurrent sampling */
+  typedef std::vector< MetricTypePointer >      MetricListType;
+
+  typedef ThreadedIndexedContainerPartitioner::IndexRangeType IndexRangeType;
+
   virtual void StartOptimization(bool doOnlyInitialization = false) ITK_OVERRIDE;
 
   /** Start optimization */
@@ -141,6 +160,22 @@ public:
     return m_InitialPosition;
   }
 
+  /** Set/Get the metric instances used to sample the grid concurrently.
+   * Each entry must be initialized like the metric set with SetMetric(), but
+   * must own its transform, so that setting the parameters of one entry does
+   * not affect the others. An empty list or a list of a single metric selects
+   * the serial walk, which is the default. */
+  void SetMetricList(const MetricListType & metrics);
+  const MetricListType & GetMetricList() const
+  {
+    return m_MetricList;
+  }
+
+  /** Sample the grid positions of linear index in \c subrange with the
+   * metric assigned to \c threadId. This function is used in
+   * ExhaustiveOptimizerv4SampleGridThreader. */
+  void SampleGridOverSubRange(const IndexRangeType & subrange, const ThreadIdType threadId);
+
 protected:
   ExhaustiveOptimizerv4();
   virtual ~ExhaustiveOptimizerv4() {}
@@ -151,6 +186,9 @@ protected:
 
   void IncrementIndex(ParametersType & param);
 
+  /** Sample the whole grid with the metrics of m_MetricList. */
+  void SampleGridConcurrently();
+
 protected:
   ParametersType  m_InitialPosition;
   MeasureType     m_CurrentValue;
@@ -163,6 +201,12 @@ protected:
   ParametersType  m_MinimumMetricValuePosition;
   ParametersType  m_MaximumMetricValuePosition;
 
+  /* Concurrent sampling */
+  MetricListType                m_MetricList;
+  std::vector< MeasureType >    m_GridValues;
+  std::vector< std::string >    m_ThreadExceptionDescription;
+  typename DomainThreader<ThreadedIndexedContainerPartitioner, Self>::Pointer m_SampleGridThreader;
+
 private:
   //purposely not implemented
   ExhaustiveOptimizerv4(const Self &);
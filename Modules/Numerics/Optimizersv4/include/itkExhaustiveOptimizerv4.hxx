@@ -19,6 +19,8 @@
 #define itkExhaustiveOptimizerv4_hxx
 
 #include "itkExhaustiveOptimizerv4.h"
+#include "itkExhaustiveOptimizerv4SampleGridThreader.h"
+#include <algorithm>
 
 namespace itk
 {
@@ -36,6 +38,19 @@ ExhaustiveOptimizerv4<TInternalComputationValueType>
   m_StopConditionDescription("")
 {
   this->m_NumberOfIterations = 0;
+  this->m_SampleGridThreader = ExhaustiveOptimizerv4SampleGridThreader<TInternalComputationValueType>::New();
+}
+
+template<typename TInternalComputationValueType>
+void
+ExhaustiveOptimizerv4<TInternalComputationValueType>
+::SetMetricList(const MetricListType & metrics)
+{
+  if ( metrics != m_MetricList )
+    {
+    m_MetricList = metrics;
+    this->Modified();
+    }
 }
 
 template<typename TInternalComputationValueType>
@@ -98,11 +113,131 @@ ExhaustiveOptimizerv4<TInternalComputationValueType>
     }
   this->m_Metric->SetParameters(position);
 
+  if ( m_MetricList.size() > 1 )
+    {
+    itkDebugMacro("Calling SampleGridConcurrently");
+
+    this->SampleGridConcurrently();
+    return;
+    }
+
   itkDebugMacro("Calling ResumeWalking");
 
   this->ResumeWalking();
 }
 
+template<typename TInternalComputationValueType>
+void
+ExhaustiveOptimizerv4<TInternalComputationValueType>
+::SampleGridConcurrently(void)
+{
+  itkDebugMacro("SampleGridConcurrently");
+
+  // Each thread owns one metric, and each metric gets an equal share of the
+  // optimizer threads.
+  const ThreadIdType numberOfThreads = std::min( this->m_NumberOfThreads,
+                                                 static_cast< ThreadIdType >( m_MetricList.size() ) );
+  const ThreadIdType threadsPerMetric = std::max( this->m_NumberOfThreads / numberOfThreads,
+                                                  static_cast< ThreadIdType >( 1 ) );
+  for ( ThreadIdType t = 0; t < numberOfThreads; t++ )
+    {
+    m_MetricList[t]->SetMaximumNumberOfThreads( threadsPerMetric );
+    }
+
+  m_GridValues.assign( this->m_NumberOfIterations, NumericTraits< MeasureType >::max() );
+  m_ThreadExceptionDescription.assign( numberOfThreads, std::string() );
+
+  IndexRangeType fullrange;
+  fullrange[0] = 0;
+  fullrange[1] = this->m_NumberOfIterations - 1; //range is inclusive
+  m_SampleGridThreader->SetMaximumNumberOfThreads( numberOfThreads );
+  m_SampleGridThreader->Execute( this, fullrange );
+
+  for ( ThreadIdType t = 0; t < numberOfThreads; t++ )
+    {
+    if ( !m_ThreadExceptionDescription[t].empty() )
+      {
+      m_GridValues.clear();
+      itkExceptionMacro(<< "Exception while sampling the grid: " << m_ThreadExceptionDescription[t]);
+      }
+    }
+
+  // Walk the grid again in the serial order with the sampled values, so that
+  // the extrema, the IterationEvents and the state seen by the observers are
+  // the same as with ResumeWalking().
+  m_Stop = false;
+
+  while ( !m_Stop )
+    {
+    ParametersType currentPosition = this->GetCurrentPosition();
+
+    m_CurrentValue = m_GridValues[this->m_CurrentIteration];
+
+    if ( m_CurrentValue > m_MaximumMetricValue )
+      {
+      m_MaximumMetricValue = m_CurrentValue;
+      m_MaximumMetricValuePosition = currentPosition;
+      }
+    if ( m_CurrentValue < m_MinimumMetricValue )
+      {
+      m_MinimumMetricValue = m_CurrentValue;
+      m_MinimumMetricValuePosition = currentPosition;
+      }
+
+    m_StopConditionDescription.str("");
+    m_StopConditionDescription << this->GetNameOfClass() << ": Running. ";
+    m_StopConditionDescription << "@ index " << this->GetCurrentIndex() << " value is " << m_CurrentValue;
+
+    this->InvokeEvent( IterationEvent() );
+    this->AdvanceOneStep();
+    this->m_CurrentIteration++;
+    }
+
+  m_GridValues.clear();
+}
+
+template<typename TInternalComputationValueType>
+void
+ExhaustiveOptimizerv4<TInternalComputationValueType>
+::SampleGridOverSubRange(const IndexRangeType & subrange, const ThreadIdType threadId)
+{
+  MetricType *         metric = m_MetricList[threadId];
+  const unsigned int   spaceDimension = m_InitialPosition.GetSize();
+  const ScalesType &   scales = this->GetScales();
+  ParametersType       position(spaceDimension);
+
+  try
+    {
+    for ( IndexValueType k = subrange[0]; k <= subrange[1]; k++ )
+      {
+      if ( k == 0 )
+        {
+        // The first grid position is set up by StartWalking().
+        position = this->m_Metric->GetParameters();
+        }
+      else
+        {
+        // The first parameter varies fastest, as in IncrementIndex().
+        SizeValueType remainder = static_cast< SizeValueType >( k );
+        for ( unsigned int i = 0; i < spaceDimension; i++ )
+          {
+          const SizeValueType gridSize = 2 * m_NumberOfSteps[i] + 1;
+          const double        gridIndex = static_cast< double >( remainder % gridSize );
+          remainder /= gridSize;
+          position[i] = ( gridIndex - m_NumberOfSteps[i] ) * m_StepLength * scales[i] + m_InitialPosition[i];
+          }
+        }
+
+      metric->SetParameters(position);
+      m_GridValues[k] = metric->GetValue();
+      }
+    }
+  catch ( ExceptionObject & e )
+    {
+    m_ThreadExceptionDescription[threadId] = e.GetDescription();
+    }
+}
+
 template<typename TInternalComputationValueType>
 void
 ExhaustiveOptimizerv4<TInternalComputationValueType>
@@ -252,6 +387,7 @@ ExhaustiveOptimizerv4<TInternalComputationValueType>
   os << indent << "MinimumMetricValue = " << m_MinimumMetricValue << std::endl;
   os << indent << "MinimumMetricValuePosition = " << m_MinimumMetricValuePosition << std::endl;
   os << indent << "MaximumMetricValuePosition = " << m_MaximumMetricValuePosition << std::endl;
+  os << indent << "Number of metrics for concurrent sampling = " << m_MetricList.size() << std::endl;
 }
 } // end namespace itk
 
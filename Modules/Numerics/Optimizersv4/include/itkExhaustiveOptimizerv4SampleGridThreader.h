@@ -0,0 +1,74 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkExhaustiveOptimizerv4SampleGridThreader_h
+#define itkExhaustiveOptimizerv4SampleGridThreader_h
+
+#include "itkDomainThreader.h"
+#include "itkThreadedIndexedContainerPartitioner.h"
+
+namespace itk
+{
+
+template<typename TInternalComputationValueType>
+class ExhaustiveOptimizerv4;
+
+/** \class ExhaustiveOptimizerv4SampleGridThreader
+ * \brief Sample a range of grid positions of ExhaustiveOptimizerv4
+ * concurrently, each thread using its own metric instance.
+ * \ingroup ITKOptimizersv4
+ */
+
+template<typename TInternalComputationValueType>
+class ExhaustiveOptimizerv4SampleGridThreader
+  : public DomainThreader< ThreadedIndexedContainerPartitioner, ExhaustiveOptimizerv4<TInternalComputationValueType> >
+{
+public:
+  /** Standard class typedefs. */
+  typedef ExhaustiveOptimizerv4SampleGridThreader                                   Self;
+  typedef DomainThreader< ThreadedIndexedContainerPartitioner, ExhaustiveOptimizerv4<TInternalComputationValueType> >
+                                                                                    Superclass;
+  typedef SmartPointer< Self >                                                      Pointer;
+  typedef SmartPointer< const Self >                                                ConstPointer;
+
+  itkTypeMacro( ExhaustiveOptimizerv4SampleGridThreader, DomainThreader );
+
+  itkNewMacro( Self );
+
+  typedef typename Superclass::DomainType    DomainType;
+  typedef typename Superclass::AssociateType AssociateType;
+  typedef DomainType                         IndexRangeType;
+
+protected:
+  virtual void ThreadedExecution( const IndexRangeType & subrange,
+                                  const ThreadIdType threadId ) ITK_OVERRIDE;
+
+  ExhaustiveOptimizerv4SampleGridThreader() {}
+  virtual ~ExhaustiveOptimizerv4SampleGridThreader() {}
+
+private:
+  ExhaustiveOptimizerv4SampleGridThreader( const Self & ); // purposely not implemented
+  void operator=( const Self & ); // purposely not implemented
+};
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkExhaustiveOptimizerv4SampleGridThreader.hxx"
+#endif
+
+#endif
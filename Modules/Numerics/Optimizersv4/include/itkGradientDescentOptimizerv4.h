@@ -153,6 +153,7 @@ public:
    *  checking.
    */
   itkSetMacro(MinimumConvergenceValue, TInternalComputationValueType);
+  itkGetConstReferenceMacro(MinimumConvergenceValue, TInternalComputationValueType);
 
   /** Window size for the convergence checker.
    *  The convergence checker calculates convergence value by fitting to
@@ -163,6 +164,7 @@ public:
    *  checking.
    */
   itkSetMacro(ConvergenceWindowSize, SizeValueType);
+  itkGetConstReferenceMacro(ConvergenceWindowSize, SizeValueType);
 
   /** Get current convergence value */
   itkGetConstReferenceMacro( ConvergenceValue, TInternalComputationValueType);
@@ -20,6 +20,8 @@
 
 #include "itkObjectToObjectOptimizerBase.h"
 #include "itkGradientDescentOptimizerv4.h"
+#include "itkThreadedIndexedContainerPartitioner.h"
+#include "itkDomainThreader.h"
 
 namespace itk
 {
@@ -34,6 +36,18 @@ namespace itk
    *   focus modifying the parameter sample space.  This is why we place the burden on the user to provide
    *   the parameter samples over which to optimize.
    *
+   *   By default the start points are visited one after the other using the metric
+   *   set with SetMetric(). When a list of independent metric instances is given
+   *   with SetMetricList(), the start points are instead distributed over up to
+   *   min( NumberOfThreads, number of metrics ) threads. Each thread uses its own
+   *   metric and its own copy of the local optimizer (see CloneLocalOptimizer()),
+   *   and each metric is limited to an equal share of the optimizer threads.
+   *   This is most useful for cheap, sparsely sampled metrics that do not
+   *   scale well internally. The results are reduced in start point order, so
+   *   the metric values list and the best parameters do not depend on the
+   *   number of threads, and IterationEvents are still invoked once per start
+   *   point, from the calling thread, after all start points have been evaluated.
+   *
    * \ingroup ITKOptimizersv4
    */
 template<typename TInternalComputationValueType>
@@ -93,6 +107,11 @@ public:
   typedef typename Superclass::MeasureType          MeasureType;
   typedef std::vector< MeasureType >                MetricValuesListType;
 
+  /** List of metric instances used for concurrent evaluation */
+  typedef std::vector< MetricTypePointer >          MetricListType;
+
+  typedef ThreadedIndexedContainerPartitioner::IndexRangeType IndexRangeType;
+
   /** Get stop condition enum */
   itkGetConstReferenceMacro(StopCondition, StopConditionType);
 
@@ -131,6 +150,19 @@ public:
 
   inline ParameterListSizeType GetBestParametersIndex( ) { return this->m_BestParametersIndex; }
 
+  /** Set/Get the metric instances used to evaluate the start points
+   * concurrently. Each entry must be initialized like the metric set with
+   * SetMetric(), but must own its transform, so that setting the parameters
+   * of one entry does not affect the others. An empty list or a list of a
+   * single metric selects the serial search, which is the default. */
+  void SetMetricList( const MetricListType & metrics );
+  const MetricListType & GetMetricList() const;
+
+  /** Evaluate the start points in \c subrange with the metric and local
+   * optimizer assigned to \c threadId. This function is used in
+   * MultiStartOptimizerv4EvaluateStartPointsThreaderTemplate. */
+  void EvaluateStartPointsOverSubRange( const IndexRangeType & subrange, const ThreadIdType threadId );
+
 protected:
   /** Default constructor */
   MultiStartOptimizerv4Template();
@@ -138,6 +170,18 @@ protected:
 
   virtual void PrintSelf(std::ostream & os, Indent indent) const ITK_OVERRIDE;
 
+  /** Evaluate all the start points with the metrics of m_MetricList, then
+   * reduce the results in start point order. */
+  virtual void ResumeOptimizationConcurrently();
+
+  /** Create an independent copy of the local optimizer, to be used by a
+   * single thread during concurrent evaluation. The default implementation
+   * handles GradientDescentOptimizerv4Template, copying its learning rate,
+   * step and convergence settings, scales and weights. Learning rate and
+   * scales estimation are disabled in the copy since estimators are bound to
+   * a single metric. */
+  virtual OptimizerPointer CloneLocalOptimizer() const;
+
   /* Common variables for optimization control and reporting */
   bool                          m_Stop;
   StopConditionType             m_StopCondition;
@@ -149,6 +193,13 @@ protected:
   ParameterListSizeType         m_BestParametersIndex;
   OptimizerPointer              m_LocalOptimizer;
 
+  /* Concurrent evaluation */
+  MetricListType                m_MetricList;
+  std::vector< OptimizerPointer > m_ThreadLocalOptimizers;
+  MetricValuesListType          m_StartPointValues;
+  std::vector< unsigned char >  m_StartPointEvaluated;
+  typename DomainThreader<ThreadedIndexedContainerPartitioner, Self>::Pointer m_EvaluateStartPointsThreader;
+
 private:
   MultiStartOptimizerv4Template( const Self & ); //purposely not implemented
   void operator=( const Self& ); //purposely not implemented
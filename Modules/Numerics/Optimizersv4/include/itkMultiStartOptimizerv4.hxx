@@ -19,6 +19,8 @@
 #define itkMultiStartOptimizerv4_hxx
 
 #include "itkMultiStartOptimizerv4.h"
+#include "itkMultiStartOptimizerv4EvaluateStartPointsThreader.h"
+#include <algorithm>
 
 namespace itk
 {
@@ -37,6 +39,8 @@ MultiStartOptimizerv4Template<TInternalComputationValueType>
   this->m_MaximumMetricValue=NumericTraits<MeasureType>::max();
   this->m_MinimumMetricValue = this->m_MaximumMetricValue;
   m_LocalOptimizer = ITK_NULLPTR;
+
+  this->m_EvaluateStartPointsThreader = MultiStartOptimizerv4EvaluateStartPointsThreaderTemplate<TInternalComputationValueType>::New();
 }
 
 //-------------------------------------------------------------------
@@ -54,6 +58,7 @@ MultiStartOptimizerv4Template<TInternalComputationValueType>
   Superclass::PrintSelf(os, indent);
   os << indent << "Stop condition:"<< this->m_StopCondition << std::endl;
   os << indent << "Stop condition description: " << this->m_StopConditionDescription.str()  << std::endl;
+  os << indent << "Number of metrics for concurrent evaluation: " << this->m_MetricList.size() << std::endl;
 }
 
 //-------------------------------------------------------------------
@@ -87,6 +92,28 @@ MultiStartOptimizerv4Template<TInternalComputationValueType>
   return this->m_MetricValuesList;
 }
 
+/** Set the list of metrics used for concurrent evaluation */
+template<typename TInternalComputationValueType>
+void
+MultiStartOptimizerv4Template<TInternalComputationValueType>
+::SetMetricList( const MetricListType & metrics )
+{
+  if( metrics != this->m_MetricList )
+    {
+    this->m_MetricList = metrics;
+    this->Modified();
+    }
+}
+
+/** Get the list of metrics used for concurrent evaluation */
+template<typename TInternalComputationValueType>
+const typename MultiStartOptimizerv4Template<TInternalComputationValueType>::MetricListType &
+MultiStartOptimizerv4Template<TInternalComputationValueType>
+::GetMetricList() const
+{
+  return this->m_MetricList;
+}
+
 //-------------------------------------------------------------------
 template<typename TInternalComputationValueType>
 typename MultiStartOptimizerv4Template<TInternalComputationValueType>::ParametersType
@@ -109,6 +136,39 @@ MultiStartOptimizerv4Template<TInternalComputationValueType>
   this->m_LocalOptimizer=optimizer;
 }
 
+//-------------------------------------------------------------------
+template<typename TInternalComputationValueType>
+typename MultiStartOptimizerv4Template<TInternalComputationValueType>::OptimizerPointer
+MultiStartOptimizerv4Template<TInternalComputationValueType>
+::CloneLocalOptimizer() const
+{
+  const LocalOptimizerType * localOptimizer = dynamic_cast< const LocalOptimizerType * >( this->m_LocalOptimizer.GetPointer() );
+  if( localOptimizer == ITK_NULLPTR )
+    {
+    itkExceptionMacro("Concurrent evaluation requires a local optimizer of type "
+                      "GradientDescentOptimizerv4Template, but the local optimizer is a "
+                      << this->m_LocalOptimizer->GetNameOfClass()
+                      << ". Override CloneLocalOptimizer() to support other types.");
+    }
+
+  LocalOptimizerPointer optimizer = LocalOptimizerType::New();
+  optimizer->SetLearningRate( localOptimizer->GetLearningRate() );
+  optimizer->SetNumberOfIterations( localOptimizer->GetNumberOfIterations() );
+  optimizer->SetMaximumStepSizeInPhysicalUnits( localOptimizer->GetMaximumStepSizeInPhysicalUnits() );
+  optimizer->SetMinimumConvergenceValue( localOptimizer->GetMinimumConvergenceValue() );
+  optimizer->SetConvergenceWindowSize( localOptimizer->GetConvergenceWindowSize() );
+  optimizer->SetReturnBestParametersAndValue( localOptimizer->GetReturnBestParametersAndValue() );
+  optimizer->SetDoEstimateLearningRateOnce( false );
+  optimizer->SetDoEstimateLearningRateAtEachIteration( false );
+  optimizer->SetDoEstimateScales( false );
+  if( localOptimizer->GetScalesInitialized() )
+    {
+    optimizer->SetScales( localOptimizer->GetScales() );
+    }
+  optimizer->SetWeights( localOptimizer->GetWeights() );
+  return optimizer.GetPointer();
+}
+
 //-------------------------------------------------------------------
 template<typename TInternalComputationValueType>
 const typename MultiStartOptimizerv4Template<TInternalComputationValueType>::StopConditionReturnStringType
@@ -173,6 +233,12 @@ void
 MultiStartOptimizerv4Template<TInternalComputationValueType>
 ::ResumeOptimization()
 {
+  if( this->m_MetricList.size() > 1 )
+    {
+    this->ResumeOptimizationConcurrently();
+    return;
+    }
+
   this->m_StopConditionDescription.str("");
   this->m_StopConditionDescription << this->GetNameOfClass() << ": ";
   this->InvokeEvent( StartEvent() );
@@ -230,6 +296,115 @@ MultiStartOptimizerv4Template<TInternalComputationValueType>
     } //while (!m_Stop)
 }
 
+/**
+* Evaluate the start points concurrently, then reduce in start point order.
+*/
+template<typename TInternalComputationValueType>
+void
+MultiStartOptimizerv4Template<TInternalComputationValueType>
+::ResumeOptimizationConcurrently()
+{
+  this->m_StopConditionDescription.str("");
+  this->m_StopConditionDescription << this->GetNameOfClass() << ": ";
+  this->InvokeEvent( StartEvent() );
+
+  this->m_Stop = false;
+
+  const SizeValueType numberOfStartPoints = this->m_NumberOfIterations;
+  this->m_StartPointValues.assign( numberOfStartPoints, this->m_MaximumMetricValue );
+  this->m_StartPointEvaluated.assign( numberOfStartPoints, 0 );
+
+  /* Each thread owns one metric and one local optimizer, and each metric
+   * gets an equal share of the optimizer threads. */
+  const ThreadIdType numberOfThreads = std::min( this->m_NumberOfThreads,
+                                                 static_cast<ThreadIdType>( this->m_MetricList.size() ) );
+  const ThreadIdType threadsPerMetric = std::max( this->m_NumberOfThreads / numberOfThreads,
+                                                  static_cast<ThreadIdType>( 1 ) );
+  this->m_ThreadLocalOptimizers.assign( numberOfThreads, OptimizerPointer() );
+  for( ThreadIdType t = 0; t < numberOfThreads; ++t )
+    {
+    this->m_MetricList[t]->SetMaximumNumberOfThreads( threadsPerMetric );
+    if( this->m_LocalOptimizer )
+      {
+      this->m_ThreadLocalOptimizers[t] = this->CloneLocalOptimizer();
+      this->m_ThreadLocalOptimizers[t]->SetNumberOfThreads( threadsPerMetric );
+      }
+    }
+
+  IndexRangeType fullrange;
+  fullrange[0] = 0;
+  fullrange[1] = numberOfStartPoints - 1; //range is inclusive
+  this->m_EvaluateStartPointsThreader->SetMaximumNumberOfThreads( numberOfThreads );
+  this->m_EvaluateStartPointsThreader->Execute( this, fullrange );
+  this->m_ThreadLocalOptimizers.clear();
+
+  /* Reduce in start point order, as the serial search does. */
+  while( ! this->m_Stop )
+    {
+    if( this->m_StartPointEvaluated[this->m_CurrentIteration] )
+      {
+      this->m_CurrentMetricValue = this->m_StartPointValues[this->m_CurrentIteration];
+      this->m_MetricValuesList.push_back( this->m_CurrentMetricValue );
+      if ( this->m_CurrentMetricValue <  this->m_MinimumMetricValue )
+        {
+        this->m_MinimumMetricValue = this->m_CurrentMetricValue;
+        this->m_BestParametersIndex = this->m_CurrentIteration;
+        }
+      }
+    else
+      {
+      itkWarningMacro("An exception occurred in sub-optimization number " << this->m_CurrentIteration << ".  If too many of these occur, you may need to set a different set of initial parameters.");
+      }
+
+    this->InvokeEvent( IterationEvent() );
+
+    this->m_CurrentIteration++;
+    if ( this->m_CurrentIteration >= this->m_NumberOfIterations )
+      {
+      this->m_StopConditionDescription << "Maximum number of iterations ("
+      << this->m_NumberOfIterations
+      << ") exceeded.";
+      this->m_StopCondition = MAXIMUM_NUMBER_OF_ITERATIONS;
+      this->StopOptimization();
+      break;
+      }
+    }
+  if( this->m_CurrentIteration < this->m_NumberOfIterations )
+    {
+    this->m_StopConditionDescription << "StopOptimization() called";
+    }
+}
+
+//-------------------------------------------------------------------
+template<typename TInternalComputationValueType>
+void
+MultiStartOptimizerv4Template<TInternalComputationValueType>
+::EvaluateStartPointsOverSubRange( const IndexRangeType & subrange, const ThreadIdType threadId )
+{
+  MetricType * metric = this->m_MetricList[threadId];
+  OptimizerType * localOptimizer = this->m_ThreadLocalOptimizers[threadId];
+
+  for( IndexValueType i = subrange[0]; i <= subrange[1]; ++i )
+    {
+    try
+      {
+      metric->SetParameters( this->m_ParametersList[i] );
+      if( localOptimizer )
+        {
+        localOptimizer->SetMetric( metric );
+        localOptimizer->StartOptimization();
+        this->m_ParametersList[i] = metric->GetParameters();
+        }
+      this->m_StartPointValues[i] = metric->GetValue();
+      this->m_StartPointEvaluated[i] = 1;
+      }
+    catch ( ExceptionObject & )
+      {
+      /** The start point is reported and skipped during the reduction. */
+      }
+    }
+}
+
 } //namespace itk
 
 #endif
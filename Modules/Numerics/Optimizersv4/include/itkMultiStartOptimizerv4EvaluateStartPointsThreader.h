@@ -0,0 +1,77 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkMultiStartOptimizerv4EvaluateStartPointsThreader_h
+#define itkMultiStartOptimizerv4EvaluateStartPointsThreader_h
+
+#include "itkDomainThreader.h"
+#include "itkThreadedIndexedContainerPartitioner.h"
+
+namespace itk
+{
+
+template<typename TInternalComputationValueType>
+class MultiStartOptimizerv4Template;
+
+/** \class MultiStartOptimizerv4EvaluateStartPointsThreaderTemplate
+ * \brief Evaluate a range of start points of MultiStartOptimizerv4
+ * concurrently, each thread using its own metric instance.
+ * \ingroup ITKOptimizersv4
+ */
+
+template<typename TInternalComputationValueType>
+class MultiStartOptimizerv4EvaluateStartPointsThreaderTemplate
+  : public DomainThreader< ThreadedIndexedContainerPartitioner, MultiStartOptimizerv4Template<TInternalComputationValueType> >
+{
+public:
+  /** Standard class typedefs. */
+  typedef MultiStartOptimizerv4EvaluateStartPointsThreaderTemplate                  Self;
+  typedef DomainThreader< ThreadedIndexedContainerPartitioner, MultiStartOptimizerv4Template<TInternalComputationValueType> >
+                                                                                    Superclass;
+  typedef SmartPointer< Self >                                                      Pointer;
+  typedef SmartPointer< const Self >                                                ConstPointer;
+
+  itkTypeMacro( MultiStartOptimizerv4EvaluateStartPointsThreaderTemplate, DomainThreader );
+
+  itkNewMacro( Self );
+
+  typedef typename Superclass::DomainType    DomainType;
+  typedef typename Superclass::AssociateType AssociateType;
+  typedef DomainType                         IndexRangeType;
+
+protected:
+  virtual void ThreadedExecution( const IndexRangeType & subrange,
+                                  const ThreadIdType threadId ) ITK_OVERRIDE;
+
+  MultiStartOptimizerv4EvaluateStartPointsThreaderTemplate() {}
+  virtual ~MultiStartOptimizerv4EvaluateStartPointsThreaderTemplate() {}
+
+private:
+  MultiStartOptimizerv4EvaluateStartPointsThreaderTemplate( const Self & ); // purposely not implemented
+  void operator=( const Self & ); // purposely not implemented
+};
+
+/** This helps to meet backward compatibility */
+typedef MultiStartOptimizerv4EvaluateStartPointsThreaderTemplate<double> MultiStartOptimizerv4EvaluateStartPointsThreader;
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkMultiStartOptimizerv4EvaluateStartPointsThreader.hxx"
+#endif
+
+#endif
@@ -185,6 +185,12 @@ public:
     return UNKNOWN_METRIC;
     }
 
+  /** Set the maximum number of threads the metric may use internally.
+   * Metrics that are not threaded ignore this value, which is the default.
+   * Optimizers that evaluate several metric instances concurrently use it to
+   * give each instance a share of their threads. */
+  virtual void SetMaximumNumberOfThreads( const ThreadIdType ) {}
+
 protected:
   ObjectToObjectMetricBaseTemplate();
   virtual ~ObjectToObjectMetricBaseTemplate();
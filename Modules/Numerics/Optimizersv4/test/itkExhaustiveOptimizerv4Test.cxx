@@ -310,6 +310,46 @@ int itkExhaustiveOptimizerv4Test(int, char* [] )
     }
 
 
+  // Sample the same grid concurrently, with one metric per thread.
+  OptimizerType::MetricListType metricList;
+  for ( unsigned int m = 0; m < 4; ++m )
+    {
+    ExhaustiveOptv4Metric::Pointer threadMetric = ExhaustiveOptv4Metric::New();
+    threadMetric->Initialize();
+    metricList.push_back( threadMetric.GetPointer() );
+    }
+  itkOptimizer->SetMetricList( metricList );
+  itkOptimizer->SetNumberOfThreads( 4 );
+  metric->SetParameters( initialPosition );
+
+  const std::vector < unsigned long > serialVisitedIndices = idxObserver->m_VisitedIndices;
+  idxObserver->m_VisitedIndices.clear();
+
+  try
+    {
+    itkOptimizer->StartOptimization();
+    }
+  catch( itk::ExceptionObject & e )
+    {
+    std::cout << "Exception thrown during concurrent sampling: " << e << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  if ( vnl_math_abs ( itkOptimizer->GetMinimumMetricValue() - -10 ) > 1E-3
+       || vnl_math_abs ( itkOptimizer->GetMaximumMetricValue() - 926 ) > 1E-3
+       || itkOptimizer->GetMinimumMetricValuePosition() != finalPosition
+       || itkOptimizer->GetCurrentIteration() != requiredNumberOfSteps
+       || idxObserver->m_VisitedIndices != serialVisitedIndices )
+    {
+    std::cout << "Concurrent sampling does not match the serial walk." << std::endl;
+    std::cout << "Number of IterationEvents = " << idxObserver->m_VisitedIndices.size() << std::endl;
+    std::cout << "MinimumMetricValue = " << itkOptimizer->GetMinimumMetricValue() << std::endl;
+    std::cout << "MaximumMetricValue = " << itkOptimizer->GetMaximumMetricValue() << std::endl;
+    std::cout << "Minimum Position = " << itkOptimizer->GetMinimumMetricValuePosition() << std::endl;
+    std::cout << "Test failed." << std::endl;
+    return EXIT_FAILURE;
+    }
+
   std::cout << "Testing PrintSelf " << std::endl;
   itkOptimizer->Print( std::cout );
 
@@ -285,6 +285,51 @@ int itkMultiStartOptimizerv4Test(int, char* [] )
     return EXIT_FAILURE;
     }
   std::cout << "Test 3 passed." << std::endl;
+
+  /*
+   * Test 4
+   */
+  std::cout << "Test optimization 4: concurrent evaluation with local optimizer" << std::endl;
+  parametersList.clear();
+  for (  int i = -3; i < 3; i++ )
+    {
+    for (  int j = -3; j < 3; j++ )
+      {
+      ParametersType  testPosition( spaceDimension );
+      testPosition[0]=(double)i;
+      testPosition[1]=(double)j;
+      parametersList.push_back( testPosition );
+      }
+    }
+  metric->SetParameters( parametersList[0] );
+  itkOptimizer->SetParametersList( parametersList );
+  if( MultiStartOptimizerv4RunTest( itkOptimizer ) == EXIT_FAILURE )
+    {
+    return EXIT_FAILURE;
+    }
+  const OptimizerType::MetricValuesListType serialValues = itkOptimizer->GetMetricValuesList();
+  const OptimizerType::ParameterListSizeType serialBestIndex = itkOptimizer->GetBestParametersIndex();
+
+  OptimizerType::MetricListType metricList;
+  for( unsigned int m = 0; m < 3; m++ )
+    {
+    metricList.push_back( MultiStartOptimizerv4TestMetric::New().GetPointer() );
+    }
+  itkOptimizer->SetMetricList( metricList );
+  itkOptimizer->SetNumberOfThreads( 3 );
+  metric->SetParameters( parametersList[0] );
+  itkOptimizer->SetParametersList( parametersList );
+  if( MultiStartOptimizerv4RunTest( itkOptimizer ) == EXIT_FAILURE )
+    {
+    return EXIT_FAILURE;
+    }
+  if( itkOptimizer->GetMetricValuesList() != serialValues
+      || itkOptimizer->GetBestParametersIndex() != serialBestIndex )
+    {
+    std::cerr << "Concurrent evaluation does not match the serial evaluation." << std::endl;
+    return EXIT_FAILURE;
+    }
+  std::cout << "Test 4 passed." << std::endl;
   return EXIT_SUCCESS;
 
 }
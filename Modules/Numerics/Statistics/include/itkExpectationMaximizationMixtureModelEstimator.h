@@ -21,6 +21,7 @@
 #include "itkMixtureModelComponentBase.h"
 #include "itkGaussianMembershipFunction.h"
 #include "itkSimpleDataObjectDecorator.h"
+#include "itkMultiThreader.h"
 
 namespace itk
 {
@@ -42,6 +43,13 @@ namespace Statistics
  * required. The EM procedure terminates when the current iteration
  * reaches the maximum iteration or the model parameters converge.
  *
+ * The expectation step splits the sample into contiguous ranges that are
+ * evaluated by separate threads (SetNumberOfThreads). Each thread also
+ * sums the weighted frequencies of its range, and the proportions are
+ * updated from those sums, so the sample is not visited again. The
+ * components' Evaluate must therefore be safe to call concurrently, as
+ * it is for GaussianMixtureModelComponent.
+ *
  * <b>Recent API changes:</b>
  * The static const macro to get the length of a measurement vector,
  * \c MeasurementVectorSize  has been removed to allow the length of a measurement
@@ -144,6 +152,12 @@ public:
     return m_CurrentIteration;
   }
 
+  /** Set/Get the number of threads used by the expectation step. It
+   * defaults to one, because the proportions are summed per thread and
+   * their rounding depends on the number of threads. */
+  itkSetClampMacro(NumberOfThreads, ThreadIdType, 1, ITK_MAX_THREADS);
+  itkGetConstMacro(NumberOfThreads, ThreadIdType);
+
   /** Adds a new component (or class). */
   int AddComponent(ComponentType *component);
 
@@ -197,6 +211,35 @@ private:
 
   MembershipFunctionVectorObjectPointer  m_MembershipFunctionsObject;
   MembershipFunctionsWeightsArrayPointer m_MembershipFunctionsWeightArrayObject;
+
+  ThreadIdType           m_NumberOfThreads;
+  MultiThreader::Pointer m_MultiThreader;
+
+  /** Sum over the sample of the weight times the frequency of each
+   * component, gathered by the last expectation step. */
+  std::vector< double > m_WeightedFrequencySums;
+
+  /** A contiguous range of the sample handled by one thread of the
+   * expectation step. */
+  struct DensityRangeType
+    {
+    typename TSample::ConstIterator Begin;
+    SizeValueType                   FirstIndex;
+    SizeValueType                   Size;
+    std::vector< double >           WeightedFrequencySums;
+
+    DensityRangeType(const typename TSample::ConstIterator & begin):Begin(begin) {}
+    };
+
+  struct ThreadStruct
+    {
+    Self *Estimator;
+    std::vector< DensityRangeType > *Ranges;
+    };
+
+  static ITK_THREAD_RETURN_TYPE CalculateDensitiesThreaderCallback(void *arg);
+
+  void ThreadedCalculateDensities(DensityRangeType & range);
 };  // end of class
 } // end of namespace Statistics
 } // end of namespace itk
@@ -33,7 +33,9 @@ ExpectationMaximizationMixtureModelEstimator< TSample >
   m_CurrentIteration(0),
   m_TerminationCode(NOT_CONVERGED),
   m_MembershipFunctionsObject           (MembershipFunctionVectorObjectType::New()),
-  m_MembershipFunctionsWeightArrayObject(MembershipFunctionsWeightsArrayObjectType::New())
+  m_MembershipFunctionsWeightArrayObject(MembershipFunctionsWeightsArrayObjectType::New()),
+  m_NumberOfThreads(1),
+  m_MultiThreader(MultiThreader::New())
 {
 }
 
@@ -54,6 +56,8 @@ ExpectationMaximizationMixtureModelEstimator< TSample >
     os << indent << "Component Membership Function[" << i << "]: "
        << this->GetComponentMembershipFunction(i) << std::endl;
     }
+  os << indent << "Number Of Threads: "
+     << this->GetNumberOfThreads() << std::endl;
   os << indent << "Termination Code: "
      << this->GetTerminationCode() << std::endl;
   os << indent << "Initial Proportions: "
@@ -173,12 +177,96 @@ ExpectationMaximizationMixtureModelEstimator< TSample >
     return false;
     }
 
+  const size_t        numberOfComponents = m_ComponentVector.size();
+  const SizeValueType sampleSize = m_Sample->Size();
+
+  //
+  // Split the sample into contiguous ranges, one per thread. The sample is
+  // only reachable through iterators, so the iterator at the start of
+  // each range is found by a single walk over the sample.
+  //
+  SizeValueType numberOfRanges = std::min( static_cast< SizeValueType >( m_NumberOfThreads ), sampleSize );
+  if ( numberOfRanges < 1 )
+    {
+    numberOfRanges = 1;
+    }
+
+  std::vector< DensityRangeType > ranges;
+  ranges.reserve(numberOfRanges);
+
+  typename TSample::ConstIterator iter = m_Sample->Begin();
+  SizeValueType                   measurementVectorIndex = 0;
+  for ( SizeValueType r = 0; r < numberOfRanges; ++r )
+    {
+    const SizeValueType first = sampleSize / numberOfRanges * r
+                                + std::min( r, sampleSize % numberOfRanges );
+    while ( measurementVectorIndex < first )
+      {
+      ++iter;
+      ++measurementVectorIndex;
+      }
+    DensityRangeType range(iter);
+    range.FirstIndex = first;
+    range.Size = sampleSize / numberOfRanges + ( r < sampleSize % numberOfRanges ? 1 : 0 );
+    range.WeightedFrequencySums.resize(numberOfComponents, 0.0);
+    ranges.push_back(range);
+    }
+
+  if ( numberOfRanges > 1 )
+    {
+    ThreadStruct str;
+    str.Estimator = this;
+    str.Ranges = &ranges;
+
+    m_MultiThreader->SetNumberOfThreads( static_cast< ThreadIdType >( numberOfRanges ) );
+    m_MultiThreader->SetSingleMethod(Self::CalculateDensitiesThreaderCallback, &str);
+    m_MultiThreader->SingleMethodExecute();
+    }
+  else
+    {
+    this->ThreadedCalculateDensities(ranges[0]);
+    }
+
+  // Add the sums of the ranges in sample order.
+  m_WeightedFrequencySums.assign(numberOfComponents, 0.0);
+  for ( SizeValueType r = 0; r < numberOfRanges; ++r )
+    {
+    for ( size_t componentIndex = 0; componentIndex < numberOfComponents; ++componentIndex )
+      {
+      m_WeightedFrequencySums[componentIndex] += ranges[r].WeightedFrequencySums[componentIndex];
+      }
+    }
+
+  return true;
+}
+
+template< typename TSample >
+ITK_THREAD_RETURN_TYPE
+ExpectationMaximizationMixtureModelEstimator< TSample >
+::CalculateDensitiesThreaderCallback(void *arg)
+{
+  typedef MultiThreader::ThreadInfoStruct ThreadInfoType;
+  ThreadInfoType *info = static_cast< ThreadInfoType * >( arg );
+  ThreadStruct *  str = static_cast< ThreadStruct * >( info->UserData );
+
+  if ( info->ThreadID < str->Ranges->size() )
+    {
+    str->Estimator->ThreadedCalculateDensities( ( *str->Ranges )[info->ThreadID] );
+    }
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+template< typename TSample >
+void
+ExpectationMaximizationMixtureModelEstimator< TSample >
+::ThreadedCalculateDensities(DensityRangeType & range)
+{
   double                temp;
   size_t                numberOfComponents = m_ComponentVector.size();
   std::vector< double > tempWeights(numberOfComponents, 0. );
 
-  typename TSample::ConstIterator iter = m_Sample->Begin();
-  typename TSample::ConstIterator last = m_Sample->End();
+  typename TSample::ConstIterator iter = range.Begin;
 
   size_t componentIndex;
 
@@ -190,9 +278,10 @@ ExpectationMaximizationMixtureModelEstimator< TSample >
   double densitySum;
   double minDouble = NumericTraits<double>::epsilon();
 
-  SizeValueType measurementVectorIndex = 0;
+  SizeValueType       measurementVectorIndex = range.FirstIndex;
+  const SizeValueType end = range.FirstIndex + range.Size;
 
-  while ( iter != last )
+  while ( measurementVectorIndex < end )
     {
     mvector = iter.GetMeasurementVector();
     frequency = iter.GetFrequency();
@@ -221,6 +310,7 @@ ExpectationMaximizationMixtureModelEstimator< TSample >
           }
         m_ComponentVector[componentIndex]->SetWeight(measurementVectorIndex,
                                                      temp);
+        range.WeightedFrequencySums[componentIndex] += temp * frequency;
         }
       }
     else
@@ -236,8 +326,6 @@ ExpectationMaximizationMixtureModelEstimator< TSample >
     ++iter;
     ++measurementVectorIndex;
     }
-
-  return true;
 }
 
 template< typename TSample >
@@ -324,16 +412,26 @@ ExpectationMaximizationMixtureModelEstimator< TSample >
   double tempSum;
   bool   updated = false;
 
+  // The expectation step already summed the weighted frequencies.
+  const bool useSums = ( m_WeightedFrequencySums.size() == numberOfComponents );
+
   for ( i = 0; i < numberOfComponents; ++i )
     {
     tempSum = 0.;
 
     if( totalFrequency > NumericTraits<double>::epsilon() )
       {
-      for ( j = 0; j < sampleSize; ++j )
+      if ( useSums )
         {
-        tempSum += ( m_ComponentVector[i]->GetWeight(j)
-                     * m_Sample->GetFrequency(j) );
+        tempSum = m_WeightedFrequencySums[i];
+        }
+      else
+        {
+        for ( j = 0; j < sampleSize; ++j )
+          {
+          tempSum += ( m_ComponentVector[i]->GetWeight(j)
+                       * m_Sample->GetFrequency(j) );
+          }
         }
 
       tempSum /= totalFrequency;
@@ -355,6 +453,7 @@ ExpectationMaximizationMixtureModelEstimator< TSample >
 ::GenerateData()
 {
   m_Proportions = m_InitialProportions;
+  m_WeightedFrequencySums.clear();
 
   int iteration = 0;
   m_CurrentIteration = 0;
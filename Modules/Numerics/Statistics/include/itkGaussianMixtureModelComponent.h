@@ -108,8 +108,6 @@ private:
 
   typename CovarianceEstimatorType::MatrixType m_Covariance;
 
-  typename MeanEstimatorType::Pointer m_MeanEstimator;
-
   typename CovarianceEstimatorType::Pointer m_CovarianceEstimator;
 };  // end of class
 } // end of namespace Statistics
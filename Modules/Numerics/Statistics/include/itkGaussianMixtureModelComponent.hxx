@@ -30,7 +30,6 @@ template< typename TSample >
 GaussianMixtureModelComponent< TSample >
 ::GaussianMixtureModelComponent()
 {
-  m_MeanEstimator = MeanEstimatorType::New();
   m_CovarianceEstimator = CovarianceEstimatorType::New();
   m_GaussianMembershipFunction = NativeMembershipFunctionType::New();
   this->SetMembershipFunction( (MembershipFunctionType *)
@@ -48,7 +47,6 @@ GaussianMixtureModelComponent< TSample >
 
   os << indent << "Mean: " << m_Mean << std::endl;
   os << indent << "Covariance: " << m_Covariance << std::endl;
-  os << indent << "Mean Estimator: " << m_MeanEstimator << std::endl;
   os << indent << "Covariance Estimator: " << m_CovarianceEstimator << std::endl;
   os << indent << "GaussianMembershipFunction: " << m_GaussianMembershipFunction << std::endl;
 }
@@ -60,7 +58,6 @@ GaussianMixtureModelComponent< TSample >
 {
   Superclass::SetSample(sample);
 
-  m_MeanEstimator->SetInput(sample);
   m_CovarianceEstimator->SetInput(sample);
 
   const MeasurementVectorSizeType measurementVectorLength =
@@ -151,7 +148,7 @@ GaussianMixtureModelComponent< TSample >
   unsigned int i, j;
 
   typename MeanVectorType::MeasurementVectorType meanEstimate =
-    m_MeanEstimator->GetMean();
+    m_CovarianceEstimator->GetMean();
 
   CovarianceMatrixType covEstimateDecoratedObject = m_CovarianceEstimator->GetOutput();
   typename CovarianceMatrixType::MeasurementVectorType covEstimate =  covEstimateDecoratedObject->et();
@@ -193,20 +190,10 @@ GaussianMixtureModelComponent< TSample >
 
   const WeightArrayType & weights = this->GetWeights();
 
-  typename TSample::ConstIterator iter = this->GetSample()->Begin();
-  typename TSample::ConstIterator end =  this->GetSample()->End();
-
-  typename TSample::MeasurementVectorType measurements;
-
-  // why these lines???
-  while ( iter != end )
-    {
-    measurements = iter.GetMeasurementVector();
-    ++iter;
-    }
-
-  m_MeanEstimator->SetWeights(weights);
-  m_MeanEstimator->Update();
+  // The covariance estimator computes the weighted mean on its way, so a
+  // single Update gives both estimates.
+  m_CovarianceEstimator->SetWeights(weights);
+  m_CovarianceEstimator->Update();
 
   MeasurementVectorSizeType   i, j;
   double         temp;
@@ -215,7 +202,7 @@ GaussianMixtureModelComponent< TSample >
   ParametersType parameters = this->GetFullParameters();
   MeasurementVectorSizeType            paramIndex  = 0;
 
-  typename MeanEstimatorType::MeasurementVectorType meanEstimate = m_MeanEstimator->GetMean();
+  typename MeanEstimatorType::MeasurementVectorType meanEstimate = m_CovarianceEstimator->GetMean();
   for ( i = 0; i < measurementVectorSize; i++ )
     {
     changes = vnl_math_abs( m_Mean[i] - meanEstimate[i] );
@@ -241,8 +228,6 @@ GaussianMixtureModelComponent< TSample >
     paramIndex = measurementVectorSize;
     }
 
-  m_CovarianceEstimator->SetWeights(weights);
-  m_CovarianceEstimator->Update();
   typename CovarianceEstimatorType::MatrixType covEstimate =
     m_CovarianceEstimator->GetCovarianceMatrix();
 
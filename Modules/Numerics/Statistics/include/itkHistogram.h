@@ -135,7 +135,9 @@ public:
 
   /** Initialize the histogram using equal size bins. To assign bin's
    * min and max values along each dimension use SetBinMin() and
-   * SetBinMax() functions. */
+   * SetBinMax() functions. As long as the bins are not modified
+   * afterwards, GetIndex() locates the bin of a measurement in constant
+   * time instead of with a binary search. */
   void Initialize(const SizeType & size, MeasurementVectorType & lowerBound,
                   MeasurementVectorType & upperBound);
 
@@ -506,6 +508,10 @@ private:
   // related to the virtual method available in DataObject.
   virtual void Initialize() ITK_OVERRIDE {}
 
+  // Bin of a value along one dimension when the bins have equal widths.
+  // The value is expected to lie within the range of the histogram.
+  IndexValueType GetUniformBin(unsigned int dimension, double value) const;
+
   // lower bound of each bin
   std::vector< std::vector< MeasurementType > > m_Min;
 
@@ -516,6 +522,12 @@ private:
   mutable IndexType             m_TempIndex;
 
   bool m_ClipBinsAtEnds;
+
+  // Set while the bins are the equal width ones created by
+  // Initialize(size, lowerBound, upperBound). GetIndex() then computes
+  // the bin from the measurement instead of searching the bin bounds.
+  bool                  m_UniformBins;
+  std::vector< double > m_UniformBinScale;
 };
 } // end of namespace Statistics
 } // end of namespace itk
@@ -32,7 +32,8 @@ Histogram< TMeasurement, TFrequencyContainer >
   m_OffsetTable(OffsetTableType(Superclass::GetMeasurementVectorSize() + 1)),
   m_FrequencyContainer(FrequencyContainerType::New()),
   m_NumberOfInstances(0),
-  m_ClipBinsAtEnds(true)
+  m_ClipBinsAtEnds(true),
+  m_UniformBins(false)
 {
   for ( unsigned int i = 0; i < this->GetMeasurementVectorSize() + 1; i++ )
     {
@@ -102,6 +103,7 @@ Histogram< TMeasurement, TFrequencyContainer >
             MeasurementType min)
 {
   m_Min[dimension][nbin] = min;
+  m_UniformBins = false;
 }
 
 template< typename TMeasurement, typename TFrequencyContainer >
@@ -111,6 +113,7 @@ Histogram< TMeasurement, TFrequencyContainer >
             MeasurementType max)
 {
   m_Max[dimension][nbin] = max;
+  m_UniformBins = false;
 }
 
 template< typename TMeasurement, typename TFrequencyContainer >
@@ -221,6 +224,8 @@ Histogram< TMeasurement, TFrequencyContainer >
   this->m_TempIndex.SetSize( this->GetMeasurementVectorSize() );
   this->m_TempMeasurementVector.SetSize( this->GetMeasurementVectorSize() );
 
+  m_UniformBins = false;
+
   // initialize the frequency container
   m_FrequencyContainer->Initialize(this->m_OffsetTable[this->GetMeasurementVectorSize()]);
   this->SetToZero();
@@ -265,6 +270,24 @@ Histogram< TMeasurement, TFrequencyContainer >
                        (MeasurementType)( upperBound[i] ) );
       }
     }
+
+  // Remember the inverse bin width of every dimension, so that GetIndex()
+  // can compute a first guess of the bin directly. Degenerate ranges keep
+  // using the binary search.
+  m_UniformBinScale.resize( this->GetMeasurementVectorSize() );
+  bool uniform = true;
+  for ( unsigned int i = 0; i < this->GetMeasurementVectorSize(); i++ )
+    {
+    const double range = size[i] > 0 ?
+      static_cast< double >( m_Max[i][size[i] - 1] ) - static_cast< double >( m_Min[i][0] ) : 0.0;
+    if ( !( range > 0.0 ) )
+      {
+      uniform = false;
+      break;
+      }
+    m_UniformBinScale[i] = static_cast< double >( size[i] ) / range;
+    }
+  m_UniformBins = uniform;
 }
 
 /** */
@@ -326,6 +349,12 @@ bool Histogram< TMeasurement, TFrequencyContainer >
         }
       }
 
+    if ( m_UniformBins )
+      {
+      index[dim] = this->GetUniformBin( dim, tempMeasurement );
+      continue;
+      }
+
     // Binary search for the bin where this measurement could be
     mid = ( end + 1 ) / 2;
     median = m_Min[dim][mid];
@@ -361,6 +390,33 @@ bool Histogram< TMeasurement, TFrequencyContainer >
   return true;
 }
 
+template< typename TMeasurement, typename TFrequencyContainer >
+inline typename Histogram< TMeasurement, TFrequencyContainer >::IndexValueType
+Histogram< TMeasurement, TFrequencyContainer >
+::GetUniformBin(unsigned int dimension, double value) const
+{
+  // Compute the bin from the bin width, then step to the neighbor if the
+  // rounding of the stored bin bounds put the value just outside of it.
+  const IndexValueType last = static_cast< IndexValueType >( m_Size[dimension] ) - 1;
+  const double offset = ( value - static_cast< double >( m_Min[dimension][0] ) )
+                        * m_UniformBinScale[dimension];
+
+  IndexValueType bin = 0;
+  if ( offset > 0.0 )
+    {
+    bin = offset < static_cast< double >( last ) ? static_cast< IndexValueType >( offset ) : last;
+    }
+  while ( bin > 0 && value < m_Min[dimension][bin] )
+    {
+    --bin;
+    }
+  while ( bin < last && value >= m_Max[dimension][bin] )
+    {
+    ++bin;
+    }
+  return bin;
+}
+
 template< typename TMeasurement, typename TFrequencyContainer >
 inline const typename Histogram< TMeasurement, TFrequencyContainer >::IndexType &
 Histogram< TMeasurement, TFrequencyContainer >
@@ -429,6 +485,11 @@ Histogram< TMeasurement, TFrequencyContainer >
     return m_Min[dimension][this->m_Size[dimension] - 1];
     }
 
+  if ( m_UniformBins )
+    {
+    return this->m_Min[dimension][this->GetUniformBin( dimension, value )];
+    }
+
   unsigned int binMinFromValue = 0;
 
   for ( unsigned int i = 0; i < this->m_Size[dimension]; i++ )
@@ -462,6 +523,11 @@ Histogram< TMeasurement, TFrequencyContainer >
     return m_Max[dimension][this->m_Size[dimension] - 1];
     }
 
+  if ( m_UniformBins )
+    {
+    return this->m_Max[dimension][this->GetUniformBin( dimension, value )];
+    }
+
   unsigned int binMaxFromValue = 0;
 
   for ( unsigned int i = 0; i < this->m_Size[dimension]; i++ )
@@ -766,6 +832,8 @@ Histogram< TMeasurement, TFrequencyContainer >
     this->m_TempMeasurementVector = that->m_TempMeasurementVector;
     this->m_TempIndex             = that->m_TempIndex;
     this->m_ClipBinsAtEnds        = that->m_ClipBinsAtEnds;
+    this->m_UniformBins           = that->m_UniformBins;
+    this->m_UniformBinScale       = that->m_UniformBinScale;
     }
 }
 
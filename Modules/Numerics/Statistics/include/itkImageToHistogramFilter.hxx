@@ -233,9 +233,10 @@ void
 ImageToHistogramFilter< TImage >
 ::AfterThreadedGenerateData()
 {
-  // group the results in the output histogram
+  // group the results in the output histogram. All the histograms have
+  // been initialized with the same bins, so the bins can be added by
+  // instance identifier without looking the measurements up again.
   HistogramType * hist = m_Histograms[0];
-  typename HistogramType::IndexType index;
   for( unsigned int i=1; i<m_Histograms.size(); i++ )
     {
     typedef typename HistogramType::ConstIterator         HistogramIterator;
@@ -244,8 +245,10 @@ ImageToHistogramFilter< TImage >
     HistogramIterator end = m_Histograms[i]->End();
     while ( hit != end )
       {
-      hist->GetIndex( hit.GetMeasurementVector(), index);
-      hist->IncreaseFrequencyOfIndex( index, hit.GetFrequency() );
+      if( hit.GetFrequency() != NumericTraits< typename HistogramType::AbsoluteFrequencyType >::ZeroValue() )
+        {
+        hist->IncreaseFrequency( hit.GetInstanceIdentifier(), hit.GetFrequency() );
+        }
       ++hit;
       }
     }
@@ -299,13 +302,16 @@ ImageToHistogramFilter< TImage >
   inputIt.GoToBegin();
   HistogramMeasurementVectorType m( nbOfComponents );
 
-  typename HistogramType::IndexType index;
+  HistogramType * hist = m_Histograms[threadId];
+  typename HistogramType::IndexType index( nbOfComponents );
   while ( !inputIt.IsAtEnd() )
     {
     const PixelType & p = inputIt.Get();
     NumericTraits<PixelType>::AssignToArray( p, m );
-    m_Histograms[threadId]->GetIndex( m, index );
-    m_Histograms[threadId]->IncreaseFrequencyOfIndex( index, 1 );
+    if ( hist->GetIndex( m, index ) )
+      {
+      hist->IncreaseFrequency( hist->GetInstanceIdentifier( index ), 1 );
+      }
     ++inputIt;
     progress.CompletedPixel();  // potential exception thrown here
     }
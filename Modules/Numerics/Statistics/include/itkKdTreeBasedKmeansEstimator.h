@@ -26,6 +26,7 @@
 #include "itkDistanceToCentroidMembershipFunction.h"
 #include "itkSimpleDataObjectDecorator.h"
 #include "itkNumericTraitsArrayPixel.h"
+#include "itkMultiThreader.h"
 
 namespace itk
 {
@@ -54,6 +55,14 @@ namespace Statistics
  * WeightedCentroidKdTreeGenerator. It will save the tree construction
  * time and memory usage.
  *
+ * The pruning pass of each iteration can run on several threads
+ * (SetNumberOfThreads). The top levels of the tree are pruned first, and
+ * the subtrees reached there are filtered by separate threads into their
+ * own sums, which are added in tree order. Threads read the measurement
+ * vectors of the tree's sample concurrently, so this requires a sample
+ * whose GetMeasurementVector is safe to call from several threads, such as
+ * ListSample. The cluster labels are always generated on one thread.
+ *
  * Note: There is a second implementation of k-means algorithm in ITK under the
  * While the Kd tree based implementation is more time efficient, the  GLA/LBG
  * based algorithm is more memory efficient.
@@ -156,6 +165,11 @@ public:
    * of changes in centroid positions)  */
   void StartOptimization();
 
+  /** Set/Get the number of threads used by the pruning pass. The
+   * default is one. */
+  itkSetClampMacro(NumberOfThreads, ThreadIdType, 1, ITK_MAX_THREADS);
+  itkGetConstMacro(NumberOfThreads, ThreadIdType);
+
   typedef itksys::hash_map< InstanceIdentifier, unsigned int > ClusterLabelsType;
 
   itkSetMacro(UseClusterLabels, bool);
@@ -323,6 +337,68 @@ private:
   ClusterLabelsType                     m_ClusterLabels;
   MeasurementVectorSizeType             m_MeasurementVectorSize;
   MembershipFunctionVectorObjectPointer m_MembershipFunctionsObject;
+
+  ThreadIdType           m_NumberOfThreads;
+  MultiThreader::Pointer m_MultiThreader;
+
+  /** A subtree reached by pruning the top levels of the tree, with the
+   * candidates that survived down to it and its cell bounds. */
+  struct FilterTaskType
+    {
+    KdTreeNodeType *      Node;
+    std::vector< int >    ValidIndexes;
+    MeasurementVectorType LowerBound;
+    MeasurementVectorType UpperBound;
+    };
+
+  struct ThreadStruct
+    {
+    Self *                         Estimator;
+    std::vector< FilterTaskType > *Tasks;
+    std::vector< CandidateVector > *Sums;
+    ThreadIdType                   NumberOfThreads;
+    };
+
+  /** Runs the pruning pass over the whole tree, on several threads when
+   * NumberOfThreads is more than one. */
+  void FilterTree(std::vector< int > & validIndexes,
+                  MeasurementVectorType & lowerBound,
+                  MeasurementVectorType & upperBound);
+
+  /** Prunes the top depth levels of the tree like Filter does, and
+   * records the subtrees where it stops. */
+  void CollectFilterTasks(KdTreeNodeType *node,
+                          std::vector< int > validIndexes,
+                          MeasurementVectorType & lowerBound,
+                          MeasurementVectorType & upperBound,
+                          unsigned int depth,
+                          std::vector< FilterTaskType > & tasks);
+
+  static ITK_THREAD_RETURN_TYPE FilterThreaderCallback(void *arg);
+
+  /** Removes from validIndexes the candidates that cannot be the closest
+   * to any point of the node's cell, and returns the closest candidate to
+   * the node's centroid. */
+  int PruneCandidates(KdTreeNodeType *node,
+                      std::vector< int > & validIndexes,
+                      MeasurementVectorType & lowerBound,
+                      MeasurementVectorType & upperBound,
+                      ParameterType & vertex);
+
+  /** Filter, with the sums written to candidates and vertex used as
+   * scratch space. */
+  void FilterNode(KdTreeNodeType *node,
+                  std::vector< int > validIndexes,
+                  MeasurementVectorType & lowerBound,
+                  MeasurementVectorType & upperBound,
+                  CandidateVector & candidates,
+                  ParameterType & vertex);
+
+  bool IsFarther(ParameterType & pointA,
+                 ParameterType & pointB,
+                 MeasurementVectorType & lowerBound,
+                 MeasurementVectorType & upperBound,
+                 ParameterType & vertex);
 };  // end of class
 } // end of namespace Statistics
 } // end of namespace itk
@@ -37,7 +37,9 @@ KdTreeBasedKmeansEstimator< TKdTree >
   m_UseClusterLabels(false),
   m_GenerateClusterLabels(false),
   m_MeasurementVectorSize(0),
-  m_MembershipFunctionsObject(MembershipFunctionVectorObjectType::New())
+  m_MembershipFunctionsObject(MembershipFunctionVectorObjectType::New()),
+  m_NumberOfThreads(1),
+  m_MultiThreader(MultiThreader::New())
 {
   m_TempVertex.Fill(0.0);
 }
@@ -72,6 +74,7 @@ KdTreeBasedKmeansEstimator< TKdTree >
   os << indent << "Parameters: " << this->GetParameters() << std::endl;
   os << indent << "MeasurementVectorSize: " << this->GetMeasurementVectorSize() << std::endl;
   os << indent << "UseClusterLabels: " << this->GetUseClusterLabels() << std::endl;
+  os << indent << "NumberOfThreads: " << this->GetNumberOfThreads() << std::endl;
 }
 
 template< typename TKdTree >
@@ -125,6 +128,18 @@ KdTreeBasedKmeansEstimator< TKdTree >
             ParameterType & pointB,
             MeasurementVectorType & lowerBound,
             MeasurementVectorType & upperBound)
+{
+  return this->IsFarther(pointA, pointB, lowerBound, upperBound, m_TempVertex);
+}
+
+template< typename TKdTree >
+inline bool
+KdTreeBasedKmeansEstimator< TKdTree >
+::IsFarther(ParameterType & pointA,
+            ParameterType & pointB,
+            MeasurementVectorType & lowerBound,
+            MeasurementVectorType & upperBound,
+            ParameterType & vertex)
 {
   // calculates the vertex of the Cell bounded by the lowerBound
   // and the upperBound
@@ -132,16 +147,16 @@ KdTreeBasedKmeansEstimator< TKdTree >
     {
     if ( ( pointA[i] - pointB[i] ) < 0.0 )
       {
-      m_TempVertex[i] = lowerBound[i];
+      vertex[i] = lowerBound[i];
       }
     else
       {
-      m_TempVertex[i] = upperBound[i];
+      vertex[i] = upperBound[i];
       }
     }
 
-  if ( m_DistanceMetric->Evaluate(pointA, m_TempVertex) >=
-       m_DistanceMetric->Evaluate(pointB, m_TempVertex) )
+  if ( m_DistanceMetric->Evaluate(pointA, vertex) >=
+       m_DistanceMetric->Evaluate(pointB, vertex) )
     {
     return true;
     }
@@ -156,6 +171,58 @@ KdTreeBasedKmeansEstimator< TKdTree >
          std::vector< int > validIndexes,
          MeasurementVectorType & lowerBound,
          MeasurementVectorType & upperBound)
+{
+  this->FilterNode(node, validIndexes, lowerBound, upperBound,
+                   m_CandidateVector, m_TempVertex);
+}
+
+template< typename TKdTree >
+int
+KdTreeBasedKmeansEstimator< TKdTree >
+::PruneCandidates(KdTreeNodeType *node,
+                  std::vector< int > & validIndexes,
+                  MeasurementVectorType & lowerBound,
+                  MeasurementVectorType & upperBound,
+                  ParameterType & vertex)
+{
+  CentroidType  centroid;
+  ParameterType closestPosition;
+  node->GetCentroid(centroid);
+
+  int closest =
+    this->GetClosestCandidate(centroid, validIndexes);
+  closestPosition = m_CandidateVector[closest].Centroid;
+  std::vector< int >::iterator iter = validIndexes.begin();
+
+  while ( iter != validIndexes.end() )
+    {
+    if ( *iter != closest
+         && this->IsFarther(m_CandidateVector[*iter].Centroid,
+                            closestPosition,
+                            lowerBound, upperBound, vertex) )
+      {
+      iter = validIndexes.erase(iter);
+      continue;
+      }
+
+    if ( iter != validIndexes.end() )
+      {
+      ++iter;
+      }
+    }
+
+  return closest;
+}
+
+template< typename TKdTree >
+void
+KdTreeBasedKmeansEstimator< TKdTree >
+::FilterNode(KdTreeNodeType *node,
+             std::vector< int > validIndexes,
+             MeasurementVectorType & lowerBound,
+             MeasurementVectorType & upperBound,
+             CandidateVector & candidates,
+             ParameterType & vertex)
 {
   unsigned int i, j;
 
@@ -183,10 +250,10 @@ KdTreeBasedKmeansEstimator< TKdTree >
         this->GetClosestCandidate(individualPoint, validIndexes);
       for ( j = 0; j < m_MeasurementVectorSize; j++ )
         {
-        m_CandidateVector[closest].WeightedCentroid[j] +=
+        candidates[closest].WeightedCentroid[j] +=
           individualPoint[j];
         }
-      m_CandidateVector[closest].Size += 1;
+      candidates[closest].Size += 1;
       if ( m_GenerateClusterLabels )
         {
         m_ClusterLabels[tempId] = closest;
@@ -195,42 +262,20 @@ KdTreeBasedKmeansEstimator< TKdTree >
     }
   else
     {
-    CentroidType  centroid;
-    CentroidType  weightedCentroid;
-    ParameterType closestPosition;
-    node->GetWeightedCentroid(weightedCentroid);
-    node->GetCentroid(centroid);
-
-    closest =
-      this->GetClosestCandidate(centroid, validIndexes);
-    closestPosition = m_CandidateVector[closest].Centroid;
-    std::vector< int >::iterator iter = validIndexes.begin();
-
-    while ( iter != validIndexes.end() )
-      {
-      if ( *iter != closest
-           && this->IsFarther(m_CandidateVector[*iter].Centroid,
-                              closestPosition,
-                              lowerBound, upperBound) )
-        {
-        iter = validIndexes.erase(iter);
-        continue;
-        }
-
-      if ( iter != validIndexes.end() )
-        {
-        ++iter;
-        }
-      }
+    closest = this->PruneCandidates(node, validIndexes,
+                                    lowerBound, upperBound, vertex);
 
     if ( validIndexes.size() == 1 )
       {
+      CentroidType weightedCentroid;
+      node->GetWeightedCentroid(weightedCentroid);
+
       for ( j = 0; j < m_MeasurementVectorSize; j++ )
         {
-        m_CandidateVector[closest].WeightedCentroid[j] +=
+        candidates[closest].WeightedCentroid[j] +=
           weightedCentroid[j];
         }
-      m_CandidateVector[closest].Size += node->Size();
+      candidates[closest].Size += node->Size();
       if ( m_GenerateClusterLabels )
         {
         this->FillClusterLabels(node, closest);
@@ -245,19 +290,150 @@ KdTreeBasedKmeansEstimator< TKdTree >
 
       tempValue = upperBound[partitionDimension];
       upperBound[partitionDimension] = partitionValue;
-      this->Filter(node->Left(), validIndexes,
-                   lowerBound, upperBound);
+      this->FilterNode(node->Left(), validIndexes,
+                       lowerBound, upperBound, candidates, vertex);
       upperBound[partitionDimension] = tempValue;
 
       tempValue = lowerBound[partitionDimension];
       lowerBound[partitionDimension] = partitionValue;
-      this->Filter(node->Right(), validIndexes,
-                   lowerBound, upperBound);
+      this->FilterNode(node->Right(), validIndexes,
+                       lowerBound, upperBound, candidates, vertex);
       lowerBound[partitionDimension] = tempValue;
       }
     }
 }
 
+template< typename TKdTree >
+void
+KdTreeBasedKmeansEstimator< TKdTree >
+::CollectFilterTasks(KdTreeNodeType *node,
+                     std::vector< int > validIndexes,
+                     MeasurementVectorType & lowerBound,
+                     MeasurementVectorType & upperBound,
+                     unsigned int depth,
+                     std::vector< FilterTaskType > & tasks)
+{
+  if ( depth > 0 && !node->IsTerminal() )
+    {
+    this->PruneCandidates(node, validIndexes, lowerBound, upperBound, m_TempVertex);
+
+    if ( validIndexes.size() > 1 )
+      {
+      unsigned int    partitionDimension;
+      MeasurementType partitionValue;
+      MeasurementType tempValue;
+      node->GetParameters(partitionDimension, partitionValue);
+
+      tempValue = upperBound[partitionDimension];
+      upperBound[partitionDimension] = partitionValue;
+      this->CollectFilterTasks(node->Left(), validIndexes,
+                               lowerBound, upperBound, depth - 1, tasks);
+      upperBound[partitionDimension] = tempValue;
+
+      tempValue = lowerBound[partitionDimension];
+      lowerBound[partitionDimension] = partitionValue;
+      this->CollectFilterTasks(node->Right(), validIndexes,
+                               lowerBound, upperBound, depth - 1, tasks);
+      lowerBound[partitionDimension] = tempValue;
+      return;
+      }
+    }
+
+  // Pruning is repeated by FilterNode on the same node, which leaves the
+  // candidates already pruned here unchanged.
+  FilterTaskType task;
+  task.Node = node;
+  task.ValidIndexes = validIndexes;
+  task.LowerBound = lowerBound;
+  task.UpperBound = upperBound;
+  tasks.push_back(task);
+}
+
+template< typename TKdTree >
+ITK_THREAD_RETURN_TYPE
+KdTreeBasedKmeansEstimator< TKdTree >
+::FilterThreaderCallback(void *arg)
+{
+  typedef MultiThreader::ThreadInfoStruct ThreadInfoType;
+  ThreadInfoType *info = static_cast< ThreadInfoType * >( arg );
+  ThreadStruct *  str = static_cast< ThreadStruct * >( info->UserData );
+
+  Self *estimator = str->Estimator;
+
+  ParameterType vertex;
+  NumericTraits<ParameterType>::SetLength(vertex, estimator->m_MeasurementVectorSize);
+  vertex.Fill(0.0);
+
+  for ( size_t t = info->ThreadID; t < str->Tasks->size(); t += str->NumberOfThreads )
+    {
+    FilterTaskType & task = ( *str->Tasks )[t];
+    estimator->FilterNode(task.Node, task.ValidIndexes,
+                          task.LowerBound, task.UpperBound,
+                          ( *str->Sums )[t], vertex);
+    }
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+template< typename TKdTree >
+void
+KdTreeBasedKmeansEstimator< TKdTree >
+::FilterTree(std::vector< int > & validIndexes,
+             MeasurementVectorType & lowerBound,
+             MeasurementVectorType & upperBound)
+{
+  if ( m_NumberOfThreads <= 1 || m_GenerateClusterLabels )
+    {
+    this->Filter(m_KdTree->GetRoot(), validIndexes,
+                 lowerBound, upperBound);
+    return;
+    }
+
+  // Stop the serial pruning deep enough to have several subtrees per
+  // thread.
+  unsigned int depth = 0;
+  while ( ( 1u << depth ) < 8 * m_NumberOfThreads && depth < 16 )
+    {
+    ++depth;
+    }
+
+  std::vector< FilterTaskType > tasks;
+  this->CollectFilterTasks(m_KdTree->GetRoot(), validIndexes,
+                           lowerBound, upperBound, depth, tasks);
+
+  // Every subtree gathers its own sums, starting from the current
+  // centroids.
+  InternalParametersType centroids;
+  m_CandidateVector.GetCentroids(centroids);
+  CandidateVector zeroSums;
+  zeroSums.SetCentroids(centroids);
+  std::vector< CandidateVector > sums(tasks.size(), zeroSums);
+
+  ThreadStruct str;
+  str.Estimator = this;
+  str.Tasks = &tasks;
+  str.Sums = &sums;
+  str.NumberOfThreads = std::min( m_NumberOfThreads, static_cast< ThreadIdType >( tasks.size() ) );
+
+  m_MultiThreader->SetNumberOfThreads(str.NumberOfThreads);
+  m_MultiThreader->SetSingleMethod(Self::FilterThreaderCallback, &str);
+  m_MultiThreader->SingleMethodExecute();
+
+  // add the sums in tree order
+  const int numberOfCandidates = m_CandidateVector.Size();
+  for ( size_t t = 0; t < sums.size(); ++t )
+    {
+    for ( int c = 0; c < numberOfCandidates; ++c )
+      {
+      for ( unsigned int j = 0; j < m_MeasurementVectorSize; ++j )
+        {
+        m_CandidateVector[c].WeightedCentroid[j] += sums[t][c].WeightedCentroid[j];
+        }
+      m_CandidateVector[c].Size += sums[t][c].Size;
+      }
+    }
+}
+
 template< typename TKdTree >
 void
 KdTreeBasedKmeansEstimator< TKdTree >
@@ -386,8 +562,7 @@ KdTreeBasedKmeansEstimator< TKdTree >
     {
     this->CopyParameters(currentPosition, previousPosition);
     m_CandidateVector.SetCentroids(currentPosition);
-    this->Filter(m_KdTree->GetRoot(), validIndexes,
-                 lowerBound, upperBound);
+    this->FilterTree(validIndexes, lowerBound, upperBound);
     m_CandidateVector.UpdateCentroids();
     m_CandidateVector.GetCentroids(currentPosition);
 
@@ -22,6 +22,8 @@
 #include "itkHistogram.h"
 #include "itkVectorContainer.h"
 #include "itkNumericTraits.h"
+#include "itkMultiThreader.h"
+#include <vector>
 
 namespace itk
 {
@@ -73,6 +75,11 @@ namespace Statistics
  * texture or in cases where the user wants more histogram bins, a sparse container
  * can be used for the histogram instead.
  *
+ * With the dense container, the co-occurrence pairs are counted in parallel,
+ * using the number of threads of the filter (see
+ * ProcessObject::SetNumberOfThreads()), unless the histogram has more bins
+ * than there are pixels per thread.
+ *
  * WARNING: This probably won't work for pixels of double or long-double type
  * unless you set the histogram min and max manually. This is because the largest
  * histogram bin by default has max value of the largest possible pixel value
@@ -197,6 +204,33 @@ private:
 
   void NormalizeHistogram();
 
+  typedef typename HistogramType::AbsoluteFrequencyType AbsoluteFrequencyType;
+  typedef std::vector< AbsoluteFrequencyType >          FrequencyVectorType;
+
+  /** The region is split in pieces that are counted in separate threads
+   * into private dense arrays indexed by the histogram instance
+   * identifier. The arrays are then added to the output in piece order.
+   * Sparse or large histograms are filled in one piece, directly. */
+  struct ThreadStruct
+    {
+    Self *                              Filter;
+    RadiusType                          Radius;
+    RegionType                          Region;
+    const ImageType *                   MaskImage;
+    ThreadIdType                        NumberOfPieces;
+    std::vector< FrequencyVectorType > *Frequencies;
+    };
+
+  static ITK_THREAD_RETURN_TYPE FillHistogramThreaderCallback(void *arg);
+
+  void FillHistogramInPieces(const RadiusType & radius, const RegionType & region,
+                             const ImageType *maskImage);
+
+  /** Count the pairs of the region into frequencies, or into the output
+   * when frequencies is ITK_NULLPTR. */
+  void ThreadedFillHistogram(const RadiusType & radius, const RegionType & region,
+                             const ImageType *maskImage, FrequencyVectorType *frequencies);
+
   OffsetVectorConstPointer m_Offsets;
   PixelType                m_Min;
   PixelType                m_Max;
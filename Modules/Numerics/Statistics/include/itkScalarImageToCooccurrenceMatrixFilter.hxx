@@ -21,7 +21,10 @@
 #include "itkScalarImageToCooccurrenceMatrixFilter.h"
 
 #include "itkConstNeighborhoodIterator.h"
+#include "itkImageRegionSplitterSlowDimension.h"
+#include "itkIsSame.h"
 #include "vnl/vnl_math.h"
+#include <algorithm>
 
 namespace itk
 {
@@ -205,111 +208,140 @@ ScalarImageToCooccurrenceMatrixFilter< TImageType,
                                        THistogramFrequencyContainer >::FillHistogram(RadiusType radius,
                                                                                      RegionType region)
 {
-  // Iterate over all of those pixels and offsets, adding each
-  // co-occurrence pair to the histogram
+  this->FillHistogramInPieces(radius, region, ITK_NULLPTR);
+}
 
-  const ImageType *input = this->GetInput();
+template< typename TImageType, typename THistogramFrequencyContainer >
+void
+ScalarImageToCooccurrenceMatrixFilter< TImageType,
+                                       THistogramFrequencyContainer >::FillHistogramWithMask(RadiusType radius,
+                                                                                             RegionType region,
+                                                                                             const ImageType *maskImage)
+{
+  this->FillHistogramInPieces(radius, region, maskImage);
+}
 
+template< typename TImageType, typename THistogramFrequencyContainer >
+void
+ScalarImageToCooccurrenceMatrixFilter< TImageType,
+                                       THistogramFrequencyContainer >::FillHistogramInPieces(const RadiusType & radius,
+                                                                                             const RegionType & region,
+                                                                                             const ImageType *maskImage)
+{
   HistogramType *output =
     static_cast< HistogramType * >( this->ProcessObject::GetOutput(0) );
 
-  typedef ConstNeighborhoodIterator< ImageType > NeighborhoodIteratorType;
-  NeighborhoodIteratorType neighborIt;
-  neighborIt = NeighborhoodIteratorType(radius, input, region);
+  ImageRegionSplitterSlowDimension::Pointer splitter =
+    ImageRegionSplitterSlowDimension::New();
+  const ThreadIdType numberOfPieces = std::max(
+    static_cast< ThreadIdType >( splitter->GetNumberOfSplits( region, std::max( this->GetNumberOfThreads(), ThreadIdType(1) ) ) ),
+    ThreadIdType(1) );
+
+  // Private dense arrays only pay off when the histogram is dense and has
+  // fewer bins than there are pixels in a piece; otherwise count directly
+  // into the output in one piece.
+  if ( numberOfPieces == 1
+       || !IsSame< THistogramFrequencyContainer, DenseFrequencyContainer2 >::Value
+       || output->Size() > region.GetNumberOfPixels() / numberOfPieces )
+    {
+    this->ThreadedFillHistogram(radius, region, maskImage, ITK_NULLPTR);
+    return;
+    }
 
-  MeasurementVectorType cooccur( output->GetMeasurementVectorSize() );
+  std::vector< FrequencyVectorType > frequencies( numberOfPieces,
+    FrequencyVectorType( output->Size(), NumericTraits< AbsoluteFrequencyType >::ZeroValue() ) );
 
-  for ( neighborIt.GoToBegin(); !neighborIt.IsAtEnd(); ++neighborIt )
-    {
-    const PixelType centerPixelIntensity = neighborIt.GetCenterPixel();
-    if ( centerPixelIntensity < m_Min
-         || centerPixelIntensity > m_Max )
-      {
-      continue; // don't put a pixel in the histogram if the value
-                // is out-of-bounds.
-      }
+  ThreadStruct str;
+  str.Filter = this;
+  str.Radius = radius;
+  str.Region = region;
+  str.MaskImage = maskImage;
+  str.NumberOfPieces = numberOfPieces;
+  str.Frequencies = &frequencies;
 
-    typename OffsetVector::ConstIterator offsets;
-    typename HistogramType::IndexType index;
-    for ( offsets = m_Offsets->Begin(); offsets != m_Offsets->End(); offsets++ )
-      {
-      bool            pixelInBounds;
-      const PixelType pixelIntensity =
-        neighborIt.GetPixel(offsets.Value(), pixelInBounds);
+  this->GetMultiThreader()->SetNumberOfThreads(numberOfPieces);
+  this->GetMultiThreader()->SetSingleMethod(Self::FillHistogramThreaderCallback, &str);
+  this->GetMultiThreader()->SingleMethodExecute();
 
-      if ( !pixelInBounds )
+  // add the counts of the pieces in piece order
+  for ( ThreadIdType piece = 0; piece < numberOfPieces; ++piece )
+    {
+    const FrequencyVectorType & pieceFrequencies = frequencies[piece];
+    for ( typename HistogramType::InstanceIdentifier id = 0; id < pieceFrequencies.size(); ++id )
+      {
+      if ( pieceFrequencies[id] != NumericTraits< AbsoluteFrequencyType >::ZeroValue() )
         {
-        continue; // don't put a pixel in the histogram if it's out-of-bounds.
+        output->IncreaseFrequency(id, pieceFrequencies[id]);
         }
+      }
+    }
+}
 
-      if ( pixelIntensity < m_Min
-           || pixelIntensity > m_Max )
-        {
-        continue; // don't put a pixel in the histogram if the value
-                  // is out-of-bounds.
-        }
+template< typename TImageType, typename THistogramFrequencyContainer >
+ITK_THREAD_RETURN_TYPE
+ScalarImageToCooccurrenceMatrixFilter< TImageType,
+                                       THistogramFrequencyContainer >::FillHistogramThreaderCallback(void *arg)
+{
+  typedef MultiThreader::ThreadInfoStruct ThreadInfoType;
+  ThreadInfoType *info = static_cast< ThreadInfoType * >( arg );
+  ThreadStruct *  str = static_cast< ThreadStruct * >( info->UserData );
 
-      // Now make both possible co-occurrence combinations and increment the
-      // histogram with them.
+  if ( info->ThreadID >= str->NumberOfPieces )
+    {
+    return ITK_THREAD_RETURN_VALUE;
+    }
 
-      cooccur[0] = centerPixelIntensity;
-      cooccur[1] = pixelIntensity;
-      output->GetIndex( cooccur, index );
-      output->IncreaseFrequencyOfIndex( index, 1 );
+  RegionType region = str->Region;
+  ImageRegionSplitterSlowDimension::Pointer splitter =
+    ImageRegionSplitterSlowDimension::New();
+  splitter->GetSplit(info->ThreadID, str->NumberOfPieces, region);
 
-      cooccur[1] = centerPixelIntensity;
-      cooccur[0] = pixelIntensity;
-      output->GetIndex( cooccur, index );
-      output->IncreaseFrequencyOfIndex( index, 1 );
-      }
-    }
+  str->Filter->ThreadedFillHistogram( str->Radius, region, str->MaskImage,
+                                      &( *str->Frequencies )[info->ThreadID] );
+
+  return ITK_THREAD_RETURN_VALUE;
 }
 
 template< typename TImageType, typename THistogramFrequencyContainer >
 void
 ScalarImageToCooccurrenceMatrixFilter< TImageType,
-                                       THistogramFrequencyContainer >::FillHistogramWithMask(RadiusType radius,
-                                                                                             RegionType region,
-                                                                                             const ImageType *maskImage)
+                                       THistogramFrequencyContainer >::ThreadedFillHistogram(const RadiusType & radius,
+                                                                                             const RegionType & region,
+                                                                                             const ImageType *maskImage,
+                                                                                             FrequencyVectorType *frequencies)
 {
   // Iterate over all of those pixels and offsets, adding each
   // co-occurrence pair to the histogram
 
-  const ImageType *input = this->GetInput();
-
   HistogramType *output =
     static_cast< HistogramType * >( this->ProcessObject::GetOutput(0) );
+  const ImageType *    input = this->GetInput();
 
-  // Iterate over all of those pixels and offsets, adding each
-  // co-occurrence pair to the histogram
   typedef ConstNeighborhoodIterator< ImageType > NeighborhoodIteratorType;
-  NeighborhoodIteratorType neighborIt, maskNeighborIt;
-  neighborIt = NeighborhoodIteratorType(radius, input, region);
-  maskNeighborIt = NeighborhoodIteratorType(radius, maskImage, region);
+  NeighborhoodIteratorType neighborIt(radius, input, region);
+  NeighborhoodIteratorType maskNeighborIt;
+  if ( maskImage != ITK_NULLPTR )
+    {
+    maskNeighborIt = NeighborhoodIteratorType(radius, maskImage, region);
+    maskNeighborIt.GoToBegin();
+    }
 
   MeasurementVectorType cooccur( output->GetMeasurementVectorSize() );
-  typename HistogramType::IndexType index;
-  for ( neighborIt.GoToBegin(), maskNeighborIt.GoToBegin();
-        !neighborIt.IsAtEnd(); ++neighborIt, ++maskNeighborIt )
+  typename HistogramType::IndexType index( output->GetMeasurementVectorSize() );
+  for ( neighborIt.GoToBegin(); !neighborIt.IsAtEnd(); ++neighborIt )
     {
-    if ( maskNeighborIt.GetCenterPixel() != m_InsidePixelValue )
-      {
-      continue; // Go to the next loop if we're not in the mask
-      }
-
+    // don't put a pixel in the histogram if it's outside of the mask or
+    // if the value is out-of-bounds.
     const PixelType centerPixelIntensity = neighborIt.GetCenterPixel();
-
-    if ( centerPixelIntensity < this->GetMin()
-         || centerPixelIntensity > this->GetMax() )
-      {
-      continue; // don't put a pixel in the histogram if the value
-                // is out-of-bounds.
-      }
+    const bool      countCenter =
+      ( maskImage == ITK_NULLPTR || maskNeighborIt.GetCenterPixel() == m_InsidePixelValue )
+      && !( centerPixelIntensity < m_Min || centerPixelIntensity > m_Max );
 
     typename OffsetVector::ConstIterator offsets;
-    for ( offsets = this->GetOffsets()->Begin(); offsets != this->GetOffsets()->End(); offsets++ )
+    for ( offsets = m_Offsets->Begin(); countCenter && offsets != m_Offsets->End(); offsets++ )
       {
-      if ( maskNeighborIt.GetPixel( offsets.Value() ) != m_InsidePixelValue )
+      if ( maskImage != ITK_NULLPTR
+           && maskNeighborIt.GetPixel( offsets.Value() ) != m_InsidePixelValue )
         {
         continue; // Go to the next loop if we're not in the mask
         }
@@ -323,8 +355,8 @@ ScalarImageToCooccurrenceMatrixFilter< TImageType,
         continue; // don't put a pixel in the histogram if it's out-of-bounds.
         }
 
-      if ( pixelIntensity < this->GetMin()
-           || pixelIntensity > this->GetMax() )
+      if ( pixelIntensity < m_Min
+           || pixelIntensity > m_Max )
         {
         continue; // don't put a pixel in the histogram if the value
                   // is out-of-bounds.
@@ -335,14 +367,36 @@ ScalarImageToCooccurrenceMatrixFilter< TImageType,
 
       cooccur[0] = centerPixelIntensity;
       cooccur[1] = pixelIntensity;
-      output->GetIndex( cooccur, index );
-      output->IncreaseFrequencyOfIndex(index, 1);
-
+      if ( output->GetIndex( cooccur, index ) )
+        {
+        if ( frequencies != ITK_NULLPTR )
+          {
+          ++( *frequencies )[output->GetInstanceIdentifier( index )];
+          }
+        else
+          {
+          output->IncreaseFrequencyOfIndex( index, 1 );
+          }
+        }
 
       cooccur[1] = centerPixelIntensity;
       cooccur[0] = pixelIntensity;
-      output->GetIndex( cooccur, index );
-      output->IncreaseFrequencyOfIndex(index, 1);
+      if ( output->GetIndex( cooccur, index ) )
+        {
+        if ( frequencies != ITK_NULLPTR )
+          {
+          ++( *frequencies )[output->GetInstanceIdentifier( index )];
+          }
+        else
+          {
+          output->IncreaseFrequencyOfIndex( index, 1 );
+          }
+        }
+      }
+
+    if ( maskImage != ITK_NULLPTR )
+      {
+      ++maskNeighborIt;
       }
     }
 }
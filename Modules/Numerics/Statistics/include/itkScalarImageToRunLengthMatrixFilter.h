@@ -22,6 +22,8 @@
 #include "itkHistogram.h"
 #include "itkNumericTraits.h"
 #include "itkVectorContainer.h"
+#include "itkMultiThreader.h"
+#include <vector>
 
 namespace itk
 {
@@ -84,6 +86,11 @@ namespace Statistics
  * with little texture or in cases where the user wants more histogram bins,
  * a sparse container can be used for the histogram instead.
  *
+ * With the dense container, the runs of the different offsets are counted
+ * in parallel, using the number of threads of the filter (see
+ * ProcessObject::SetNumberOfThreads()), unless the histogram has more bins
+ * than the image has pixels.
+ *
  * WARNING: This probably won't work for pixels of double or long-double type
  * unless you set the histogram min and max manually. This is because the largest
  * histogram bin by default has max value of the largest possible pixel value
@@ -256,6 +263,28 @@ protected:
 
 private:
 
+  typedef typename HistogramType::AbsoluteFrequencyType AbsoluteFrequencyType;
+  typedef std::vector< AbsoluteFrequencyType >          FrequencyVectorType;
+
+  /** The offsets are distributed over the threads, each counting the runs
+   * of its offsets into a private dense array indexed by the histogram
+   * instance identifier. Sparse or large histograms are filled by a
+   * single thread, directly. */
+  struct ThreadStruct
+    {
+    Self *                              Filter;
+    const std::vector< OffsetType > *   Offsets;
+    ThreadIdType                        NumberOfThreads;
+    std::vector< FrequencyVectorType > *Frequencies;
+    };
+
+  static ITK_THREAD_RETURN_TYPE RunLengthThreaderCallback( void *arg );
+
+  /** Count the runs of offsets [first, last) into frequencies, or into the
+   * output when frequencies is ITK_NULLPTR. */
+  void ThreadedComputeRunLengths( const std::vector< OffsetType > & offsets,
+    SizeValueType first, SizeValueType last, FrequencyVectorType *frequencies );
+
   unsigned int             m_NumberOfBinsPerAxis;
   PixelType                m_Min;
   PixelType                m_Max;
@@ -20,10 +20,12 @@
 
 #include "itkScalarImageToRunLengthMatrixFilter.h"
 
-#include "itkConstNeighborhoodIterator.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
 #include "itkNeighborhood.h"
 #include "vnl/vnl_math.h"
 #include "itkMacro.h"
+#include "itkIsSame.h"
+#include <algorithm>
 
 namespace itk
 {
@@ -152,141 +154,221 @@ ScalarImageToRunLengthMatrixFilter<TImageType, THistogramFrequencyContainer>
   this->m_UpperBound[1] = this->m_MaxDistance;
   output->Initialize( size, this->m_LowerBound, this->m_UpperBound );
 
-  MeasurementVectorType run( output->GetMeasurementVectorSize() );
-  typename HistogramType::IndexType hIndex;
+  // The offsets are independent of each other: they are distributed over
+  // the threads, that count the runs in private dense arrays indexed by the
+  // histogram instance identifier. The arrays only pay off when the
+  // histogram is dense and has fewer bins than the image has pixels;
+  // otherwise the runs are counted directly into the output.
+  std::vector< OffsetType > offsets;
+  typename OffsetVector::ConstIterator offsetIt;
+  for( offsetIt = this->GetOffsets()->Begin();
+    offsetIt != this->GetOffsets()->End(); offsetIt++ )
+    {
+    OffsetType offset = offsetIt.Value();
+    this->NormalizeOffsetDirection(offset);
+    offsets.push_back( offset );
+    }
 
-  // Iterate over all of those pixels and offsets, adding each
-  // distance/intensity pair to the histogram
+  const ThreadIdType numberOfThreads = std::max( std::min(
+    this->GetNumberOfThreads(), static_cast< ThreadIdType >( offsets.size() ) ), ThreadIdType(1) );
 
-  typedef ConstNeighborhoodIterator<ImageType> NeighborhoodIteratorType;
-  typename NeighborhoodIteratorType::RadiusType radius;
-  radius.Fill( 1 );
-  NeighborhoodIteratorType neighborIt( radius,
-    inputImage, inputImage->GetRequestedRegion() );
-
-
-  // this temp image has the same dimension for each offset
-  // moving the allocation out of loop of offsets
-  // while keeping FillBuffer with boolean false in each loop
-  typedef Image<bool, ImageDimension> BoolImageType;
-  typename BoolImageType::Pointer alreadyVisitedImage = BoolImageType::New();
-  alreadyVisitedImage->CopyInformation( inputImage );
-  alreadyVisitedImage->SetRegions( inputImage->GetRequestedRegion() );
-  alreadyVisitedImage->Allocate();
-
-  typename OffsetVector::ConstIterator offsets;
-  for( offsets = this->GetOffsets()->Begin();
-    offsets != this->GetOffsets()->End(); offsets++ )
+  if( numberOfThreads == 1
+    || !IsSame< THistogramFrequencyContainer, DenseFrequencyContainer2 >::Value
+    || output->Size() > inputImage->GetRequestedRegion().GetNumberOfPixels() )
     {
+    this->ThreadedComputeRunLengths( offsets, 0, offsets.size(), ITK_NULLPTR );
+    return;
+    }
 
-    alreadyVisitedImage->FillBuffer( false );
-
-    neighborIt.GoToBegin();
-    OffsetType offset = offsets.Value();
+  std::vector< FrequencyVectorType > frequencies( numberOfThreads,
+    FrequencyVectorType( output->Size(), NumericTraits< AbsoluteFrequencyType >::ZeroValue() ) );
 
-    this->NormalizeOffsetDirection(offset);
+  ThreadStruct str;
+  str.Filter = this;
+  str.Offsets = &offsets;
+  str.NumberOfThreads = numberOfThreads;
+  str.Frequencies = &frequencies;
 
+  this->GetMultiThreader()->SetNumberOfThreads( numberOfThreads );
+  this->GetMultiThreader()->SetSingleMethod( Self::RunLengthThreaderCallback, &str );
+  this->GetMultiThreader()->SingleMethodExecute();
 
-    for( neighborIt.GoToBegin(); !neighborIt.IsAtEnd(); ++neighborIt )
+  // add the counts of the threads in thread order
+  for( ThreadIdType t = 0; t < numberOfThreads; ++t )
+    {
+    const FrequencyVectorType & threadFrequencies = frequencies[t];
+    for( typename HistogramType::InstanceIdentifier id = 0; id < threadFrequencies.size(); ++id )
       {
-      const PixelType centerPixelIntensity = neighborIt.GetCenterPixel();
-      IndexType centerIndex = neighborIt.GetIndex();
-      if( centerPixelIntensity < this->m_Min ||
-        centerPixelIntensity > this->m_Max ||
-        alreadyVisitedImage->GetPixel( centerIndex ) || ( this->GetMaskImage() &&
-        this->GetMaskImage()->GetPixel( centerIndex ) !=
-        this->m_InsidePixelValue ) )
+      if( threadFrequencies[id] != NumericTraits< AbsoluteFrequencyType >::ZeroValue() )
         {
-        continue; // don't put a pixel in the histogram if the value
-                  // is out-of-bounds or is outside the mask.
+        output->IncreaseFrequency( id, threadFrequencies[id] );
         }
+      }
+    }
+}
+
+template<typename TImageType, typename THistogramFrequencyContainer>
+ITK_THREAD_RETURN_TYPE
+ScalarImageToRunLengthMatrixFilter<TImageType, THistogramFrequencyContainer>
+::RunLengthThreaderCallback( void *arg )
+{
+  typedef MultiThreader::ThreadInfoStruct ThreadInfoType;
+  ThreadInfoType *info = static_cast< ThreadInfoType * >( arg );
+  ThreadStruct *  str = static_cast< ThreadStruct * >( info->UserData );
+
+  const ThreadIdType threadId = info->ThreadID;
+  if( threadId >= str->NumberOfThreads )
+    {
+    return ITK_THREAD_RETURN_VALUE;
+    }
+
+  const SizeValueType numberOfOffsets = str->Offsets->size();
+  const SizeValueType first = numberOfOffsets / str->NumberOfThreads * threadId
+    + std::min( static_cast< SizeValueType >( threadId ), numberOfOffsets % str->NumberOfThreads );
+  const SizeValueType last = first + numberOfOffsets / str->NumberOfThreads
+    + ( threadId < numberOfOffsets % str->NumberOfThreads ? 1 : 0 );
+
+  str->Filter->ThreadedComputeRunLengths( *str->Offsets, first, last,
+    &( *str->Frequencies )[threadId] );
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+template<typename TImageType, typename THistogramFrequencyContainer>
+void
+ScalarImageToRunLengthMatrixFilter<TImageType, THistogramFrequencyContainer>
+::ThreadedComputeRunLengths( const std::vector< OffsetType > & offsets,
+  SizeValueType first, SizeValueType last, FrequencyVectorType *frequencies )
+{
+  HistogramType *output =
+    static_cast<HistogramType *>( this->ProcessObject::GetOutput( 0 ) );
+  const ImageType * inputImage = this->GetInput();
+  const RegionType & region = inputImage->GetRequestedRegion();
 
-      itkDebugMacro("===> offset = " << offset << std::endl);
+  const ImageType * maskImage = this->GetMaskImage();
 
-      MeasurementType centerBinMin = this->GetOutput()->
-        GetBinMinFromValue( 0, centerPixelIntensity );
-      MeasurementType centerBinMax = this->GetOutput()->
-        GetBinMaxFromValue( 0, centerPixelIntensity );
-      MeasurementType lastBinMax = this->GetOutput()->
-              GetDimensionMaxs( 0 )[ this->GetOutput()->GetSize( 0 ) - 1 ];
+  MeasurementVectorType run( output->GetMeasurementVectorSize() );
+  typename HistogramType::IndexType hIndex( output->GetMeasurementVectorSize() );
 
-      PixelType pixelIntensity( NumericTraits<PixelType>::ZeroValue() );
-      IndexType index;
+  // Iterate over all of those pixels and offsets, adding each
+  // distance/intensity pair to the histogram
 
-      index = centerIndex + offset;
-      IndexType lastGoodIndex = centerIndex;
-      bool runLengthSegmentAlreadyVisited = false;
+  const MeasurementType lastBinMax =
+    output->GetDimensionMaxs( 0 )[ output->GetSize( 0 ) - 1 ];
 
-      // Scan from the current pixel at index, following
-      // the direction of offset. Run length is computed as the
-      // length of continuous pixels whose pixel values are
-      // in the same bin.
+  for( SizeValueType o = first; o < last; ++o )
+    {
+    const OffsetType & offset = offsets[o];
+
+    // The pixels are visited along the lines following the direction of
+    // offset, starting from the pixels with no predecessor in the region.
+    // A run starts at the first pixel following the previous run, so each
+    // run length segment is counted once without marking the pixels
+    // already visited.
+    ImageRegionConstIteratorWithIndex<ImageType> lineIt( inputImage, region );
+    for( lineIt.GoToBegin(); !lineIt.IsAtEnd(); ++lineIt )
+      {
+      IndexType centerIndex = lineIt.GetIndex();
+      if( region.IsInside( centerIndex - offset ) )
+        {
+        continue;
+        }
 
-      while ( inputImage->GetRequestedRegion().IsInside(index) )
+      while( region.IsInside( centerIndex ) )
         {
-        // For the same offset, each run length segment can
-        // only be visited once
-        if (alreadyVisitedImage->GetPixel( index ) )
+        const PixelType centerPixelIntensity = inputImage->GetPixel( centerIndex );
+        if( centerPixelIntensity < this->m_Min ||
+          centerPixelIntensity > this->m_Max || ( maskImage &&
+          maskImage->GetPixel( centerIndex ) !=
+          this->m_InsidePixelValue ) )
           {
-          runLengthSegmentAlreadyVisited = true;
-          break;
+          centerIndex += offset;
+          continue; // don't put a pixel in the histogram if the value
+                    // is out-of-bounds or is outside the mask.
           }
 
-        pixelIntensity = inputImage->GetPixel( index );
+        itkDebugMacro("===> offset = " << offset << std::endl);
 
-        // Special attention paid to boundaries of bins.
-        // For the last bin,
-        // it is left close and right close (following the previous
-        // gerrit patch).
-        // For all
-        // other bins,
-        // the bin is left close and right open.
+        MeasurementType centerBinMin = output->
+          GetBinMinFromValue( 0, centerPixelIntensity );
+        MeasurementType centerBinMax = output->
+          GetBinMaxFromValue( 0, centerPixelIntensity );
 
-        if ( pixelIntensity >= centerBinMin
-            && ( pixelIntensity < centerBinMax || ( pixelIntensity == centerBinMax && centerBinMax == lastBinMax ) ) )
-          {
-          alreadyVisitedImage->SetPixel( index, true );
-          lastGoodIndex = index;
-          index += offset;
-          }
-        else
+        PixelType pixelIntensity( NumericTraits<PixelType>::ZeroValue() );
+        IndexType index;
+
+        index = centerIndex + offset;
+        IndexType lastGoodIndex = centerIndex;
+
+        // Scan from the current pixel at index, following
+        // the direction of offset. Run length is computed as the
+        // length of continuous pixels whose pixel values are
+        // in the same bin.
+
+        while ( region.IsInside(index) )
           {
-          break;
+          pixelIntensity = inputImage->GetPixel( index );
+
+          // Special attention paid to boundaries of bins.
+          // For the last bin,
+          // it is left close and right close (following the previous
+          // gerrit patch).
+          // For all
+          // other bins,
+          // the bin is left close and right open.
+
+          if ( pixelIntensity >= centerBinMin
+              && ( pixelIntensity < centerBinMax || ( pixelIntensity == centerBinMax && centerBinMax == lastBinMax ) ) )
+            {
+            lastGoodIndex = index;
+            index += offset;
+            }
+          else
+            {
+            break;
+            }
           }
-        }
 
-      if ( runLengthSegmentAlreadyVisited )
-        {
-        continue;
-        }
+        PointType centerPoint;
+        inputImage->TransformIndexToPhysicalPoint(
+          centerIndex, centerPoint );
+        PointType point;
+        inputImage->TransformIndexToPhysicalPoint( lastGoodIndex, point );
 
-      PointType centerPoint;
-      inputImage->TransformIndexToPhysicalPoint(
-        centerIndex, centerPoint );
-      PointType point;
-      inputImage->TransformIndexToPhysicalPoint( lastGoodIndex, point );
+        run[0] = centerPixelIntensity;
+        run[1] = centerPoint.EuclideanDistanceTo( point );
 
-      run[0] = centerPixelIntensity;
-      run[1] = centerPoint.EuclideanDistanceTo( point );
+        if( run[1] >= this->m_MinDistance && run[1] <= this->m_MaxDistance )
+          {
+          if( output->GetIndex( run, hIndex ) )
+            {
+            if( frequencies != ITK_NULLPTR )
+              {
+              ++( *frequencies )[output->GetInstanceIdentifier( hIndex )];
+              }
+            else
+              {
+              output->IncreaseFrequencyOfIndex( hIndex, 1 );
+              }
+            }
+
+          itkDebugStatement(typename HistogramType::IndexType tempMeasurementIndex;)
+          itkDebugStatement(output->GetIndex(run,tempMeasurementIndex);)
+          itkDebugMacro( "centerIndex<->index: "
+              << static_cast<int>( centerPixelIntensity )
+              << "@"<< centerIndex
+                  << "<->" << static_cast<int>( pixelIntensity ) << "@" << index
+                  <<", Bin# " << tempMeasurementIndex
+                  << ", Measurement: (" << run[0] << ", " << run[1] << ")"
+                  << ", Center bin [" << this->GetOutput()->GetBinMinFromValue( 0, run[0] )
+                  << "," << this->GetOutput()->GetBinMaxFromValue( 0, run[0] ) << "]"
+                  << "~[" << this->GetOutput()->GetBinMinFromValue( 1, run[1] )
+                  << "," << this->GetOutput()->GetBinMaxFromValue( 1, run[1] ) << "]"
+                  << std::endl );
+          }
 
-      if( run[1] >= this->m_MinDistance && run[1] <= this->m_MaxDistance )
-        {
-        output->GetIndex( run, hIndex );
-        output->IncreaseFrequencyOfIndex( hIndex, 1 );
-
-        itkDebugStatement(typename HistogramType::IndexType tempMeasurementIndex;)
-        itkDebugStatement(output->GetIndex(run,tempMeasurementIndex);)
-        itkDebugMacro( "centerIndex<->index: "
-            << static_cast<int>( centerPixelIntensity )
-            << "@"<< centerIndex
-                << "<->" << static_cast<int>( pixelIntensity ) << "@" << index
-                <<", Bin# " << tempMeasurementIndex
-                << ", Measurement: (" << run[0] << ", " << run[1] << ")"
-                << ", Center bin [" << this->GetOutput()->GetBinMinFromValue( 0, run[0] )
-                << "," << this->GetOutput()->GetBinMaxFromValue( 0, run[0] ) << "]"
-                << "~[" << this->GetOutput()->GetBinMinFromValue( 1, run[1] )
-                << "," << this->GetOutput()->GetBinMaxFromValue( 1, run[1] ) << "]"
-                << std::endl );
+        // the next run starts at the first pixel out of the bin
+        centerIndex = index;
         }
       }
     }
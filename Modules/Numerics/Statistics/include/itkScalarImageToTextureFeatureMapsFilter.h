@@ -0,0 +1,235 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkScalarImageToTextureFeatureMapsFilter_h
+#define itkScalarImageToTextureFeatureMapsFilter_h
+
+#include "itkImageToImageFilter.h"
+#include "itkVectorImage.h"
+#include "itkVectorContainer.h"
+#include "itkNumericTraits.h"
+#include <vector>
+
+namespace itk
+{
+namespace Statistics
+{
+/** \class ScalarImageToTextureFeatureMapsFilter
+ *  \brief Computes per-pixel co-occurrence and run length texture features
+ *  in a sliding window.
+ *
+ * For every pixel of the output, a grey level co-occurrence matrix and a
+ * grey level run length matrix are computed from the pixels of the input
+ * that lie in a window of the given radius centered at the pixel. The
+ * texture features of both matrices are stored in the components of the
+ * output vector pixel, in the following order:
+ *
+ * - the eight co-occurrence features of HistogramToTextureFeaturesFilter
+ *   (Energy, Entropy, Correlation, InverseDifferenceMoment, Inertia,
+ *   ClusterShade, ClusterProminence, HaralickCorrelation), if
+ *   ComputeCooccurrenceFeatures is on;
+ * - the ten run length features of HistogramToRunLengthFeaturesFilter
+ *   (ShortRunEmphasis, LongRunEmphasis, GreyLevelNonuniformity,
+ *   RunLengthNonuniformity, LowGreyLevelRunEmphasis, HighGreyLevelRunEmphasis,
+ *   ShortRunLowGreyLevelEmphasis, ShortRunHighGreyLevelEmphasis,
+ *   LongRunLowGreyLevelEmphasis, LongRunHighGreyLevelEmphasis), if
+ *   ComputeRunLengthFeatures is on.
+ *
+ * As with the FastCalculations mode of ScalarImageToTextureFeaturesFilter,
+ * a single matrix accumulates the pairs (or runs) of all the offsets. The
+ * co-occurrence features are those of the normalized matrix. Run lengths
+ * are measured in pixels: the second index of the run length matrix is the
+ * number of pixels of the run minus one.
+ *
+ * The pixel values are quantized in NumberOfBinsPerAxis equal bins
+ * between the min and max pixel values set with SetPixelValueMinMax(),
+ * exactly as in ScalarImageToCooccurrenceMatrixFilter. Values outside of
+ * this range, and pixels outside of the optional mask, do not contribute
+ * to the matrices; the features of pixels outside of the mask are zero.
+ *
+ * The matrices are not recomputed for each pixel: along each line of the
+ * output, the matrices of the window are updated with the pairs and runs
+ * of the slice of pixels leaving the window and of the slice entering it.
+ * The output lines are distributed over the threads.
+ *
+ * \sa ScalarImageToTextureFeaturesFilter
+ * \sa ScalarImageToRunLengthFeaturesFilter
+ * \sa HistogramToTextureFeaturesFilter
+ * \sa HistogramToRunLengthFeaturesFilter
+ *
+ * \ingroup ITKStatistics
+ */
+template< typename TInputImage,
+          typename TOutputImage = VectorImage< float, TInputImage::ImageDimension > >
+class ScalarImageToTextureFeatureMapsFilter:
+  public ImageToImageFilter< TInputImage, TOutputImage >
+{
+public:
+  /** Standard typedefs */
+  typedef ScalarImageToTextureFeatureMapsFilter           Self;
+  typedef ImageToImageFilter< TInputImage, TOutputImage > Superclass;
+  typedef SmartPointer< Self >                            Pointer;
+  typedef SmartPointer< const Self >                      ConstPointer;
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(ScalarImageToTextureFeatureMapsFilter, ImageToImageFilter);
+
+  /** standard New() method support */
+  itkNewMacro(Self);
+
+  typedef TInputImage                                  InputImageType;
+  typedef typename InputImageType::PixelType           PixelType;
+  typedef typename InputImageType::IndexType           IndexType;
+  typedef typename InputImageType::SizeType            RadiusType;
+  typedef typename InputImageType::OffsetType          OffsetType;
+  typedef typename InputImageType::RegionType          RegionType;
+  typedef TOutputImage                                 OutputImageType;
+  typedef typename OutputImageType::PixelType          OutputPixelType;
+  typedef typename OutputImageType::RegionType         OutputRegionType;
+  typedef VectorContainer< unsigned char, OffsetType > OffsetVector;
+  typedef typename OffsetVector::Pointer               OffsetVectorPointer;
+  typedef typename OffsetVector::ConstPointer          OffsetVectorConstPointer;
+
+  itkStaticConstMacro(ImageDimension, unsigned int, TInputImage::ImageDimension);
+
+  /** Number of output components of each feature family. */
+  itkStaticConstMacro(NumberOfCooccurrenceFeatures, unsigned int, 8);
+  itkStaticConstMacro(NumberOfRunLengthFeatures, unsigned int, 10);
+
+  itkStaticConstMacro(DefaultBinsPerAxis, unsigned int, 8);
+
+  /** Set/Get the offsets over which the pairs and the runs are computed.
+   * Defaults to half of the offsets to the face, edge and vertex connected
+   * neighbors (the other half is included by symmetry). */
+  itkSetConstObjectMacro(Offsets, OffsetVector);
+  itkGetConstObjectMacro(Offsets, OffsetVector);
+
+  /** Set/Get the radius of the window around each pixel. Defaults to 2. */
+  itkSetMacro(WindowRadius, RadiusType);
+  itkGetConstReferenceMacro(WindowRadius, RadiusType);
+
+  /** Set/Get the number of grey level bins. Defaults to 8. */
+  itkSetClampMacro(NumberOfBinsPerAxis, unsigned int, 1, NumericTraits< unsigned int >::max());
+  itkGetConstMacro(NumberOfBinsPerAxis, unsigned int);
+
+  /** Set the min and max (inclusive) pixel value that will be placed in the
+   * matrices. */
+  void SetPixelValueMinMax(PixelType min, PixelType max);
+  itkGetConstMacro(Min, PixelType);
+  itkGetConstMacro(Max, PixelType);
+
+  /** Select the feature families stored in the output. Both are on by
+   * default. */
+  itkSetMacro(ComputeCooccurrenceFeatures, bool);
+  itkGetConstMacro(ComputeCooccurrenceFeatures, bool);
+  itkBooleanMacro(ComputeCooccurrenceFeatures);
+  itkSetMacro(ComputeRunLengthFeatures, bool);
+  itkGetConstMacro(ComputeRunLengthFeatures, bool);
+  itkBooleanMacro(ComputeRunLengthFeatures);
+
+  /** Method to set/get the mask image */
+  void SetMaskImage(const InputImageType *image);
+  const InputImageType * GetMaskImage() const;
+
+  /** Set the pixel value of the mask that should be considered "inside" the
+   * object. Defaults to one. */
+  itkSetMacro(InsidePixelValue, PixelType);
+  itkGetConstMacro(InsidePixelValue, PixelType);
+
+protected:
+  ScalarImageToTextureFeatureMapsFilter();
+  virtual ~ScalarImageToTextureFeatureMapsFilter() {}
+  virtual void PrintSelf(std::ostream & os, Indent indent) const ITK_OVERRIDE;
+
+  /** The windows of the output pixels may cover the whole input. */
+  virtual void GenerateInputRequestedRegion() ITK_OVERRIDE;
+
+  /** Set the number of components of the output. */
+  virtual void GenerateOutputInformation() ITK_OVERRIDE;
+
+  /** Quantize the input. */
+  virtual void BeforeThreadedGenerateData() ITK_OVERRIDE;
+
+  virtual void ThreadedGenerateData(const OutputRegionType & outputRegionForThread,
+                                    ThreadIdType threadId) ITK_OVERRIDE;
+
+  /** Release the quantized input. */
+  virtual void AfterThreadedGenerateData() ITK_OVERRIDE;
+
+private:
+  ScalarImageToTextureFeatureMapsFilter(const Self &); //purposely not implemented
+  void operator=(const Self &);                        //purposely not implemented
+
+  typedef std::vector< SizeValueType > MatrixType;
+
+  /** Matrices of the current window of a thread. */
+  struct WindowMatrices
+    {
+    MatrixType    Cooccurrence;
+    SizeValueType NumberOfPairs;
+    MatrixType    RunLength;
+    SizeValueType NumberOfRuns;
+    };
+
+  /** Bin of the pixel at the index, or -1 if it is not counted. */
+  int GetBin(const IndexType & index) const;
+
+  /** Add (sign 1) or remove (sign -1) the co-occurrence pairs of the window
+   * that involve a pixel of the slice at the given position along the
+   * first dimension. */
+  void UpdateCooccurrence(const RegionType & window, IndexValueType slice,
+                          int sign, WindowMatrices & matrices) const;
+
+  /** Update the run length matrix when the window shrinks by the slice at
+   * its lower end (shrink true), or grows by the slice at its upper end. */
+  void UpdateRunLength(const RegionType & window, IndexValueType slice,
+                       bool shrink, WindowMatrices & matrices) const;
+
+  /** Length of the run through the pixel along the offset in the window,
+   * and whether the pixel is the first pixel of the run. */
+  SizeValueType GetRunLength(const RegionType & window, const IndexType & index,
+                             const OffsetType & offset, int bin, bool & isFirst) const;
+
+  void AddRun(int bin, SizeValueType length, int sign, WindowMatrices & matrices) const;
+
+  void ComputeCooccurrenceFeatures(const WindowMatrices & matrices, OutputPixelType & features,
+                                   unsigned int firstComponent) const;
+
+  void ComputeRunLengthFeatures(const WindowMatrices & matrices, OutputPixelType & features,
+                                unsigned int firstComponent) const;
+
+  OffsetVectorConstPointer m_Offsets;
+  RadiusType               m_WindowRadius;
+  unsigned int             m_NumberOfBinsPerAxis;
+  PixelType                m_Min;
+  PixelType                m_Max;
+  bool                     m_ComputeCooccurrenceFeatures;
+  bool                     m_ComputeRunLengthFeatures;
+  PixelType                m_InsidePixelValue;
+
+  typedef Image< int, itkGetStaticConstMacro(ImageDimension) > BinImageType;
+  typename BinImageType::Pointer m_BinImage;
+  SizeValueType                  m_MaximumRunLength;
+};
+} // end of namespace Statistics
+} // end of namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkScalarImageToTextureFeatureMapsFilter.hxx"
+#endif
+
+#endif
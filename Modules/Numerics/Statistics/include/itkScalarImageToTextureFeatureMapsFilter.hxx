@@ -0,0 +1,700 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkScalarImageToTextureFeatureMapsFilter_hxx
+#define itkScalarImageToTextureFeatureMapsFilter_hxx
+
+#include "itkScalarImageToTextureFeatureMapsFilter.h"
+
+#include "itkHistogram.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkImageScanlineIterator.h"
+#include "itkNeighborhood.h"
+#include "itkProgressReporter.h"
+#include "itkMath.h"
+#include <algorithm>
+#include <cmath>
+
+namespace itk
+{
+namespace Statistics
+{
+template< typename TInputImage, typename TOutputImage >
+ScalarImageToTextureFeatureMapsFilter< TInputImage, TOutputImage >
+::ScalarImageToTextureFeatureMapsFilter() :
+  m_NumberOfBinsPerAxis( itkGetStaticConstMacro(DefaultBinsPerAxis) ),
+  m_Min( NumericTraits< PixelType >::NonpositiveMin() ),
+  m_Max( NumericTraits< PixelType >::max() ),
+  m_ComputeCooccurrenceFeatures(true),
+  m_ComputeRunLengthFeatures(true),
+  m_InsidePixelValue( NumericTraits< PixelType >::OneValue() ),
+  m_MaximumRunLength(1)
+{
+  this->SetNumberOfRequiredInputs(1);
+
+  m_WindowRadius.Fill(2);
+
+  // Set the offset directions to their defaults: half of all the possible
+  // directions 1 pixel away. (The other half is included by symmetry.)
+  typedef Neighborhood< PixelType, ImageDimension > NeighborhoodType;
+  NeighborhoodType hood;
+  hood.SetRadius(1);
+
+  const unsigned int  centerIndex = hood.GetCenterNeighborhoodIndex();
+  OffsetVectorPointer offsets = OffsetVector::New();
+  for ( unsigned int d = 0; d < centerIndex; d++ )
+    {
+    offsets->push_back( hood.GetOffset(d) );
+    }
+  this->SetOffsets(offsets);
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+ScalarImageToTextureFeatureMapsFilter< TInputImage, TOutputImage >
+::SetPixelValueMinMax(PixelType min, PixelType max)
+{
+  if ( m_Min != min || m_Max != max )
+    {
+    itkDebugMacro("setting Min to " << min << "and Max to " << max);
+    m_Min = min;
+    m_Max = max;
+    this->Modified();
+    }
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+ScalarImageToTextureFeatureMapsFilter< TInputImage, TOutputImage >
+::SetMaskImage(const InputImageType *image)
+{
+  // Process object is not const-correct so the const_cast is required here
+  this->ProcessObject::SetNthInput( 1, const_cast< InputImageType * >( image ) );
+}
+
+template< typename TInputImage, typename TOutputImage >
+const typename ScalarImageToTextureFeatureMapsFilter< TInputImage, TOutputImage >::InputImageType *
+ScalarImageToTextureFeatureMapsFilter< TInputImage, TOutputImage >
+::GetMaskImage() const
+{
+  return static_cast< const InputImageType * >( this->ProcessObject::GetInput(1) );
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+ScalarImageToTextureFeatureMapsFilter< TInputImage, TOutputImage >
+::GenerateInputRequestedRegion()
+{
+  Superclass::GenerateInputRequestedRegion();
+
+  InputImageType *input = const_cast< InputImageType * >( this->GetInput() );
+  if ( input )
+    {
+    input->SetRequestedRegionToLargestPossibleRegion();
+    }
+  InputImageType *mask = const_cast< InputImageType * >( this->GetMaskImage() );
+  if ( mask )
+    {
+    mask->SetRequestedRegionToLargestPossibleRegion();
+    }
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+ScalarImageToTextureFeatureMapsFilter< TInputImage, TOutputImage >
+::GenerateOutputInformation()
+{
+  Superclass::GenerateOutputInformation();
+
+  unsigned int numberOfComponents = 0;
+  if ( m_ComputeCooccurrenceFeatures )
+    {
+    numberOfComponents += NumberOfCooccurrenceFeatures;
+    }
+  if ( m_ComputeRunLengthFeatures )
+    {
+    numberOfComponents += NumberOfRunLengthFeatures;
+    }
+  if ( numberOfComponents == 0 )
+    {
+    itkExceptionMacro("Neither the co-occurrence nor the run length features are computed");
+    }
+  this->GetOutput()->SetNumberOfComponentsPerPixel(numberOfComponents);
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+ScalarImageToTextureFeatureMapsFilter< TInputImage, TOutputImage >
+::BeforeThreadedGenerateData()
+{
+  const InputImageType *input = this->GetInput();
+  const InputImageType *mask = this->GetMaskImage();
+
+  // Quantize the input with the bins of ScalarImageToCooccurrenceMatrixFilter.
+  typedef typename NumericTraits< PixelType >::RealType MeasurementType;
+  typedef Histogram< MeasurementType >                  HistogramType;
+
+  typename HistogramType::Pointer histogram = HistogramType::New();
+  histogram->SetMeasurementVectorSize(1);
+  typename HistogramType::SizeType size(1);
+  size.Fill(m_NumberOfBinsPerAxis);
+  typename HistogramType::MeasurementVectorType lowerBound(1);
+  typename HistogramType::MeasurementVectorType upperBound(1);
+  lowerBound.Fill(m_Min);
+  upperBound.Fill(m_Max + 1);
+  histogram->Initialize(size, lowerBound, upperBound);
+
+  m_BinImage = BinImageType::New();
+  m_BinImage->SetRegions( input->GetBufferedRegion() );
+  m_BinImage->Allocate();
+
+  typename HistogramType::MeasurementVectorType measurement(1);
+  typename HistogramType::IndexType             histogramIndex(1);
+
+  ImageRegionConstIteratorWithIndex< InputImageType > it( input, input->GetBufferedRegion() );
+  for ( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    const PixelType value = it.Get();
+    int             bin = -1;
+    if ( !( value < m_Min || value > m_Max )
+         && ( mask == ITK_NULLPTR || mask->GetPixel( it.GetIndex() ) == m_InsidePixelValue ) )
+      {
+      measurement[0] = value;
+      if ( histogram->GetIndex(measurement, histogramIndex) )
+        {
+        bin = static_cast< int >( histogramIndex[0] );
+        }
+      }
+    m_BinImage->SetPixel(it.GetIndex(), bin);
+    }
+
+  m_MaximumRunLength = 1;
+  for ( unsigned int d = 0; d < ImageDimension; d++ )
+    {
+    m_MaximumRunLength = std::max( m_MaximumRunLength,
+                                   static_cast< SizeValueType >( 2 * m_WindowRadius[d] + 1 ) );
+    }
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+ScalarImageToTextureFeatureMapsFilter< TInputImage, TOutputImage >
+::AfterThreadedGenerateData()
+{
+  m_BinImage = ITK_NULLPTR;
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+ScalarImageToTextureFeatureMapsFilter< TInputImage, TOutputImage >
+::ThreadedGenerateData(const OutputRegionType & outputRegionForThread,
+                       ThreadIdType threadId)
+{
+  OutputImageType *     output = this->GetOutput();
+  const InputImageType *mask = this->GetMaskImage();
+  const RegionType      imageRegion = m_BinImage->GetBufferedRegion();
+  const unsigned int    numberOfComponents = output->GetNumberOfComponentsPerPixel();
+  const unsigned int    bins = m_NumberOfBinsPerAxis;
+
+  WindowMatrices matrices;
+
+  OutputPixelType features;
+  NumericTraits< OutputPixelType >::SetLength(features, numberOfComponents);
+  OutputPixelType zero;
+  NumericTraits< OutputPixelType >::SetLength(zero, numberOfComponents);
+  zero.Fill(NumericTraits< typename NumericTraits< OutputPixelType >::ValueType >::ZeroValue());
+
+  const IndexValueType imageBegin = imageRegion.GetIndex(0);
+  const IndexValueType imageEnd = imageBegin + static_cast< IndexValueType >( imageRegion.GetSize(0) ) - 1;
+  const IndexValueType radius = static_cast< IndexValueType >( m_WindowRadius[0] );
+
+  ProgressReporter progress( this, threadId, outputRegionForThread.GetNumberOfPixels() );
+
+  ImageScanlineIterator< OutputImageType > outIt(output, outputRegionForThread);
+  while ( !outIt.IsAtEnd() )
+    {
+    // The window of the first pixel of the line is grown slice by slice
+    // from an empty matrix.
+    IndexType  index = outIt.GetIndex();
+    RegionType window;
+    for ( unsigned int d = 0; d < ImageDimension; d++ )
+      {
+      const IndexValueType begin = std::max( index[d] - static_cast< IndexValueType >( m_WindowRadius[d] ),
+                                             imageRegion.GetIndex(d) );
+      const IndexValueType end = std::min( index[d] + static_cast< IndexValueType >( m_WindowRadius[d] ),
+                                           imageRegion.GetIndex(d)
+                                           + static_cast< IndexValueType >( imageRegion.GetSize(d) ) - 1 );
+      window.SetIndex( d, begin );
+      window.SetSize( d, end >= begin ? static_cast< SizeValueType >( end - begin + 1 ) : 0 );
+      }
+
+    matrices.Cooccurrence.assign(bins * bins, 0);
+    matrices.NumberOfPairs = 0;
+    matrices.RunLength.assign(bins * m_MaximumRunLength, 0);
+    matrices.NumberOfRuns = 0;
+
+    IndexValueType windowBegin = window.GetIndex(0);
+    IndexValueType windowEnd = windowBegin + static_cast< IndexValueType >( window.GetSize(0) ) - 1;
+    for ( IndexValueType slice = windowBegin; slice <= windowEnd; ++slice )
+      {
+      window.SetSize( 0, static_cast< SizeValueType >( slice - windowBegin + 1 ) );
+      if ( m_ComputeCooccurrenceFeatures )
+        {
+        this->UpdateCooccurrence(window, slice, 1, matrices);
+        }
+      if ( m_ComputeRunLengthFeatures )
+        {
+        this->UpdateRunLength(window, slice, false, matrices);
+        }
+      }
+
+    while ( !outIt.IsAtEndOfLine() )
+      {
+      index = outIt.GetIndex();
+      if ( mask != ITK_NULLPTR && mask->GetPixel(index) != m_InsidePixelValue )
+        {
+        outIt.Set(zero);
+        }
+      else
+        {
+        unsigned int component = 0;
+        if ( m_ComputeCooccurrenceFeatures )
+          {
+          this->ComputeCooccurrenceFeatures(matrices, features, component);
+          component += NumberOfCooccurrenceFeatures;
+          }
+        if ( m_ComputeRunLengthFeatures )
+          {
+          this->ComputeRunLengthFeatures(matrices, features, component);
+          }
+        outIt.Set(features);
+        }
+      ++outIt;
+      progress.CompletedPixel();
+
+      if ( outIt.IsAtEndOfLine() )
+        {
+        break;
+        }
+
+      // Slide the window by one pixel: first remove the slice leaving the
+      // window, then add the slice entering it.
+      const IndexValueType nextBegin = std::max( index[0] + 1 - radius, imageBegin );
+      const IndexValueType nextEnd = std::min( index[0] + 1 + radius, imageEnd );
+      if ( nextBegin > windowBegin )
+        {
+        if ( m_ComputeCooccurrenceFeatures )
+          {
+          this->UpdateCooccurrence(window, windowBegin, -1, matrices);
+          }
+        if ( m_ComputeRunLengthFeatures )
+          {
+          this->UpdateRunLength(window, windowBegin, true, matrices);
+          }
+        windowBegin = nextBegin;
+        window.SetIndex(0, windowBegin);
+        window.SetSize( 0, static_cast< SizeValueType >( windowEnd - windowBegin + 1 ) );
+        }
+      if ( nextEnd > windowEnd )
+        {
+        windowEnd = nextEnd;
+        window.SetSize( 0, static_cast< SizeValueType >( windowEnd - windowBegin + 1 ) );
+        if ( m_ComputeCooccurrenceFeatures )
+          {
+          this->UpdateCooccurrence(window, windowEnd, 1, matrices);
+          }
+        if ( m_ComputeRunLengthFeatures )
+          {
+          this->UpdateRunLength(window, windowEnd, false, matrices);
+          }
+        }
+      }
+    outIt.NextLine();
+    }
+}
+
+template< typename TInputImage, typename TOutputImage >
+inline int
+ScalarImageToTextureFeatureMapsFilter< TInputImage, TOutputImage >
+::GetBin(const IndexType & index) const
+{
+  return m_BinImage->GetPixel(index);
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+ScalarImageToTextureFeatureMapsFilter< TInputImage, TOutputImage >
+::UpdateCooccurrence(const RegionType & window, IndexValueType slice,
+                     int sign, WindowMatrices & matrices) const
+{
+  // The pairs (p, p + offset) with both pixels in the window that involve
+  // the slice are those starting in the slice, and those ending in the
+  // slice that do not start in it.
+  RegionType sliceRegion = window;
+  sliceRegion.SetIndex(0, slice);
+  sliceRegion.SetSize(0, 1);
+
+  const unsigned int bins = m_NumberOfBinsPerAxis;
+
+  ImageRegionConstIteratorWithIndex< BinImageType > it(m_BinImage, sliceRegion);
+  for ( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    const int bin = it.Get();
+    if ( bin < 0 )
+      {
+      continue;
+      }
+    const IndexType index = it.GetIndex();
+
+    typename OffsetVector::ConstIterator offsets;
+    for ( offsets = m_Offsets->Begin(); offsets != m_Offsets->End(); offsets++ )
+      {
+      const OffsetType & offset = offsets.Value();
+
+      const IndexType next = index + offset;
+      if ( window.IsInside(next) )
+        {
+        const int nextBin = this->GetBin(next);
+        if ( nextBin >= 0 )
+          {
+          matrices.Cooccurrence[bin * bins + nextBin] += sign;
+          matrices.Cooccurrence[nextBin * bins + bin] += sign;
+          matrices.NumberOfPairs += 2 * sign;
+          }
+        }
+
+      const IndexType previous = index - offset;
+      if ( previous[0] != slice && window.IsInside(previous) )
+        {
+        const int previousBin = this->GetBin(previous);
+        if ( previousBin >= 0 )
+          {
+          matrices.Cooccurrence[previousBin * bins + bin] += sign;
+          matrices.Cooccurrence[bin * bins + previousBin] += sign;
+          matrices.NumberOfPairs += 2 * sign;
+          }
+        }
+      }
+    }
+}
+
+template< typename TInputImage, typename TOutputImage >
+SizeValueType
+ScalarImageToTextureFeatureMapsFilter< TInputImage, TOutputImage >
+::GetRunLength(const RegionType & window, const IndexType & index,
+               const OffsetType & offset, int bin, bool & isFirst) const
+{
+  SizeValueType length = 1;
+
+  IndexType previous = index - offset;
+  isFirst = true;
+  while ( window.IsInside(previous) && this->GetBin(previous) == bin )
+    {
+    isFirst = false;
+    ++length;
+    previous -= offset;
+    }
+
+  IndexType next = index + offset;
+  while ( window.IsInside(next) && this->GetBin(next) == bin )
+    {
+    ++length;
+    next += offset;
+    }
+  return length;
+}
+
+template< typename TInputImage, typename TOutputImage >
+inline void
+ScalarImageToTextureFeatureMapsFilter< TInputImage, TOutputImage >
+::AddRun(int bin, SizeValueType length, int sign, WindowMatrices & matrices) const
+{
+  matrices.RunLength[bin * m_MaximumRunLength + length - 1] += sign;
+  matrices.NumberOfRuns += sign;
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+ScalarImageToTextureFeatureMapsFilter< TInputImage, TOutputImage >
+::UpdateRunLength(const RegionType & window, IndexValueType slice,
+                  bool shrink, WindowMatrices & matrices) const
+{
+  // The slice is at one end of the window along the first dimension.
+  // Runs along offsets that do not move along that dimension lie in the
+  // slice and are added or removed as a whole. Any other run crosses the
+  // slice at most once, at one of its ends: that run is replaced by the
+  // run without its pixel in the slice.
+  RegionType sliceRegion = window;
+  sliceRegion.SetIndex(0, slice);
+  sliceRegion.SetSize(0, 1);
+
+  const int sign = shrink ? -1 : 1;
+
+  ImageRegionConstIteratorWithIndex< BinImageType > it(m_BinImage, sliceRegion);
+  for ( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    const int bin = it.Get();
+    if ( bin < 0 )
+      {
+      continue;
+      }
+    const IndexType index = it.GetIndex();
+
+    typename OffsetVector::ConstIterator offsets;
+    for ( offsets = m_Offsets->Begin(); offsets != m_Offsets->End(); offsets++ )
+      {
+      const OffsetType & offset = offsets.Value();
+
+      bool zeroOffset = true;
+      for ( unsigned int d = 0; d < ImageDimension; d++ )
+        {
+        zeroOffset = zeroOffset && offset[d] == 0;
+        }
+      if ( zeroOffset )
+        {
+        continue;
+        }
+
+      bool                isFirst;
+      const SizeValueType length = this->GetRunLength(window, index, offset, bin, isFirst);
+      if ( offset[0] == 0 )
+        {
+        if ( isFirst )
+          {
+          this->AddRun(bin, length, sign, matrices);
+          }
+        }
+      else
+        {
+        this->AddRun(bin, length, sign, matrices);
+        if ( length > 1 )
+          {
+          this->AddRun(bin, length - 1, -sign, matrices);
+          }
+        }
+      }
+    }
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+ScalarImageToTextureFeatureMapsFilter< TInputImage, TOutputImage >
+::ComputeCooccurrenceFeatures(const WindowMatrices & matrices, OutputPixelType & features,
+                              unsigned int firstComponent) const
+{
+  // Same computations as HistogramToTextureFeaturesFilter.
+  const unsigned int bins = m_NumberOfBinsPerAxis;
+
+  if ( matrices.NumberOfPairs == 0 )
+    {
+    for ( unsigned int i = 0; i < NumberOfCooccurrenceFeatures; i++ )
+      {
+      features[firstComponent + i] = 0;
+      }
+    return;
+    }
+
+  const double totalFrequency = static_cast< double >( matrices.NumberOfPairs );
+
+  std::vector< double > marginalSums(bins, 0.0);
+  double                pixelMean = 0;
+  for ( unsigned int i = 0; i < bins; i++ )
+    {
+    for ( unsigned int j = 0; j < bins; j++ )
+      {
+      const double frequency = matrices.Cooccurrence[i * bins + j] / totalFrequency;
+      pixelMean += i * frequency;
+      marginalSums[i] += frequency;
+      }
+    }
+
+  double marginalMean = marginalSums[0];
+  double marginalDevSquared = 0;
+  for ( unsigned int arrayIndex = 1; arrayIndex < bins; arrayIndex++ )
+    {
+    const int    k = arrayIndex + 1;
+    const double M_k_minus_1 = marginalMean;
+    const double x_k = marginalSums[arrayIndex];
+    const double M_k = M_k_minus_1 + ( x_k - M_k_minus_1 ) / k;
+    marginalDevSquared += ( x_k - M_k_minus_1 ) * ( x_k - M_k );
+    marginalMean = M_k;
+    }
+  marginalDevSquared = marginalDevSquared / bins;
+
+  double pixelVariance = 0;
+  for ( unsigned int i = 0; i < bins; i++ )
+    {
+    for ( unsigned int j = 0; j < bins; j++ )
+      {
+      const double frequency = matrices.Cooccurrence[i * bins + j] / totalFrequency;
+      pixelVariance += ( i - pixelMean ) * ( i - pixelMean ) * frequency;
+      }
+    }
+
+  double pixelVarianceSquared = pixelVariance * pixelVariance;
+  if ( Math::FloatAlmostEqual( pixelVarianceSquared, 0.0, 4, 2 * NumericTraits< double >::epsilon() ) )
+    {
+    pixelVarianceSquared = 1.;
+    }
+  const double log2 = std::log(2.0);
+
+  double energy = 0;
+  double entropy = 0;
+  double correlation = 0;
+  double inverseDifferenceMoment = 0;
+  double inertia = 0;
+  double clusterShade = 0;
+  double clusterProminence = 0;
+  double haralickCorrelation = 0;
+
+  for ( unsigned int i = 0; i < bins; i++ )
+    {
+    for ( unsigned int j = 0; j < bins; j++ )
+      {
+      const SizeValueType count = matrices.Cooccurrence[i * bins + j];
+      if ( count == 0 )
+        {
+        continue;
+        }
+      const double frequency = count / totalFrequency;
+      const double di = static_cast< double >( i );
+      const double dj = static_cast< double >( j );
+
+      energy += frequency * frequency;
+      entropy -= ( frequency > 0.0001 ) ? frequency * std::log(frequency) / log2 : 0;
+      correlation += ( ( di - pixelMean ) * ( dj - pixelMean ) * frequency ) / pixelVarianceSquared;
+      inverseDifferenceMoment += frequency / ( 1.0 + ( di - dj ) * ( di - dj ) );
+      inertia += ( di - dj ) * ( di - dj ) * frequency;
+      clusterShade += std::pow( ( di - pixelMean ) + ( dj - pixelMean ), 3 ) * frequency;
+      clusterProminence += std::pow( ( di - pixelMean ) + ( dj - pixelMean ), 4 ) * frequency;
+      haralickCorrelation += di * dj * frequency;
+      }
+    }
+  haralickCorrelation = ( haralickCorrelation - marginalMean * marginalMean ) / marginalDevSquared;
+
+  features[firstComponent] = energy;
+  features[firstComponent + 1] = entropy;
+  features[firstComponent + 2] = correlation;
+  features[firstComponent + 3] = inverseDifferenceMoment;
+  features[firstComponent + 4] = inertia;
+  features[firstComponent + 5] = clusterShade;
+  features[firstComponent + 6] = clusterProminence;
+  features[firstComponent + 7] = haralickCorrelation;
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+ScalarImageToTextureFeatureMapsFilter< TInputImage, TOutputImage >
+::ComputeRunLengthFeatures(const WindowMatrices & matrices, OutputPixelType & features,
+                           unsigned int firstComponent) const
+{
+  // Same computations as HistogramToRunLengthFeaturesFilter.
+  if ( matrices.NumberOfRuns == 0 )
+    {
+    for ( unsigned int i = 0; i < NumberOfRunLengthFeatures; i++ )
+      {
+      features[firstComponent + i] = 0;
+      }
+    return;
+    }
+
+  double shortRunEmphasis = 0;
+  double longRunEmphasis = 0;
+  double lowGreyLevelRunEmphasis = 0;
+  double highGreyLevelRunEmphasis = 0;
+  double shortRunLowGreyLevelEmphasis = 0;
+  double shortRunHighGreyLevelEmphasis = 0;
+  double longRunLowGreyLevelEmphasis = 0;
+  double longRunHighGreyLevelEmphasis = 0;
+
+  std::vector< double > greyLevelNonuniformityVector(m_NumberOfBinsPerAxis, 0.0);
+  std::vector< double > runLengthNonuniformityVector(m_MaximumRunLength, 0.0);
+
+  for ( unsigned int i = 0; i < m_NumberOfBinsPerAxis; i++ )
+    {
+    for ( SizeValueType j = 0; j < m_MaximumRunLength; j++ )
+      {
+      const double frequency = static_cast< double >( matrices.RunLength[i * m_MaximumRunLength + j] );
+      if ( frequency == 0 )
+        {
+        continue;
+        }
+      const double i2 = static_cast< double >( ( i + 1 ) * ( i + 1 ) );
+      const double j2 = static_cast< double >( ( j + 1 ) * ( j + 1 ) );
+
+      shortRunEmphasis += ( frequency / j2 );
+      longRunEmphasis += ( frequency * j2 );
+
+      greyLevelNonuniformityVector[i] += frequency;
+      runLengthNonuniformityVector[j] += frequency;
+
+      lowGreyLevelRunEmphasis += ( frequency / i2 );
+      highGreyLevelRunEmphasis += ( frequency * i2 );
+
+      shortRunLowGreyLevelEmphasis += ( frequency / ( i2 * j2 ) );
+      shortRunHighGreyLevelEmphasis += ( frequency * i2 / j2 );
+      longRunLowGreyLevelEmphasis += ( frequency * j2 / i2 );
+      longRunHighGreyLevelEmphasis += ( frequency * i2 * j2 );
+      }
+    }
+
+  double greyLevelNonuniformity = 0;
+  for ( unsigned int i = 0; i < m_NumberOfBinsPerAxis; i++ )
+    {
+    greyLevelNonuniformity += greyLevelNonuniformityVector[i] * greyLevelNonuniformityVector[i];
+    }
+  double runLengthNonuniformity = 0;
+  for ( SizeValueType j = 0; j < m_MaximumRunLength; j++ )
+    {
+    runLengthNonuniformity += runLengthNonuniformityVector[j] * runLengthNonuniformityVector[j];
+    }
+
+  // Normalize all measures by the total number of runs
+  const double numberOfRuns = static_cast< double >( matrices.NumberOfRuns );
+
+  features[firstComponent] = shortRunEmphasis / numberOfRuns;
+  features[firstComponent + 1] = longRunEmphasis / numberOfRuns;
+  features[firstComponent + 2] = greyLevelNonuniformity / numberOfRuns;
+  features[firstComponent + 3] = runLengthNonuniformity / numberOfRuns;
+  features[firstComponent + 4] = lowGreyLevelRunEmphasis / numberOfRuns;
+  features[firstComponent + 5] = highGreyLevelRunEmphasis / numberOfRuns;
+  features[firstComponent + 6] = shortRunLowGreyLevelEmphasis / numberOfRuns;
+  features[firstComponent + 7] = shortRunHighGreyLevelEmphasis / numberOfRuns;
+  features[firstComponent + 8] = longRunLowGreyLevelEmphasis / numberOfRuns;
+  features[firstComponent + 9] = longRunHighGreyLevelEmphasis / numberOfRuns;
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+ScalarImageToTextureFeatureMapsFilter< TInputImage, TOutputImage >
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "Offsets: " << this->GetOffsets() << std::endl;
+  os << indent << "WindowRadius: " << m_WindowRadius << std::endl;
+  os << indent << "NumberOfBinsPerAxis: " << m_NumberOfBinsPerAxis << std::endl;
+  os << indent << "Min: " << static_cast< typename NumericTraits< PixelType >::PrintType >( m_Min ) << std::endl;
+  os << indent << "Max: " << static_cast< typename NumericTraits< PixelType >::PrintType >( m_Max ) << std::endl;
+  os << indent << "ComputeCooccurrenceFeatures: " << m_ComputeCooccurrenceFeatures << std::endl;
+  os << indent << "ComputeRunLengthFeatures: " << m_ComputeRunLengthFeatures << std::endl;
+  os << indent << "InsidePixelValue: "
+     << static_cast< typename NumericTraits< PixelType >::PrintType >( m_InsidePixelValue ) << std::endl;
+}
+} // end of namespace Statistics
+} // end of namespace itk
+
+#endif
@@ -34,6 +34,12 @@ namespace Statistics
  * or an array containing weight values. If none of these two is specified,
  * the covariance matrix is generated with equal weights.
  *
+ * With a weight array, the sample can be split into contiguous ranges that
+ * are accumulated by separate threads (SetNumberOfThreads), and the
+ * partial sums are added in sample order. The grouping of the sums depends
+ * on the number of threads, which changes the result in the last bits, so
+ * the filter uses a single thread unless asked otherwise.
+ *
  * \sa CovarianceSampleFilter
  *
  * \ingroup ITKStatistics
@@ -114,6 +120,32 @@ private:
   WeightedCovarianceSampleFilter(const Self &); //purposely not implemented
   void operator=(const Self &);                 //purposely not implemented
 
+  /** A contiguous range of the sample accumulated by one thread of
+   * ComputeCovarianceMatrixWithWeights. */
+  struct CovarianceRangeType
+    {
+    typename SampleType::ConstIterator Begin;
+    SizeValueType                      FirstIndex;
+    SizeValueType                      Size;
+    MatrixType                         Covariance;
+    WeightValueType                    TotalWeight;
+    WeightValueType                    TotalSquaredWeight;
+
+    CovarianceRangeType(const typename SampleType::ConstIterator & begin):Begin(begin) {}
+    };
+
+  struct ThreadStruct
+    {
+    Self *                             Filter;
+    std::vector< CovarianceRangeType > *Ranges;
+    const MeasurementVectorRealType *  Mean;
+    };
+
+  static ITK_THREAD_RETURN_TYPE CovarianceThreaderCallback(void *arg);
+
+  void ThreadedComputeCovarianceMatrixWithWeights(CovarianceRangeType & range,
+                                                  const MeasurementVectorRealType & mean);
+
 };  // end of class
 } // end of namespace Statistics
 } // end of namespace itk
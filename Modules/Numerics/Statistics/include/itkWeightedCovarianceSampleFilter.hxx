@@ -30,6 +30,7 @@ WeightedCovarianceSampleFilter< TSample >
 ::WeightedCovarianceSampleFilter()
 {
   this->ProcessObject::SetNthInput(1, ITK_NULLPTR);
+  this->SetNumberOfThreads(1);
 }
 
 template< typename TSample >
@@ -214,46 +215,73 @@ WeightedCovarianceSampleFilter< TSample >
   decoratedMeanOutput->Set( mean );
 
   // covariance algorithm
-  MeasurementVectorRealType diff;
-  NumericTraits<MeasurementVectorRealType>::SetLength( diff, measurementVectorSize );
-
-  WeightValueType totalWeight = NumericTraits< WeightValueType >::ZeroValue();
-
-  WeightValueType totalSquaredWeight = NumericTraits< WeightValueType >::ZeroValue();
-
-  typename SampleType::ConstIterator iter =      input->Begin();
-  const typename SampleType::ConstIterator end = input->End();
-
-  // fills the lower triangle and the diagonal cells in the covariance matrix
-  for ( unsigned int sampleVectorIndex = 0;
-        iter != end;
-        ++iter, ++sampleVectorIndex )
+  //
+  // Split the sample into contiguous ranges, one per thread. The sample is
+  // only reachable through iterators, so the iterator at the start of
+  // each range is found by a single walk over the sample.
+  //
+  const SizeValueType sampleSize = input->Size();
+  SizeValueType       numberOfRanges =
+    std::min( static_cast< SizeValueType >( this->GetNumberOfThreads() ), sampleSize );
+  if ( numberOfRanges < 1 )
     {
-    const MeasurementVectorType & measurement = iter.GetMeasurementVector();
+    numberOfRanges = 1;
+    }
 
-    const typename SampleType::AbsoluteFrequencyType frequency = iter.GetFrequency();
+  std::vector< CovarianceRangeType > ranges;
+  ranges.reserve(numberOfRanges);
 
-    const WeightValueType rawWeight = weightsArray[sampleVectorIndex];
+  typename SampleType::ConstIterator iter = input->Begin();
+  SizeValueType                      sampleVectorIndex = 0;
+  for ( SizeValueType r = 0; r < numberOfRanges; ++r )
+    {
+    const SizeValueType first = sampleSize / numberOfRanges * r
+                                + std::min( r, sampleSize % numberOfRanges );
+    while ( sampleVectorIndex < first )
+      {
+      ++iter;
+      ++sampleVectorIndex;
+      }
+    CovarianceRangeType range(iter);
+    range.FirstIndex = first;
+    range.Size = sampleSize / numberOfRanges + ( r < sampleSize % numberOfRanges ? 1 : 0 );
+    range.Covariance.SetSize( measurementVectorSize, measurementVectorSize );
+    range.Covariance.Fill( NumericTraits< typename MatrixType::ValueType >::ZeroValue() );
+    range.TotalWeight = NumericTraits< WeightValueType >::ZeroValue();
+    range.TotalSquaredWeight = NumericTraits< WeightValueType >::ZeroValue();
+    ranges.push_back(range);
+    }
 
-    const WeightValueType weight = ( rawWeight * static_cast< WeightValueType >( frequency ) );
-    totalWeight += weight;
-    totalSquaredWeight += ( weight * weight );
+  if ( numberOfRanges > 1 )
+    {
+    ThreadStruct str;
+    str.Filter = this;
+    str.Ranges = &ranges;
+    str.Mean = &mean;
+
+    this->GetMultiThreader()->SetNumberOfThreads( static_cast< ThreadIdType >( numberOfRanges ) );
+    this->GetMultiThreader()->SetSingleMethod(Self::CovarianceThreaderCallback, &str);
+    this->GetMultiThreader()->SingleMethodExecute();
+    }
+  else
+    {
+    this->ThreadedComputeCovarianceMatrixWithWeights(ranges[0], mean);
+    }
 
-    for ( unsigned int dim = 0; dim < measurementVectorSize; ++dim )
-      {
-      const MeasurementRealType component =
-        static_cast< MeasurementRealType >( measurement[dim] );
+  // adds the sums of the ranges in sample order
+  WeightValueType totalWeight = NumericTraits< WeightValueType >::ZeroValue();
 
-      diff[dim] = ( component - mean[dim] );
-      }
+  WeightValueType totalSquaredWeight = NumericTraits< WeightValueType >::ZeroValue();
 
-    // updates the covariance matrix
+  for ( SizeValueType r = 0; r < numberOfRanges; ++r )
+    {
+    totalWeight += ranges[r].TotalWeight;
+    totalSquaredWeight += ranges[r].TotalSquaredWeight;
     for ( unsigned int row = 0; row < measurementVectorSize; ++row )
       {
       for ( unsigned int col = 0; col < row + 1; ++col )
         {
-        output(row, col) +=
-          ( static_cast< MeasurementRealType >( weight ) * diff[row] * diff[col] );
+        output(row, col) += ranges[r].Covariance(row, col);
         }
       }
     }
@@ -282,6 +310,77 @@ WeightedCovarianceSampleFilter< TSample >
 
   decoratedOutput->Set( output );
 }
+
+template< typename TSample >
+ITK_THREAD_RETURN_TYPE
+WeightedCovarianceSampleFilter< TSample >
+::CovarianceThreaderCallback(void *arg)
+{
+  typedef MultiThreader::ThreadInfoStruct ThreadInfoType;
+  ThreadInfoType *info = static_cast< ThreadInfoType * >( arg );
+  ThreadStruct *  str = static_cast< ThreadStruct * >( info->UserData );
+
+  if ( info->ThreadID < str->Ranges->size() )
+    {
+    str->Filter->ThreadedComputeCovarianceMatrixWithWeights( ( *str->Ranges )[info->ThreadID], *str->Mean );
+    }
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+template< typename TSample >
+void
+WeightedCovarianceSampleFilter< TSample >
+::ThreadedComputeCovarianceMatrixWithWeights(CovarianceRangeType & range,
+                                             const MeasurementVectorRealType & mean)
+{
+  const MeasurementVectorSizeType measurementVectorSize = this->GetInput()->GetMeasurementVectorSize();
+
+  const WeightArrayType & weightsArray = this->GetWeights();
+
+  MeasurementVectorRealType diff;
+  NumericTraits<MeasurementVectorRealType>::SetLength( diff, measurementVectorSize );
+
+  MatrixType & output = range.Covariance;
+
+  typename SampleType::ConstIterator iter = range.Begin;
+
+  const SizeValueType end = range.FirstIndex + range.Size;
+
+  // fills the lower triangle and the diagonal cells in the covariance matrix
+  for ( SizeValueType sampleVectorIndex = range.FirstIndex;
+        sampleVectorIndex < end;
+        ++iter, ++sampleVectorIndex )
+    {
+    const MeasurementVectorType & measurement = iter.GetMeasurementVector();
+
+    const typename SampleType::AbsoluteFrequencyType frequency = iter.GetFrequency();
+
+    const WeightValueType rawWeight = weightsArray[sampleVectorIndex];
+
+    const WeightValueType weight = ( rawWeight * static_cast< WeightValueType >( frequency ) );
+    range.TotalWeight += weight;
+    range.TotalSquaredWeight += ( weight * weight );
+
+    for ( unsigned int dim = 0; dim < measurementVectorSize; ++dim )
+      {
+      const MeasurementRealType component =
+        static_cast< MeasurementRealType >( measurement[dim] );
+
+      diff[dim] = ( component - mean[dim] );
+      }
+
+    // updates the covariance matrix
+    for ( unsigned int row = 0; row < measurementVectorSize; ++row )
+      {
+      for ( unsigned int col = 0; col < row + 1; ++col )
+        {
+        output(row, col) +=
+          ( static_cast< MeasurementRealType >( weight ) * diff[row] * diff[col] );
+        }
+      }
+    }
+}
 } // end of namespace Statistics
 } // end of namespace itk
 
@@ -18,6 +18,7 @@
 
 
 #include <fstream>
+#include <cmath>
 
 #include "itkPointSetToListSampleAdaptor.h"
 
@@ -145,6 +146,7 @@ int itkExpectationMaximizationMixtureModelEstimatorTest(int argc, char* argv[] )
   estimator->SetSample(sample.GetPointer());
   estimator->SetMaximumIteration(maximumIteration);
   estimator->SetInitialProportions(initialProportions);
+  estimator->SetNumberOfThreads(1);
 
   for ( i = 0; i < numberOfClasses; i++)
     {
@@ -189,6 +191,60 @@ int itkExpectationMaximizationMixtureModelEstimatorTest(int argc, char* argv[] )
     return EXIT_FAILURE;
     }
 
+  /* Estimating again with the expectation step split over 4 threads: only
+   * the order of the sums of the weights changes, so the estimates have to
+   * stay those of the single threaded run up to rounding. */
+  std::vector< ComponentPointer > threadedComponents;
+  EstimatorType::Pointer threadedEstimator = EstimatorType::New();
+  threadedEstimator->SetSample(sample.GetPointer());
+  threadedEstimator->SetMaximumIteration(maximumIteration);
+  threadedEstimator->SetInitialProportions(initialProportions);
+  threadedEstimator->SetNumberOfThreads(4);
+  for ( i = 0; i < numberOfClasses; i++ )
+    {
+    threadedComponents.push_back(ComponentType::New());
+    (threadedComponents[i])->SetSample(sample.GetPointer());
+    (threadedComponents[i])->SetParameters(initialParameters[i]);
+    threadedEstimator->AddComponent((ComponentType::Superclass*)
+                                      (threadedComponents[i]).GetPointer());
+    }
+
+  threadedEstimator->Update();
+
+  if ( threadedEstimator->GetNumberOfThreads() != 4 )
+    {
+    std::cout << "Test failed: the number of threads was not set." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  const double tolerance = 1e-8;
+  for ( i = 0; i < numberOfClasses; i++)
+    {
+    const ParametersType oneThread = (components[i])->GetFullParameters();
+    const ParametersType fourThreads = (threadedComponents[i])->GetFullParameters();
+    for ( j = 0; j < oneThread.Size(); j++)
+      {
+      if ( std::fabs(fourThreads[j] - oneThread[j])
+           > tolerance * ( 1.0 + std::fabs(oneThread[j]) ) )
+        {
+        passed = false;
+        }
+      }
+    if ( std::fabs((threadedEstimator->GetProportions())[i] - (estimator->GetProportions())[i])
+         > tolerance )
+      {
+      passed = false;
+      }
+    if ( !passed )
+      {
+      std::cout << "Cluster[" << i << "] with 4 threads:" << std::endl;
+      std::cout << "         " << fourThreads << std::endl;
+      std::cout << "         " << (threadedEstimator->GetProportions())[i] << std::endl;
+      std::cout << "Test failed: the estimates depend on the number of threads." << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
   estimator->Print(std::cout);
 
   std::cout << "Test passed." << std::endl;
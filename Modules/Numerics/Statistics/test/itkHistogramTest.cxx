@@ -830,6 +830,69 @@ int itkHistogramTest(int, char* [] )
 
     }
 
+  // Compare the bins found for equal width bins with the bins found by
+  // the binary search, used once the bins are set individually.
+  {
+  HistogramType::Pointer uniformHistogram = HistogramType::New();
+  HistogramType::Pointer searchedHistogram = HistogramType::New();
+  uniformHistogram->SetMeasurementVectorSize( 2 );
+  searchedHistogram->SetMeasurementVectorSize( 2 );
+
+  HistogramType::SizeType binSize( 2 );
+  binSize[0] = 7;
+  binSize[1] = 13;
+  MeasurementVectorType binLower( 2 );
+  MeasurementVectorType binUpper( 2 );
+  binLower[0] = -0.3f;
+  binLower[1] = 5.0f;
+  binUpper[0] = 1.1f;
+  binUpper[1] = 17.7f;
+
+  uniformHistogram->Initialize( binSize, binLower, binUpper );
+  searchedHistogram->Initialize( binSize );
+  for( unsigned int dim = 0; dim < 2; ++dim )
+    {
+    for( unsigned int bin = 0; bin < binSize[dim]; ++bin )
+      {
+      searchedHistogram->SetBinMin( dim, bin, uniformHistogram->GetBinMin( dim, bin ) );
+      searchedHistogram->SetBinMax( dim, bin, uniformHistogram->GetBinMax( dim, bin ) );
+      }
+    }
+
+  IndexType uniformIndex;
+  IndexType searchedIndex;
+  MeasurementVectorType sample( 2 );
+  for( unsigned int bin = 0; bin < binSize[0]; ++bin )
+    {
+    for( int step = -2; step < 20; ++step )
+      {
+      // samples on the bin bounds, and spread over the bins
+      sample[0] = uniformHistogram->GetBinMin( 0, bin ) + step * 0.011f;
+      sample[1] = uniformHistogram->GetBinMin( 1, ( bin * 2 ) % binSize[1] ) + step * 0.05f;
+      if( step == 0 )
+        {
+        sample[1] = uniformHistogram->GetBinMax( 1, bin );
+        }
+      const bool uniformInside = uniformHistogram->GetIndex( sample, uniformIndex );
+      const bool searchedInside = searchedHistogram->GetIndex( sample, searchedIndex );
+      if( uniformInside != searchedInside
+          || ( uniformInside && uniformIndex != searchedIndex ) )
+        {
+        pass = false;
+        whereFail = "GetIndex() with equal width bins";
+        }
+      if( uniformHistogram->GetBinMinFromValue( 0, sample[0] )
+          != searchedHistogram->GetBinMinFromValue( 0, sample[0] )
+          || uniformHistogram->GetBinMaxFromValue( 1, sample[1] )
+          != searchedHistogram->GetBinMaxFromValue( 1, sample[1] ) )
+        {
+        pass = false;
+        whereFail = "GetBinMinFromValue()/GetBinMaxFromValue() with equal width bins";
+        }
+      }
+    }
+  }
+
   // Exercise Print() method
   histogram->Print( std::cout );
 
@@ -176,6 +176,32 @@ int itkKdTreeBasedKmeansEstimatorTest(int argc, char* argv[] )
       }
     }
 
+  // Filtering the subtrees on several threads only changes the order in
+  // which the centroid sums are added.
+  Estimator::Pointer threadedEstimator = Estimator::New();
+  threadedEstimator->SetParameters(initialMeans);
+  threadedEstimator->SetMaximumIteration(maximumIteration);
+  threadedEstimator->SetKdTree(generator->GetOutput());
+  threadedEstimator->SetCentroidPositionChangesThreshold(0.0);
+  threadedEstimator->SetNumberOfThreads(4);
+  if ( threadedEstimator->GetNumberOfThreads() != 4 )
+    {
+    std::cerr << "Error in Set/GetNumberOfThreads" << std::endl;
+    return EXIT_FAILURE;
+    }
+  threadedEstimator->StartOptimization();
+  Estimator::ParametersType threadedMeans = threadedEstimator->GetParameters();
+  for (i = 0; i < estimatedMeans.size(); i++)
+    {
+    if ( std::fabs( threadedMeans[i] - estimatedMeans[i] ) > 1e-9 * std::fabs( estimatedMeans[i] ) )
+      {
+      std::cerr << "Threaded estimate [" << i << "] " << threadedMeans[i]
+                << " differs from the single threaded estimate "
+                << estimatedMeans[i] << std::endl;
+      passed = false;
+      }
+    }
+
   if( !passed )
     {
     std::cout << "Test failed." << std::endl;
@@ -21,6 +21,7 @@
 
 
 #include "itkScalarImageToRunLengthMatrixFilter.h"
+#include "itkSparseFrequencyContainer2.h"
 
 int itkScalarImageToRunLengthMatrixFilterTest(int, char* [] )
 {
@@ -274,6 +275,40 @@ int itkScalarImageToRunLengthMatrixFilterTest(int, char* [] )
         }
       }
 
+    // The sparse container is filled directly, whatever the number of
+    // threads, and has to give the same runs.
+    typedef itk::Statistics::ScalarImageToRunLengthMatrixFilter<
+      InputImageType, itk::Statistics::SparseFrequencyContainer2 > SparseFilterType;
+
+    SparseFilterType::Pointer sparseFilter = SparseFilterType::New();
+    sparseFilter->SetInput( image );
+    sparseFilter->SetOffsets( offsetV );
+    sparseFilter->SetMaskImage( mask );
+    sparseFilter->SetInsidePixelValue( 0 );
+    sparseFilter->SetPixelValueMinMax( 0, 3 );
+    sparseFilter->SetDistanceValueMinMax( 0, 8 );
+    sparseFilter->SetNumberOfBinsPerAxis( 5 );
+    sparseFilter->SetNumberOfThreads( 2 );
+    sparseFilter->Update();
+    const SparseFilterType::HistogramType * sparseHist = sparseFilter->GetOutput();
+
+    for( unsigned int i = 0; i < 5; i++ )
+      {
+      for( unsigned int j = 0; j < 5; j++ )
+        {
+        SparseFilterType::HistogramType::IndexType index( sparseHist->GetMeasurementVectorSize() );
+        index[0] = i;
+        index[1] = j;
+        if( sparseHist->GetFrequency( index ) != frequencies2[j][i] )
+          {
+          std::cerr << "Expected sparse frequency2  (i,j)= " << "(" <<i << "," << j << ")" << frequencies2[j][i]
+            << ", calculated = "
+            << sparseHist->GetFrequency( index ) << std::endl;
+          passed = false;
+          }
+        }
+      }
+
     filter->Print( std::cout, 3 );
 
     if (!passed)
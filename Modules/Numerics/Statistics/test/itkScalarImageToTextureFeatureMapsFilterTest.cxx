@@ -0,0 +1,260 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkScalarImageToTextureFeatureMapsFilter.h"
+#include "itkScalarImageToCooccurrenceMatrixFilter.h"
+#include "itkHistogramToTextureFeaturesFilter.h"
+
+namespace
+{
+typedef itk::Image< unsigned char, 2 > InputImageType;
+
+// Copy of the window of the given radius around the index, clipped to the
+// image, in an image of its own.
+InputImageType::Pointer
+ExtractWindow( const InputImageType * image, const InputImageType::IndexType & center,
+               const InputImageType::SizeType & radius )
+{
+  InputImageType::RegionType window;
+  for( unsigned int d = 0; d < 2; ++d )
+    {
+    window.SetIndex( d, center[d] - static_cast< itk::IndexValueType >( radius[d] ) );
+    window.SetSize( d, 2 * radius[d] + 1 );
+    }
+  window.Crop( image->GetLargestPossibleRegion() );
+
+  InputImageType::RegionType region;
+  region.SetSize( window.GetSize() );
+  InputImageType::Pointer windowImage = InputImageType::New();
+  windowImage->SetRegions( region );
+  windowImage->Allocate();
+
+  itk::ImageRegionIteratorWithIndex< InputImageType > it( windowImage, region );
+  for( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    InputImageType::IndexType index = window.GetIndex();
+    for( unsigned int d = 0; d < 2; ++d )
+      {
+      index[d] += it.GetIndex()[d];
+      }
+    it.Set( image->GetPixel( index ) );
+    }
+  return windowImage;
+}
+
+// Short and long run emphasis of the window, counting the runs of equal
+// bins along the offsets.
+void
+RunEmphasis( const InputImageType * window, const std::vector< InputImageType::OffsetType > & offsets,
+             unsigned int bins, double & shortRunEmphasis, double & longRunEmphasis )
+{
+  const InputImageType::RegionType region = window->GetLargestPossibleRegion();
+  double numberOfRuns = 0;
+  shortRunEmphasis = 0;
+  longRunEmphasis = 0;
+  itk::ImageRegionConstIteratorWithIndex< InputImageType > it( window, region );
+  for( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    const unsigned int bin = it.Get() * bins / 256;
+    for( unsigned int o = 0; o < offsets.size(); ++o )
+      {
+      InputImageType::IndexType index = it.GetIndex() - offsets[o];
+      if( region.IsInside( index ) && window->GetPixel( index ) * bins / 256 == bin )
+        {
+        continue; // not the first pixel of the run
+        }
+      double length = 0;
+      index = it.GetIndex();
+      while( region.IsInside( index ) && window->GetPixel( index ) * bins / 256 == bin )
+        {
+        ++length;
+        index += offsets[o];
+        }
+      numberOfRuns += 1;
+      shortRunEmphasis += 1.0 / ( length * length );
+      longRunEmphasis += length * length;
+      }
+    }
+  shortRunEmphasis /= numberOfRuns;
+  longRunEmphasis /= numberOfRuns;
+}
+}
+
+int itkScalarImageToTextureFeatureMapsFilterTest(int, char* [] )
+{
+  typedef itk::VectorImage< float, 2 >                                                   FeatureImageType;
+  typedef itk::Statistics::ScalarImageToTextureFeatureMapsFilter< InputImageType >      FilterType;
+  typedef itk::Statistics::ScalarImageToCooccurrenceMatrixFilter< InputImageType >      CooccurrenceFilterType;
+  typedef itk::Statistics::HistogramToTextureFeaturesFilter<
+    CooccurrenceFilterType::HistogramType >                                             TextureFeaturesFilterType;
+
+  // An image with stripes of different widths, and some noise.
+  InputImageType::RegionType region;
+  InputImageType::SizeType   size = {{ 23, 17 }};
+  region.SetSize( size );
+  InputImageType::Pointer image = InputImageType::New();
+  image->SetRegions( region );
+  image->Allocate();
+
+  unsigned int random = 12345;
+  itk::ImageRegionIteratorWithIndex< InputImageType > it( image, region );
+  for( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    random = random * 1103515245 + 12345;
+    const InputImageType::IndexType index = it.GetIndex();
+    unsigned int value = ( ( index[0] / 3 + index[1] / 2 ) % 4 ) * 64;
+    if( ( random >> 16 ) % 5 == 0 )
+      {
+      value = ( random >> 8 ) % 256;
+      }
+    it.Set( static_cast< InputImageType::PixelType >( value ) );
+    }
+
+  FilterType::Pointer filter = FilterType::New();
+  filter->SetInput( image );
+  FilterType::RadiusType radius;
+  radius[0] = 3;
+  radius[1] = 2;
+  filter->SetWindowRadius( radius );
+  filter->SetNumberOfBinsPerAxis( 4 );
+  filter->SetNumberOfThreads( 3 );
+
+  try
+    {
+    filter->Update();
+    }
+  catch( itk::ExceptionObject & excp )
+    {
+    std::cerr << excp << std::endl;
+    return EXIT_FAILURE;
+    }
+  filter->Print( std::cout );
+
+  const FeatureImageType * features = filter->GetOutput();
+  if( features->GetNumberOfComponentsPerPixel() !=
+      FilterType::NumberOfCooccurrenceFeatures + FilterType::NumberOfRunLengthFeatures )
+    {
+    std::cerr << "Wrong number of components: " << features->GetNumberOfComponentsPerPixel() << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::vector< InputImageType::OffsetType > offsets;
+  FilterType::OffsetVector::ConstIterator offsetIt;
+  for( offsetIt = filter->GetOffsets()->Begin(); offsetIt != filter->GetOffsets()->End(); ++offsetIt )
+    {
+    offsets.push_back( offsetIt.Value() );
+    }
+
+  // Compare the features of a few pixels, including pixels whose window is
+  // clipped by the image, with the features of their window.
+  const itk::IndexValueType testIndices[][2] = { { 0, 0 }, { 5, 4 }, { 11, 8 }, { 22, 3 }, { 12, 16 }, { 20, 14 } };
+  for( unsigned int t = 0; t < sizeof( testIndices ) / sizeof( testIndices[0] ); ++t )
+    {
+    InputImageType::IndexType index;
+    index[0] = testIndices[t][0];
+    index[1] = testIndices[t][1];
+    InputImageType::Pointer window = ExtractWindow( image, index, radius );
+
+    CooccurrenceFilterType::Pointer cooccurrence = CooccurrenceFilterType::New();
+    cooccurrence->SetInput( window );
+    cooccurrence->SetOffsets( filter->GetOffsets() );
+    cooccurrence->SetNumberOfBinsPerAxis( 4 );
+    TextureFeaturesFilterType::Pointer textureFeatures = TextureFeaturesFilterType::New();
+    textureFeatures->SetInput( cooccurrence->GetOutput() );
+    textureFeatures->Update();
+
+    const FeatureImageType::PixelType pixel = features->GetPixel( index );
+    for( unsigned int f = 0; f < FilterType::NumberOfCooccurrenceFeatures; ++f )
+      {
+      const double expected = textureFeatures->GetFeature(
+        static_cast< TextureFeaturesFilterType::TextureFeatureName >( f ) );
+      if( std::fabs( pixel[f] - expected ) > 1e-4 * ( 1.0 + std::fabs( expected ) ) )
+        {
+        std::cerr << "Co-occurrence feature " << f << " at " << index << " is " << pixel[f]
+                  << " instead of " << expected << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+
+    double shortRunEmphasis;
+    double longRunEmphasis;
+    RunEmphasis( window, offsets, 4, shortRunEmphasis, longRunEmphasis );
+    const unsigned int first = FilterType::NumberOfCooccurrenceFeatures;
+    if( std::fabs( pixel[first] - shortRunEmphasis ) > 1e-4 * shortRunEmphasis
+        || std::fabs( pixel[first + 1] - longRunEmphasis ) > 1e-4 * longRunEmphasis )
+      {
+      std::cerr << "Run emphasis at " << index << " is " << pixel[first] << ", " << pixel[first + 1]
+                << " instead of " << shortRunEmphasis << ", " << longRunEmphasis << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  // Pixels outside of the mask get zero features, and the others do not
+  // depend on the number of threads.
+  InputImageType::Pointer mask = InputImageType::New();
+  mask->SetRegions( region );
+  mask->Allocate();
+  itk::ImageRegionIteratorWithIndex< InputImageType > maskIt( mask, region );
+  for( maskIt.GoToBegin(); !maskIt.IsAtEnd(); ++maskIt )
+    {
+    maskIt.Set( maskIt.GetIndex()[0] + maskIt.GetIndex()[1] < 25 ? 1 : 0 );
+    }
+
+  FilterType::Pointer maskedFilter = FilterType::New();
+  maskedFilter->SetInput( image );
+  maskedFilter->SetMaskImage( mask );
+  maskedFilter->SetWindowRadius( radius );
+  maskedFilter->SetNumberOfBinsPerAxis( 4 );
+  maskedFilter->ComputeCooccurrenceFeaturesOff();
+  maskedFilter->SetNumberOfThreads( 1 );
+  maskedFilter->Update();
+
+  FilterType::Pointer threadedFilter = FilterType::New();
+  threadedFilter->SetInput( image );
+  threadedFilter->SetMaskImage( mask );
+  threadedFilter->SetWindowRadius( radius );
+  threadedFilter->SetNumberOfBinsPerAxis( 4 );
+  threadedFilter->ComputeCooccurrenceFeaturesOff();
+  threadedFilter->SetNumberOfThreads( 4 );
+  threadedFilter->Update();
+
+  if( maskedFilter->GetOutput()->GetNumberOfComponentsPerPixel() != FilterType::NumberOfRunLengthFeatures )
+    {
+    std::cerr << "Wrong number of components with the run length features only" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  for( maskIt.GoToBegin(); !maskIt.IsAtEnd(); ++maskIt )
+    {
+    const FeatureImageType::PixelType single = maskedFilter->GetOutput()->GetPixel( maskIt.GetIndex() );
+    const FeatureImageType::PixelType threaded = threadedFilter->GetOutput()->GetPixel( maskIt.GetIndex() );
+    for( unsigned int f = 0; f < FilterType::NumberOfRunLengthFeatures; ++f )
+      {
+      if( ( maskIt.Get() == 0 && single[f] != 0 ) || single[f] != threaded[f] )
+        {
+        std::cerr << "Masked run length feature " << f << " at " << maskIt.GetIndex() << " is "
+                  << single[f] << " with one thread and " << threaded[f] << " with four" << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+    }
+
+  std::cout << "Test succeeded." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -345,6 +345,58 @@ int itkWeightedCovarianceSampleFilterTest(int, char* [] )
     }
 
 
+  // run with unequal weights on 1 and on 4 threads: each thread sums its
+  // own range of the sample, so only the order of the additions changes
+  WeightArrayType unequalWeights( sample->Size() );
+  for ( unsigned int i = 0; i < sample->Size(); i++ )
+    {
+    unequalWeights[i] = 0.5 + 0.25 * i;
+    }
+  filter->SetWeights( unequalWeights );
+
+  MeasurementVectorRealType threadMeans[2];
+  CovarianceMatrixType      threadMatrices[2];
+  const itk::ThreadIdType   threads[2] = { 1, 4 };
+  for ( unsigned int t = 0; t < 2; t++ )
+    {
+    filter->SetNumberOfThreads( threads[t] );
+    try
+      {
+      filter->Update();
+      }
+    catch ( itk::ExceptionObject & excp )
+      {
+      std::cerr << "Exception caught: " << excp << std::endl;
+      return EXIT_FAILURE;
+      }
+    threadMeans[t] = filter->GetMean();
+    threadMatrices[t] = filter->GetCovarianceMatrix();
+    }
+  filter->SetNumberOfThreads( 1 );
+
+  std::cout << "Mean with 4 threads: "              << threadMeans[1] << std::endl;
+  std::cout << "Covariance Matrix with 4 threads: " << threadMatrices[1] << std::endl;
+
+  const double threadsTolerance = 1e-12;
+  for ( unsigned int i = 0; i < MeasurementVectorSize; i++ )
+    {
+    if ( std::abs( threadMeans[1][i] - threadMeans[0][i] )
+         > threadsTolerance * ( 1.0 + std::abs( threadMeans[0][i] ) ) )
+      {
+      std::cerr << "The mean computed with 4 threads differs from the one with 1 thread" << std::endl;
+      return EXIT_FAILURE;
+      }
+    for ( unsigned int j = 0; j < MeasurementVectorSize; j++ )
+      {
+      if ( std::abs( threadMatrices[1][i][j] - threadMatrices[0][i][j] )
+           > threadsTolerance * ( 1.0 + std::abs( threadMatrices[0][i][j] ) ) )
+        {
+        std::cerr << "The covariance matrix computed with 4 threads differs from the one with 1 thread" << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+    }
+
   //set  a constant 1.0 weight using a function
   WeightedCovarianceTestFunction::Pointer weightFunction = WeightedCovarianceTestFunction::New();
   filter->SetWeightingFunction( weightFunction.GetPointer() );
@@ -41,6 +41,15 @@ namespace itk
  * achieved by using an appropriate mask during selection of feature points.
  * If you are unsure whether feature points satisfy the above condition set
  * CheckBoundary flag to true which turns on boundary checks.
+ * The fixed image neighborhood covering the whole search window and the
+ * moving image block of each feature point are copied once into contiguous
+ * buffers, and the block statistics of the moving image are computed once
+ * per feature point, so each candidate displacement only costs the fixed
+ * image block statistics and the cross term.
+ * When UseSubvoxelRefinement is on, the best displacement is refined along
+ * each dimension by fitting a parabola through the similarities of the best
+ * candidate and of its two neighbors in the search window. It is off by
+ * default, in which case displacements are multiples of the voxel spacing.
  * The default output(0) is a PointSet with displacements stored as vectors.
  * Additional output(1) is a PointSet containing similarities. Similarities
  * are needed to compute displacements and are always computed. The number
@@ -128,6 +137,12 @@ public:
   itkSetMacro(SearchRadius, ImageSizeType);
   itkGetConstMacro(SearchRadius, ImageSizeType);
 
+  /** set/get whether the displacements are refined to sub-voxel accuracy
+   * by parabolic interpolation of the similarities. Default is off. */
+  itkSetMacro(UseSubvoxelRefinement, bool);
+  itkGetConstMacro(UseSubvoxelRefinement, bool);
+  itkBooleanMacro(UseSubvoxelRefinement);
+
   /** set/get fixed image */
   itkSetInputMacro(FixedImage, FixedImageType);
   itkGetInputMacro(FixedImage, FixedImageType);
@@ -199,6 +214,7 @@ private:
   // algorithm parameters
   ImageSizeType  m_BlockRadius;
   ImageSizeType  m_SearchRadius;
+  bool           m_UseSubvoxelRefinement;
 
   // temporary dynamic arrays for storing threads outputs
   SizeValueType         m_PointsCount;
@@ -21,7 +21,10 @@
 #include "itkBlockMatchingImageFilter.h"
 #include "itkImageRegionConstIterator.h"
 #include "itkConstNeighborhoodIterator.h"
+#include "itkContinuousIndex.h"
+#include <algorithm>
 #include <limits>
+#include <vector>
 
 
 namespace itk
@@ -33,6 +36,7 @@ BlockMatchingImageFilter< TFixedImage, TMovingImage, TFeatures, TDisplacements,
   // defaults
   this->m_BlockRadius.Fill( 2 );
   this->m_SearchRadius.Fill( 3 );
+  this->m_UseSubvoxelRefinement = false;
 
   // make the outputs
   this->ProcessObject::SetNumberOfRequiredOutputs( 2 );
@@ -62,7 +66,8 @@ BlockMatchingImageFilter< TFixedImage, TMovingImage, TFeatures, TDisplacements,
   Superclass::PrintSelf( os, indent );
   os << indent << "Number of threads: " << this->GetNumberOfThreads() << std::endl
      << indent << "m_BlockRadius: " << m_BlockRadius << std::endl
-     << indent << "m_SearchRadius: " << m_SearchRadius << std::endl;
+     << indent << "m_SearchRadius: " << m_SearchRadius << std::endl
+     << indent << "m_UseSubvoxelRefinement: " << m_UseSubvoxelRefinement << std::endl;
 }
 
 template< typename TFixedImage, typename TMovingImage, typename TFeatures, typename TDisplacements, typename TSimilarities >
@@ -229,29 +234,68 @@ BlockMatchingImageFilter< TFixedImage, TMovingImage, TFeatures, TDisplacements,
 
   SizeValueType threadCount = this->GetNumberOfThreads();
 
-  // compute first point and number of points (count) for this thread
+  // compute first point and number of points (count) for this thread, the
+  // remainder is spread over the first threads
   SizeValueType count = m_PointsCount / threadCount;
-  SizeValueType first = threadId * count;
-  if ( threadId + 1 == threadCount ) // last thread
+  const SizeValueType remainder = m_PointsCount % threadCount;
+  SizeValueType first = threadId * count + std::min( static_cast< SizeValueType >( threadId ), remainder );
+  if ( threadId < remainder )
     {
-    count += this->m_PointsCount % threadCount;
+    count++;
+    }
+  if ( count == 0 )
+    {
+    return;
     }
 
-  // start constructing window region and center region (single voxel)
-  ImageRegionType window;
+  // The fixed image neighborhood of a feature point covers all the blocks
+  // of the search window: its radius is m_SearchRadius + m_BlockRadius.
+  ImageSizeType bufferRadius = m_SearchRadius + m_BlockRadius;
   ImageRegionType center;
-  ImageSizeType windowSize;
-  windowSize.Fill( 1 );
-  center.SetSize( windowSize ); // size of center region is 1
-  windowSize += m_SearchRadius + m_SearchRadius;
-  window.SetSize( windowSize ); // size of window region is 1+2*m_BlockHalfWindow
-
-  // start constructing block iterator
+  ImageSizeType centerSize;
+  centerSize.Fill( 1 );
+  center.SetSize( centerSize ); // size of center region is 1
+
+  // strides of the fixed buffer and of the search window, as well as
+  // offsets of the block voxels in the fixed buffer, all in the raster
+  // order of the neighborhood iterators
+  SizeValueType bufferStride[ ImageDimension ];
+  SizeValueType windowStride[ ImageDimension ];
+  SizeValueType bufferStrideValue = 1;
+  SizeValueType windowStrideValue = 1;
   SizeValueType numberOfVoxelInBlock = 1;
-  for ( unsigned i = 0; i < ImageSizeType::Dimension; i++ )
+  for ( unsigned i = 0; i < ImageDimension; i++ )
     {
+    bufferStride[ i ] = bufferStrideValue;
+    windowStride[ i ] = windowStrideValue;
+    bufferStrideValue *= 2 * bufferRadius[ i ] + 1;
+    windowStrideValue *= 2 * m_SearchRadius[ i ] + 1;
     numberOfVoxelInBlock *= m_BlockRadius[ i ] + 1 + m_BlockRadius[ i ];
     }
+  const SizeValueType numberOfCandidates = windowStrideValue;
+
+  std::vector< SizeValueType > blockOffsets( numberOfVoxelInBlock );
+  for ( SizeValueType i = 0; i < numberOfVoxelInBlock; i++ )
+    {
+    SizeValueType remaining = i;
+    SizeValueType offset = 0;
+    for ( unsigned d = 0; d < ImageDimension; d++ )
+      {
+      const SizeValueType blockSize = 2 * m_BlockRadius[ d ] + 1;
+      offset += ( remaining % blockSize ) * bufferStride[ d ];
+      remaining /= blockSize;
+      }
+    blockOffsets[ i ] = offset;
+    }
+
+  // buffers reused for all the feature points of this thread
+  std::vector< SimilaritiesValue > fixedBuffer( bufferStrideValue );
+  std::vector< SimilaritiesValue > movingBuffer( numberOfVoxelInBlock );
+  std::vector< SimilaritiesValue > similarities;
+  if ( m_UseSubvoxelRefinement )
+    {
+    similarities.resize( numberOfCandidates );
+    }
 
   // loop thru feature points
   for ( SizeValueType idx = first, last = first + count; idx < last; idx++ )
@@ -264,46 +308,58 @@ BlockMatchingImageFilter< TFixedImage, TMovingImage, TFeatures, TDisplacements,
 
     // the block is selected for a minimum similarity metric
     SimilaritiesValue  similarity = NumericTraits< SimilaritiesValue >::ZeroValue();
+    SizeValueType      bestCandidate = 0;
 
-    // New point location
-    DisplacementsVector displacement;
+    // copy the fixed image neighborhood covering the search window
+    center.SetIndex( fixedIndex );
+    ConstNeighborhoodIterator< FixedImageType > fixedIterator( bufferRadius, fixedImage, center );
+    fixedIterator.GoToBegin();
+    for ( SizeValueType i = 0; i < bufferStrideValue; i++ )
+      {
+      fixedBuffer[ i ] = fixedIterator.GetPixel( i );
+      }
 
-    // set centers of window and center regions to current location
-    ImageIndexType start = fixedIndex - this->m_SearchRadius;
-    window.SetIndex( start );
+    // copy the block of the moving image around the feature point and
+    // compute its statistics, which are the same for all candidates
     center.SetIndex( movingIndex );
-
-    // iterate over neighborhoods in region window, for each neighborhood: iterate over voxels in blockRadius
-    ConstNeighborhoodIterator< FixedImageType > windowIterator( m_BlockRadius, fixedImage, window );
-
-    // iterate over voxels in neighborhood of current feature point
     ConstNeighborhoodIterator< MovingImageType > centerIterator( m_BlockRadius, movingImage, center );
     centerIterator.GoToBegin();
+    SimilaritiesValue movingSum = NumericTraits< SimilaritiesValue >::ZeroValue();
+    SimilaritiesValue movingSumOfSquares = NumericTraits< SimilaritiesValue >::ZeroValue();
+    for ( SizeValueType i = 0; i < numberOfVoxelInBlock; i++ )
+      {
+      const SimilaritiesValue movingValue = centerIterator.GetPixel( i );
+      movingBuffer[ i ] = movingValue;
+      movingSum += movingValue;
+      movingSumOfSquares += movingValue * movingValue;
+      }
+    const SimilaritiesValue movingMean = movingSum / numberOfVoxelInBlock;
+    const SimilaritiesValue movingVariance = movingSumOfSquares - numberOfVoxelInBlock * movingMean * movingMean;
 
-    // iterate over neighborhoods in region window
-    for ( windowIterator.GoToBegin(); !windowIterator.IsAtEnd(); ++windowIterator )
+    // iterate over the candidate positions of the search window
+    SizeValueType windowPosition[ ImageDimension ];
+    for ( unsigned d = 0; d < ImageDimension; d++ )
       {
+      windowPosition[ d ] = 0;
+      }
+    SizeValueType candidateOffset = 0;
+    for ( SizeValueType candidate = 0; candidate < numberOfCandidates; candidate++ )
+      {
+      const SimilaritiesValue *fixedBlock = &fixedBuffer[ candidateOffset ];
       SimilaritiesValue fixedSum = NumericTraits< SimilaritiesValue >::ZeroValue();
       SimilaritiesValue fixedSumOfSquares = NumericTraits< SimilaritiesValue >::ZeroValue();
-      SimilaritiesValue movingSum = NumericTraits< SimilaritiesValue >::ZeroValue();
-      SimilaritiesValue movingSumOfSquares = NumericTraits< SimilaritiesValue >::ZeroValue();
       SimilaritiesValue covariance = NumericTraits< SimilaritiesValue >::ZeroValue();
 
       // iterate over voxels in blockRadius
-      for ( SizeValueType i = 0; i < numberOfVoxelInBlock; i++ ) // windowIterator.Size() == numberOfVoxelInBlock
+      for ( SizeValueType i = 0; i < numberOfVoxelInBlock; i++ )
         {
-        const SimilaritiesValue fixedValue = windowIterator.GetPixel( i );
-        const SimilaritiesValue movingValue = centerIterator.GetPixel( i );
-        movingSum += movingValue;
+        const SimilaritiesValue fixedValue = fixedBlock[ blockOffsets[ i ] ];
         fixedSum += fixedValue;
-        movingSumOfSquares += movingValue * movingValue;
         fixedSumOfSquares += fixedValue * fixedValue;
-        covariance += fixedValue * movingValue;
+        covariance += fixedValue * movingBuffer[ i ];
         }
       const SimilaritiesValue fixedMean = fixedSum / numberOfVoxelInBlock;
-      const SimilaritiesValue movingMean = movingSum / numberOfVoxelInBlock;
       const SimilaritiesValue fixedVariance = fixedSumOfSquares - numberOfVoxelInBlock * fixedMean * fixedMean;
-      const SimilaritiesValue movingVariance = movingSumOfSquares - numberOfVoxelInBlock * movingMean * movingMean;
       covariance -= numberOfVoxelInBlock * fixedMean * movingMean;
 
       SimilaritiesValue sim = NumericTraits< SimilaritiesValue >::ZeroValue();
@@ -311,16 +367,69 @@ BlockMatchingImageFilter< TFixedImage, TMovingImage, TFeatures, TDisplacements,
         {
         sim = ( covariance * covariance ) / ( fixedVariance * movingVariance );
         }
+      if ( m_UseSubvoxelRefinement )
+        {
+        similarities[ candidate ] = sim;
+        }
 
       if ( sim >= similarity )
         {
-        FeaturePointsPhysicalCoordinates newLocation;
-        fixedImage->TransformIndexToPhysicalPoint( windowIterator.GetIndex(), newLocation );
-        displacement = newLocation - originalLocation;
+        bestCandidate = candidate;
         similarity = sim;
         }
+
+      // move to the next candidate in raster order
+      for ( unsigned d = 0; d < ImageDimension; d++ )
+        {
+        candidateOffset += bufferStride[ d ];
+        if ( ++windowPosition[ d ] < 2 * m_SearchRadius[ d ] + 1 )
+          {
+          break;
+          }
+        candidateOffset -= windowPosition[ d ] * bufferStride[ d ];
+        windowPosition[ d ] = 0;
+        }
+      }
+
+    // location of the best candidate
+    ImageIndexType bestIndex;
+    SizeValueType remaining = bestCandidate;
+    for ( unsigned d = 0; d < ImageDimension; d++ )
+      {
+      const SizeValueType windowSize = 2 * m_SearchRadius[ d ] + 1;
+      bestIndex[ d ] = fixedIndex[ d ] - static_cast< IndexValueType >( m_SearchRadius[ d ] )
+        + static_cast< IndexValueType >( remaining % windowSize );
+      remaining /= windowSize;
+      }
+
+    FeaturePointsPhysicalCoordinates newLocation;
+    if ( m_UseSubvoxelRefinement )
+      {
+      // parabolic interpolation of the similarity along each dimension
+      ContinuousIndex< SpacePrecisionType, ImageDimension > refinedIndex( bestIndex );
+      for ( unsigned d = 0; d < ImageDimension; d++ )
+        {
+        const IndexValueType position = bestIndex[ d ] - fixedIndex[ d ] + static_cast< IndexValueType >( m_SearchRadius[ d ] );
+        if ( position > 0 && position < static_cast< IndexValueType >( 2 * m_SearchRadius[ d ] ) )
+          {
+          const SimilaritiesValue previous = similarities[ bestCandidate - windowStride[ d ] ];
+          const SimilaritiesValue next = similarities[ bestCandidate + windowStride[ d ] ];
+          const SimilaritiesValue curvature = previous - 2 * similarity + next;
+          if ( curvature < NumericTraits< SimilaritiesValue >::ZeroValue() )
+            {
+            SpacePrecisionType shift = 0.5 * ( previous - next ) / curvature;
+            shift = std::max( -0.5, std::min( 0.5, shift ) );
+            refinedIndex[ d ] += shift;
+            }
+          }
+        }
+      fixedImage->TransformContinuousIndexToPhysicalPoint( refinedIndex, newLocation );
+      }
+    else
+      {
+      fixedImage->TransformIndexToPhysicalPoint( bestIndex, newLocation );
       }
-    this->m_DisplacementsVectorsArray[ idx ] = displacement;
+    this->m_DisplacementsVectorsArray[ idx ] = newLocation - originalLocation;
     this->m_SimilaritiesValuesArray[ idx ] = similarity;
     }
 }
@@ -278,6 +278,8 @@ HistogramImageToImageMetric< TFixedImage, TMovingImage >
   typename FixedImageType::IndexType index;
   typename FixedImageType::RegionType fixedRegion;
   typename HistogramType::IndexType hIndex;
+  typename HistogramType::MeasurementVectorType sample;
+  sample.SetSize(2);
 
   fixedRegion = this->GetFixedImageRegion();
   FixedIteratorType ti(fixedImage, fixedRegion);
@@ -323,13 +325,15 @@ HistogramImageToImageMetric< TFixedImage, TMovingImage >
         const RealType fixedValue = ti.Get();
         this->m_NumberOfPixelsCounted++;
 
-        typename HistogramType::MeasurementVectorType sample;
-        sample.SetSize(2);
         sample[0] = fixedValue;
         sample[1] = movingValue;
 
-        histogram.GetIndex( sample, hIndex );
-        histogram.IncreaseFrequencyOfIndex( hIndex, 1 );
+        // the histogram has equal width bins, so the bin of the sample is
+        // computed directly by GetIndex()
+        if ( histogram.GetIndex( sample, hIndex ) )
+          {
+          histogram.IncreaseFrequency( histogram.GetInstanceIdentifier( hIndex ), 1 );
+          }
         }
       }
 
@@ -22,10 +22,10 @@
 
 #include "itkPoint.h"
 #include "itkIntTypes.h"
-#include "itkKdTree.h"
-#include "itkKdTreeGenerator.h"
 #include "itkVectorContainer.h"
-#include "itkVectorContainerToListSampleAdaptor.h"
+#include "itkMultiThreader.h"
+
+#include <vector>
 
 namespace itk
 {
@@ -36,6 +36,22 @@ namespace itk
  * This class accelerates the search for the closest point to a user-provided
  * point, by using constructing a Kd-Tree structure for the PointSetContainer.
  *
+ * The tree is stored flattened: the nodes are kept in one array, the two
+ * children of a node next to each other, and the points are copied in
+ * bucket order so that the points of a leaf are contiguous in memory. Each
+ * node holds the bounding box of its points, which the searches use for
+ * pruning.
+ *
+ * Besides the single point queries, the k-nearest neighbors, closest point
+ * and radius searches accept a container of query points, which is split
+ * among NumberOfThreads threads. Each thread keeps its search buffers from
+ * one query to the next of the same call. The searches only read the
+ * locator, so they may be called concurrently once it is initialized.
+ *
+ * When only the positions of the points change, as in iterative point set
+ * registration, UpdatePointPositions() refits the bounding boxes of the
+ * existing tree instead of rebuilding it.
+ *
  * \ingroup ITKRegistrationCommon
  */
 template<
@@ -70,17 +86,8 @@ public:
   typedef typename PointsContainer::ConstIterator PointsContainerConstIterator;
   typedef typename PointsContainer::Iterator      PointsContainerIterator;
 
-  /** Type of the PointsContainer to List Adaptor. */
-  typedef Statistics::VectorContainerToListSampleAdaptor
-    <PointsContainer>                                   SampleAdaptorType;
-  typedef typename SampleAdaptorType::Pointer           SampleAdaptorPointer;
-
-  /** Types fo the KdTreeGenerator */
-  typedef Statistics::KdTreeGenerator<SampleAdaptorType>    TreeGeneratorType;
-  typedef typename TreeGeneratorType::Pointer               TreeGeneratorPointer;
-  typedef typename TreeGeneratorType::KdTreeType            TreeType;
-  typedef typename TreeType::ConstPointer                   TreeConstPointer;
-  typedef typename TreeType::InstanceIdentifierVectorType   NeighborsIdentifierType;
+  /** Type of the point ids returned by the searches. */
+  typedef std::vector< IdentifierType > NeighborsIdentifierType;
 
   /** Set/Get the points from which the bounding box should be computed. */
   itkSetObjectMacro( Points, PointsContainer );
@@ -88,9 +95,25 @@ public:
   /** Set/Get the points from which the bounding box should be computed. */
   itkGetModifiableObjectMacro(Points, PointsContainer );
 
+  /** Type of the results of the searches for several query points. */
+  typedef std::vector< PointIdentifier >         PointIdentifierVectorType;
+  typedef std::vector< NeighborsIdentifierType > NeighborsIdentifierVectorType;
+
+  /** Set/Get the number of threads used by the searches for several query
+   * points. */
+  itkSetClampMacro( NumberOfThreads, ThreadIdType, 1, ITK_MAX_THREADS );
+  itkGetConstMacro( NumberOfThreads, ThreadIdType );
+
   /** Compute the kd-tree that will facilitate the querying the points. */
   void Initialize();
 
+  /** Refit the kd-tree to the current positions of the points. The points
+   * container must hold the same point identifiers, in the same order, as
+   * when the tree was built; otherwise, or when the points moved so much
+   * that the refitted tree would be slow to search, the tree is rebuilt
+   * with Initialize(). */
+  void UpdatePointPositions();
+
   /** Find the closest point */
   PointIdentifier FindClosestPoint( const PointType &query ) const;
 
@@ -109,6 +132,22 @@ public:
   void FindPointsWithinRadius( const PointType &, double,
     NeighborsIdentifierType & ) const;
 
+  /** Find the closest point of each query point. The results are in the
+   * iteration order of the query points container. */
+  void FindClosestPoints( const PointsContainer *,
+    PointIdentifierVectorType & ) const;
+
+  /** Find the closest N points of each query point, sorted by increasing
+   * distance. The results are in the iteration order of the query points
+   * container, the vectors of identifiers are reused when possible. */
+  void FindClosestNPoints( const PointsContainer *, unsigned int,
+    NeighborsIdentifierVectorType & ) const;
+
+  /** Find all the points within a specified radius of each query point. The
+   * results are in the iteration order of the query points container. */
+  void FindPointsWithinRadius( const PointsContainer *, double,
+    NeighborsIdentifierVectorType & ) const;
+
 protected:
   PointsLocator();
   ~PointsLocator();
@@ -118,10 +157,93 @@ private:
   PointsLocator( const Self& ); //purposely not implemented
   void operator=( const Self& ); //purposely not implemented
 
+  /** Node of the flattened tree. A leaf has no children and owns the
+   * points [m_Begin, m_End) of m_FlatPoints; the children of a nonterminal
+   * node are at m_Left and m_Left + 1. */
+  struct FlatNode
+    {
+    PointType     m_Lower;
+    PointType     m_Upper;
+    SizeValueType m_Begin;
+    SizeValueType m_End;
+    SizeValueType m_Left;
+    };
+
+  typedef std::pair< double, SizeValueType > DistanceSlotPairType;
+
+  /** Buffers of a search, kept from one query to the next. */
+  struct SearchBuffers
+    {
+    std::vector< DistanceSlotPairType > m_Stack;
+    std::vector< DistanceSlotPairType > m_Heap;
+    NeighborsIdentifierType             m_Result;
+    };
+
+  /** Orders container positions by one coordinate of their points. */
+  struct CoordinateCompare
+    {
+    const std::vector< PointType > *Points;
+    unsigned int                    Dimension;
+
+    bool operator()( SizeValueType a, SizeValueType b ) const
+    {
+      return ( *Points )[a][Dimension] < ( *Points )[b][Dimension];
+    }
+    };
+
+  enum SearchModeType { ClosestPointSearch, ClosestNPointsSearch, RadiusSearch };
+
+  struct ThreadStruct
+    {
+    const Self *                     Locator;
+    const std::vector< PointType > * Queries;
+    SearchModeType                   Mode;
+    unsigned int                     NumberOfNeighbors;
+    double                           Radius;
+    PointIdentifierVectorType *      ClosestPoints;
+    NeighborsIdentifierVectorType *  Neighbors;
+    std::vector< SearchBuffers > *   Buffers;
+    };
+
+  static ITK_THREAD_RETURN_TYPE SearchThreaderCallback( void *arg );
+
+  void BuildSubtree( SizeValueType node, SizeValueType begin, SizeValueType end,
+    const std::vector< PointType > & points, std::vector< SizeValueType > & order );
+
+  /** Recompute the bounding boxes, children after parents in reverse. */
+  void ComputeBounds();
+
+  double SumOfLeafExtents() const;
+
+  double SquaredDistanceToNode( const PointType &, const FlatNode & ) const;
+
+  void SearchNeighbors( const PointType &, unsigned int,
+    SearchBuffers &, NeighborsIdentifierType & ) const;
+
+  void SearchRadius( const PointType &, double,
+    SearchBuffers &, NeighborsIdentifierType & ) const;
+
+  unsigned int CheckNumberOfNeighbors( unsigned int ) const;
+
+  void ExecuteSearch( const PointsContainer *, ThreadStruct & ) const;
+
+  /** Answer the queries [first, last) of a search. */
+  void SearchQueries( const ThreadStruct &, SizeValueType, SizeValueType,
+    SearchBuffers & ) const;
+
   PointsContainerPointer   m_Points;
-  SampleAdaptorPointer     m_SampleAdaptor;
-  TreeGeneratorPointer     m_KdTreeGenerator;
-  TreeConstPointer         m_Tree;
+
+  std::vector< FlatNode >        m_Nodes;
+  std::vector< PointType >       m_FlatPoints;
+  std::vector< PointIdentifier > m_FlatIdentifiers;
+
+  /** Position in m_FlatPoints of each point, in container order. */
+  std::vector< SizeValueType >   m_Slots;
+
+  /** Sum of the leaf box extents when the tree was built. */
+  double                         m_InitialLeafExtent;
+
+  ThreadIdType                   m_NumberOfThreads;
 };
 
 } // end namespace itk
@@ -19,15 +19,17 @@
 #define itkPointsLocator_hxx
 #include "itkPointsLocator.h"
 
+#include <algorithm>
+
 namespace itk
 {
 
 template<typename TPointsContainer>
 PointsLocator<TPointsContainer>
-::PointsLocator()
+::PointsLocator() :
+  m_InitialLeafExtent( 0.0 )
 {
-  this->m_SampleAdaptor = SampleAdaptorType::New();
-  this->m_KdTreeGenerator = TreeGeneratorType::New();
+  this->m_NumberOfThreads = MultiThreader::GetGlobalDefaultNumberOfThreads();
 }
 
 template<typename TPointsContainer>
@@ -50,21 +52,351 @@ PointsLocator<TPointsContainer>
     itkExceptionMacro( "The number of points is 0." );
     }
 
-  this->m_SampleAdaptor = SampleAdaptorType::New();
-  this->m_KdTreeGenerator = TreeGeneratorType::New();
+  const SizeValueType numberOfPoints = this->m_Points->Size();
+
+  std::vector< PointType >       points;
+  std::vector< PointIdentifier > identifiers;
+  std::vector< SizeValueType >   order;
+  points.reserve( numberOfPoints );
+  identifiers.reserve( numberOfPoints );
+  order.reserve( numberOfPoints );
+
+  for( PointsContainerConstIterator it = this->m_Points->Begin();
+    it != this->m_Points->End(); ++it )
+    {
+    order.push_back( static_cast< SizeValueType >( points.size() ) );
+    points.push_back( it.Value() );
+    identifiers.push_back( it.Index() );
+    }
+
+  this->m_Nodes.clear();
+  this->m_Nodes.push_back( FlatNode() );
+  this->BuildSubtree( 0, 0, numberOfPoints, points, order );
+
+  // Copy the points in bucket order.
+  this->m_FlatPoints.resize( numberOfPoints );
+  this->m_FlatIdentifiers.resize( numberOfPoints );
+  this->m_Slots.resize( numberOfPoints );
+  for( SizeValueType i = 0; i < numberOfPoints; ++i )
+    {
+    this->m_FlatPoints[i] = points[order[i]];
+    this->m_FlatIdentifiers[i] = identifiers[order[i]];
+    this->m_Slots[order[i]] = i;
+    }
+
+  this->ComputeBounds();
+  this->m_InitialLeafExtent = this->SumOfLeafExtents();
+}
+
+template<typename TPointsContainer>
+void
+PointsLocator<TPointsContainer>
+::BuildSubtree( SizeValueType node, SizeValueType begin, SizeValueType end,
+  const std::vector< PointType > & points, std::vector< SizeValueType > & order )
+{
+  const SizeValueType bucketSize = 16;
+
+  this->m_Nodes[node].m_Begin = begin;
+  this->m_Nodes[node].m_End = end;
+  this->m_Nodes[node].m_Left = 0;
+
+  if( end - begin <= bucketSize )
+    {
+    return;
+    }
+
+  // Split at the median of the dimension of largest extent.
+  PointType lower = points[order[begin]];
+  PointType upper = lower;
+  for( SizeValueType i = begin + 1; i < end; ++i )
+    {
+    const PointType & point = points[order[i]];
+    for( unsigned int d = 0; d < PointDimension; ++d )
+      {
+      lower[d] = std::min( lower[d], point[d] );
+      upper[d] = std::max( upper[d], point[d] );
+      }
+    }
+
+  CoordinateCompare compare;
+  compare.Points = &points;
+  compare.Dimension = 0;
+  for( unsigned int d = 1; d < PointDimension; ++d )
+    {
+    if( upper[d] - lower[d] > upper[compare.Dimension] - lower[compare.Dimension] )
+      {
+      compare.Dimension = d;
+      }
+    }
+
+  const SizeValueType middle = begin + ( end - begin ) / 2;
+  std::nth_element( order.begin() + begin, order.begin() + middle,
+    order.begin() + end, compare );
+
+  const SizeValueType left = static_cast< SizeValueType >( this->m_Nodes.size() );
+  this->m_Nodes.push_back( FlatNode() );
+  this->m_Nodes.push_back( FlatNode() );
+  this->m_Nodes[node].m_Left = left;
+
+  this->BuildSubtree( left, begin, middle, points, order );
+  this->BuildSubtree( left + 1, middle, end, points, order );
+}
+
+template<typename TPointsContainer>
+void
+PointsLocator<TPointsContainer>
+::ComputeBounds()
+{
+  for( SizeValueType n = this->m_Nodes.size(); n > 0; --n )
+    {
+    FlatNode & node = this->m_Nodes[n - 1];
+    if( node.m_Left == 0 )
+      {
+      node.m_Lower = this->m_FlatPoints[node.m_Begin];
+      node.m_Upper = node.m_Lower;
+      for( SizeValueType i = node.m_Begin + 1; i < node.m_End; ++i )
+        {
+        const PointType & point = this->m_FlatPoints[i];
+        for( unsigned int d = 0; d < PointDimension; ++d )
+          {
+          node.m_Lower[d] = std::min( node.m_Lower[d], point[d] );
+          node.m_Upper[d] = std::max( node.m_Upper[d], point[d] );
+          }
+        }
+      }
+    else
+      {
+      const FlatNode & left = this->m_Nodes[node.m_Left];
+      const FlatNode & right = this->m_Nodes[node.m_Left + 1];
+      for( unsigned int d = 0; d < PointDimension; ++d )
+        {
+        node.m_Lower[d] = std::min( left.m_Lower[d], right.m_Lower[d] );
+        node.m_Upper[d] = std::max( left.m_Upper[d], right.m_Upper[d] );
+        }
+      }
+    }
+}
+
+template<typename TPointsContainer>
+double
+PointsLocator<TPointsContainer>
+::SumOfLeafExtents() const
+{
+  double sum = 0.0;
+  for( SizeValueType n = 0; n < this->m_Nodes.size(); ++n )
+    {
+    const FlatNode & node = this->m_Nodes[n];
+    if( node.m_Left == 0 )
+      {
+      for( unsigned int d = 0; d < PointDimension; ++d )
+        {
+        sum += static_cast< double >( node.m_Upper[d] - node.m_Lower[d] );
+        }
+      }
+    }
+  return sum;
+}
+
+template<typename TPointsContainer>
+void
+PointsLocator<TPointsContainer>
+::UpdatePointPositions()
+{
+  if( !this->m_Points || this->m_Nodes.empty()
+    || this->m_Points->Size() != this->m_Slots.size() )
+    {
+    this->Initialize();
+    return;
+    }
+
+  SizeValueType position = 0;
+  for( PointsContainerConstIterator it = this->m_Points->Begin();
+    it != this->m_Points->End(); ++it, ++position )
+    {
+    const SizeValueType slot = this->m_Slots[position];
+    if( this->m_FlatIdentifiers[slot] != it.Index() )
+      {
+      this->Initialize();
+      return;
+      }
+    this->m_FlatPoints[slot] = it.Value();
+    }
+
+  this->ComputeBounds();
+
+  // Once the leaves overlap too much the searches visit many of them, a
+  // new partition is then cheaper.
+  if( this->SumOfLeafExtents() > 2.0 * this->m_InitialLeafExtent )
+    {
+    this->Initialize();
+    }
+}
+
+template<typename TPointsContainer>
+inline double
+PointsLocator<TPointsContainer>
+::SquaredDistanceToNode( const PointType &query, const FlatNode &node ) const
+{
+  double sum = 0.0;
+  for( unsigned int d = 0; d < PointDimension; ++d )
+    {
+    double delta = 0.0;
+    if( query[d] < node.m_Lower[d] )
+      {
+      delta = static_cast< double >( node.m_Lower[d] ) - query[d];
+      }
+    else if( query[d] > node.m_Upper[d] )
+      {
+      delta = static_cast< double >( query[d] ) - node.m_Upper[d];
+      }
+    sum += delta * delta;
+    }
+  return sum;
+}
+
+template<typename TPointsContainer>
+void
+PointsLocator<TPointsContainer>
+::SearchNeighbors( const PointType &query, unsigned int numberOfNeighbors,
+  SearchBuffers &buffers, NeighborsIdentifierType &identifiers ) const
+{
+  std::vector< DistanceSlotPairType > & stack = buffers.m_Stack;
+  std::vector< DistanceSlotPairType > & heap = buffers.m_Heap;
+  stack.clear();
+  heap.clear();
+
+  if( numberOfNeighbors > 0 )
+    {
+    stack.push_back( DistanceSlotPairType(
+      this->SquaredDistanceToNode( query, this->m_Nodes[0] ), 0 ) );
+    }
+
+  // The heap holds the best neighbors found so far, farthest on top. The
+  // nearer child is pushed last so that it is visited first.
+  while( !stack.empty() )
+    {
+    const DistanceSlotPairType top = stack.back();
+    stack.pop_back();
+    if( heap.size() == numberOfNeighbors && top.first >= heap.front().first )
+      {
+      continue;
+      }
+
+    const FlatNode & node = this->m_Nodes[top.second];
+    if( node.m_Left == 0 )
+      {
+      for( SizeValueType i = node.m_Begin; i < node.m_End; ++i )
+        {
+        double distance = 0.0;
+        for( unsigned int d = 0; d < PointDimension; ++d )
+          {
+          const double delta = static_cast< double >( this->m_FlatPoints[i][d] ) - query[d];
+          distance += delta * delta;
+          }
+        if( heap.size() < numberOfNeighbors )
+          {
+          heap.push_back( DistanceSlotPairType( distance, i ) );
+          std::push_heap( heap.begin(), heap.end() );
+          }
+        else if( distance < heap.front().first )
+          {
+          std::pop_heap( heap.begin(), heap.end() );
+          heap.back() = DistanceSlotPairType( distance, i );
+          std::push_heap( heap.begin(), heap.end() );
+          }
+        }
+      }
+    else
+      {
+      const double leftDistance = this->SquaredDistanceToNode( query, this->m_Nodes[node.m_Left] );
+      const double rightDistance = this->SquaredDistanceToNode( query, this->m_Nodes[node.m_Left + 1] );
+      if( leftDistance <= rightDistance )
+        {
+        stack.push_back( DistanceSlotPairType( rightDistance, node.m_Left + 1 ) );
+        stack.push_back( DistanceSlotPairType( leftDistance, node.m_Left ) );
+        }
+      else
+        {
+        stack.push_back( DistanceSlotPairType( leftDistance, node.m_Left ) );
+        stack.push_back( DistanceSlotPairType( rightDistance, node.m_Left + 1 ) );
+        }
+      }
+    }
+
+  std::sort_heap( heap.begin(), heap.end() );
+
+  identifiers.resize( heap.size() );
+  for( SizeValueType i = 0; i < heap.size(); ++i )
+    {
+    identifiers[i] = this->m_FlatIdentifiers[heap[i].second];
+    }
+}
+
+template<typename TPointsContainer>
+void
+PointsLocator<TPointsContainer>
+::SearchRadius( const PointType &query, double radius,
+  SearchBuffers &buffers, NeighborsIdentifierType &identifiers ) const
+{
+  std::vector< DistanceSlotPairType > & stack = buffers.m_Stack;
+  stack.clear();
+  identifiers.clear();
+
+  const double squaredRadius = radius * radius;
 
-  // Lack of const-correctness in the PointSetAdaptor should be fixed.
-  this->m_SampleAdaptor->SetVectorContainer(
-    const_cast<PointsContainer *>( this->m_Points.GetPointer() ) );
+  stack.push_back( DistanceSlotPairType(
+    this->SquaredDistanceToNode( query, this->m_Nodes[0] ), 0 ) );
 
-  this->m_SampleAdaptor->SetMeasurementVectorSize( PointDimension );
+  while( !stack.empty() )
+    {
+    const DistanceSlotPairType top = stack.back();
+    stack.pop_back();
+    if( top.first > squaredRadius )
+      {
+      continue;
+      }
 
-  this->m_KdTreeGenerator->SetSample( this->m_SampleAdaptor );
-  this->m_KdTreeGenerator->SetBucketSize( 16 );
+    const FlatNode & node = this->m_Nodes[top.second];
+    if( node.m_Left == 0 )
+      {
+      for( SizeValueType i = node.m_Begin; i < node.m_End; ++i )
+        {
+        double distance = 0.0;
+        for( unsigned int d = 0; d < PointDimension; ++d )
+          {
+          const double delta = static_cast< double >( this->m_FlatPoints[i][d] ) - query[d];
+          distance += delta * delta;
+          }
+        if( distance <= squaredRadius )
+          {
+          identifiers.push_back( this->m_FlatIdentifiers[i] );
+          }
+        }
+      }
+    else
+      {
+      stack.push_back( DistanceSlotPairType(
+        this->SquaredDistanceToNode( query, this->m_Nodes[node.m_Left] ), node.m_Left ) );
+      stack.push_back( DistanceSlotPairType(
+        this->SquaredDistanceToNode( query, this->m_Nodes[node.m_Left + 1] ), node.m_Left + 1 ) );
+      }
+    }
+}
 
-  this->m_KdTreeGenerator->Update();
+template<typename TPointsContainer>
+unsigned int
+PointsLocator<TPointsContainer>
+::CheckNumberOfNeighbors( unsigned int numberOfNeighborsRequested ) const
+{
+  unsigned int N = numberOfNeighborsRequested;
+  if( N > this->m_FlatPoints.size() )
+    {
+    N = static_cast< unsigned int >( this->m_FlatPoints.size() );
 
-  this->m_Tree = this->m_KdTreeGenerator->GetOutput();
+    itkWarningMacro( "The number of requested neighbors is greater than the "
+     << "total number of points.  Only returning " << N << " points." );
+    }
+  return N;
 }
 
 template<typename TPointsContainer>
@@ -73,10 +405,10 @@ typename PointsLocator<TPointsContainer>
 PointsLocator<TPointsContainer>
 ::FindClosestPoint( const PointType &query ) const
 {
-  NeighborsIdentifierType identifiers;
-  this->m_Tree->Search( query, 1u, identifiers );
+  SearchBuffers buffers;
+  this->SearchNeighbors( query, 1u, buffers, buffers.m_Result );
 
-  return identifiers[0];
+  return buffers.m_Result[0];
 }
 
 template<
@@ -86,15 +418,9 @@ PointsLocator<TPointsContainer>
 ::Search( const PointType &query, unsigned int numberOfNeighborsRequested,
   NeighborsIdentifierType &identifiers ) const
 {
-  unsigned int N = numberOfNeighborsRequested;
-  if( N > this->m_Points->Size() )
-    {
-    N = this->m_Points->Size();
-
-    itkWarningMacro( "The number of requested neighbors is greater than the "
-     << "total number of points.  Only returning " << N << " points." );
-    }
-  this->m_Tree->Search( query, N, identifiers );
+  SearchBuffers buffers;
+  this->SearchNeighbors( query, this->CheckNumberOfNeighbors( numberOfNeighborsRequested ),
+    buffers, identifiers );
 }
 
 template<
@@ -104,15 +430,9 @@ PointsLocator<TPointsContainer>
 ::FindClosestNPoints( const PointType &query, unsigned int
   numberOfNeighborsRequested, NeighborsIdentifierType &identifiers ) const
 {
-  unsigned int N = numberOfNeighborsRequested;
-  if( N > this->m_Points->Size() )
-    {
-    N = this->m_Points->Size();
-
-    itkWarningMacro( "The number of requested neighbors is greater than the "
-     << "total number of points.  Only returning " << N << " points." );
-    }
-  this->m_Tree->Search( query, N, identifiers );
+  SearchBuffers buffers;
+  this->SearchNeighbors( query, this->CheckNumberOfNeighbors( numberOfNeighborsRequested ),
+    buffers, identifiers );
 }
 
 template<
@@ -122,7 +442,8 @@ PointsLocator<TPointsContainer>
 ::Search( const PointType &query, double radius,
   NeighborsIdentifierType &identifiers ) const
 {
-  this->m_Tree->Search( query, radius, identifiers );
+  SearchBuffers buffers;
+  this->SearchRadius( query, radius, buffers, identifiers );
 }
 
 template<
@@ -132,7 +453,155 @@ PointsLocator<TPointsContainer>
 ::FindPointsWithinRadius( const PointType &query, double radius,
   NeighborsIdentifierType &identifiers ) const
 {
-  this->m_Tree->Search( query, radius, identifiers );
+  SearchBuffers buffers;
+  this->SearchRadius( query, radius, buffers, identifiers );
+}
+
+template<
+  typename TPointsContainer>
+void
+PointsLocator<TPointsContainer>
+::FindClosestPoints( const PointsContainer *queries,
+  PointIdentifierVectorType &identifiers ) const
+{
+  identifiers.resize( queries->Size() );
+
+  ThreadStruct str;
+  str.Mode = ClosestPointSearch;
+  str.NumberOfNeighbors = 1;
+  str.Radius = 0.0;
+  str.ClosestPoints = &identifiers;
+  str.Neighbors = ITK_NULLPTR;
+  this->ExecuteSearch( queries, str );
+}
+
+template<
+  typename TPointsContainer>
+void
+PointsLocator<TPointsContainer>
+::FindClosestNPoints( const PointsContainer *queries, unsigned int
+  numberOfNeighborsRequested, NeighborsIdentifierVectorType &identifiers ) const
+{
+  identifiers.resize( queries->Size() );
+
+  ThreadStruct str;
+  str.Mode = ClosestNPointsSearch;
+  str.NumberOfNeighbors = this->CheckNumberOfNeighbors( numberOfNeighborsRequested );
+  str.Radius = 0.0;
+  str.ClosestPoints = ITK_NULLPTR;
+  str.Neighbors = &identifiers;
+  this->ExecuteSearch( queries, str );
+}
+
+template<
+  typename TPointsContainer>
+void
+PointsLocator<TPointsContainer>
+::FindPointsWithinRadius( const PointsContainer *queries, double radius,
+  NeighborsIdentifierVectorType &identifiers ) const
+{
+  identifiers.resize( queries->Size() );
+
+  ThreadStruct str;
+  str.Mode = RadiusSearch;
+  str.NumberOfNeighbors = 0;
+  str.Radius = radius;
+  str.ClosestPoints = ITK_NULLPTR;
+  str.Neighbors = &identifiers;
+  this->ExecuteSearch( queries, str );
+}
+
+template<
+  typename TPointsContainer>
+void
+PointsLocator<TPointsContainer>
+::ExecuteSearch( const PointsContainer *queries, ThreadStruct &str ) const
+{
+  std::vector< PointType > points;
+  points.reserve( queries->Size() );
+  for( PointsContainerConstIterator it = queries->Begin(); it != queries->End(); ++it )
+    {
+    points.push_back( it.Value() );
+    }
+  if( points.empty() )
+    {
+    return;
+    }
+
+  str.Locator = this;
+  str.Queries = &points;
+
+  ThreadIdType numberOfThreads = this->m_NumberOfThreads;
+  if( static_cast< SizeValueType >( numberOfThreads ) > points.size() )
+    {
+    numberOfThreads = static_cast< ThreadIdType >( points.size() );
+    }
+
+  // The threader and the buffers belong to this call so that concurrent
+  // searches do not share them.
+  std::vector< SearchBuffers > buffers( numberOfThreads );
+  str.Buffers = &buffers;
+
+  if( numberOfThreads == 1 )
+    {
+    this->SearchQueries( str, 0, points.size(), buffers[0] );
+    return;
+    }
+
+  MultiThreader::Pointer threader = MultiThreader::New();
+  threader->SetNumberOfThreads( numberOfThreads );
+  threader->SetSingleMethod( Self::SearchThreaderCallback, &str );
+  threader->SingleMethodExecute();
+}
+
+template<
+  typename TPointsContainer>
+ITK_THREAD_RETURN_TYPE
+PointsLocator<TPointsContainer>
+::SearchThreaderCallback( void *arg )
+{
+  typedef MultiThreader::ThreadInfoStruct ThreadInfoType;
+  ThreadInfoType *info = static_cast< ThreadInfoType * >( arg );
+  ThreadStruct *  str = static_cast< ThreadStruct * >( info->UserData );
+
+  const SizeValueType numberOfQueries = str->Queries->size();
+  const SizeValueType numberOfThreads = info->NumberOfThreads;
+  const SizeValueType threadId = info->ThreadID;
+
+  const SizeValueType first = numberOfQueries / numberOfThreads * threadId
+                              + std::min( threadId, numberOfQueries % numberOfThreads );
+  const SizeValueType last = first + numberOfQueries / numberOfThreads
+                             + ( threadId < numberOfQueries % numberOfThreads ? 1 : 0 );
+
+  str->Locator->SearchQueries( *str, first, last, ( *str->Buffers )[threadId] );
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+template<
+  typename TPointsContainer>
+void
+PointsLocator<TPointsContainer>
+::SearchQueries( const ThreadStruct &str, SizeValueType first, SizeValueType last,
+  SearchBuffers &buffers ) const
+{
+  for( SizeValueType i = first; i < last; ++i )
+    {
+    const PointType & query = ( *str.Queries )[i];
+    switch( str.Mode )
+      {
+      case ClosestPointSearch:
+        this->SearchNeighbors( query, 1u, buffers, buffers.m_Result );
+        ( *str.ClosestPoints )[i] = buffers.m_Result[0];
+        break;
+      case ClosestNPointsSearch:
+        this->SearchNeighbors( query, str.NumberOfNeighbors, buffers, ( *str.Neighbors )[i] );
+        break;
+      case RadiusSearch:
+        this->SearchRadius( query, str.Radius, buffers, ( *str.Neighbors )[i] );
+        break;
+      }
+    }
 }
 
 /**
@@ -145,6 +614,8 @@ PointsLocator<TPointsContainer>
 ::PrintSelf( std::ostream& os, Indent indent ) const
 {
   Superclass::PrintSelf( os, indent );
+  os << indent << "NumberOfThreads: " << this->m_NumberOfThreads << std::endl;
+  os << indent << "Number of tree nodes: " << this->m_Nodes.size() << std::endl;
 }
 
 } // end namespace itk
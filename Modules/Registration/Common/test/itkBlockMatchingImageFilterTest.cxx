@@ -33,6 +33,129 @@
 #include "itkScalarToRGBColormapImageFilter.h"
 #include "itkTranslationTransform.h"
 #include "itkResampleImageFilter.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+
+// Match a smooth texture against a copy of itself translated by a known
+// sub-voxel shift, and check that the refined displacements differ from the
+// integer ones and are closer to the shift.
+static int BlockMatchingSubvoxelRefinementTest()
+{
+  static const unsigned int Dimension = 3;
+  typedef itk::Image< float, Dimension >                          ImageType;
+  typedef itk::BlockMatchingImageFilter< ImageType >              BlockMatchingFilterType;
+  typedef BlockMatchingFilterType::FeaturePointsType              PointSetType;
+  typedef BlockMatchingFilterType::DisplacementsType              DisplacementsType;
+  typedef itk::ImageRegionIteratorWithIndex< ImageType >          IteratorType;
+
+  ImageType::SizeType size;
+  size.Fill( 32 );
+  ImageType::RegionType region( size );
+
+  // texture made of random blobs
+  typedef itk::Statistics::MersenneTwisterRandomVariateGenerator GeneratorType;
+  GeneratorType::Pointer generator = GeneratorType::New();
+  generator->Initialize( 1234 );
+  const unsigned int numberOfBlobs = 400;
+  const double sigma = 1.5;
+  std::vector< double > blobs( numberOfBlobs * Dimension );
+  for ( unsigned int i = 0; i < blobs.size(); ++i )
+    {
+    blobs[i] = generator->GetUniformVariate( 0.0, 32.0 );
+    }
+  double shift[Dimension] = { 1.3, -0.6, 0.4 };
+
+  // the fixed image is the moving image translated by shift
+  ImageType::Pointer images[2];
+  for ( unsigned int n = 0; n < 2; ++n )
+    {
+    images[n] = ImageType::New();
+    images[n]->SetRegions( region );
+    images[n]->Allocate();
+    for ( IteratorType it( images[n], region ); !it.IsAtEnd(); ++it )
+      {
+      double value = 0.0;
+      for ( unsigned int b = 0; b < numberOfBlobs; ++b )
+        {
+        double squaredDistance = 0.0;
+        for ( unsigned int d = 0; d < Dimension; ++d )
+          {
+          const double x = it.GetIndex()[d] + ( n == 0 ? shift[d] : 0.0 ) - blobs[b * Dimension + d];
+          squaredDistance += x * x;
+          }
+        value += std::exp( -squaredDistance / ( 2.0 * sigma * sigma ) );
+        }
+      it.Set( 100.0 * value );
+      }
+    }
+
+  // feature points around the center of the image
+  PointSetType::Pointer featurePoints = PointSetType::New();
+  const double pointOffsets[6][Dimension] = { { 4, 0, 0 }, { -4, 0, 0 }, { 0, 4, 0 },
+                                              { 0, -4, 0 }, { 0, 0, 4 }, { 3, 3, -3 } };
+  for ( unsigned int i = 0; i < 6; ++i )
+    {
+    PointSetType::PointType point;
+    for ( unsigned int d = 0; d < Dimension; ++d )
+      {
+      point[d] = 16.0 + pointOffsets[i][d];
+      }
+    featurePoints->SetPoint( i, point );
+    }
+
+  BlockMatchingFilterType::Pointer blockMatchingFilter = BlockMatchingFilterType::New();
+  blockMatchingFilter->SetFixedImage( images[0] );
+  blockMatchingFilter->SetMovingImage( images[1] );
+  blockMatchingFilter->SetFeaturePoints( featurePoints );
+  ImageType::SizeType blockRadius;
+  blockRadius.Fill( 2 );
+  blockMatchingFilter->SetBlockRadius( blockRadius );
+  ImageType::SizeType searchRadius;
+  searchRadius.Fill( 3 );
+  blockMatchingFilter->SetSearchRadius( searchRadius );
+
+  DisplacementsType::PointDataContainer::Pointer integerDisplacements;
+  DisplacementsType::PointDataContainer::Pointer refinedDisplacements;
+  try
+    {
+    blockMatchingFilter->Update();
+    integerDisplacements = blockMatchingFilter->GetDisplacements()->GetPointData();
+    blockMatchingFilter->UseSubvoxelRefinementOn();
+    blockMatchingFilter->Update();
+    refinedDisplacements = blockMatchingFilter->GetDisplacements()->GetPointData();
+    }
+  catch ( itk::ExceptionObject &err )
+    {
+    std::cerr << err << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // the block at p in the moving image matches the block at p - shift in
+  // the fixed image
+  for ( itk::SizeValueType i = 0; i < featurePoints->GetNumberOfPoints(); ++i )
+    {
+    double integerError = 0.0;
+    double refinedError = 0.0;
+    bool refined = false;
+    for ( unsigned int d = 0; d < Dimension; ++d )
+      {
+      const double integerValue = integerDisplacements->GetElement( i )[d];
+      const double refinedValue = refinedDisplacements->GetElement( i )[d];
+      integerError += vnl_math_sqr( integerValue + shift[d] );
+      refinedError += vnl_math_sqr( refinedValue + shift[d] );
+      refined |= ( refinedValue != integerValue );
+      }
+    std::cout << "Point " << i << ": integer displacement " << integerDisplacements->GetElement( i )
+              << " (error " << std::sqrt( integerError ) << "), refined displacement "
+              << refinedDisplacements->GetElement( i ) << " (error " << std::sqrt( refinedError ) << ")" << std::endl;
+    if ( !refined || refinedError >= integerError )
+      {
+      std::cerr << "Sub-voxel refinement did not improve the displacement of point " << i << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  return EXIT_SUCCESS;
+}
 
 
 int itkBlockMatchingImageFilterTest( int argc, char * argv[] )
@@ -244,5 +367,44 @@ int itkBlockMatchingImageFilterTest( int argc, char * argv[] )
     return EXIT_FAILURE;
     }
 
-  return EXIT_SUCCESS;
+  // Sub-voxel refinement must stay within half a voxel of the integer
+  // displacements and must not change the similarities
+  typedef BlockMatchingFilterType::DisplacementsType::PointDataContainer  DisplacementsContainerType;
+  typedef BlockMatchingFilterType::SimilaritiesType::PointDataContainer   SimilaritiesContainerType;
+  DisplacementsContainerType::Pointer integerDisplacements = displacements->GetPointData();
+  SimilaritiesContainerType::Pointer integerSimilarities = similarities->GetPointData();
+
+  blockMatchingFilter->UseSubvoxelRefinementOn();
+  try
+    {
+    blockMatchingFilter->Update();
+    }
+  catch ( itk::ExceptionObject &err )
+    {
+    std::cerr << err << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  const InputImageType::SpacingType spacing = reader->GetOutput()->GetSpacing();
+  DisplacementsContainerType::ConstPointer refinedDisplacements = blockMatchingFilter->GetDisplacements()->GetPointData();
+  SimilaritiesContainerType::ConstPointer refinedSimilarities = blockMatchingFilter->GetSimilarities()->GetPointData();
+  for ( itk::SizeValueType i = 0; i < integerDisplacements->Size(); ++i )
+    {
+    if ( refinedSimilarities->GetElement( i ) != integerSimilarities->GetElement( i ) )
+      {
+      std::cerr << "Sub-voxel refinement changed the similarity of point " << i << std::endl;
+      return EXIT_FAILURE;
+      }
+    for ( unsigned int d = 0; d < Dimension; ++d )
+      {
+      const double difference = refinedDisplacements->GetElement( i )[d] - integerDisplacements->GetElement( i )[d];
+      if ( std::fabs( difference ) > 0.5 * spacing[d] + 1e-6 )
+        {
+        std::cerr << "Sub-voxel refinement of point " << i << " moved by " << difference << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+    }
+
+  return BlockMatchingSubvoxelRefinementTest();
 }
@@ -19,6 +19,88 @@
 #include "itkPointsLocator.h"
 #include "itkMapContainer.h"
 
+#include <algorithm>
+
+namespace
+{
+double SquaredDistance( const itk::Point<float, 3> & a, const itk::Point<float, 3> & b )
+{
+  double distance = 0.0;
+  for( unsigned int d = 0; d < 3; ++d )
+    {
+    const double delta = static_cast<double>( a[d] ) - b[d];
+    distance += delta * delta;
+    }
+  return distance;
+}
+
+// Compare the searches for several query points with an exhaustive search.
+template< typename TLocator, typename TPointsContainer >
+bool CompareWithBruteForce( const TLocator * locator, const TPointsContainer * points,
+  const TPointsContainer * queries, unsigned int numberOfNeighbors, double radius )
+{
+  typename TLocator::PointIdentifierVectorType     closestPoints;
+  typename TLocator::NeighborsIdentifierVectorType neighborhoods;
+  typename TLocator::NeighborsIdentifierVectorType radiusNeighborhoods;
+
+  locator->FindClosestPoints( queries, closestPoints );
+  locator->FindClosestNPoints( queries, numberOfNeighbors, neighborhoods );
+  locator->FindPointsWithinRadius( queries, radius, radiusNeighborhoods );
+
+  typedef std::pair< double, typename TLocator::PointIdentifier > DistanceIdentifierPairType;
+  std::vector< DistanceIdentifierPairType > distances;
+
+  unsigned int q = 0;
+  for( typename TPointsContainer::ConstIterator qIt = queries->Begin(); qIt != queries->End(); ++qIt, ++q )
+    {
+    distances.clear();
+    std::vector< typename TLocator::PointIdentifier > withinRadius;
+    for( typename TPointsContainer::ConstIterator pIt = points->Begin(); pIt != points->End(); ++pIt )
+      {
+      const double distance = SquaredDistance( pIt.Value(), qIt.Value() );
+      distances.push_back( DistanceIdentifierPairType( distance, pIt.Index() ) );
+      if( distance <= radius * radius )
+        {
+        withinRadius.push_back( pIt.Index() );
+        }
+      }
+    std::sort( distances.begin(), distances.end() );
+
+    if( SquaredDistance( points->ElementAt( closestPoints[q] ), qIt.Value() ) != distances[0].first )
+      {
+      std::cerr << "FindClosestPoints() differs from the exhaustive search for query " << q << std::endl;
+      return false;
+      }
+
+    if( neighborhoods[q].size() != numberOfNeighbors )
+      {
+      std::cerr << "FindClosestNPoints() found " << neighborhoods[q].size() << " points for query " << q << std::endl;
+      return false;
+      }
+    for( unsigned int k = 0; k < numberOfNeighbors; ++k )
+      {
+      if( SquaredDistance( points->ElementAt( neighborhoods[q][k] ), qIt.Value() ) != distances[k].first )
+        {
+        std::cerr << "FindClosestNPoints() differs from the exhaustive search for query " << q
+                  << " at neighbor " << k << std::endl;
+        return false;
+        }
+      }
+
+    std::vector< typename TLocator::PointIdentifier > found( radiusNeighborhoods[q].begin(),
+      radiusNeighborhoods[q].end() );
+    std::sort( found.begin(), found.end() );
+    std::sort( withinRadius.begin(), withinRadius.end() );
+    if( found != withinRadius )
+      {
+      std::cerr << "FindPointsWithinRadius() differs from the exhaustive search for query " << q << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+}
+
 template< typename TPointsContainer >
 int testPointsLocatorTest()
 {
@@ -110,6 +192,134 @@ int testPointsLocatorTest()
     return EXIT_FAILURE;
     }
 
+  /**
+   * Search for several query points at once.
+   */
+  typename PointsContainerType::Pointer queries = PointsContainerType::New();
+  for( unsigned int i = 0; i < 20; ++i )
+    {
+    PointType query;
+    query.Fill( static_cast<float>( 5 * i ) + 0.75f );
+    queries->InsertElement( i, query );
+    }
+
+  std::cout << "Test:  FindClosestPoints() for several points" << std::endl;
+
+  typename PointsLocatorType::PointIdentifierVectorType closestPoints;
+  pointsLocator->SetNumberOfThreads( 3 );
+  pointsLocator->FindClosestPoints( queries, closestPoints );
+  if( closestPoints.size() != queries->Size() )
+    {
+    std::cerr << "Error with FindClosestPoints() for several points" << std::endl;
+    return EXIT_FAILURE;
+    }
+  for( unsigned int i = 0; i < queries->Size(); ++i )
+    {
+    if( closestPoints[i] != pointsLocator->FindClosestPoint( queries->ElementAt( i ) ) )
+      {
+      std::cerr << "Error with FindClosestPoints() for query " << i << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  std::cout << "Test:  FindClosestNPoints() for several points" << std::endl;
+
+  typename PointsLocatorType::NeighborsIdentifierVectorType neighborhoods;
+  pointsLocator->FindClosestNPoints( queries, 10u, neighborhoods );
+  for( unsigned int i = 0; i < queries->Size(); ++i )
+    {
+    pointsLocator->FindClosestNPoints( queries->ElementAt( i ), 10u, neighborhood );
+    if( neighborhoods[i] != neighborhood )
+      {
+      std::cerr << "Error with FindClosestNPoints() for query " << i << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  std::cout << "Test:  FindPointsWithinRadius() for several points" << std::endl;
+
+  pointsLocator->FindPointsWithinRadius( queries, radius, neighborhoods );
+  for( unsigned int i = 0; i < queries->Size(); ++i )
+    {
+    pointsLocator->FindPointsWithinRadius( queries->ElementAt( i ), radius, neighborhood );
+    if( neighborhoods[i].size() != neighborhood.size() )
+      {
+      std::cerr << "Error with FindPointsWithinRadius() for query " << i << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  /**
+   * Move the points and refit the tree.
+   */
+  std::cout << "Test:  UpdatePointPositions()" << std::endl;
+
+  for( unsigned int i = 1; i <= 100; ++i )
+    {
+    PointType & point = points->ElementAt( i - 1 );
+    point[0] += 0.25f * static_cast<float>( i % 3 );
+    point[1] -= 0.25f * static_cast<float>( i % 2 );
+    }
+  pointsLocator->UpdatePointPositions();
+
+  coords[0] = 20.6;
+  coords[1] = 20;
+  coords[2] = 20;
+  pointId = pointsLocator->FindClosestPoint( coords );
+  if( pointId != 19 )
+    {
+    std::cerr << "Error with UpdatePointPositions()" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  /**
+   * Compare with an exhaustive search on scattered points, before and after
+   * moving them.
+   */
+  std::cout << "Test:  exhaustive search" << std::endl;
+
+  unsigned int seed = 12345;
+  points->Initialize();
+  for( unsigned int i = 0; i < 2000; ++i )
+    {
+    PointType point;
+    for( unsigned int d = 0; d < PointDimension; ++d )
+      {
+      seed = seed * 1103515245u + 12345u;
+      point[d] = static_cast<float>( ( seed >> 8 ) % 10000 ) / 100.0f;
+      }
+    points->InsertElement( i, point );
+    }
+  queries->Initialize();
+  for( unsigned int i = 0; i < 200; ++i )
+    {
+    PointType query;
+    for( unsigned int d = 0; d < PointDimension; ++d )
+      {
+      seed = seed * 1103515245u + 12345u;
+      query[d] = static_cast<float>( ( seed >> 8 ) % 12000 ) / 100.0f - 10.0f;
+      }
+    queries->InsertElement( i, query );
+    }
+
+  pointsLocator->SetNumberOfThreads( 4 );
+  pointsLocator->Initialize();
+  if( !CompareWithBruteForce( pointsLocator.GetPointer(), points.GetPointer(), queries.GetPointer(), 7u, 9.0 ) )
+    {
+    return EXIT_FAILURE;
+    }
+
+  for( typename PointsContainerType::Iterator it = points->Begin(); it != points->End(); ++it )
+    {
+    seed = seed * 1103515245u + 12345u;
+    it.Value()[seed % PointDimension] += static_cast<float>( ( seed >> 8 ) % 300 ) / 100.0f;
+    }
+  pointsLocator->UpdatePointPositions();
+  if( !CompareWithBruteForce( pointsLocator.GetPointer(), points.GetPointer(), queries.GetPointer(), 7u, 9.0 ) )
+    {
+    return EXIT_FAILURE;
+    }
+
   return EXIT_SUCCESS;
 }
 
@@ -24,6 +24,7 @@
 #include "itkConstNeighborhoodIterator.h"
 
 #include <deque>
+#include <vector>
 
 namespace itk
 {
@@ -45,6 +46,13 @@ struct IdentityHelper
  * its derivative incrementally inside the window. The sparse threader uses a sampled point set partitioner to
  * computer local cross correlation only at the sampled positions.
  *
+ * When scanning, each new hyperplane of the window needs the fixed and moving
+ * values of (2*radius+1)^(Dimension-1) voxels. The dense threader caches
+ * these values for a ring of 2*radius+1 slices along the last dimension of
+ * its region, so that the images are evaluated once per voxel rather than
+ * once per window that contains the voxel. The cached values are summed in
+ * the same order as without the cache.
+ *
  * This threader class is designed to host the dense and sparse threader under the same name so most computation
  * routine functions and interior member variables can be shared. This eliminates the need to duplicate codes
  * for two threaders. This is made by using function overloading and a helper class to identify different types of domain
@@ -125,6 +133,19 @@ public:
     FixedImagePointType     mappedFixedPoint;
     MovingImagePointType    mappedMovingPoint;
     VirtualPointType        virtualPoint;
+
+    // cache of the fixed and moving values over a ring of slices along
+    // the last dimension, used by the dense threader only
+    bool                                useValueCache;
+    ImageRegionType                     cacheRegion;
+    SizeValueType                       cacheSliceSize;
+    std::vector< FixedImagePixelType >  cachedFixedValues;
+    std::vector< MovingImagePixelType > cachedMovingValues;
+    std::vector< unsigned char >        cachedValidity;
+    std::vector< IndexValueType >       cachedSliceIndex;
+    // offsets of the voxels of a hyperplane of the window, in the order of
+    // the neighborhood iterator
+    std::vector< typename VirtualImageType::OffsetType > hyperplaneOffsets;
   } ScanMemType;
 
   // For dense scan over one image region
@@ -249,6 +270,25 @@ protected:
     ScanIteratorType &scanIt, ScanMemType &scanMem,
     ScanParametersType &scanParameters ) const;
 
+  /** Allocate the cache of the fixed and moving values over the scan region
+   * padded by the radius. Used by the dense threader only. */
+  void InitializeValueCache( ScanMemType &scanMem,
+    const ScanParametersType &scanParameters ) const;
+
+  /** Get the fixed and moving values at a virtual index from the cache.
+   * Returns false if the point is outside of the cached region or is not
+   * valid. */
+  bool GetCachedFixedAndMovingValues( const VirtualIndexType &index,
+    ScanMemType &scanMem, const ScanParametersType &scanParameters,
+    FixedImagePixelType &fixedImageValue,
+    MovingImagePixelType &movingImageValue ) const;
+
+  /** Transform the virtual index and evaluate the fixed and moving images.
+   * Returns false if the point is not valid. */
+  bool EvaluateFixedAndMovingValues( const VirtualIndexType &index,
+    FixedImagePixelType &fixedImageValue,
+    MovingImagePixelType &movingImageValue ) const;
+
   /** Update the queues for the next point.  Calls either \c
    * UpdateQueuesAtBeginningOfLine or \c UpdateQueuesToNextScanWindow. */
   void UpdateQueues(const ScanIteratorType &scanIt,
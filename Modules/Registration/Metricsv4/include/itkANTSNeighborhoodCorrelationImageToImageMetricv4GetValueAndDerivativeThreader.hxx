@@ -19,6 +19,8 @@
 #define itkANTSNeighborhoodCorrelationImageToImageMetricv4GetValueAndDerivativeThreader_hxx
 
 #include "itkANTSNeighborhoodCorrelationImageToImageMetricv4GetValueAndDerivativeThreader.h"
+#include "itkImageRegionConstIteratorWithOnlyIndex.h"
+#include <algorithm>
 
 namespace itk
 {
@@ -51,6 +53,7 @@ ANTSNeighborhoodCorrelationImageToImageMetricv4GetValueAndDerivativeThreader< TD
   /* Create an iterator over the virtual sub region */
   // this->m_ANTSAssociate->InitializeScanning( virtualImageSubRegion, scanIt, scanMem, scanParameters );
   this->InitializeScanning( virtualImageSubRegion, scanIt, scanMem, scanParameters );
+  this->InitializeValueCache( scanMem, scanParameters );
 
   /* Iterate over the sub region */
   scanIt.GoToBegin();
@@ -151,45 +154,32 @@ ANTSNeighborhoodCorrelationImageToImageMetricv4GetValueAndDerivativeThreader< TD
      LocalRealType sumFixedMoving = localZero;
      LocalRealType count = localZero;
 
-     for ( SizeValueType indct = i; indct < hoodlen; indct += ( diameter + NumericTraits<SizeValueType>::OneValue() ) )
-       {
-       typename ScanIteratorType::OffsetType internalIndex, offset;
-       bool isInBounds = scanIt.IndexInBounds( indct, internalIndex, offset );
-       if (!isInBounds)
-         {
-         // std::cout << "DEBUG: error" << std::endl;
-         continue;
-         }
+     typename VirtualImageType::IndexType hyperplaneIndex = scanIt.GetIndex();
+     hyperplaneIndex[0] += static_cast< OffsetValueType >( i ) - static_cast< OffsetValueType >( scanParameters.radius[0] );
 
-       typename VirtualImageType::IndexType index = scanIt.GetIndex(indct);
-
-       VirtualPointType        virtualPoint;
-       FixedImagePointType     mappedFixedPoint;
+     SizeValueType hyperplaneVoxel = 0;
+     for ( SizeValueType indct = i; indct < hoodlen; indct += ( diameter + NumericTraits<SizeValueType>::OneValue() ), hyperplaneVoxel++ )
+       {
        FixedImagePixelType     fixedImageValue;
-       MovingImagePointType    mappedMovingPoint;
        MovingImagePixelType    movingImageValue;
        bool pointIsValid;
 
-       this->m_ANTSAssociate->TransformVirtualIndexToPhysicalPoint(index, virtualPoint);
-
-       try
+       if ( scanMem.useValueCache )
          {
-         pointIsValid = this->m_ANTSAssociate->TransformAndEvaluateFixedPoint( virtualPoint, mappedFixedPoint, fixedImageValue );
-         if ( pointIsValid )
-           {
-           pointIsValid = this->m_ANTSAssociate->TransformAndEvaluateMovingPoint( virtualPoint, mappedMovingPoint, movingImageValue );
-           }
+         pointIsValid = this->GetCachedFixedAndMovingValues( hyperplaneIndex + scanMem.hyperplaneOffsets[hyperplaneVoxel],
+           scanMem, scanParameters, fixedImageValue, movingImageValue );
          }
-       catch (ExceptionObject & exc)
+       else
          {
-         //NOTE: there must be a cleaner way to do this:
-         std::string msg("Caught exception: \n");
-         msg += exc.what();
-         ExceptionObject err(__FILE__, __LINE__, msg);
-         throw err;
+         typename ScanIteratorType::OffsetType internalIndex, offset;
+         bool isInBounds = scanIt.IndexInBounds( indct, internalIndex, offset );
+         if (!isInBounds)
+           {
+           continue;
+           }
+         pointIsValid = this->EvaluateFixedAndMovingValues( scanIt.GetIndex(indct), fixedImageValue, movingImageValue );
          }
 
-
        if ( pointIsValid )
          {
          sumFixed2 += fixedImageValue  * fixedImageValue;
@@ -230,43 +220,32 @@ template < typename TDomainPartitioner, typename TImageToImageMetric, typename T
 
  SizeValueType diameter = 2 * scanParameters.radius[0];
 
- for ( SizeValueType indct = diameter; indct < hoodlen; indct += (diameter + NumericTraits<SizeValueType>::OneValue()))
-   {
-   typename ScanIteratorType::OffsetType internalIndex, offset;
-   bool isInBounds = scanIt.IndexInBounds( indct, internalIndex, offset );
+ typename VirtualImageType::IndexType hyperplaneIndex = scanIt.GetIndex();
+ hyperplaneIndex[0] += static_cast< OffsetValueType >( scanParameters.radius[0] );
 
-   if (!isInBounds)
+ SizeValueType hyperplaneVoxel = 0;
+ for ( SizeValueType indct = diameter; indct < hoodlen; indct += (diameter + NumericTraits<SizeValueType>::OneValue()), hyperplaneVoxel++ )
    {
-   continue;
-   }
-
-   typename VirtualImageType::IndexType index = scanIt.GetIndex(indct);
-
-   VirtualPointType virtualPoint;
-   FixedImagePointType mappedFixedPoint;
    FixedImagePixelType fixedImageValue;
-   MovingImagePointType mappedMovingPoint;
    MovingImagePixelType movingImageValue;
-   MovingImageGradientType movingImageGradient;
    bool pointIsValid;
 
-   this->m_ANTSAssociate->TransformVirtualIndexToPhysicalPoint(index, virtualPoint);
-   try
+   if ( scanMem.useValueCache )
      {
-     pointIsValid = this->m_ANTSAssociate->TransformAndEvaluateFixedPoint( virtualPoint, mappedFixedPoint, fixedImageValue );
-     if (pointIsValid)
-       {
-       pointIsValid = this->m_ANTSAssociate->TransformAndEvaluateMovingPoint( virtualPoint, mappedMovingPoint, movingImageValue );
-       }
+     pointIsValid = this->GetCachedFixedAndMovingValues( hyperplaneIndex + scanMem.hyperplaneOffsets[hyperplaneVoxel],
+       scanMem, scanParameters, fixedImageValue, movingImageValue );
      }
-   catch (ExceptionObject & exc)
+   else
      {
-     //NOTE: there must be a cleaner way to do this:
-     std::string msg("Caught exception: \n");
-     msg += exc.what();
-     ExceptionObject err(__FILE__, __LINE__, msg);
-     throw err;
+     typename ScanIteratorType::OffsetType internalIndex, offset;
+     bool isInBounds = scanIt.IndexInBounds( indct, internalIndex, offset );
+     if (!isInBounds)
+       {
+       continue;
+       }
+     pointIsValid = this->EvaluateFixedAndMovingValues( scanIt.GetIndex(indct), fixedImageValue, movingImageValue );
      }
+
    if ( pointIsValid )
      {
      sumFixed2 += fixedImageValue  * fixedImageValue;
@@ -327,6 +306,136 @@ ANTSNeighborhoodCorrelationImageToImageMetricv4GetValueAndDerivativeThreader< TD
   scanMem.fixedImageGradient.Fill(0.0);
   scanMem.movingImageGradient.Fill(0.0);
   scanMem.mappedMovingPoint.Fill(0.0);
+
+  scanMem.useValueCache = false;
+}
+
+template < typename TDomainPartitioner, typename TImageToImageMetric, typename TNeighborhoodCorrelationMetric >
+void
+ANTSNeighborhoodCorrelationImageToImageMetricv4GetValueAndDerivativeThreader< TDomainPartitioner, TImageToImageMetric, TNeighborhoodCorrelationMetric >
+::InitializeValueCache( ScanMemType & scanMem, const ScanParametersType &scanParameters ) const
+{
+  const unsigned int lastDimension = TImageToImageMetric::VirtualImageDimension - 1;
+
+  // The cache covers the scan region padded by the radius, restricted to
+  // the voxels the scan iterator considers in bounds.
+  ImageRegionType cacheRegion = scanParameters.scanRegion;
+  cacheRegion.PadByRadius( scanParameters.radius );
+  if ( !cacheRegion.Crop( scanParameters.virtualImage->GetBufferedRegion() ) )
+    {
+    return;
+    }
+
+  const SizeValueType numberOfSlices = std::min( static_cast< SizeValueType >( 2 * scanParameters.radius[lastDimension] + 1 ),
+                                                 static_cast< SizeValueType >( cacheRegion.GetSize( lastDimension ) ) );
+  scanMem.cacheRegion = cacheRegion;
+  scanMem.cacheSliceSize = cacheRegion.GetNumberOfPixels() / cacheRegion.GetSize( lastDimension );
+  scanMem.cachedFixedValues.resize( scanMem.cacheSliceSize * numberOfSlices );
+  scanMem.cachedMovingValues.resize( scanMem.cacheSliceSize * numberOfSlices );
+  scanMem.cachedValidity.resize( scanMem.cacheSliceSize * numberOfSlices );
+  // no slice is cached yet
+  scanMem.cachedSliceIndex.assign( numberOfSlices, cacheRegion.GetIndex( lastDimension ) - 1 );
+
+  // offsets of the voxels of a hyperplane, the second dimension varying fastest
+  SizeValueType numberOfHyperplaneVoxels = 1;
+  for ( unsigned int d = 1; d <= lastDimension; d++ )
+    {
+    numberOfHyperplaneVoxels *= 2 * scanParameters.radius[d] + 1;
+    }
+  scanMem.hyperplaneOffsets.resize( numberOfHyperplaneVoxels );
+  for ( SizeValueType k = 0; k < numberOfHyperplaneVoxels; k++ )
+    {
+    typename VirtualImageType::OffsetType & offset = scanMem.hyperplaneOffsets[k];
+    offset[0] = 0;
+    SizeValueType remaining = k;
+    for ( unsigned int d = 1; d <= lastDimension; d++ )
+      {
+      const SizeValueType diameter = 2 * scanParameters.radius[d] + 1;
+      offset[d] = static_cast< OffsetValueType >( remaining % diameter ) - static_cast< OffsetValueType >( scanParameters.radius[d] );
+      remaining /= diameter;
+      }
+    }
+  scanMem.useValueCache = true;
+}
+
+template < typename TDomainPartitioner, typename TImageToImageMetric, typename TNeighborhoodCorrelationMetric >
+bool
+ANTSNeighborhoodCorrelationImageToImageMetricv4GetValueAndDerivativeThreader< TDomainPartitioner, TImageToImageMetric, TNeighborhoodCorrelationMetric >
+::GetCachedFixedAndMovingValues( const VirtualIndexType & index, ScanMemType & scanMem, const ScanParametersType &scanParameters,
+                                 FixedImagePixelType & fixedImageValue, MovingImagePixelType & movingImageValue ) const
+{
+  if ( !scanMem.cacheRegion.IsInside( index ) )
+    {
+    return false;
+    }
+
+  const unsigned int lastDimension = TImageToImageMetric::VirtualImageDimension - 1;
+  const IndexValueType sliceIndex = index[lastDimension];
+  const SizeValueType  slot = static_cast< SizeValueType >( sliceIndex - scanMem.cacheRegion.GetIndex( lastDimension ) )
+    % scanMem.cachedSliceIndex.size();
+  const SizeValueType  slotOffset = slot * scanMem.cacheSliceSize;
+
+  if ( scanMem.cachedSliceIndex[slot] != sliceIndex )
+    {
+    // evaluate the whole slice once
+    ImageRegionType sliceRegion = scanMem.cacheRegion;
+    sliceRegion.SetIndex( lastDimension, sliceIndex );
+    sliceRegion.SetSize( lastDimension, 1 );
+
+    ImageRegionConstIteratorWithOnlyIndex< VirtualImageType > sliceIt( scanParameters.virtualImage, sliceRegion );
+    SizeValueType offset = slotOffset;
+    for ( sliceIt.GoToBegin(); !sliceIt.IsAtEnd(); ++sliceIt, ++offset )
+      {
+      scanMem.cachedValidity[offset] = this->EvaluateFixedAndMovingValues( sliceIt.GetIndex(),
+        scanMem.cachedFixedValues[offset], scanMem.cachedMovingValues[offset] );
+      }
+    scanMem.cachedSliceIndex[slot] = sliceIndex;
+    }
+
+  SizeValueType offset = 0;
+  SizeValueType stride = 1;
+  for ( unsigned int d = 0; d < lastDimension; d++ )
+    {
+    offset += static_cast< SizeValueType >( index[d] - scanMem.cacheRegion.GetIndex( d ) ) * stride;
+    stride *= scanMem.cacheRegion.GetSize( d );
+    }
+  offset += slotOffset;
+
+  fixedImageValue = scanMem.cachedFixedValues[offset];
+  movingImageValue = scanMem.cachedMovingValues[offset];
+  return scanMem.cachedValidity[offset] != 0;
+}
+
+template < typename TDomainPartitioner, typename TImageToImageMetric, typename TNeighborhoodCorrelationMetric >
+bool
+ANTSNeighborhoodCorrelationImageToImageMetricv4GetValueAndDerivativeThreader< TDomainPartitioner, TImageToImageMetric, TNeighborhoodCorrelationMetric >
+::EvaluateFixedAndMovingValues( const VirtualIndexType & index, FixedImagePixelType & fixedImageValue,
+                                MovingImagePixelType & movingImageValue ) const
+{
+  VirtualPointType     virtualPoint;
+  FixedImagePointType  mappedFixedPoint;
+  MovingImagePointType mappedMovingPoint;
+  bool pointIsValid;
+
+  this->m_ANTSAssociate->TransformVirtualIndexToPhysicalPoint(index, virtualPoint);
+
+  try
+    {
+    pointIsValid = this->m_ANTSAssociate->TransformAndEvaluateFixedPoint( virtualPoint, mappedFixedPoint, fixedImageValue );
+    if ( pointIsValid )
+      {
+      pointIsValid = this->m_ANTSAssociate->TransformAndEvaluateMovingPoint( virtualPoint, mappedMovingPoint, movingImageValue );
+      }
+    }
+  catch (ExceptionObject & exc)
+    {
+    //NOTE: there must be a cleaner way to do this:
+    std::string msg("Caught exception: \n");
+    msg += exc.what();
+    ExceptionObject err(__FILE__, __LINE__, msg);
+    throw err;
+    }
+  return pointIsValid;
 }
 
 template < typename TDomainPartitioner, typename TImageToImageMetric, typename TNeighborhoodCorrelationMetric >
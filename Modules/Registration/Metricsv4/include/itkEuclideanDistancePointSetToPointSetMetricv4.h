@@ -65,6 +65,7 @@ public:
   typedef typename Superclass::PointType            PointType;
   typedef typename Superclass::PixelType            PixelType;
   typedef typename Superclass::PointIdentifier      PointIdentifier;
+  typedef typename Superclass::PointIdentifierVectorType PointIdentifierVectorType;
 
   /**
    * Calculates the local metric value for a single point.
@@ -77,16 +78,39 @@ public:
   virtual void GetLocalNeighborhoodValueAndDerivative( const PointType &,
     MeasureType &, LocalDerivativeType &, const PixelType & pixel = 0 ) const ITK_OVERRIDE;
 
+  /**
+   * Calculates the local metric value for a fixed transformed point, using
+   * the closest point found in InitializeForIteration().
+   */
+  virtual MeasureType GetLocalNeighborhoodValueWithIndex( const PointIdentifier &,
+    const PointType &, const PixelType & pixel = 0 ) const ITK_OVERRIDE;
+
+  /**
+   * Calculates the local value and derivative for a fixed transformed point,
+   * using the closest point found in InitializeForIteration().
+   */
+  virtual void GetLocalNeighborhoodValueAndDerivativeWithIndex( const PointIdentifier &,
+    const PointType &, MeasureType &, LocalDerivativeType &,
+    const PixelType & pixel = 0 ) const ITK_OVERRIDE;
+
 protected:
   EuclideanDistancePointSetToPointSetMetricv4();
   virtual ~EuclideanDistancePointSetToPointSetMetricv4();
 
+  /** Find the closest moving point of all the fixed points at once. */
+  virtual void InitializeForIteration() const ITK_OVERRIDE;
+
   /** PrintSelf function */
   void PrintSelf( std::ostream & os, Indent indent ) const ITK_OVERRIDE;
 
 private:
   EuclideanDistancePointSetToPointSetMetricv4(const Self &); //purposely not implemented
   void operator=(const Self &);               //purposely not implemented
+
+  /** Closest moving point of each fixed transformed point, valid when
+   * m_UseClosestPoints is true. */
+  mutable PointIdentifierVectorType m_ClosestPoints;
+  mutable bool                      m_UseClosestPoints;
 };
 } // end namespace itk
 
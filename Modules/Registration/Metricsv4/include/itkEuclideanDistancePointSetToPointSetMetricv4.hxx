@@ -26,7 +26,8 @@ namespace itk
 /** Constructor */
 template<typename TFixedPointSet, typename TMovingPointSet, class TInternalComputationValueType>
 EuclideanDistancePointSetToPointSetMetricv4<TFixedPointSet, TMovingPointSet, TInternalComputationValueType>
-::EuclideanDistancePointSetToPointSetMetricv4()
+::EuclideanDistancePointSetToPointSetMetricv4() :
+  m_UseClosestPoints( false )
 {
 }
 
@@ -69,6 +70,58 @@ EuclideanDistancePointSetToPointSetMetricv4<TFixedPointSet, TMovingPointSet, TIn
   localDerivative = closestPoint - point;
 }
 
+template<typename TFixedPointSet, typename TMovingPointSet, class TInternalComputationValueType>
+void
+EuclideanDistancePointSetToPointSetMetricv4<TFixedPointSet, TMovingPointSet, TInternalComputationValueType>
+::InitializeForIteration() const
+{
+  Superclass::InitializeForIteration();
+
+  this->m_UseClosestPoints = this->FixedTransformedPointIdentifiersAreSequential();
+  if( this->m_UseClosestPoints )
+    {
+    this->m_MovingTransformedPointsLocator->FindClosestPoints(
+      this->m_FixedTransformedPointSet->GetPoints(), this->m_ClosestPoints );
+    }
+}
+
+template<typename TFixedPointSet, typename TMovingPointSet, class TInternalComputationValueType>
+typename EuclideanDistancePointSetToPointSetMetricv4<TFixedPointSet, TMovingPointSet, TInternalComputationValueType>
+::MeasureType
+EuclideanDistancePointSetToPointSetMetricv4<TFixedPointSet, TMovingPointSet, TInternalComputationValueType>
+::GetLocalNeighborhoodValueWithIndex( const PointIdentifier & index,
+  const PointType & point, const PixelType & pixel ) const
+{
+  if( !this->m_UseClosestPoints || index >= this->m_ClosestPoints.size() )
+    {
+    return this->GetLocalNeighborhoodValue( point, pixel );
+    }
+
+  const PointType closestPoint = this->m_MovingTransformedPointSet->GetPoint( this->m_ClosestPoints[index] );
+
+  const MeasureType distance = point.EuclideanDistanceTo( closestPoint );
+  return distance;
+}
+
+template<typename TFixedPointSet, typename TMovingPointSet, class TInternalComputationValueType>
+void
+EuclideanDistancePointSetToPointSetMetricv4<TFixedPointSet, TMovingPointSet, TInternalComputationValueType>
+::GetLocalNeighborhoodValueAndDerivativeWithIndex( const PointIdentifier & index,
+  const PointType & point, MeasureType &measure, LocalDerivativeType & localDerivative,
+  const PixelType & pixel ) const
+{
+  if( !this->m_UseClosestPoints || index >= this->m_ClosestPoints.size() )
+    {
+    this->GetLocalNeighborhoodValueAndDerivative( point, measure, localDerivative, pixel );
+    return;
+    }
+
+  const PointType closestPoint = this->m_MovingTransformedPointSet->GetPoint( this->m_ClosestPoints[index] );
+
+  measure = point.EuclideanDistanceTo( closestPoint );
+  localDerivative = closestPoint - point;
+}
+
 /** PrintSelf method */
 template<typename TFixedPointSet, typename TMovingPointSet, class TInternalComputationValueType>
 void
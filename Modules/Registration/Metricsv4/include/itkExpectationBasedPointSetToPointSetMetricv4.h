@@ -69,6 +69,8 @@ public:
   typedef typename Superclass::CoordRepType             CoordRepType;
   typedef typename Superclass::PointIdentifier          PointIdentifier;
   typedef typename Superclass::NeighborsIdentifierType  NeighborsIdentifierType;
+  typedef typename Superclass::NeighborsIdentifierVectorType
+                                                        NeighborsIdentifierVectorType;
 
   /**
    * Calculates the local metric value for a single point.
@@ -81,6 +83,21 @@ public:
   virtual void GetLocalNeighborhoodValueAndDerivative( const PointType &,
     MeasureType &, LocalDerivativeType &, const PixelType & pixel = 0 ) const ITK_OVERRIDE;
 
+  /**
+   * Calculates the local metric value for a fixed transformed point, using
+   * the neighbors found in InitializeForIteration().
+   */
+  virtual MeasureType GetLocalNeighborhoodValueWithIndex( const PointIdentifier &,
+    const PointType &, const PixelType & pixel = 0 ) const ITK_OVERRIDE;
+
+  /**
+   * Calculates the local value and derivative for a fixed transformed point,
+   * using the neighbors found in InitializeForIteration().
+   */
+  virtual void GetLocalNeighborhoodValueAndDerivativeWithIndex( const PointIdentifier &,
+    const PointType &, MeasureType &, LocalDerivativeType &,
+    const PixelType & pixel = 0 ) const ITK_OVERRIDE;
+
   /**
    * Each point is associated with a Gaussian characterized by m_PointSetSigma
    * which provides a sense of scale for determining the similarity between two
@@ -116,6 +133,9 @@ protected:
   /** PrintSelf function */
   void PrintSelf( std::ostream & os, Indent indent ) const ITK_OVERRIDE;
 
+  /** Find the moving neighbors of all the fixed points at once. */
+  virtual void InitializeForIteration() const ITK_OVERRIDE;
+
 private:
   ExpectationBasedPointSetToPointSetMetricv4( const Self & ); //purposely not implemented
   void operator=( const Self & );               //purposely not implemented
@@ -123,11 +143,22 @@ private:
   typedef typename PointType::VectorType                    VectorType;
   typedef typename NeighborsIdentifierType::const_iterator  NeighborsIterator;
 
+  MeasureType ComputeLocalNeighborhoodValue( const PointType &,
+    const NeighborsIdentifierType & ) const;
+
+  void ComputeLocalNeighborhoodValueAndDerivative( const PointType &,
+    const NeighborsIdentifierType &, MeasureType &, LocalDerivativeType & ) const;
+
   CoordRepType                               m_PointSetSigma;
   MeasureType                                m_PreFactor;
   MeasureType                                m_Denominator;
   unsigned int                               m_EvaluationKNeighborhood;
 
+  /** Moving neighbors of each fixed transformed point, valid when
+   * m_UseNeighborhoods is true. */
+  mutable NeighborsIdentifierVectorType      m_Neighborhoods;
+  mutable bool                               m_UseNeighborhoods;
+
 };
 } // end namespace itk
 
@@ -30,7 +30,8 @@ ExpectationBasedPointSetToPointSetMetricv4<TFixedPointSet, TMovingPointSet, TInt
   m_PointSetSigma( 1.0 ),
   m_PreFactor( 0.0 ),
   m_Denominator( 0.0 ),
-  m_EvaluationKNeighborhood( 50 )
+  m_EvaluationKNeighborhood( 50 ),
+  m_UseNeighborhoods( false )
 {
 }
 
@@ -56,17 +57,55 @@ ExpectationBasedPointSetToPointSetMetricv4<TFixedPointSet, TMovingPointSet, TInt
   this->m_Denominator = 2.0 * vnl_math_sqr( this->m_PointSetSigma );
 }
 
+template<typename TFixedPointSet, typename TMovingPointSet, class TInternalComputationValueType>
+void
+ExpectationBasedPointSetToPointSetMetricv4<TFixedPointSet, TMovingPointSet, TInternalComputationValueType>
+::InitializeForIteration() const
+{
+  Superclass::InitializeForIteration();
+
+  this->m_UseNeighborhoods = this->FixedTransformedPointIdentifiersAreSequential();
+  if( this->m_UseNeighborhoods )
+    {
+    this->m_MovingTransformedPointsLocator->FindClosestNPoints( this->m_FixedTransformedPointSet->GetPoints(),
+      this->m_EvaluationKNeighborhood, this->m_Neighborhoods );
+    }
+}
+
 template<typename TFixedPointSet, typename TMovingPointSet, class TInternalComputationValueType>
 typename ExpectationBasedPointSetToPointSetMetricv4<TFixedPointSet, TMovingPointSet, TInternalComputationValueType>
 ::MeasureType
 ExpectationBasedPointSetToPointSetMetricv4<TFixedPointSet, TMovingPointSet, TInternalComputationValueType>
 ::GetLocalNeighborhoodValue( const PointType & point, const PixelType & itkNotUsed( pixel ) ) const
 {
-  MeasureType localValue = NumericTraits<MeasureType>::ZeroValue();
-
   NeighborsIdentifierType neighborhood;
   this->m_MovingTransformedPointsLocator->FindClosestNPoints( point, this->m_EvaluationKNeighborhood, neighborhood );
 
+  return this->ComputeLocalNeighborhoodValue( point, neighborhood );
+}
+
+template<typename TFixedPointSet, typename TMovingPointSet, class TInternalComputationValueType>
+typename ExpectationBasedPointSetToPointSetMetricv4<TFixedPointSet, TMovingPointSet, TInternalComputationValueType>
+::MeasureType
+ExpectationBasedPointSetToPointSetMetricv4<TFixedPointSet, TMovingPointSet, TInternalComputationValueType>
+::GetLocalNeighborhoodValueWithIndex( const PointIdentifier & index, const PointType & point,
+  const PixelType & pixel ) const
+{
+  if( !this->m_UseNeighborhoods || index >= this->m_Neighborhoods.size() )
+    {
+    return this->GetLocalNeighborhoodValue( point, pixel );
+    }
+  return this->ComputeLocalNeighborhoodValue( point, this->m_Neighborhoods[index] );
+}
+
+template<typename TFixedPointSet, typename TMovingPointSet, class TInternalComputationValueType>
+typename ExpectationBasedPointSetToPointSetMetricv4<TFixedPointSet, TMovingPointSet, TInternalComputationValueType>
+::MeasureType
+ExpectationBasedPointSetToPointSetMetricv4<TFixedPointSet, TMovingPointSet, TInternalComputationValueType>
+::ComputeLocalNeighborhoodValue( const PointType & point, const NeighborsIdentifierType & neighborhood ) const
+{
+  MeasureType localValue = NumericTraits<MeasureType>::ZeroValue();
+
   for( NeighborsIterator it = neighborhood.begin(); it != neighborhood.end(); ++it )
     {
     PointType neighbor = this->m_MovingTransformedPointSet->GetPoint( *it );
@@ -82,6 +121,32 @@ void
 ExpectationBasedPointSetToPointSetMetricv4<TFixedPointSet, TMovingPointSet, TInternalComputationValueType>
 ::GetLocalNeighborhoodValueAndDerivative( const PointType & point,
   MeasureType &measure, LocalDerivativeType &localDerivative, const PixelType & itkNotUsed( pixel ) ) const
+{
+  NeighborsIdentifierType neighborhood;
+  this->m_MovingTransformedPointsLocator->FindClosestNPoints( point, this->m_EvaluationKNeighborhood, neighborhood );
+
+  this->ComputeLocalNeighborhoodValueAndDerivative( point, neighborhood, measure, localDerivative );
+}
+
+template<typename TFixedPointSet, typename TMovingPointSet, class TInternalComputationValueType>
+void
+ExpectationBasedPointSetToPointSetMetricv4<TFixedPointSet, TMovingPointSet, TInternalComputationValueType>
+::GetLocalNeighborhoodValueAndDerivativeWithIndex( const PointIdentifier & index, const PointType & point,
+  MeasureType &measure, LocalDerivativeType &localDerivative, const PixelType & pixel ) const
+{
+  if( !this->m_UseNeighborhoods || index >= this->m_Neighborhoods.size() )
+    {
+    this->GetLocalNeighborhoodValueAndDerivative( point, measure, localDerivative, pixel );
+    return;
+    }
+  this->ComputeLocalNeighborhoodValueAndDerivative( point, this->m_Neighborhoods[index], measure, localDerivative );
+}
+
+template<typename TFixedPointSet, typename TMovingPointSet, class TInternalComputationValueType>
+void
+ExpectationBasedPointSetToPointSetMetricv4<TFixedPointSet, TMovingPointSet, TInternalComputationValueType>
+::ComputeLocalNeighborhoodValueAndDerivative( const PointType & point,
+  const NeighborsIdentifierType & neighborhood, MeasureType &measure, LocalDerivativeType &localDerivative ) const
 {
   Array<MeasureType> measureValues;
   measureValues.SetSize( this->m_EvaluationKNeighborhood );
@@ -94,10 +159,6 @@ ExpectationBasedPointSetToPointSetMetricv4<TFixedPointSet, TMovingPointSet, TInt
   PointType weightedPoint;
   weightedPoint.Fill( 0.0 );
 
-  NeighborsIdentifierType neighborhood;
-
-  this->m_MovingTransformedPointsLocator->FindClosestNPoints( point, this->m_EvaluationKNeighborhood, neighborhood );
-
   for( NeighborsIterator it = neighborhood.begin(); it != neighborhood.end(); ++it )
     {
     PointType neighbor = this->m_MovingTransformedPointSet->GetPoint( *it );
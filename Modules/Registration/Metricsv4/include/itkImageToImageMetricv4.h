@@ -461,7 +461,7 @@ public:
   /** Set number of threads to use. This the maximum number of threads to use
    * when multithreaded.  The actual number of threads used (may be less than
    * this value) can be obtained with \c GetNumberOfThreadsUsed. */
-  virtual void SetMaximumNumberOfThreads( const ThreadIdType threads );
+  virtual void SetMaximumNumberOfThreads( const ThreadIdType threads ) ITK_OVERRIDE;
   virtual ThreadIdType GetMaximumNumberOfThreads() const;
 
   /** Initialize per-thread components for computing metric
@@ -155,6 +155,10 @@ public:
   /** Typedef for points locator class to speed up finding neighboring points */
   typedef PointsLocator< PointsContainer>                     PointsLocatorType;
   typedef typename PointsLocatorType::NeighborsIdentifierType NeighborsIdentifierType;
+  typedef typename PointsLocatorType::PointIdentifierVectorType
+                                                              PointIdentifierVectorType;
+  typedef typename PointsLocatorType::NeighborsIdentifierVectorType
+                                                              NeighborsIdentifierVectorType;
 
   typedef PointSet<FixedPixelType, itkGetStaticConstMacro( PointDimension )>    FixedTransformedPointSetType;
   typedef PointSet<MovingPixelType, itkGetStaticConstMacro( PointDimension )>   MovingTransformedPointSetType;
@@ -280,6 +284,23 @@ public:
   virtual void GetLocalNeighborhoodValueAndDerivative( const PointType &,
     MeasureType &, LocalDerivativeType &, const PixelType & pixel ) const = 0;
 
+  /**
+   * Calculates the local metric value for the fixed transformed point of
+   * identifier \c index.  GetValue() and GetValueAndDerivative() call these
+   * variants so that derived classes can look up the neighbors found for all
+   * the points at once in InitializeForIteration().  By default, they call
+   * the functions above.
+   */
+  virtual MeasureType GetLocalNeighborhoodValueWithIndex( const PointIdentifier & index,
+    const PointType &, const PixelType & pixel ) const;
+
+  /**
+   * Calculates the local value/derivative for the fixed transformed point of
+   * identifier \c index.
+   */
+  virtual void GetLocalNeighborhoodValueAndDerivativeWithIndex( const PointIdentifier & index,
+    const PointType &, MeasureType &, LocalDerivativeType &, const PixelType & pixel ) const;
+
   /**
    * Get the virtual point set, derived from the fixed point set.
    * If the virtual point set has not yet been derived, it will be
@@ -321,6 +342,11 @@ public:
   itkGetConstMacro( CalculateValueAndDerivativeInTangentSpace, bool );
   itkBooleanMacro( CalculateValueAndDerivativeInTangentSpace );
 
+  /** Set/Get the maximum number of threads used by the neighbor searches for
+   * all the fixed points. */
+  virtual void SetMaximumNumberOfThreads( const ThreadIdType threads ) ITK_OVERRIDE;
+  virtual ThreadIdType GetMaximumNumberOfThreads() const;
+
 protected:
   PointSetToPointSetMetricv4();
   virtual ~PointSetToPointSetMetricv4();
@@ -393,10 +419,18 @@ protected:
 
   /**
    * Build point locators for the fixed and moving point sets to speed up
-   * derivative and value calculations.
+   * derivative and value calculations. A locator whose points only moved is
+   * refitted rather than rebuilt.
    */
   void InitializePointsLocators() const;
 
+  /**
+   * Returns true if the identifiers of the fixed transformed points are
+   * 0, 1, 2, ... in iteration order, so that the results of a search for all
+   * the points can be indexed by point identifier.
+   */
+  bool FixedTransformedPointIdentifiersAreSequential() const;
+
   /**
    * Store a derivative from a single point in a field.
    * Only relevant when active transform has local support.
@@ -429,6 +463,8 @@ private:
 
   mutable ModifiedTimeType m_MovingTransformedPointSetTime;
   mutable ModifiedTimeType m_FixedTransformedPointSetTime;
+
+  ThreadIdType m_MaximumNumberOfThreads;
 };
 } // end namespace itk
 
@@ -55,6 +55,8 @@ PointSetToPointSetMetricv4<TFixedPointSet, TMovingPointSet, TInternalComputation
   this->m_StoreDerivativeAsSparseFieldForLocalSupportTransforms = true;
 
   this->m_CalculateValueAndDerivativeInTangentSpace = false;
+
+  this->m_MaximumNumberOfThreads = MultiThreader::GetGlobalDefaultNumberOfThreads();
 }
 
 /** Destructor */
@@ -201,7 +203,7 @@ PointSetToPointSetMetricv4<TFixedPointSet, TMovingPointSet, TInternalComputation
         }
       }
 
-    value += this->GetLocalNeighborhoodValue( It.Value(), pixel );
+    value += this->GetLocalNeighborhoodValueWithIndex( It.Index(), It.Value(), pixel );
     ++virtualIt;
     ++It;
     }
@@ -292,7 +294,7 @@ PointSetToPointSetMetricv4<TFixedPointSet, TMovingPointSet, TInternalComputation
 
     if( calculateValue )
       {
-      this->GetLocalNeighborhoodValueAndDerivative( It.Value(), pointValue, pointDerivative, pixel );
+      this->GetLocalNeighborhoodValueAndDerivativeWithIndex( It.Index(), It.Value(), pointValue, pointDerivative, pixel );
       value += pointValue;
       }
     else
@@ -424,6 +426,26 @@ PointSetToPointSetMetricv4<TFixedPointSet, TMovingPointSet, TInternalComputation
   return localDerivative;
 }
 
+template<typename TFixedPointSet, typename TMovingPointSet, class TInternalComputationValueType>
+typename PointSetToPointSetMetricv4<TFixedPointSet, TMovingPointSet, TInternalComputationValueType>
+::MeasureType
+PointSetToPointSetMetricv4<TFixedPointSet, TMovingPointSet, TInternalComputationValueType>
+::GetLocalNeighborhoodValueWithIndex( const PointIdentifier & itkNotUsed( index ),
+  const PointType & point, const PixelType & pixel ) const
+{
+  return this->GetLocalNeighborhoodValue( point, pixel );
+}
+
+template<typename TFixedPointSet, typename TMovingPointSet, class TInternalComputationValueType>
+void
+PointSetToPointSetMetricv4<TFixedPointSet, TMovingPointSet, TInternalComputationValueType>
+::GetLocalNeighborhoodValueAndDerivativeWithIndex( const PointIdentifier & itkNotUsed( index ),
+  const PointType & point, MeasureType & measure, LocalDerivativeType & localDerivative,
+  const PixelType & pixel ) const
+{
+  this->GetLocalNeighborhoodValueAndDerivative( point, measure, localDerivative, pixel );
+}
+
 template<typename TFixedPointSet, typename TMovingPointSet, class TInternalComputationValueType>
 void
 PointSetToPointSetMetricv4<TFixedPointSet, TMovingPointSet, TInternalComputationValueType>
@@ -529,8 +551,10 @@ PointSetToPointSetMetricv4<TFixedPointSet, TMovingPointSet, TInternalComputation
       {
       this->m_FixedTransformedPointsLocator = PointsLocatorType::New();
       }
+    this->m_FixedTransformedPointsLocator->SetNumberOfThreads( this->m_MaximumNumberOfThreads );
     this->m_FixedTransformedPointsLocator->SetPoints( this->m_FixedTransformedPointSet->GetPoints() );
-    this->m_FixedTransformedPointsLocator->Initialize();
+    this->m_FixedTransformedPointsLocator->UpdatePointPositions();
+    this->m_FixedTransformPointLocatorsNeedInitialization = false;
     }
 
   if( this->m_MovingTransformPointLocatorsNeedInitialization )
@@ -543,11 +567,52 @@ PointSetToPointSetMetricv4<TFixedPointSet, TMovingPointSet, TInternalComputation
       {
       this->m_MovingTransformedPointsLocator = PointsLocatorType::New();
       }
+    this->m_MovingTransformedPointsLocator->SetNumberOfThreads( this->m_MaximumNumberOfThreads );
     this->m_MovingTransformedPointsLocator->SetPoints( this->m_MovingTransformedPointSet->GetPoints() );
-    this->m_MovingTransformedPointsLocator->Initialize();
+    this->m_MovingTransformedPointsLocator->UpdatePointPositions();
+    this->m_MovingTransformPointLocatorsNeedInitialization = false;
     }
 }
 
+template<typename TFixedPointSet, typename TMovingPointSet, class TInternalComputationValueType>
+bool
+PointSetToPointSetMetricv4<TFixedPointSet, TMovingPointSet, TInternalComputationValueType>
+::FixedTransformedPointIdentifiersAreSequential() const
+{
+  PointIdentifier expected = NumericTraits<PointIdentifier>::ZeroValue();
+  PointsConstIterator It = this->m_FixedTransformedPointSet->GetPoints()->Begin();
+  while( It != this->m_FixedTransformedPointSet->GetPoints()->End() )
+    {
+    if( It.Index() != expected )
+      {
+      return false;
+      }
+    ++expected;
+    ++It;
+    }
+  return true;
+}
+
+template<typename TFixedPointSet, typename TMovingPointSet, class TInternalComputationValueType>
+void
+PointSetToPointSetMetricv4<TFixedPointSet, TMovingPointSet, TInternalComputationValueType>
+::SetMaximumNumberOfThreads( const ThreadIdType threads )
+{
+  if( threads != this->m_MaximumNumberOfThreads )
+    {
+    this->m_MaximumNumberOfThreads = threads;
+    this->Modified();
+    }
+}
+
+template<typename TFixedPointSet, typename TMovingPointSet, class TInternalComputationValueType>
+ThreadIdType
+PointSetToPointSetMetricv4<TFixedPointSet, TMovingPointSet, TInternalComputationValueType>
+::GetMaximumNumberOfThreads() const
+{
+  return this->m_MaximumNumberOfThreads;
+}
+
 /** PrintSelf */
 template<typename TFixedPointSet, typename TMovingPointSet, class TInternalComputationValueType>
 void
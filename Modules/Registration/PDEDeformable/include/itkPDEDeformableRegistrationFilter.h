@@ -223,6 +223,18 @@ public:
   virtual void StopRegistration()
   { m_StopRegistrationFlag = true; }
 
+  /** Set/Get whether the displacement and update fields are smoothed with
+   * a SmoothingRecursiveGaussianImageFilter instead of the separable
+   * Gaussian operators. The recursive filter runs in place on all the
+   * components at once, and its cost does not grow with the standard
+   * deviations, but it approximates the Gaussian kernel differently, so the
+   * results are slightly different. The standard deviations are still given
+   * in pixel units, and MaximumError and MaximumKernelWidth are ignored. The
+   * field must have at least 4 pixels along each dimension. Default is off. */
+  itkSetMacro(UseRecursiveGaussianSmoothing, bool);
+  itkGetConstMacro(UseRecursiveGaussianSmoothing, bool);
+  itkBooleanMacro(UseRecursiveGaussianSmoothing);
+
   /** Set/Get the desired maximum error of the Guassian kernel approximate.
    * \sa GaussianOperator. */
   itkSetMacro(MaximumError, double);
@@ -273,6 +285,11 @@ protected:
    * UpdateFieldStandardDeviations. */
   virtual void SmoothUpdateField();
 
+  /** Smooth the given field in place, with the given standard deviations
+   * in pixel units. The field is not reallocated, and the temporary buffer
+   * used by the separable operators is kept until PostProcessOutput(). */
+  void SmoothGivenField(DisplacementFieldType *field, const StandardDeviationsType & standardDeviations);
+
   /** This method is called after the solution has been generated. In this case,
    * the filter release the memory of the internal buffers. */
   virtual void PostProcessOutput() ITK_OVERRIDE;
@@ -305,9 +322,10 @@ private:
   /** Modes to control smoothing of the update and displacement fields */
   bool m_SmoothDisplacementField;
   bool m_SmoothUpdateField;
+  bool m_UseRecursiveGaussianSmoothing;
 
   /** Temporary displacement field use for smoothing the
-   * the displacement field. */
+   * the displacement and update fields. */
   DisplacementFieldPointer m_TempField;
 
 private:
@@ -26,6 +26,7 @@
 
 #include "itkGaussianOperator.h"
 #include "itkVectorNeighborhoodOperatorImageFilter.h"
+#include "itkSmoothingRecursiveGaussianImageFilter.h"
 
 #include "vnl/vnl_math.h"
 
@@ -58,6 +59,7 @@ PDEDeformableRegistrationFilter< TFixedImage, TMovingImage, TDisplacementField >
 
   m_SmoothDisplacementField = true;
   m_SmoothUpdateField = false;
+  m_UseRecursiveGaussianSmoothing = false;
 }
 
 /*
@@ -216,6 +218,8 @@ PDEDeformableRegistrationFilter< TFixedImage, TMovingImage, TDisplacementField >
     os<< ", " << m_UpdateFieldStandardDeviations[j];
     }
   os << "]" << std::endl;
+  os << indent << "UseRecursiveGaussianSmoothing: ";
+  os << m_UseRecursiveGaussianSmoothing << std::endl;
   os << indent << "StopRegistrationFlag: ";
   os << m_StopRegistrationFlag << std::endl;
   os << indent << "MaximumError: ";
@@ -389,16 +393,62 @@ void
 PDEDeformableRegistrationFilter< TFixedImage, TMovingImage, TDisplacementField >
 ::SmoothDisplacementField()
 {
-  DisplacementFieldPointer field = this->GetOutput();
-
-  // copy field to TempField
-  m_TempField->SetOrigin( field->GetOrigin() );
-  m_TempField->SetSpacing( field->GetSpacing() );
-  m_TempField->SetDirection( field->GetDirection() );
-  m_TempField->SetLargestPossibleRegion(
-    field->GetLargestPossibleRegion() );
-  m_TempField->SetRequestedRegion(
-    field->GetRequestedRegion() );
+  this->SmoothGivenField( this->GetOutput(), m_StandardDeviations );
+}
+
+/*
+ * Smooth deformation using a separable Gaussian kernel
+ */
+template< typename TFixedImage, typename TMovingImage, typename TDisplacementField >
+void
+PDEDeformableRegistrationFilter< TFixedImage, TMovingImage, TDisplacementField >
+::SmoothUpdateField()
+{
+  // The update buffer will be overwritten with new data.
+  this->SmoothGivenField( this->GetUpdateBuffer(), m_UpdateFieldStandardDeviations );
+}
+
+/*
+ * Smooth a field in place, all the components at once
+ */
+template< typename TFixedImage, typename TMovingImage, typename TDisplacementField >
+void
+PDEDeformableRegistrationFilter< TFixedImage, TMovingImage, TDisplacementField >
+::SmoothGivenField(DisplacementFieldType *field, const StandardDeviationsType & standardDeviations)
+{
+  if ( m_UseRecursiveGaussianSmoothing )
+    {
+    typedef SmoothingRecursiveGaussianImageFilter<
+      DisplacementFieldType,
+      DisplacementFieldType >                            RecursiveSmootherType;
+
+    typename RecursiveSmootherType::Pointer recursiveSmoother = RecursiveSmootherType::New();
+
+    // the standard deviations are given in pixel units
+    typename RecursiveSmootherType::SigmaArrayType sigmas;
+    for ( unsigned int j = 0; j < ImageDimension; j++ )
+      {
+      sigmas[j] = standardDeviations[j] * field->GetSpacing()[j];
+      }
+    recursiveSmoother->SetSigmaArray(sigmas);
+    recursiveSmoother->SetNumberOfThreads( this->GetNumberOfThreads() );
+
+    // the smoother runs in place: its output takes the buffer of the field,
+    // which is then grafted back onto the field.
+    recursiveSmoother->InPlaceOn();
+    recursiveSmoother->SetInput(field);
+    recursiveSmoother->Update();
+
+    field->Graft( recursiveSmoother->GetOutput() );
+    return;
+    }
+
+  // Each directional pass writes into TempField, whose container is then
+  // swapped with the one of the field. Both containers are kept from one
+  // call to the next, so that no buffer is allocated once the first
+  // iteration is done.
+  m_TempField->CopyInformation(field);
+  m_TempField->SetRequestedRegion( field->GetBufferedRegion() );
   m_TempField->SetBufferedRegion( field->GetBufferedRegion() );
   m_TempField->Allocate();
 
@@ -409,105 +459,38 @@ PDEDeformableRegistrationFilter< TFixedImage, TMovingImage, TDisplacementField >
     DisplacementFieldType,
     DisplacementFieldType >                              SmootherType;
 
-  OperatorType *oper = new OperatorType;
+  OperatorType oper;
   typename SmootherType::Pointer smoother = SmootherType::New();
 
+  // keep the grafted buffer through the update
+  smoother->ReleaseDataBeforeUpdateFlagOff();
+
   typedef typename DisplacementFieldType::PixelContainerPointer
   PixelContainerPointer;
   PixelContainerPointer swapPtr;
 
-  // graft the output field onto the mini-pipeline
-  smoother->GraftOutput(m_TempField);
-
   for ( unsigned int j = 0; j < ImageDimension; j++ )
     {
     // smooth along this dimension
-    oper->SetDirection(j);
-    double variance = vnl_math_sqr(m_StandardDeviations[j]);
-    oper->SetVariance(variance);
-    oper->SetMaximumError(m_MaximumError);
-    oper->SetMaximumKernelWidth(m_MaximumKernelWidth);
-    oper->CreateDirectional();
+    oper.SetDirection(j);
+    double variance = vnl_math_sqr(standardDeviations[j]);
+    oper.SetVariance(variance);
+    oper.SetMaximumError(m_MaximumError);
+    oper.SetMaximumKernelWidth(m_MaximumKernelWidth);
+    oper.CreateDirectional();
 
     // todo: make sure we only smooth within the buffered region
-    smoother->SetOperator(*oper);
+    smoother->SetOperator(oper);
     smoother->SetInput(field);
+    smoother->GraftOutput(m_TempField);
+    smoother->Modified();
     smoother->Update();
 
-    if ( j + 1 < ImageDimension )
-      {
-      // swap the containers
-      swapPtr = smoother->GetOutput()->GetPixelContainer();
-      smoother->GraftOutput(field);
-      field->SetPixelContainer(swapPtr);
-      smoother->Modified();
-      }
-    }
-
-  // graft the output back to this filter
-  m_TempField->SetPixelContainer( field->GetPixelContainer() );
-  this->GraftOutput( smoother->GetOutput() );
-
-  delete oper;
-}
-
-/*
- * Smooth deformation using a separable Gaussian kernel
- */
-template< typename TFixedImage, typename TMovingImage, typename TDisplacementField >
-void
-PDEDeformableRegistrationFilter< TFixedImage, TMovingImage, TDisplacementField >
-::SmoothUpdateField()
-{
-  // The update buffer will be overwritten with new data.
-  DisplacementFieldPointer field = this->GetUpdateBuffer();
-
-  typedef typename DisplacementFieldType::PixelType       VectorType;
-  typedef typename VectorType::ValueType                  ScalarType;
-  typedef GaussianOperator< ScalarType, ImageDimension >  OperatorType;
-  typedef VectorNeighborhoodOperatorImageFilter<
-    DisplacementFieldType,
-    DisplacementFieldType >                               SmootherType;
-
-  OperatorType opers[ImageDimension];
-  typename SmootherType::Pointer smoothers[ImageDimension];
-
-  for ( unsigned int j = 0; j < ImageDimension; j++ )
-    {
-    // smooth along this dimension
-    opers[j].SetDirection(j);
-    double variance = vnl_math_sqr(this->GetUpdateFieldStandardDeviations()[j]);
-    //double variance = vnl_math_sqr( 1.0 );
-    opers[j].SetVariance(variance);
-    opers[j].SetMaximumError( this->GetMaximumError() );
-    opers[j].SetMaximumKernelWidth( this->GetMaximumKernelWidth() );
-    opers[j].CreateDirectional();
-
-    smoothers[j] = SmootherType::New();
-    smoothers[j]->SetOperator(opers[j]);
-    smoothers[j]->ReleaseDataFlagOn();
-
-    if ( j > 0 )
-      {
-      smoothers[j]->SetInput( smoothers[j - 1]->GetOutput() );
-      }
+    // swap the containers
+    swapPtr = smoother->GetOutput()->GetPixelContainer();
+    m_TempField->SetPixelContainer( field->GetPixelContainer() );
+    field->SetPixelContainer(swapPtr);
     }
-  smoothers[0]->SetInput(field);
-  smoothers[ImageDimension - 1]->GetOutput()
-  ->SetRequestedRegion( field->GetBufferedRegion() );
-
-  smoothers[ImageDimension - 1]->Update();
-
-  // field to contain the final smoothed data, do the equivalent of a graft
-  field->SetPixelContainer( smoothers[ImageDimension - 1]->GetOutput()
-                            ->GetPixelContainer() );
-  field->SetRequestedRegion( smoothers[ImageDimension - 1]->GetOutput()
-                             ->GetRequestedRegion() );
-  field->SetBufferedRegion( smoothers[ImageDimension - 1]->GetOutput()
-                            ->GetBufferedRegion() );
-  field->SetLargestPossibleRegion( smoothers[ImageDimension - 1]->GetOutput()
-                                   ->GetLargestPossibleRegion() );
-  field->CopyInformation( smoothers[ImageDimension - 1]->GetOutput() );
 }
 } // end namespace itk
 
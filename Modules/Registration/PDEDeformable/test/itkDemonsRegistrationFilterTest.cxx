@@ -264,6 +264,37 @@ int itkDemonsRegistrationFilterTest(int, char* [] )
     return EXIT_FAILURE;
     }
 
+  // -----------------------------------------------------------
+  std::cout << "Test recursive Gaussian smoothing of the fields." << std::endl;
+
+  registrator->UseRecursiveGaussianSmoothingOn();
+  warper->Update();
+
+  fixedIter.GoToBegin();
+  warpedIter = itk::ImageRegionIterator<ImageType>( warper->GetOutput(),
+    fixed->GetBufferedRegion() );
+  numPixelsDifferent = 0;
+  while( !fixedIter.IsAtEnd() )
+    {
+    if( fixedIter.Get() != warpedIter.Get() )
+      {
+      numPixelsDifferent++;
+      }
+    ++fixedIter;
+    ++warpedIter;
+    }
+
+  std::cout << "Number of pixels different: " << numPixelsDifferent;
+  std::cout << std::endl;
+
+  if( numPixelsDifferent > 10 )
+    {
+    std::cout << "Test failed - too many pixels different." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  registrator->UseRecursiveGaussianSmoothingOff();
+
   registrator->Print( std::cout );
 
   // -----------------------------------------------------------
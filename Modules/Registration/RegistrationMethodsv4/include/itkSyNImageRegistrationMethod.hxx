@@ -530,18 +530,21 @@ typename SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform,
 SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform, TVirtualImage, TPointSet>
 ::GaussianSmoothDisplacementField( const DisplacementFieldType * field, const RealType variance )
 {
-  typedef ImageDuplicator<DisplacementFieldType> DuplicatorType;
-  typename DuplicatorType::Pointer duplicator = DuplicatorType::New();
-  duplicator->SetInputImage( field );
-  duplicator->Update();
-
-  DisplacementFieldPointer smoothField = duplicator->GetModifiableOutput();
-
   if( variance <= 0.0 )
     {
-    return smoothField;
+    typedef ImageDuplicator<DisplacementFieldType> DuplicatorType;
+    typename DuplicatorType::Pointer duplicator = DuplicatorType::New();
+    duplicator->SetInputImage( field );
+    duplicator->Update();
+
+    return duplicator->GetModifiableOutput();
     }
 
+  // The first pass reads the input field directly, so that it does not
+  // need to be duplicated.
+  DisplacementFieldPointer smoothField;
+  const DisplacementFieldType * smootherInput = field;
+
   typedef GaussianOperator<RealType, ImageDimension> GaussianSmoothingOperatorType;
   GaussianSmoothingOperatorType gaussianSmoothingOperator;
 
@@ -554,12 +557,12 @@ SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform, TVirtual
     gaussianSmoothingOperator.SetDirection( d );
     gaussianSmoothingOperator.SetVariance( variance );
     gaussianSmoothingOperator.SetMaximumError( 0.001 );
-    gaussianSmoothingOperator.SetMaximumKernelWidth( smoothField->GetRequestedRegion().GetSize()[d] );
+    gaussianSmoothingOperator.SetMaximumKernelWidth( smootherInput->GetRequestedRegion().GetSize()[d] );
     gaussianSmoothingOperator.CreateDirectional();
 
     // todo: make sure we only smooth within the buffered region
     smoother->SetOperator( gaussianSmoothingOperator );
-    smoother->SetInput( smoothField );
+    smoother->SetInput( smootherInput );
     try
       {
       smoother->Update();
@@ -574,6 +577,7 @@ SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform, TVirtual
     smoothField = smoother->GetOutput();
     smoothField->Update();
     smoothField->DisconnectPipeline();
+    smootherInput = smoothField;
     }
 
   const DisplacementVectorType zeroVector( 0.0 );
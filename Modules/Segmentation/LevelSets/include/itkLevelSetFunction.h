@@ -219,6 +219,12 @@ public:
   virtual void ReleaseGlobalDataPointer(void *GlobalData) const ITK_OVERRIDE
   { delete (GlobalDataStruct *)GlobalData; }
 
+  /** Merges the maximum changes recorded in the global data \c source into
+   * \c target, so that a solver which gives each thread its own global data
+   * can compute a single time step.  Subclasses that extend the global data
+   * with further maxima must extend this method too. */
+  virtual void MergeGlobalData(void *target, const void *source) const;
+
   /**  */
   virtual ScalarValueType ComputeCurvatureTerm(const NeighborhoodType &,
                                                const FloatOffsetType &,
@@ -219,6 +219,19 @@ double LevelSetFunction< TImageType >::m_WaveDT = 1.0 / ( 2.0 * ImageDimension )
 template< typename TImageType >
 double LevelSetFunction< TImageType >::m_DT     = 1.0 / ( 2.0 * ImageDimension );
 
+template< typename TImageType >
+void
+LevelSetFunction< TImageType >
+::MergeGlobalData(void *target, const void *source) const
+{
+  GlobalDataStruct *      t = (GlobalDataStruct *)target;
+  const GlobalDataStruct *s = (const GlobalDataStruct *)source;
+
+  t->m_MaxAdvectionChange = vnl_math_max(t->m_MaxAdvectionChange, s->m_MaxAdvectionChange);
+  t->m_MaxPropagationChange = vnl_math_max(t->m_MaxPropagationChange, s->m_MaxPropagationChange);
+  t->m_MaxCurvatureChange = vnl_math_max(t->m_MaxCurvatureChange, s->m_MaxCurvatureChange);
+}
+
 template< typename TImageType >
 typename LevelSetFunction< TImageType >::TimeStepType
 LevelSetFunction< TImageType >
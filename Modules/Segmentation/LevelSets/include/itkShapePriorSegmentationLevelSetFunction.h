@@ -136,6 +136,9 @@ public:
   virtual void ReleaseGlobalDataPointer(void *GlobalData) const ITK_OVERRIDE
   { delete (ShapePriorGlobalDataStruct *)GlobalData; }
 
+  /** Merge the maximum changes, including the shape prior one. */
+  virtual void MergeGlobalData(void *target, const void *source) const ITK_OVERRIDE;
+
 protected:
   ShapePriorSegmentationLevelSetFunction();
   virtual ~ShapePriorSegmentationLevelSetFunction() {}
@@ -87,6 +87,21 @@ ShapePriorSegmentationLevelSetFunction< TImageType, TFeatureImageType >
   return value;
 }
 
+/**
+ * Merge the global data of two threads.
+ */
+template< typename TImageType, typename TFeatureImageType >
+void
+ShapePriorSegmentationLevelSetFunction< TImageType, TFeatureImageType >
+::MergeGlobalData(void *target, const void *source) const
+{
+  this->Superclass::MergeGlobalData(target, source);
+
+  ShapePriorGlobalDataStruct *      t = (ShapePriorGlobalDataStruct *)target;
+  const ShapePriorGlobalDataStruct *s = (const ShapePriorGlobalDataStruct *)source;
+  t->m_MaxShapePriorChange = vnl_math_max(t->m_MaxShapePriorChange, s->m_MaxShapePriorChange);
+}
+
 /**
  * Compute the global time step.
  */
@@ -367,9 +367,19 @@ protected:
   void ApplyUpdate(const TimeStepType& dt) ITK_OVERRIDE;
 
   /** Traverses the active layer list and calculates the change at these
-   *  indices to be applied in the current iteration. */
+   *  indices to be applied in the current iteration.  When the difference
+   *  function is a LevelSetFunction, the list is split into contiguous
+   *  parts which are processed by separate threads, each with its own
+   *  global data; the global data are then merged with
+   *  LevelSetFunction::MergeGlobalData before the time step is computed,
+   *  so that the result does not depend on the number of threads.  Other
+   *  difference functions are evaluated by a single thread. */
   TimeStepType CalculateChange() ITK_OVERRIDE;
 
+  /** Calculates the change at the part of the active layer assigned to
+   *  threadId, using the global data of that thread. */
+  void ThreadedCalculateChange(ThreadIdType threadId, ThreadIdType numberOfThreads);
+
   /** Initializes a layer of the sparse field using a previously initialized
    * layer. Builds the list of nodes in m_Layer[to] using m_Layer[from].
    * Marks values in the m_StatusImage. */
@@ -420,6 +430,25 @@ protected:
   SparseFieldCityBlockNeighborList< NeighborhoodIterator< OutputImageType > >
   m_NeighborList;
 
+  /** Buffer offsets of the m_NeighborList neighbors in the status image and
+   *  in the output image.  Computed in Initialize(). */
+  std::vector< OffsetValueType > m_StatusNeighborOffsets;
+  std::vector< OffsetValueType > m_OutputNeighborOffsets;
+
+  /** Fill statusNeighbors and outputNeighbors with the buffer offsets of the
+   *  m_NeighborList neighbors of index, which sits at statusCenter and
+   *  outputCenter.  When boundsChecking is on, a neighbor outside the
+   *  requested region is mapped back onto index itself, which is what the
+   *  zero flux Neumann condition of a radius one neighborhood iterator
+   *  reads there.  This lets the layer updates address their neighbors
+   *  directly instead of repositioning neighborhood iterators. */
+  void ComputeNeighborBufferOffsets(const IndexType & index,
+                                    OffsetValueType statusCenter,
+                                    OffsetValueType outputCenter,
+                                    bool boundsChecking,
+                                    OffsetValueType *statusNeighbors,
+                                    OffsetValueType *outputNeighbors) const;
+
   /** The constant gradient to maintain between isosurfaces in the
       sparse-field of the level-set image.  This value defaults to 1.0 */
   double m_ConstantGradientValue;
@@ -501,6 +530,18 @@ private:
   /** This flag is true when methods need to check boundary conditions and
       false when methods do not need to check for boundary conditions. */
   bool m_BoundsCheckingActive;
+
+  struct CalculateChangeThreadStruct {
+    Self *Filter;
+  };
+
+  static ITK_THREAD_RETURN_TYPE CalculateChangeThreaderCallback(void *arg);
+
+  /** The active layer nodes, in list order, and the global data of each
+   *  thread.  Valid only during CalculateChange. */
+  std::vector< const LayerNodeType * > m_ActiveLayerNodes;
+  std::vector< void * >                m_ThreadGlobalData;
+  std::vector< std::string >           m_ThreadExceptionDescription;
 };
 } // end namespace itk
 
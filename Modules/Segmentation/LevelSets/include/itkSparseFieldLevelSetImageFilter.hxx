@@ -23,6 +23,7 @@
 #include "itkImageRegionIterator.h"
 #include "itkShiftScaleImageFilter.h"
 #include "itkNeighborhoodAlgorithm.h"
+#include "itkLevelSetFunction.h"
 
 namespace itk
 {
@@ -220,6 +221,32 @@ SparseFieldLevelSetImageFilter< TInputImage, TOutputImage >
   this->PropagateAllLayerValues();
 }
 
+template< typename TInputImage, typename TOutputImage >
+void
+SparseFieldLevelSetImageFilter< TInputImage, TOutputImage >
+::ComputeNeighborBufferOffsets(const IndexType & index,
+                               OffsetValueType statusCenter,
+                               OffsetValueType outputCenter,
+                               bool boundsChecking,
+                               OffsetValueType *statusNeighbors,
+                               OffsetValueType *outputNeighbors) const
+{
+  for ( unsigned int i = 0; i < m_NeighborList.GetSize(); ++i )
+    {
+    if ( boundsChecking
+         && !this->m_OutputImage->GetRequestedRegion().IsInside( index + m_NeighborList.GetNeighborhoodOffset(i) ) )
+      {
+      statusNeighbors[i] = statusCenter;
+      outputNeighbors[i] = outputCenter;
+      }
+    else
+      {
+      statusNeighbors[i] = statusCenter + m_StatusNeighborOffsets[i];
+      outputNeighbors[i] = outputCenter + m_OutputNeighborOffsets[i];
+      }
+    }
+}
+
 template< typename TInputImage, typename TOutputImage >
 void
 SparseFieldLevelSetImageFilter< TInputImage, TOutputImage >
@@ -245,18 +272,15 @@ SparseFieldLevelSetImageFilter< TInputImage, TOutputImage >
                     StatusType ChangeToStatus, StatusType SearchForStatus)
 {
   unsigned int   i;
-  bool           bounds_status;
   LayerNodeType *node;
   StatusType     neighbor_status;
+  IndexType      center_index;
+  OffsetValueType statusCenter, outputCenter;
+  OffsetValueType statusNeighbors[2 * ImageDimension];
+  OffsetValueType outputNeighbors[2 * ImageDimension];
 
-  NeighborhoodIterator< StatusImageType >
-  statusIt( m_NeighborList.GetRadius(), m_StatusImage,
-            this->GetOutput()->GetRequestedRegion() );
-
-  if ( m_BoundsCheckingActive == false )
-    {
-    statusIt.NeedToUseBoundaryConditionOff();
-    }
+  const bool boundsChecking = m_BoundsCheckingActive;
+  StatusType *statusBuffer = m_StatusImage->GetBufferPointer();
 
   // Push each index in the input list into its appropriate status layer
   // (ChangeToStatus) and update the status image value at that index.
@@ -264,8 +288,12 @@ SparseFieldLevelSetImageFilter< TInputImage, TOutputImage >
   // the output list (search for SearchForStatus).
   while ( !InputList->Empty() )
     {
-    statusIt.SetLocation(InputList->Front()->m_Value);
-    statusIt.SetCenterPixel(ChangeToStatus);
+    center_index = InputList->Front()->m_Value;
+    statusCenter = m_StatusImage->ComputeOffset(center_index);
+    outputCenter = this->m_OutputImage->ComputeOffset(center_index);
+    this->ComputeNeighborBufferOffsets(center_index, statusCenter, outputCenter,
+                                       boundsChecking, statusNeighbors, outputNeighbors);
+    statusBuffer[statusCenter] = ChangeToStatus;
 
     node = InputList->Front();  // Must unlink from the input list
     InputList->PopFront();      // _before_ transferring to another list.
@@ -273,7 +301,7 @@ SparseFieldLevelSetImageFilter< TInputImage, TOutputImage >
 
     for ( i = 0; i < m_NeighborList.GetSize(); ++i )
       {
-      neighbor_status = statusIt.GetPixel( m_NeighborList.GetArrayIndex(i) );
+      neighbor_status = statusBuffer[statusNeighbors[i]];
 
       // Have we bumped up against the boundary?  If so, turn on bounds
       // checking.
@@ -284,12 +312,11 @@ SparseFieldLevelSetImageFilter< TInputImage, TOutputImage >
 
       if ( neighbor_status == SearchForStatus )
         { // mark this pixel so we don't add it twice.
-        statusIt.SetPixel(m_NeighborList.GetArrayIndex(i),
-                          m_StatusChanging, bounds_status);
-        if ( bounds_status == true )
+        if ( statusNeighbors[i] != statusCenter )
           {
+          statusBuffer[statusNeighbors[i]] = m_StatusChanging;
           node = m_LayerNodeStore->Borrow();
-          node->m_Value = statusIt.GetIndex()
+          node->m_Value = center_index
                           + m_NeighborList.GetNeighborhoodOffset(i);
           OutputList->PushFront(node);
           } // else this index was out of bounds.
@@ -318,25 +345,19 @@ SparseFieldLevelSetImageFilter< TInputImage, TOutputImage >
   ValueType      new_value, temp_value, rms_change_accumulator;
   LayerNodeType *node, *release_node;
   StatusType     neighbor_status;
-  unsigned int   i, idx, counter;
-  bool           bounds_status, flag;
+  unsigned int   i, counter;
+  bool           flag;
 
   typename LayerType::Iterator layerIt;
   typename UpdateBufferType::const_iterator updateIt;
 
-  NeighborhoodIterator< OutputImageType >
-  outputIt( m_NeighborList.GetRadius(), this->GetOutput(),
-            this->GetOutput()->GetRequestedRegion() );
+  OffsetValueType statusCenter, outputCenter;
+  OffsetValueType statusNeighbors[2 * ImageDimension];
+  OffsetValueType outputNeighbors[2 * ImageDimension];
 
-  NeighborhoodIterator< StatusImageType >
-  statusIt( m_NeighborList.GetRadius(), m_StatusImage,
-            this->GetOutput()->GetRequestedRegion() );
-
-  if ( m_BoundsCheckingActive == false )
-    {
-    outputIt.NeedToUseBoundaryConditionOff();
-    statusIt.NeedToUseBoundaryConditionOff();
-    }
+  const bool boundsChecking = m_BoundsCheckingActive;
+  StatusType *statusBuffer = m_StatusImage->GetBufferPointer();
+  ValueType  *outputBuffer = this->m_OutputImage->GetBufferPointer();
 
   counter = 0;
   rms_change_accumulator = m_ValueZero;
@@ -344,12 +365,14 @@ SparseFieldLevelSetImageFilter< TInputImage, TOutputImage >
   updateIt = m_UpdateBuffer.begin();
   while ( layerIt != m_Layers[0]->End() )
     {
-    outputIt.SetLocation(layerIt->m_Value);
-    statusIt.SetLocation(layerIt->m_Value);
+    statusCenter = m_StatusImage->ComputeOffset(layerIt->m_Value);
+    outputCenter = this->m_OutputImage->ComputeOffset(layerIt->m_Value);
+    this->ComputeNeighborBufferOffsets(layerIt->m_Value, statusCenter, outputCenter,
+                                       boundsChecking, statusNeighbors, outputNeighbors);
 
     new_value = this->CalculateUpdateValue(layerIt->m_Value,
                                            dt,
-                                           outputIt.GetCenterPixel(),
+                                           outputBuffer[outputCenter],
                                            *updateIt);
 
     // If this index needs to be moved to another layer, then search its
@@ -370,8 +393,7 @@ SparseFieldLevelSetImageFilter< TInputImage, TOutputImage >
       flag = false;
       for ( i = 0; i < m_NeighborList.GetSize(); ++i )
         {
-        if ( statusIt.GetPixel( m_NeighborList.GetArrayIndex(i) )
-             == m_StatusActiveChangingDown )
+        if ( statusBuffer[statusNeighbors[i]] == m_StatusActiveChangingDown )
           {
           flag = true;
           break;
@@ -384,29 +406,31 @@ SparseFieldLevelSetImageFilter< TInputImage, TOutputImage >
         continue;
         }
 
-      rms_change_accumulator += vnl_math_sqr( new_value - outputIt.GetCenterPixel() );
+      rms_change_accumulator += vnl_math_sqr( new_value - outputBuffer[outputCenter] );
 
       // Search the neighborhood for inside indices.
       temp_value = new_value - m_ConstantGradientValue;
       for ( i = 0; i < m_NeighborList.GetSize(); ++i )
         {
-        idx = m_NeighborList.GetArrayIndex(i);
-        neighbor_status = statusIt.GetPixel(idx);
+        neighbor_status = statusBuffer[statusNeighbors[i]];
         if ( neighbor_status == 1 )
           {
           // Keep the smallest possible value for the new active node.  This
           // places the new active layer node closest to the zero level-set.
-          if ( outputIt.GetPixel(idx) < LOWER_ACTIVE_THRESHOLD
-               || ::vnl_math_abs(temp_value) < ::vnl_math_abs( outputIt.GetPixel(idx) ) )
+          if ( outputBuffer[outputNeighbors[i]] < LOWER_ACTIVE_THRESHOLD
+               || ::vnl_math_abs(temp_value) < ::vnl_math_abs( outputBuffer[outputNeighbors[i]] ) )
             {
-            outputIt.SetPixel(idx, temp_value, bounds_status);
+            if ( outputNeighbors[i] != outputCenter )
+              {
+              outputBuffer[outputNeighbors[i]] = temp_value;
+              }
             }
           }
         }
       node = m_LayerNodeStore->Borrow();
       node->m_Value = layerIt->m_Value;
       UpList->PushFront(node);
-      statusIt.SetCenterPixel(m_StatusActiveChangingUp);
+      statusBuffer[statusCenter] = m_StatusActiveChangingUp;
 
       // Now remove this index from the active list.
       release_node = layerIt.GetPointer();
@@ -422,8 +446,7 @@ SparseFieldLevelSetImageFilter< TInputImage, TOutputImage >
       flag = false;
       for ( i = 0; i < m_NeighborList.GetSize(); ++i )
         {
-        if ( statusIt.GetPixel( m_NeighborList.GetArrayIndex(i) )
-             == m_StatusActiveChangingUp )
+        if ( statusBuffer[statusNeighbors[i]] == m_StatusActiveChangingUp )
           {
           flag = true;
           break;
@@ -436,29 +459,31 @@ SparseFieldLevelSetImageFilter< TInputImage, TOutputImage >
         continue;
         }
 
-      rms_change_accumulator += vnl_math_sqr( new_value - outputIt.GetCenterPixel() );
+      rms_change_accumulator += vnl_math_sqr( new_value - outputBuffer[outputCenter] );
 
       // Search the neighborhood for outside indices.
       temp_value = new_value + m_ConstantGradientValue;
       for ( i = 0; i < m_NeighborList.GetSize(); ++i )
         {
-        idx = m_NeighborList.GetArrayIndex(i);
-        neighbor_status = statusIt.GetPixel(idx);
+        neighbor_status = statusBuffer[statusNeighbors[i]];
         if ( neighbor_status == 2 )
           {
           // Keep the smallest magnitude value for this active set node.  This
           // places the node closest to the active layer.
-          if ( outputIt.GetPixel(idx) >= UPPER_ACTIVE_THRESHOLD
-               || ::vnl_math_abs(temp_value) < ::vnl_math_abs( outputIt.GetPixel(idx) ) )
+          if ( outputBuffer[outputNeighbors[i]] >= UPPER_ACTIVE_THRESHOLD
+               || ::vnl_math_abs(temp_value) < ::vnl_math_abs( outputBuffer[outputNeighbors[i]] ) )
             {
-            outputIt.SetPixel(idx, temp_value, bounds_status);
+            if ( outputNeighbors[i] != outputCenter )
+              {
+              outputBuffer[outputNeighbors[i]] = temp_value;
+              }
             }
           }
         }
       node = m_LayerNodeStore->Borrow();
       node->m_Value = layerIt->m_Value;
       DownList->PushFront(node);
-      statusIt.SetCenterPixel(m_StatusActiveChangingDown);
+      statusBuffer[statusCenter] = m_StatusActiveChangingDown;
 
       // Now remove this index from the active list.
       release_node = layerIt.GetPointer();
@@ -468,9 +493,9 @@ SparseFieldLevelSetImageFilter< TInputImage, TOutputImage >
       }
     else
       {
-      rms_change_accumulator += vnl_math_sqr( new_value - outputIt.GetCenterPixel() );
+      rms_change_accumulator += vnl_math_sqr( new_value - outputBuffer[outputCenter] );
       //rms_change_accumulator += (*updateIt) * (*updateIt);
-      outputIt.SetCenterPixel(new_value);
+      outputBuffer[outputCenter] = new_value;
       ++layerIt;
       }
     ++updateIt;
@@ -549,6 +574,21 @@ SparseFieldLevelSetImageFilter< TInputImage, TOutputImage >
   m_StatusImage->SetRegions( this->GetOutput()->GetRequestedRegion() );
   m_StatusImage->Allocate();
 
+  // Buffer offsets of the city-block neighbors in the status and output
+  // images, so that the layer updates can address them directly.
+  m_StatusNeighborOffsets.assign(m_NeighborList.GetSize(), 0);
+  m_OutputNeighborOffsets.assign(m_NeighborList.GetSize(), 0);
+  for ( unsigned int i = 0; i < m_NeighborList.GetSize(); ++i )
+    {
+    for ( unsigned int j = 0; j < ImageDimension; ++j )
+      {
+      m_StatusNeighborOffsets[i] += m_NeighborList.GetNeighborhoodOffset(i)[j]
+                                    * m_StatusImage->GetOffsetTable()[j];
+      m_OutputNeighborOffsets[i] += m_NeighborList.GetNeighborhoodOffset(i)[j]
+                                    * this->m_OutputImage->GetOffsetTable()[j];
+      }
+    }
+
   // Initialize the status image to contain all m_StatusNull values.
   ImageRegionIterator< StatusImageType >
   statusIt( m_StatusImage, m_StatusImage->GetRequestedRegion() );
@@ -901,6 +941,123 @@ SparseFieldLevelSetImageFilter< TInputImage, TOutputImage >::TimeStepType
 SparseFieldLevelSetImageFilter< TInputImage, TOutputImage >
 ::CalculateChange()
 {
+  const typename Superclass::FiniteDifferenceFunctionType::Pointer df =
+    this->GetDifferenceFunction();
+
+  // Collect the active layer nodes so that the threads can address their
+  // part of the list directly.  The update buffer keeps the list order.
+  m_ActiveLayerNodes.clear();
+  m_ActiveLayerNodes.reserve( m_Layers[0]->Size() );
+  for ( typename LayerType::ConstIterator layerIt = m_Layers[0]->Begin();
+        layerIt != m_Layers[0]->End(); ++layerIt )
+    {
+    m_ActiveLayerNodes.push_back( layerIt.GetPointer() );
+    }
+  m_UpdateBuffer.resize( m_ActiveLayerNodes.size() );
+
+  // Only the level set functions know how to merge the global data of
+  // several threads.  Small layers are not worth starting the threads.
+  typedef LevelSetFunction< OutputImageType > LevelSetFunctionType;
+  const LevelSetFunctionType *levelSetFunction =
+    dynamic_cast< const LevelSetFunctionType * >( df.GetPointer() );
+
+  const SizeValueType minimumNumberOfNodesPerThread = 128;
+  ThreadIdType numberOfThreads = 1;
+  if ( levelSetFunction != ITK_NULLPTR )
+    {
+    numberOfThreads = std::min( this->GetNumberOfThreads(),
+      static_cast< ThreadIdType >( m_ActiveLayerNodes.size() / minimumNumberOfNodesPerThread ) );
+    numberOfThreads = std::max( numberOfThreads, static_cast< ThreadIdType >( 1 ) );
+    }
+  if ( numberOfThreads > 1 )
+    {
+    this->GetMultiThreader()->SetNumberOfThreads( numberOfThreads );
+    numberOfThreads = this->GetMultiThreader()->GetNumberOfThreads();
+    }
+
+  m_ThreadGlobalData.resize( numberOfThreads );
+  for ( ThreadIdType t = 0; t < numberOfThreads; t++ )
+    {
+    m_ThreadGlobalData[t] = df->GetGlobalDataPointer();
+    }
+  m_ThreadExceptionDescription.assign( numberOfThreads, std::string() );
+
+  if ( numberOfThreads == 1 )
+    {
+    this->ThreadedCalculateChange( 0, 1 );
+    }
+  else
+    {
+    CalculateChangeThreadStruct str;
+    str.Filter = this;
+    this->GetMultiThreader()->SetSingleMethod( this->CalculateChangeThreaderCallback, &str );
+    this->GetMultiThreader()->SingleMethodExecute();
+    }
+
+  // Ask the finite difference function to compute the time step for
+  // this iteration from the merged global data, then free the global
+  // data memory.
+  for ( ThreadIdType t = 1; t < numberOfThreads; t++ )
+    {
+    levelSetFunction->MergeGlobalData( m_ThreadGlobalData[0], m_ThreadGlobalData[t] );
+    df->ReleaseGlobalDataPointer( m_ThreadGlobalData[t] );
+    }
+  const TimeStepType timeStep = df->ComputeGlobalTimeStep( m_ThreadGlobalData[0] );
+  df->ReleaseGlobalDataPointer( m_ThreadGlobalData[0] );
+
+  m_ThreadGlobalData.clear();
+  m_ActiveLayerNodes.clear();
+
+  for ( ThreadIdType t = 0; t < numberOfThreads; t++ )
+    {
+    if ( !m_ThreadExceptionDescription[t].empty() )
+      {
+      itkExceptionMacro( << m_ThreadExceptionDescription[t] );
+      }
+    }
+
+  return timeStep;
+}
+
+template< typename TInputImage, typename TOutputImage >
+ITK_THREAD_RETURN_TYPE
+SparseFieldLevelSetImageFilter< TInputImage, TOutputImage >
+::CalculateChangeThreaderCallback(void *arg)
+{
+  MultiThreader::ThreadInfoStruct *info = static_cast< MultiThreader::ThreadInfoStruct * >( arg );
+  CalculateChangeThreadStruct *str = static_cast< CalculateChangeThreadStruct * >( info->UserData );
+
+  try
+    {
+    str->Filter->ThreadedCalculateChange( info->ThreadID, info->NumberOfThreads );
+    }
+  catch ( ExceptionObject & e )
+    {
+    str->Filter->m_ThreadExceptionDescription[info->ThreadID] = e.GetDescription();
+    }
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+SparseFieldLevelSetImageFilter< TInputImage, TOutputImage >
+::ThreadedCalculateChange(ThreadIdType threadId, ThreadIdType numberOfThreads)
+{
+  // Each thread processes a contiguous part of the active layer list.
+  const SizeValueType numberOfNodes = m_ActiveLayerNodes.size();
+  SizeValueType       count = numberOfNodes / numberOfThreads;
+  const SizeValueType remainder = numberOfNodes % numberOfThreads;
+  const SizeValueType first = threadId * count + std::min( static_cast< SizeValueType >( threadId ), remainder );
+  if ( threadId < remainder )
+    {
+    ++count;
+    }
+  if ( count == 0 )
+    {
+    return;
+    }
+
   const typename Superclass::FiniteDifferenceFunctionType::Pointer df =
     this->GetDifferenceFunction();
   typename Superclass::FiniteDifferenceFunctionType::FloatOffsetType offset;
@@ -918,28 +1075,23 @@ SparseFieldLevelSetImageFilter< TInputImage, TOutputImage >
     MIN_NORM *= minSpacing;
     }
 
-  void *globalData = df->GetGlobalDataPointer();
+  void *globalData = m_ThreadGlobalData[threadId];
 
-  typename LayerType::ConstIterator layerIt;
   NeighborhoodIterator< OutputImageType > outputIt( df->GetRadius(),
                                                     this->m_OutputImage, this->m_OutputImage->GetRequestedRegion() );
-  TimeStepType timeStep;
 
   if ( m_BoundsCheckingActive == false )
     {
     outputIt.NeedToUseBoundaryConditionOff();
     }
 
-  m_UpdateBuffer.clear();
-  m_UpdateBuffer.reserve( m_Layers[0]->Size() );
-
   // Calculates the update values for the active layer indices in this
   // iteration.  Iterates through the active layer index list, applying
   // the level set function to the output image (level set image) at each
   // index.  Update values are stored in the update buffer.
-  for ( layerIt = m_Layers[0]->Begin(); layerIt != m_Layers[0]->End(); ++layerIt )
+  for ( SizeValueType n = first; n < first + count; ++n )
     {
-    outputIt.SetLocation(layerIt->m_Value);
+    outputIt.SetLocation(m_ActiveLayerNodes[n]->m_Value);
 
     // Calculate the offset to the surface from the center of this
     // neighborhood.  This is used by some level set functions in sampling a
@@ -992,22 +1144,13 @@ SparseFieldLevelSetImageFilter< TInputImage, TOutputImage >
         offset[i] = ( offset[i] * centerValue ) / ( norm_grad_phi_squared + MIN_NORM );
         }
 
-      m_UpdateBuffer.push_back( df->ComputeUpdate(outputIt, globalData, offset) );
+      m_UpdateBuffer[n] = df->ComputeUpdate(outputIt, globalData, offset);
       }
     else // Don't do interpolation
       {
-      m_UpdateBuffer.push_back( df->ComputeUpdate(outputIt, globalData) );
+      m_UpdateBuffer[n] = df->ComputeUpdate(outputIt, globalData);
       }
     }
-
-  // Ask the finite difference function to compute the time step for
-  // this iteration.  We give it the global data pointer to use, then
-  // ask it to free the global data memory.
-  timeStep = df->ComputeGlobalTimeStep(globalData);
-
-  df->ReleaseGlobalDataPointer(globalData);
-
-  return timeStep;
 }
 
 template< typename TInputImage, typename TOutputImage >
@@ -1050,28 +1193,23 @@ SparseFieldLevelSetImageFilter< TInputImage, TOutputImage >
   if ( InOrOut == 1 ) { delta = -m_ConstantGradientValue; }
   else { delta = m_ConstantGradientValue; }
 
-  NeighborhoodIterator< OutputImageType >
-  outputIt( m_NeighborList.GetRadius(), this->m_OutputImage,
-            this->m_OutputImage->GetRequestedRegion() );
-  NeighborhoodIterator< StatusImageType >
-  statusIt( m_NeighborList.GetRadius(), m_StatusImage,
-            this->m_OutputImage->GetRequestedRegion() );
+  OffsetValueType statusCenter, outputCenter;
+  OffsetValueType statusNeighbors[2 * ImageDimension];
+  OffsetValueType outputNeighbors[2 * ImageDimension];
 
-  if ( m_BoundsCheckingActive == false )
-    {
-    outputIt.NeedToUseBoundaryConditionOff();
-    statusIt.NeedToUseBoundaryConditionOff();
-    }
+  const bool boundsChecking = m_BoundsCheckingActive;
+  StatusType *statusBuffer = m_StatusImage->GetBufferPointer();
+  ValueType  *outputBuffer = this->m_OutputImage->GetBufferPointer();
 
   toIt  = m_Layers[to]->Begin();
   while ( toIt != m_Layers[to]->End() )
     {
-    statusIt.SetLocation(toIt->m_Value);
+    statusCenter = m_StatusImage->ComputeOffset(toIt->m_Value);
 
     // Is this index marked for deletion? If the status image has
     // been marked with another layer's value, we need to delete this node
     // from the current list then skip to the next iteration.
-    if ( statusIt.GetCenterPixel() != to )
+    if ( statusBuffer[statusCenter] != to )
       {
       node = toIt.GetPointer();
       ++toIt;
@@ -1080,7 +1218,9 @@ SparseFieldLevelSetImageFilter< TInputImage, TOutputImage >
       continue;
       }
 
-    outputIt.SetLocation(toIt->m_Value);
+    outputCenter = this->m_OutputImage->ComputeOffset(toIt->m_Value);
+    this->ComputeNeighborBufferOffsets(toIt->m_Value, statusCenter, outputCenter,
+                                       boundsChecking, statusNeighbors, outputNeighbors);
 
     found_neighbor_flag = false;
     for ( i = 0; i < m_NeighborList.GetSize(); ++i )
@@ -1088,9 +1228,9 @@ SparseFieldLevelSetImageFilter< TInputImage, TOutputImage >
       // If this neighbor is in the "from" list, compare its absolute value
       // to to any previous values found in the "from" list.  Keep the value
       // that will cause the next layer to be closest to the zero level set.
-      if ( statusIt.GetPixel( m_NeighborList.GetArrayIndex(i) ) == from )
+      if ( statusBuffer[statusNeighbors[i]] == from )
         {
-        value_temp = outputIt.GetPixel( m_NeighborList.GetArrayIndex(i) );
+        value_temp = outputBuffer[outputNeighbors[i]];
 
         if ( found_neighbor_flag == false )
           {
@@ -1122,7 +1262,7 @@ SparseFieldLevelSetImageFilter< TInputImage, TOutputImage >
       {
       // Set the new value using the smallest distance
       // found in our "from" neighbors.
-      outputIt.SetCenterPixel(value + delta);
+      outputBuffer[outputCenter] = value + delta;
       ++toIt;
       }
     else
@@ -1137,12 +1277,12 @@ SparseFieldLevelSetImageFilter< TInputImage, TOutputImage >
       if ( promote > past_end )
         {
         m_LayerNodeStore->Return(node);
-        statusIt.SetCenterPixel(m_StatusNull);
+        statusBuffer[statusCenter] = m_StatusNull;
         }
       else
         {
         m_Layers[promote]->PushFront(node);
-        statusIt.SetCenterPixel(promote);
+        statusBuffer[statusCenter] = promote;
         }
       }
     }
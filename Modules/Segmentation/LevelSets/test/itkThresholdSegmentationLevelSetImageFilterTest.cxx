@@ -17,6 +17,7 @@
  *=========================================================================*/
 
 #include "itkThresholdSegmentationLevelSetImageFilter.h"
+#include "itkImageRegionConstIterator.h"
 
 namespace TSIFTN {
 
@@ -234,5 +235,58 @@ int itkThresholdSegmentationLevelSetImageFilterTest(int, char * [] )
     return EXIT_FAILURE;
     }
 
+  // The changes at the active layer are computed by several threads, which
+  // must give the same result as a single thread.
+  FilterType::Pointer singleThreaded = FilterType::New();
+  FilterType::Pointer multiThreaded = FilterType::New();
+  FilterType::Pointer filters[2] = { singleThreaded, multiThreaded };
+  for (i = 0; i < 2; ++i)
+    {
+    filters[i]->SetInput(seedImage);
+    filters[i]->SetFeatureImage(inputImage);
+    filters[i]->SetUpperThreshold(63);
+    filters[i]->SetLowerThreshold(50);
+    filters[i]->SetMaximumRMSError(0.0);
+    filters[i]->SetNumberOfIterations(10);
+    filters[i]->ReverseExpansionDirectionOn();
+    filters[i]->SetIsoSurfaceValue(0.5);
+    }
+  singleThreaded->SetNumberOfThreads(1);
+  multiThreaded->SetNumberOfThreads(4);
+
+  try
+    {
+    singleThreaded->Update();
+    multiThreaded->Update();
+    }
+  catch (itk::ExceptionObject &e)
+    {
+    std::cerr << e << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  if ( singleThreaded->GetRMSChange() != multiThreaded->GetRMSChange() )
+    {
+    std::cerr << "The RMS change depends on the number of threads: "
+              << singleThreaded->GetRMSChange() << " != "
+              << multiThreaded->GetRMSChange() << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  itk::ImageRegionConstIterator< TSIFTN::ImageType >
+    singleIt(singleThreaded->GetOutput(), reg);
+  itk::ImageRegionConstIterator< TSIFTN::ImageType >
+    multiIt(multiThreaded->GetOutput(), reg);
+  for (; !singleIt.IsAtEnd(); ++singleIt, ++multiIt)
+    {
+    if ( singleIt.Get() != multiIt.Get() )
+      {
+      std::cerr << "The output depends on the number of threads at "
+                << singleIt.GetIndex() << ": " << singleIt.Get()
+                << " != " << multiIt.Get() << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
   return EXIT_SUCCESS;
 }
@@ -289,7 +289,7 @@ LevelSetEvolution< TEquationContainer, WhitakerSparseLevelSetImage< TOutput, VDi
   while( this->m_LevelSetContainerIteratorToProcessWhenThreading != this->m_LevelSetContainer->End() )
     {
     typename LevelSetType::ConstPointer levelSet = this->m_LevelSetContainerIteratorToProcessWhenThreading->GetLevelSet();
-    const LevelSetLayerType zeroLayer = levelSet->GetLayer( 0 );
+    const LevelSetLayerType & zeroLayer = levelSet->GetLayer( 0 );
     typename LevelSetType::LayerConstIterator layerBegin = zeroLayer.begin();
     typename LevelSetType::LayerConstIterator layerEnd = zeroLayer.end();
     typename SplitLevelSetPartitionerType::DomainType completeDomain( layerBegin, layerEnd );
@@ -372,7 +372,8 @@ LevelSetEvolution< TEquationContainer, WhitakerSparseLevelSetImage< TOutput, VDi
 // Shi
 template< typename TEquationContainer, unsigned int VDimension >
 LevelSetEvolution< TEquationContainer, ShiSparseLevelSetImage< VDimension > >
-::LevelSetEvolution()
+::LevelSetEvolution() :
+  m_NumberOfThreads( MultiThreader::GetGlobalDefaultNumberOfThreads() )
 {
 }
 
@@ -381,6 +382,22 @@ LevelSetEvolution< TEquationContainer, ShiSparseLevelSetImage< VDimension > >
 ::~LevelSetEvolution()
 {}
 
+template< typename TEquationContainer, unsigned int VDimension >
+void
+LevelSetEvolution< TEquationContainer, ShiSparseLevelSetImage< VDimension > >
+::SetNumberOfThreads( const ThreadIdType numberOfThreads )
+{
+  this->m_NumberOfThreads = numberOfThreads;
+}
+
+template< typename TEquationContainer, unsigned int VDimension >
+ThreadIdType
+LevelSetEvolution< TEquationContainer, ShiSparseLevelSetImage< VDimension > >
+::GetNumberOfThreads() const
+{
+  return this->m_NumberOfThreads;
+}
+
 template< typename TEquationContainer, unsigned int VDimension >
 void LevelSetEvolution< TEquationContainer, ShiSparseLevelSetImage< VDimension > >
 ::UpdateLevelSets()
@@ -395,6 +412,7 @@ void LevelSetEvolution< TEquationContainer, ShiSparseLevelSetImage< VDimension >
     updateLevelSet->SetInputLevelSet( levelSet );
     updateLevelSet->SetCurrentLevelSetId( it->GetIdentifier() );
     updateLevelSet->SetEquationContainer( this->m_EquationContainer );
+    updateLevelSet->SetNumberOfThreads( this->m_NumberOfThreads );
     updateLevelSet->Update();
 
     levelSet->Graft( updateLevelSet->GetOutputLevelSet() );
@@ -415,7 +433,8 @@ void LevelSetEvolution< TEquationContainer, ShiSparseLevelSetImage< VDimension >
 // Malcolm
 template< typename TEquationContainer, unsigned int VDimension >
 LevelSetEvolution< TEquationContainer, MalcolmSparseLevelSetImage< VDimension > >
-::LevelSetEvolution()
+::LevelSetEvolution() :
+  m_NumberOfThreads( MultiThreader::GetGlobalDefaultNumberOfThreads() )
 {
 }
 
@@ -424,6 +443,22 @@ LevelSetEvolution< TEquationContainer, MalcolmSparseLevelSetImage< VDimension >
 ::~LevelSetEvolution()
 {}
 
+template< typename TEquationContainer, unsigned int VDimension >
+void
+LevelSetEvolution< TEquationContainer, MalcolmSparseLevelSetImage< VDimension > >
+::SetNumberOfThreads( const ThreadIdType numberOfThreads )
+{
+  this->m_NumberOfThreads = numberOfThreads;
+}
+
+template< typename TEquationContainer, unsigned int VDimension >
+ThreadIdType
+LevelSetEvolution< TEquationContainer, MalcolmSparseLevelSetImage< VDimension > >
+::GetNumberOfThreads() const
+{
+  return this->m_NumberOfThreads;
+}
+
 template< typename TEquationContainer, unsigned int VDimension >
 void LevelSetEvolution< TEquationContainer, MalcolmSparseLevelSetImage< VDimension > >
 ::UpdateLevelSets()
@@ -439,6 +474,7 @@ void LevelSetEvolution< TEquationContainer, MalcolmSparseLevelSetImage< VDimensi
     updateLevelSet->SetInputLevelSet( levelSet );
     updateLevelSet->SetCurrentLevelSetId( levelSetId );
     updateLevelSet->SetEquationContainer( this->m_EquationContainer );
+    updateLevelSet->SetNumberOfThreads( this->m_NumberOfThreads );
     updateLevelSet->Update();
 
     levelSet->Graft( updateLevelSet->GetOutputLevelSet() );
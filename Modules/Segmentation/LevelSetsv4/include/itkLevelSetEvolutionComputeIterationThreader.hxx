@@ -238,13 +238,17 @@ LevelSetEvolutionComputeIterationThreader<
   LevelSetIdentifierType levelSetId = it->GetIdentifier();
   typename LevelSetEvolutionType::LevelSetLayerType * levelSetLayerUpdateBuffer = this->m_Associate->m_UpdateBuffer[ levelSetId ];
 
+  // the sub-ranges follow the layer order, so each pair goes right after the
+  // previous one
+  typename LevelSetEvolutionType::LevelSetLayerType::iterator hintIt = levelSetLayerUpdateBuffer->end();
+
   const ThreadIdType numberOfThreads = this->GetNumberOfThreadsUsed();
   for( ThreadIdType ii = 0; ii < numberOfThreads; ++ii )
     {
     typename std::vector< NodePairType >::const_iterator pairIt = this->m_NodePairsPerThread[ii].begin();
     while( pairIt != this->m_NodePairsPerThread[ii].end() )
       {
-      levelSetLayerUpdateBuffer->insert( *pairIt );
+      hintIt = levelSetLayerUpdateBuffer->insert( hintIt, *pairIt );
       ++pairIt;
       }
     }
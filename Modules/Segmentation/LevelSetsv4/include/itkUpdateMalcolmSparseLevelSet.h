@@ -27,6 +27,7 @@
 #include "itkNeighborhoodAlgorithm.h"
 #include "itkLabelMapToLabelImageFilter.h"
 #include "itkLabelImageToLabelMapFilter.h"
+#include "itkUpdateSparseLevelSetEvaluationThreader.h"
 
 namespace itk
 {
@@ -103,6 +104,11 @@ public:
   itkSetMacro( CurrentLevelSetId, IdentifierType );
   itkGetMacro( CurrentLevelSetId, IdentifierType );
 
+  /** Set/Get the maximum number of threads used to evaluate the equation
+   * over a layer */
+  void SetNumberOfThreads( const ThreadIdType numberOfThreads );
+  ThreadIdType GetNumberOfThreads() const;
+
 protected:
   UpdateMalcolmSparseLevelSet();
   virtual ~UpdateMalcolmSparseLevelSet();
@@ -123,6 +129,10 @@ protected:
 
   typedef ShapedNeighborhoodIterator< LabelImageType > NeighborhoodIteratorType;
 
+  friend class UpdateSparseLevelSetEvaluationThreader< Self >;
+  typedef UpdateSparseLevelSetEvaluationThreader< Self > EvaluationThreaderType;
+  SmartPointer< EvaluationThreaderType >                 m_EvaluationThreader;
+
   bool m_IsUsingUnPhasedPropagation;
 
   /** Compute the updates for all points in the 0 layer and store in UpdateContainer */
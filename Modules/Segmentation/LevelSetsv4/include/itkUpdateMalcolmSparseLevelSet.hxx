@@ -34,6 +34,7 @@ UpdateMalcolmSparseLevelSet< VDimension, TEquationContainer >
 {
   this->m_Offset.Fill( 0 );
   this->m_OutputLevelSet = LevelSetType::New();
+  this->m_EvaluationThreader = EvaluationThreaderType::New();
 }
 
 template< unsigned int VDimension, typename TEquationContainer >
@@ -41,6 +42,22 @@ UpdateMalcolmSparseLevelSet< VDimension, TEquationContainer >
 ::~UpdateMalcolmSparseLevelSet()
 {}
 
+template< unsigned int VDimension, typename TEquationContainer >
+void
+UpdateMalcolmSparseLevelSet< VDimension, TEquationContainer >
+::SetNumberOfThreads( const ThreadIdType numberOfThreads )
+{
+  this->m_EvaluationThreader->SetMaximumNumberOfThreads( numberOfThreads );
+}
+
+template< unsigned int VDimension, typename TEquationContainer >
+ThreadIdType
+UpdateMalcolmSparseLevelSet< VDimension, TEquationContainer >
+::GetNumberOfThreads() const
+{
+  return this->m_EvaluationThreader->GetMaximumNumberOfThreads();
+}
+
 
 template< unsigned int VDimension, typename TEquationContainer >
 void
@@ -134,20 +151,23 @@ void
 UpdateMalcolmSparseLevelSet< VDimension, TEquationContainer >
 ::FillUpdateContainer()
 {
-  LevelSetLayerType levelZero = this->m_OutputLevelSet->GetLayer( LevelSetType::ZeroLayer() );
+  const LevelSetLayerType & levelZero = this->m_OutputLevelSet->GetLayer( LevelSetType::ZeroLayer() );
 
-  LevelSetLayerIterator nodeIt = levelZero.begin();
-  LevelSetLayerIterator nodeEnd = levelZero.end();
+  this->m_EvaluationThreader->EvaluateLayer( this, levelZero );
+  typename EvaluationThreaderType::UpdateContainerType::const_iterator
+    upIt = this->m_EvaluationThreader->GetUpdates().begin();
 
-  TermContainerPointer termContainer = this->m_EquationContainer->GetEquation( this->m_CurrentLevelSetId );
+  LevelSetLayerConstIterator nodeIt = levelZero.begin();
+  LevelSetLayerConstIterator nodeEnd = levelZero.end();
+
+  // the nodes come in order, so each one is appended at the end
+  LevelSetLayerIterator updateIt = this->m_Update.end();
 
-  LevelSetInputType inputIndex;
   while( nodeIt != nodeEnd )
     {
     const LevelSetInputType currentIndex = nodeIt->first;
-    inputIndex = currentIndex + this->m_Offset;
 
-    const LevelSetOutputRealType update = termContainer->Evaluate( inputIndex );
+    const LevelSetOutputRealType update = *upIt;
 
     LevelSetOutputType value = NumericTraits< LevelSetOutputType >::ZeroValue();
 
@@ -160,9 +180,10 @@ UpdateMalcolmSparseLevelSet< VDimension, TEquationContainer >
       value = - NumericTraits< LevelSetOutputType >::OneValue();
       }
 
-    this->m_Update.insert( NodePairType( currentIndex, value ) );
+    updateIt = this->m_Update.insert( updateIt, NodePairType( currentIndex, value ) );
 
     ++nodeIt;
+    ++upIt;
     }
 }
 
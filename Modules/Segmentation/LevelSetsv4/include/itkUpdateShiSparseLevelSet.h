@@ -27,6 +27,7 @@
 #include "itkNeighborhoodAlgorithm.h"
 #include "itkLabelMapToLabelImageFilter.h"
 #include "itkLabelImageToLabelMapFilter.h"
+#include "itkUpdateSparseLevelSetEvaluationThreader.h"
 
 namespace itk
 {
@@ -103,6 +104,11 @@ public:
   itkSetMacro( CurrentLevelSetId, IdentifierType );
   itkGetMacro( CurrentLevelSetId, IdentifierType );
 
+  /** Set/Get the maximum number of threads used to evaluate the equation
+   * over a layer */
+  void SetNumberOfThreads( const ThreadIdType numberOfThreads );
+  ThreadIdType GetNumberOfThreads() const;
+
 protected:
   UpdateShiSparseLevelSet();
   virtual ~UpdateShiSparseLevelSet();
@@ -121,6 +127,10 @@ protected:
 
   typedef ShapedNeighborhoodIterator< LabelImageType > NeighborhoodIteratorType;
 
+  friend class UpdateSparseLevelSetEvaluationThreader< Self >;
+  typedef UpdateSparseLevelSetEvaluationThreader< Self > EvaluationThreaderType;
+  SmartPointer< EvaluationThreaderType >                 m_EvaluationThreader;
+
   /** Update +1 level set layers by checking the direction of the movement towards -1 */
   // this is the same as Procedure 2
   // Input is a update image point m_UpdateImage
@@ -32,6 +32,7 @@ UpdateShiSparseLevelSet< VDimension, TEquationContainer >
 {
   this->m_Offset.Fill( 0 );
   this->m_OutputLevelSet = LevelSetType::New();
+  this->m_EvaluationThreader = EvaluationThreaderType::New();
 }
 
 template< unsigned int VDimension,
@@ -40,6 +41,22 @@ UpdateShiSparseLevelSet< VDimension, TEquationContainer >
 ::~UpdateShiSparseLevelSet()
 {}
 
+template< unsigned int VDimension, typename TEquationContainer >
+void
+UpdateShiSparseLevelSet< VDimension, TEquationContainer >
+::SetNumberOfThreads( const ThreadIdType numberOfThreads )
+{
+  this->m_EvaluationThreader->SetMaximumNumberOfThreads( numberOfThreads );
+}
+
+template< unsigned int VDimension, typename TEquationContainer >
+ThreadIdType
+UpdateShiSparseLevelSet< VDimension, TEquationContainer >
+::GetNumberOfThreads() const
+{
+  return this->m_EvaluationThreader->GetMaximumNumberOfThreads();
+}
+
 
 template< unsigned int VDimension, typename TEquationContainer >
 void
@@ -229,21 +246,25 @@ UpdateShiSparseLevelSet< VDimension, TEquationContainer >
   LevelSetLayerType insertListIn;
   LevelSetLayerType insertListOut;
 
+  // the level set is only modified once every point has been visited,
+  // hence the updates can be evaluated beforehand, in parallel
+  this->m_EvaluationThreader->EvaluateLayer( this, listOut );
+  typename EvaluationThreaderType::UpdateContainerType::const_iterator
+    upIt = this->m_EvaluationThreader->GetUpdates().begin();
+
   LevelSetLayerIterator nodeIt   = listOut.begin();
   LevelSetLayerIterator nodeEnd  = listOut.end();
 
-  LevelSetInputType inputIndex;
-
   // for each point in Lz
   while( nodeIt != nodeEnd )
     {
     bool erased = false;
     const LevelSetInputType   currentIndex = nodeIt->first;
     const LevelSetOutputType  currentValue = nodeIt->second;
-    inputIndex = currentIndex + this->m_Offset;
 
     // update the level set
-    LevelSetOutputRealType update = termContainer->Evaluate( inputIndex );
+    LevelSetOutputRealType update = *upIt;
+    ++upIt;
 
     if( update < NumericTraits< LevelSetOutputRealType >::ZeroValue() )
       {
@@ -346,6 +367,10 @@ UpdateShiSparseLevelSet< VDimension, TEquationContainer >
   LevelSetLayerType insertListIn;
   LevelSetLayerType insertListOut;
 
+  this->m_EvaluationThreader->EvaluateLayer( this, listIn );
+  typename EvaluationThreaderType::UpdateContainerType::const_iterator
+    upIt = this->m_EvaluationThreader->GetUpdates().begin();
+
   LevelSetLayerIterator nodeIt   = listIn.begin();
   LevelSetLayerIterator nodeEnd  = listIn.end();
 
@@ -355,10 +380,10 @@ UpdateShiSparseLevelSet< VDimension, TEquationContainer >
     bool erased = false;
     const LevelSetInputType   currentIndex = nodeIt->first;
     const LevelSetOutputType  currentValue = nodeIt->second;
-    const LevelSetInputType inputIndex = currentIndex + this->m_Offset;
 
     // update for the current level set
-    LevelSetOutputRealType update = termContainer->Evaluate( inputIndex );
+    LevelSetOutputRealType update = *upIt;
+    ++upIt;
 
     if( update > NumericTraits< LevelSetOutputRealType >::ZeroValue() )
       {
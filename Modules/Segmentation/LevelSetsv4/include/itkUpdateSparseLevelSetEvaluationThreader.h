@@ -0,0 +1,108 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkUpdateSparseLevelSetEvaluationThreader_h
+#define itkUpdateSparseLevelSetEvaluationThreader_h
+
+#include "itkDomainThreader.h"
+#include "itkThreadedIteratorRangePartitioner.h"
+
+namespace itk
+{
+
+/** \class UpdateSparseLevelSetEvaluationThreader
+ * \brief Thread the evaluation of the equation over one layer of a sparse
+ * level set.
+ *
+ * The Shi and Malcolm update classes evaluate the level set equation at every
+ * node of a layer before moving any of them. Those evaluations only read the
+ * level set, so they are split over threads here. The results are stored in
+ * the order of the layer, so that the update class can walk them alongside
+ * the layer and behave exactly as if the equation was evaluated in the loop.
+ *
+ * \tparam TUpdateLevelSet Update class owning the threader; it must grant
+ * friendship to this class.
+ *
+ * \ingroup ITKLevelSetsv4
+ */
+template< typename TUpdateLevelSet >
+class UpdateSparseLevelSetEvaluationThreader
+  : public DomainThreader< ThreadedIteratorRangePartitioner< typename TUpdateLevelSet::LevelSetLayerConstIterator >, TUpdateLevelSet >
+{
+public:
+  /** Standard class typedefs. */
+  typedef UpdateSparseLevelSetEvaluationThreader                                                                                 Self;
+  typedef DomainThreader< ThreadedIteratorRangePartitioner< typename TUpdateLevelSet::LevelSetLayerConstIterator >, TUpdateLevelSet > Superclass;
+  typedef SmartPointer< Self >                                                                                                   Pointer;
+  typedef SmartPointer< const Self >                                                                                             ConstPointer;
+
+  /** Run time type information. */
+  itkTypeMacro( UpdateSparseLevelSetEvaluationThreader, DomainThreader );
+
+  /** Standard New macro. */
+  itkNewMacro( Self );
+
+  /** Superclass types. */
+  typedef typename Superclass::DomainType    DomainType;
+  typedef typename Superclass::AssociateType AssociateType;
+
+  /** Types of the associate class. */
+  typedef TUpdateLevelSet                                         UpdateLevelSetType;
+  typedef typename UpdateLevelSetType::LevelSetLayerType          LevelSetLayerType;
+  typedef typename UpdateLevelSetType::LevelSetLayerConstIterator LevelSetLayerConstIterator;
+  typedef typename UpdateLevelSetType::LevelSetInputType          LevelSetInputType;
+  typedef typename UpdateLevelSetType::LevelSetOutputRealType     LevelSetOutputRealType;
+  typedef typename UpdateLevelSetType::TermContainerPointer       TermContainerPointer;
+
+  typedef std::vector< LevelSetOutputRealType > UpdateContainerType;
+
+  /** Evaluate the equation at every node of the layer. The i-th value of
+   * GetUpdates() then belongs to the i-th node of the layer. */
+  void EvaluateLayer( AssociateType * updateLevelSet, const LevelSetLayerType & layer );
+
+  /** Updates computed by the last call to EvaluateLayer(). */
+  const UpdateContainerType & GetUpdates() const
+  {
+    return this->m_Updates;
+  }
+
+protected:
+  UpdateSparseLevelSetEvaluationThreader();
+
+  virtual void BeforeThreadedExecution() ITK_OVERRIDE;
+
+  virtual void ThreadedExecution( const DomainType & iteratorSubRange, const ThreadIdType threadId ) ITK_OVERRIDE;
+
+  virtual void AfterThreadedExecution() ITK_OVERRIDE;
+
+  typedef std::vector< UpdateContainerType > UpdatesPerThreadType;
+  UpdatesPerThreadType m_UpdatesPerThread;
+
+  UpdateContainerType m_Updates;
+
+private:
+  UpdateSparseLevelSetEvaluationThreader( const Self & ); // purposely not implemented
+  void operator=( const Self & ); // purposely not implemented
+};
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkUpdateSparseLevelSetEvaluationThreader.hxx"
+#endif
+
+#endif
@@ -0,0 +1,103 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkUpdateSparseLevelSetEvaluationThreader_hxx
+#define itkUpdateSparseLevelSetEvaluationThreader_hxx
+
+#include "itkUpdateSparseLevelSetEvaluationThreader.h"
+
+namespace itk
+{
+
+template< typename TUpdateLevelSet >
+UpdateSparseLevelSetEvaluationThreader< TUpdateLevelSet >
+::UpdateSparseLevelSetEvaluationThreader()
+{
+}
+
+template< typename TUpdateLevelSet >
+void
+UpdateSparseLevelSetEvaluationThreader< TUpdateLevelSet >
+::EvaluateLayer( AssociateType * updateLevelSet, const LevelSetLayerType & layer )
+{
+  this->m_Updates.clear();
+
+  // the range partitioner cannot split an empty range
+  if( layer.empty() )
+    {
+    return;
+    }
+
+  DomainType completeDomain( layer.begin(), layer.end() );
+  this->Execute( updateLevelSet, completeDomain );
+}
+
+template< typename TUpdateLevelSet >
+void
+UpdateSparseLevelSetEvaluationThreader< TUpdateLevelSet >
+::BeforeThreadedExecution()
+{
+  const ThreadIdType numberOfThreads = this->GetNumberOfThreadsUsed();
+  this->m_UpdatesPerThread.resize( numberOfThreads );
+
+  for( ThreadIdType ii = 0; ii < numberOfThreads; ++ii )
+    {
+    this->m_UpdatesPerThread[ii].clear();
+    }
+}
+
+template< typename TUpdateLevelSet >
+void
+UpdateSparseLevelSetEvaluationThreader< TUpdateLevelSet >
+::ThreadedExecution( const DomainType & iteratorSubRange,
+                     const ThreadIdType threadId )
+{
+  TermContainerPointer termContainer =
+    this->m_Associate->m_EquationContainer->GetEquation( this->m_Associate->m_CurrentLevelSetId );
+
+  const typename UpdateLevelSetType::LevelSetOffsetType offset = this->m_Associate->m_Offset;
+
+  UpdateContainerType & updates = this->m_UpdatesPerThread[threadId];
+
+  LevelSetLayerConstIterator nodeIt = iteratorSubRange.Begin();
+  while( nodeIt != iteratorSubRange.End() )
+    {
+    const LevelSetInputType inputIndex = nodeIt->first + offset;
+    updates.push_back( termContainer->Evaluate( inputIndex ) );
+    ++nodeIt;
+    }
+}
+
+template< typename TUpdateLevelSet >
+void
+UpdateSparseLevelSetEvaluationThreader< TUpdateLevelSet >
+::AfterThreadedExecution()
+{
+  // the partitioner hands out consecutive sub-ranges in thread order
+  const ThreadIdType numberOfThreads = this->GetNumberOfThreadsUsed();
+  for( ThreadIdType ii = 0; ii < numberOfThreads; ++ii )
+    {
+    this->m_Updates.insert( this->m_Updates.end(),
+                            this->m_UpdatesPerThread[ii].begin(),
+                            this->m_UpdatesPerThread[ii].end() );
+    this->m_UpdatesPerThread[ii].clear();
+    }
+}
+
+} // end namespace itk
+
+#endif
@@ -141,127 +141,152 @@ int itkMultiLevelSetMalcolmImageSubset2DTest( int argc, char* argv[] )
     ++bIt;
     }
 
-  // Convert binary mask to dense level set
-  BinaryImageToLevelSetType::Pointer adaptor1 = BinaryImageToLevelSetType::New();
-  adaptor1->SetInputImage( binary );
-  adaptor1->Initialize();
-  LevelSetType::Pointer levelSet1 = adaptor1->GetModifiableLevelSet();
-
-  input->TransformPhysicalPointToIndex( binary->GetOrigin(), index );
-  InputImageType::OffsetType offset;
-  for( unsigned int i = 0; i < Dimension; i++ )
+  // Evolve the level set with 1 and 4 threads: the sparse layers are
+  // updated by several threads and have to end up the same.
+  const itk::ThreadIdType threads[2] = { 1, 4 };
+  LevelSetType::Pointer   levelSets[2];
+  for( unsigned int t = 0; t < 2; t++ )
     {
-    offset[i] = index[i];
+    // Convert binary mask to dense level set
+    BinaryImageToLevelSetType::Pointer adaptor1 = BinaryImageToLevelSetType::New();
+    adaptor1->SetInputImage( binary );
+    adaptor1->Initialize();
+    LevelSetType::Pointer levelSet1 = adaptor1->GetModifiableLevelSet();
+
+    input->TransformPhysicalPointToIndex( binary->GetOrigin(), index );
+    InputImageType::OffsetType offset;
+    for( unsigned int i = 0; i < Dimension; i++ )
+      {
+      offset[i] = index[i];
+      }
+    levelSet1->SetDomainOffset( offset );
+
+    IdListType listIds;
+    listIds.clear();
+
+    index.Fill( 900 );
+    size.Fill( 100 );
+    region.SetIndex( index );
+    region.SetSize( size );
+
+    IdListImageType::Pointer idImage = IdListImageType::New();
+    idImage->SetRegions( input->GetLargestPossibleRegion() );
+    idImage->Allocate();
+    idImage->FillBuffer( listIds );
+
+    listIds.push_back( 1 );
+    IdIteratorType it( idImage, region );
+    it.GoToBegin();
+    while( !it.IsAtEnd() )
+      {
+      it.Set( listIds );
+      ++it;
+      }
+
+    DomainMapImageFilterType::Pointer domainMapFilter = DomainMapImageFilterType::New();
+    domainMapFilter->SetInput( idImage );
+    domainMapFilter->Update();
+    std::cout << "Domain map computed" << std::endl;
+
+    // Define the Heaviside function
+    HeavisideFunctionBaseType::Pointer heaviside = HeavisideFunctionBaseType::New();
+    heaviside->SetEpsilon( 1.0 );
+
+    // Insert the levelsets in a levelset container
+    LevelSetContainerType::Pointer lscontainer = LevelSetContainerType::New();
+    lscontainer->SetHeaviside( heaviside );
+    lscontainer->SetDomainMapFilter( domainMapFilter );
+
+    bool levelSetNotYetAdded = lscontainer->AddLevelSet( 0, levelSet1, false );
+    if ( !levelSetNotYetAdded )
+      {
+      return EXIT_FAILURE;
+      }
+    std::cout << "Level set container created" << std::endl;
+
+    // Create ChanAndVese internal term for phi_{1}
+    ChanAndVeseInternalTermType::Pointer cvInternalTerm0 = ChanAndVeseInternalTermType::New();
+    cvInternalTerm0->SetInput( input );
+    cvInternalTerm0->SetCoefficient( 1.0 );
+    std::cout << "LevelSet 0: CV internal term created" << std::endl;
+
+    // Create ChanAndVese external term for phi_{1}
+    ChanAndVeseExternalTermType::Pointer cvExternalTerm0 = ChanAndVeseExternalTermType::New();
+    cvExternalTerm0->SetInput( input );
+    cvExternalTerm0->SetCoefficient( 1.0 );
+    std::cout << "LevelSet 0: CV external term created" << std::endl;
+
+
+    // Create Term Container
+    TermContainerType::Pointer termContainer0 = TermContainerType::New();
+    termContainer0->SetInput( input );
+    termContainer0->SetCurrentLevelSetId( 0 );
+    termContainer0->SetLevelSetContainer( lscontainer );
+
+    termContainer0->AddTerm( 0, cvInternalTerm0 );
+    termContainer0->AddTerm( 1, cvExternalTerm0 );
+    std::cout << "Term container 0 created" << std::endl;
+
+
+    EquationContainerType::Pointer equationContainer = EquationContainerType::New();
+    equationContainer->SetLevelSetContainer( lscontainer );
+    equationContainer->AddEquation( 0, termContainer0 );
+    std::cout << "Equation container created" << std::endl;
+
+    typedef itk::LevelSetEvolutionNumberOfIterationsStoppingCriterion< LevelSetContainerType >
+        StoppingCriterionType;
+    StoppingCriterionType::Pointer criterion = StoppingCriterionType::New();
+    criterion->SetNumberOfIterations( 5000 );
+    std::cout << "Stopping criterion created" << std::endl;
+
+    LevelSetEvolutionType::Pointer evolution = LevelSetEvolutionType::New();
+    evolution->SetEquationContainer( equationContainer );
+    evolution->SetStoppingCriterion( criterion );
+    evolution->SetLevelSetContainer( lscontainer );
+    evolution->SetNumberOfThreads( threads[t] );
+
+    try
+      {
+      evolution->Update();
+      }
+    catch ( itk::ExceptionObject& err )
+      {
+      std::cerr << err << std::endl;
+      return EXIT_FAILURE;
+      }
+
+    PixelType mean = cvInternalTerm0->GetMean();
+    if ( ( mean < 80 ) || ( mean > 105 ) )
+      {
+      std::cerr << "( ( mean < 95 ) || ( mean > 105 ) )" <<std::endl;
+      std::cerr << "mean = " <<mean <<std::endl;
+      return EXIT_FAILURE;
+      }
+
+    mean = cvExternalTerm0->GetMean();
+    if ( ( mean > 50.0 ) )
+      {
+      std::cerr << "( ( mean < 0 ) || ( mean > 5 ) )" <<std::endl;
+      std::cerr << "External mean = " <<mean <<std::endl;
+      return EXIT_FAILURE;
+      }
+
+    levelSets[t] = levelSet1;
     }
-  levelSet1->SetDomainOffset( offset );
 
-  IdListType listIds;
-  listIds.clear();
-
-  index.Fill( 900 );
-  size.Fill( 100 );
-  region.SetIndex( index );
-  region.SetSize( size );
-
-  IdListImageType::Pointer idImage = IdListImageType::New();
-  idImage->SetRegions( input->GetLargestPossibleRegion() );
-  idImage->Allocate();
-  idImage->FillBuffer( listIds );
-
-  listIds.push_back( 1 );
-  IdIteratorType it( idImage, region );
-  it.GoToBegin();
-  while( !it.IsAtEnd() )
-    {
-    it.Set( listIds );
-    ++it;
-    }
-
-  DomainMapImageFilterType::Pointer domainMapFilter = DomainMapImageFilterType::New();
-  domainMapFilter->SetInput( idImage );
-  domainMapFilter->Update();
-  std::cout << "Domain map computed" << std::endl;
-
-  // Define the Heaviside function
-  HeavisideFunctionBaseType::Pointer heaviside = HeavisideFunctionBaseType::New();
-  heaviside->SetEpsilon( 1.0 );
-
-  // Insert the levelsets in a levelset container
-  LevelSetContainerType::Pointer lscontainer = LevelSetContainerType::New();
-  lscontainer->SetHeaviside( heaviside );
-  lscontainer->SetDomainMapFilter( domainMapFilter );
-
-  bool levelSetNotYetAdded = lscontainer->AddLevelSet( 0, levelSet1, false );
-  if ( !levelSetNotYetAdded )
-    {
-    return EXIT_FAILURE;
-    }
-  std::cout << "Level set container created" << std::endl;
-
-  // Create ChanAndVese internal term for phi_{1}
-  ChanAndVeseInternalTermType::Pointer cvInternalTerm0 = ChanAndVeseInternalTermType::New();
-  cvInternalTerm0->SetInput( input );
-  cvInternalTerm0->SetCoefficient( 1.0 );
-  std::cout << "LevelSet 0: CV internal term created" << std::endl;
-
-  // Create ChanAndVese external term for phi_{1}
-  ChanAndVeseExternalTermType::Pointer cvExternalTerm0 = ChanAndVeseExternalTermType::New();
-  cvExternalTerm0->SetInput( input );
-  cvExternalTerm0->SetCoefficient( 1.0 );
-  std::cout << "LevelSet 0: CV external term created" << std::endl;
-
-
-  // Create Term Container
-  TermContainerType::Pointer termContainer0 = TermContainerType::New();
-  termContainer0->SetInput( input );
-  termContainer0->SetCurrentLevelSetId( 0 );
-  termContainer0->SetLevelSetContainer( lscontainer );
-
-  termContainer0->AddTerm( 0, cvInternalTerm0 );
-  termContainer0->AddTerm( 1, cvExternalTerm0 );
-  std::cout << "Term container 0 created" << std::endl;
-
-
-  EquationContainerType::Pointer equationContainer = EquationContainerType::New();
-  equationContainer->SetLevelSetContainer( lscontainer );
-  equationContainer->AddEquation( 0, termContainer0 );
-  std::cout << "Equation container created" << std::endl;
-
-  typedef itk::LevelSetEvolutionNumberOfIterationsStoppingCriterion< LevelSetContainerType >
-      StoppingCriterionType;
-  StoppingCriterionType::Pointer criterion = StoppingCriterionType::New();
-  criterion->SetNumberOfIterations( 5000 );
-  std::cout << "Stopping criterion created" << std::endl;
-
-  LevelSetEvolutionType::Pointer evolution = LevelSetEvolutionType::New();
-  evolution->SetEquationContainer( equationContainer );
-  evolution->SetStoppingCriterion( criterion );
-  evolution->SetLevelSetContainer( lscontainer );
-
-  try
-    {
-    evolution->Update();
-    }
-  catch ( itk::ExceptionObject& err )
+  InputIteratorType lsIt( binary, binary->GetLargestPossibleRegion() );
+  lsIt.GoToBegin();
+  while( !lsIt.IsAtEnd() )
     {
-    std::cerr << err << std::endl;
-    return EXIT_FAILURE;
-    }
-
-  PixelType mean = cvInternalTerm0->GetMean();
-  if ( ( mean < 80 ) || ( mean > 105 ) )
-    {
-    std::cerr << "( ( mean < 95 ) || ( mean > 105 ) )" <<std::endl;
-    std::cerr << "mean = " <<mean <<std::endl;
-    return EXIT_FAILURE;
-    }
-
-  mean = cvExternalTerm0->GetMean();
-  if ( ( mean > 50.0 ) )
-    {
-    std::cerr << "( ( mean < 0 ) || ( mean > 5 ) )" <<std::endl;
-    std::cerr << "External mean = " <<mean <<std::endl;
-    return EXIT_FAILURE;
+    const LevelSetType::InputType lsIndex = lsIt.GetIndex();
+    if( levelSets[0]->Evaluate( lsIndex ) != levelSets[1]->Evaluate( lsIndex ) )
+      {
+      std::cerr << "Level set differs at " << lsIndex << " with 1 and 4 threads: "
+                << levelSets[0]->Evaluate( lsIndex ) << " != "
+                << levelSets[1]->Evaluate( lsIndex ) << std::endl;
+      return EXIT_FAILURE;
+      }
+    ++lsIt;
     }
 
   return EXIT_SUCCESS;
@@ -30,6 +30,13 @@ namespace itk
  * connected to an initial Seed AND lie within a Lower and Upper
  * threshold range.
  *
+ * The region is filled span by span along the first dimension, with one
+ * bit per pixel to remember the filled pixels. The fill runs in a single
+ * thread: growing the region from several threads would need that bit
+ * mask to be updated concurrently, with atomic operations for which there
+ * is no portable primitive here. The output only depends on the connected
+ * set, so it is the same as the one of the flood filled iterators.
+ *
  * \ingroup RegionGrowingSegmentation
  * \ingroup ITKRegionGrowing
  */
@@ -19,11 +19,10 @@
 #define itkConnectedThresholdImageFilter_hxx
 
 #include "itkConnectedThresholdImageFilter.h"
-#include "itkBinaryThresholdImageFunction.h"
-#include "itkFloodFilledImageFunctionConditionalIterator.h"
 #include "itkProgressReporter.h"
 
-#include "itkShapedFloodFilledImageFunctionConditionalIterator.h"
+#include <algorithm>
+#include <vector>
 
 namespace itk
 {
@@ -285,45 +284,145 @@ ConnectedThresholdImageFilter< TInputImage, TOutputImage >
   outputImage->Allocate();
   outputImage->FillBuffer (NumericTraits< OutputImagePixelType >::Zero);
 
-  typedef BinaryThresholdImageFunction< InputImageType, double > FunctionType;
-
-  typename FunctionType::Pointer function = FunctionType::New();
-  function->SetInputImage (inputImage);
-  function->ThresholdBetween (m_Lower, m_Upper);
-
   ProgressReporter progress( this, 0, region.GetNumberOfPixels() );
 
+  // Scanline flood fill: a seed is grown into the whole run of included
+  // pixels along the first dimension, then the runs of the adjacent lines
+  // which touch it are queued. A pixel is included when its value lies
+  // between the thresholds, inclusively. The filled pixels are tracked with
+  // one bit per pixel, indexed by their offset in the output buffer.
+  const InputImagePixelType *inputBuffer = inputImage->GetBufferPointer();
+  OutputImagePixelType *     outputBuffer = outputImage->GetBufferPointer();
+  std::vector< bool >        filled( region.GetNumberOfPixels(), false );
+
+  const IndexValueType lineFirst = region.GetIndex(0);
+  const IndexValueType lineLast = lineFirst + static_cast< IndexValueType >( region.GetSize(0) ) - 1;
+
+  // the lines adjacent to a line, and how far beyond a run its neighbors
+  // on these lines extend
+  typedef typename InputImageType::OffsetType OffsetType;
+  std::vector< OffsetType > adjacentLines;
+  IndexValueType            runExtension = 0;
   if ( this->m_Connectivity == FaceConnectivity )
     {
-    typedef FloodFilledImageFunctionConditionalIterator< OutputImageType, FunctionType > IteratorType;
-    IteratorType it (outputImage, function, m_Seeds);
-    it.GoToBegin();
+    for ( unsigned int d = 1; d < InputImageDimension; ++d )
+      {
+      OffsetType offset;
+      offset.Fill(0);
+      offset[d] = -1;
+      adjacentLines.push_back(offset);
+      offset[d] = 1;
+      adjacentLines.push_back(offset);
+      }
+    }
+  else
+    {
+    runExtension = 1;
+    OffsetType offset;
+    offset.Fill(-1);
+    offset[0] = 0;
+    for (;; )
+      {
+      bool isCenter = true;
+      for ( unsigned int d = 1; d < InputImageDimension; ++d )
+        {
+        isCenter = isCenter && offset[d] == 0;
+        }
+      if ( !isCenter )
+        {
+        adjacentLines.push_back(offset);
+        }
+      // next combination of {-1, 0, 1} over the dimensions but the first
+      unsigned int d = 1;
+      while ( d < InputImageDimension && offset[d] == 1 )
+        {
+        offset[d] = -1;
+        ++d;
+        }
+      if ( d == InputImageDimension )
+        {
+        break;
+        }
+      ++offset[d];
+      }
+    }
 
-    while ( !it.IsAtEnd() )
+  std::vector< IndexType > pending;
+  for ( typename SeedContainerType::const_iterator sit = m_Seeds.begin(); sit != m_Seeds.end(); ++sit )
+    {
+    if ( region.IsInside(*sit) )
       {
-      it.Set(m_ReplaceValue);
-      ++it;
-      progress.CompletedPixel();  // potential exception thrown here
+      pending.push_back(*sit);
       }
     }
-  else if ( this->m_Connectivity == FullConnectivity )
+
+  while ( !pending.empty() )
     {
-    // use the fully connected iterator here. The fully connected iterator
-    // below is a superset of the above. However, it is reported to be 20%
-    // slower. Hence we use this "if" block to use the old iterator when
-    // we don't need full connectivity.
+    IndexType index = pending.back();
+    pending.pop_back();
+
+    const IndexValueType  x = index[0];
+    const OffsetValueType outputOffset = outputImage->ComputeOffset(index) - x;
+    const OffsetValueType inputOffset = inputImage->ComputeOffset(index) - x;
 
-    typedef ShapedFloodFilledImageFunctionConditionalIterator< OutputImageType, FunctionType > IteratorType;
-    IteratorType it (outputImage, function, m_Seeds);
-    it.FullyConnectedOn();
-    it.GoToBegin();
+    if ( filled[outputOffset + x]
+         || !( m_Lower <= inputBuffer[inputOffset + x] && inputBuffer[inputOffset + x] <= m_Upper ) )
+      {
+      continue;
+      }
 
-    while ( !it.IsAtEnd() )
+    // grow the run along the line
+    IndexValueType runFirst = x;
+    while ( runFirst > lineFirst
+            && !filled[outputOffset + runFirst - 1]
+            && m_Lower <= inputBuffer[inputOffset + runFirst - 1]
+            && inputBuffer[inputOffset + runFirst - 1] <= m_Upper )
+      {
+      --runFirst;
+      }
+    IndexValueType runLast = x;
+    while ( runLast < lineLast
+            && !filled[outputOffset + runLast + 1]
+            && m_Lower <= inputBuffer[inputOffset + runLast + 1]
+            && inputBuffer[inputOffset + runLast + 1] <= m_Upper )
       {
-      it.Set(m_ReplaceValue);
-      ++it;
+      ++runLast;
+      }
+    for ( IndexValueType i = runFirst; i <= runLast; ++i )
+      {
+      filled[outputOffset + i] = true;
+      outputBuffer[outputOffset + i] = m_ReplaceValue;
       progress.CompletedPixel();  // potential exception thrown here
       }
+
+    // queue the first pixel of each candidate run on the adjacent lines
+    const IndexValueType scanFirst = std::max(runFirst - runExtension, lineFirst);
+    const IndexValueType scanLast = std::min(runLast + runExtension, lineLast);
+    for ( typename std::vector< OffsetType >::const_iterator lit = adjacentLines.begin();
+          lit != adjacentLines.end(); ++lit )
+      {
+      IndexType adjacentIndex = index + *lit;
+      adjacentIndex[0] = scanFirst;
+      if ( !region.IsInside(adjacentIndex) )
+        {
+        continue;
+        }
+      const OffsetValueType adjacentOutputOffset = outputImage->ComputeOffset(adjacentIndex) - scanFirst;
+      const OffsetValueType adjacentInputOffset = inputImage->ComputeOffset(adjacentIndex) - scanFirst;
+      bool inRun = false;
+      for ( IndexValueType i = scanFirst; i <= scanLast; ++i )
+        {
+        const InputImagePixelType value = inputBuffer[adjacentInputOffset + i];
+        const bool candidate = !filled[adjacentOutputOffset + i]
+                               && m_Lower <= value && value <= m_Upper;
+        if ( candidate && !inRun )
+          {
+          adjacentIndex[0] = i;
+          pending.push_back(adjacentIndex);
+          }
+        inRun = candidate;
+        }
+      }
     }
 }
 } // end namespace itk
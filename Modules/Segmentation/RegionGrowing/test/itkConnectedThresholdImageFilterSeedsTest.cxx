@@ -0,0 +1,152 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkConnectedThresholdImageFilter.h"
+#include "itkBinaryThresholdImageFunction.h"
+#include "itkFloodFilledImageFunctionConditionalIterator.h"
+#include "itkShapedFloodFilledImageFunctionConditionalIterator.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkImageRegionConstIterator.h"
+#include <cmath>
+
+// Compare the scanline fill of ConnectedThresholdImageFilter with the flood
+// filled iterators it replaced, on a 3D image with several seeds.
+int itkConnectedThresholdImageFilterSeedsTest(int, char* [] )
+{
+  typedef unsigned char                      PixelType;
+  typedef itk::Image< PixelType, 3 >         ImageType;
+  typedef ImageType::IndexType               IndexType;
+  typedef itk::ConnectedThresholdImageFilter< ImageType, ImageType > FilterType;
+  typedef itk::BinaryThresholdImageFunction< ImageType, double >      FunctionType;
+
+  // a noisy wavy pattern, with a non-zero region index
+  ImageType::IndexType start = {{ 3, -2, 5 }};
+  ImageType::SizeType  size = {{ 41, 37, 29 }};
+  ImageType::RegionType region( start, size );
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions( region );
+  image->Allocate();
+
+  unsigned int seed = 2015;
+  itk::ImageRegionIteratorWithIndex< ImageType > it( image, region );
+  for ( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    const IndexType index = it.GetIndex();
+    seed = seed * 1103515245u + 12345u;
+    const double value = 128.0
+      + 60.0 * std::sin( 0.3 * index[0] ) * std::cos( 0.25 * index[1] )
+      + 40.0 * std::sin( 0.2 * index[2] + 0.1 * index[0] )
+      + static_cast< double >( ( seed >> 16 ) % 41 ) - 20.0;
+    it.Set( static_cast< PixelType >( value ) );
+    }
+
+  std::vector< IndexType > seeds;
+  for ( unsigned int s = 0; s < 6; ++s )
+    {
+    IndexType index;
+    for ( unsigned int d = 0; d < 3; ++d )
+      {
+      seed = seed * 1103515245u + 12345u;
+      index[d] = start[d] + static_cast< itk::IndexValueType >( ( seed >> 16 ) % size[d] );
+      }
+    seeds.push_back( index );
+    }
+  seeds.push_back( seeds[0] ); // a repeated seed
+  IndexType outside = {{ 0, 0, 0 }}; // a seed outside of the image
+  seeds.push_back( outside );
+
+  const PixelType lowers[] = { 90, 120, 140 };
+  const PixelType uppers[] = { 200, 170, 255 };
+
+  for ( unsigned int full = 0; full < 2; ++full )
+    {
+    for ( unsigned int t = 0; t < 3; ++t )
+      {
+      FilterType::Pointer filter = FilterType::New();
+      filter->SetInput( image );
+      filter->SetLower( lowers[t] );
+      filter->SetUpper( uppers[t] );
+      filter->SetReplaceValue( 255 );
+      filter->SetConnectivity( full ? FilterType::FullConnectivity : FilterType::FaceConnectivity );
+      for ( unsigned int s = 0; s < seeds.size(); ++s )
+        {
+        filter->AddSeed( seeds[s] );
+        }
+      filter->Update();
+
+      ImageType::Pointer expected = ImageType::New();
+      expected->SetRegions( region );
+      expected->Allocate();
+      expected->FillBuffer( 0 );
+
+      FunctionType::Pointer function = FunctionType::New();
+      function->SetInputImage( image );
+      function->ThresholdBetween( lowers[t], uppers[t] );
+
+      std::vector< IndexType > insideSeeds;
+      for ( unsigned int s = 0; s < seeds.size(); ++s )
+        {
+        if ( region.IsInside( seeds[s] ) )
+          {
+          insideSeeds.push_back( seeds[s] );
+          }
+        }
+
+      if ( full )
+        {
+        typedef itk::ShapedFloodFilledImageFunctionConditionalIterator< ImageType, FunctionType > IteratorType;
+        IteratorType fit( expected, function, insideSeeds );
+        fit.FullyConnectedOn();
+        for ( fit.GoToBegin(); !fit.IsAtEnd(); ++fit )
+          {
+          fit.Set( 255 );
+          }
+        }
+      else
+        {
+        typedef itk::FloodFilledImageFunctionConditionalIterator< ImageType, FunctionType > IteratorType;
+        IteratorType fit( expected, function, insideSeeds );
+        for ( fit.GoToBegin(); !fit.IsAtEnd(); ++fit )
+          {
+          fit.Set( 255 );
+          }
+        }
+
+      itk::SizeValueType filledPixels = 0;
+      itk::SizeValueType differences = 0;
+      itk::ImageRegionConstIterator< ImageType > oit( filter->GetOutput(), region );
+      itk::ImageRegionConstIterator< ImageType > eit( expected, region );
+      for ( ; !oit.IsAtEnd(); ++oit, ++eit )
+        {
+        filledPixels += ( eit.Get() != 0 );
+        differences += ( oit.Get() != eit.Get() );
+        }
+      std::cout << ( full ? "Full" : "Face" ) << " connectivity, thresholds ["
+                << static_cast< int >( lowers[t] ) << ", " << static_cast< int >( uppers[t] ) << "]: "
+                << filledPixels << " filled pixels, " << differences << " differences" << std::endl;
+      if ( differences != 0 || filledPixels == 0 )
+        {
+        std::cerr << "The filter differs from the flood filled iterators" << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+    }
+
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
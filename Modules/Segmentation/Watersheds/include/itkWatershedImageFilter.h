@@ -22,6 +22,7 @@
 #include "itkImageToImageFilter.h"
 #include "itkWatershedSegmentTreeGenerator.h"
 #include "itkWatershedRelabeler.h"
+#include "itkWatershedBoundaryResolver.h"
 #include "itkWatershedMiniPipelineProgressCommand.h"
 
 namespace itk
@@ -75,9 +76,9 @@ namespace itk
  * algorithm components in the namespace ``watershed'').  For a more complete
  * picture of the implementation, refer to the documentation of those components.
  * The component classes were designed to operate in either a data-streaming or
- * a non-data-streaming mode.  The pipeline constructed in this class'
- * GenerateData() method does not support streaming, but is the common use case
- * for the components.
+ * a non-data-streaming mode.  By default the pipeline constructed in this
+ * class' GenerateData() method does not stream, which is the common use case
+ * for the components.  See the notes on streaming below.
  *
  * \par Description of the input to this filter
  * The input to this filter is a scalar itk::Image of any dimensionality.  This
@@ -139,9 +140,22 @@ namespace itk
  * Get/SetThreshold() and Get/SetLevel() methods.
  *
  * \par Notes on streaming the watershed segmentation code
- *  Coming soon... 12/06/01
- *
+ * When NumberOfStreamDivisions is greater than one, the input is divided into
+ * that many slabs (chunks) along its slowest varying dimension and only one
+ * chunk of the input and of the basic segmentation is held in memory at a
+ * time.  Each chunk is segmented with boundary analysis turned on, the labels
+ * of facing chunks are joined by a watershed::BoundaryResolver, and a single
+ * merge tree is generated from the accumulated segment table.  The threshold
+ * and the maximum depth are computed from the range of the complete input, so
+ * every chunk is thresholded at the same level.
  *
+ * \par
+ * In this mode the filter does not enlarge its output requested region, so
+ * the output can be written piecewise by a streaming writer.  The merge tree
+ * and the chunk label offsets are cached after the first update; later
+ * updates of other output regions only segment the chunks they intersect
+ * again.  Chunks are at least two pixels thick.  The result can differ from
+ * the non-streamed segmentation where a flat region crosses a chunk face.
  *
  * \ingroup WatershedSegmentation
  * \ingroup ITKWatersheds
@@ -233,14 +247,26 @@ public:
     return m_Segmenter->GetOutputImage();
   }
 
-  /** Get the segmentation tree from from the TreeGenerator member filter. */
+  /** Get the segmentation tree from from the TreeGenerator member filter.
+   * When streaming, this is the tree generated from all the chunks. */
   typename watershed::SegmentTreeGenerator< ScalarType >::SegmentTreeType *
   GetSegmentTree()
   {
+    if ( m_NumberOfStreamDivisions > 1 )
+      {
+      return m_StreamSegmentTree;
+      }
     return m_TreeGenerator->GetOutputSegmentTree();
   }
 
-  // Override since the filter produces all of its output
+  /** Set/Get the number of chunks the input is divided into when
+   * segmenting it.  The default value of 1 segments the whole input at once.
+   * See the notes on streaming in the class documentation. */
+  void SetNumberOfStreamDivisions(unsigned int);
+
+  itkGetConstMacro(NumberOfStreamDivisions, unsigned int);
+
+  // Override since the filter produces all of its output, unless it streams
   void EnlargeOutputRequestedRegion(DataObject *data) ITK_OVERRIDE;
 
 #ifdef ITK_USE_CONCEPT_CHECKING
@@ -265,6 +291,35 @@ protected:
    */
   virtual void PrepareOutputs() ITK_OVERRIDE;
 
+  typedef watershed::Segmenter< InputImageType >        SegmenterType;
+  typedef typename SegmenterType::BoundaryType          BoundaryType;
+  typedef typename SegmenterType::SegmentTableType      SegmentTableType;
+  typedef watershed::SegmentTreeGenerator< ScalarType > TreeGeneratorType;
+  typedef typename TreeGeneratorType::SegmentTreeType   SegmentTreeType;
+  typedef watershed::BoundaryResolver< ScalarType, itkGetStaticConstMacro(ImageDimension) >
+  BoundaryResolverType;
+
+  /** Streaming counterpart of GenerateData().  Runs the chunk analysis if
+   * the cached merge tree is out of date, then produces the labels of the
+   * output requested region. */
+  void GenerateStreamedData();
+
+  /** Segments every chunk of the input, resolves the boundaries between
+   * facing chunks and generates the merge tree.  The labels of the chunks
+   * that intersect the output requested region are copied to the output. */
+  void AnalyzeStreamedChunks();
+
+  /** Creates a segmenter configured identically for every chunk, so that a
+   * chunk segmented again reproduces the labels of the analysis. */
+  typename SegmenterType::Pointer MakeChunkSegmenter() const;
+
+  /** Segments the chunk with the given index and copies the labels that lie
+   * in the output requested region to the output. */
+  void SegmentStreamedChunk(SegmenterType *segmenter, unsigned int chunk);
+
+  /** Applies the thresholding of watershed::Segmenter to a single value. */
+  static ScalarType ThresholdValue(ScalarType value, ScalarType thresholdLevel);
+
 private:
   WatershedImageFilter(const Self &);  //purposely not implemented
   void operator=(const Self &); //purposely not implemented
@@ -292,6 +347,18 @@ private:
 
   unsigned long m_ObserverTag;
 
+  /** Streaming state.  The chunk regions and their first labels are kept
+   * so that any chunk can be segmented again with the same labels. */
+  unsigned int                      m_NumberOfStreamDivisions;
+  std::vector< RegionType >         m_StreamChunks;
+  std::vector< IdentifierType >     m_StreamChunkLabels;
+  ScalarType                        m_StreamMinimum;
+  ScalarType                        m_StreamMaximum;
+  double                            m_StreamFloodLevel;
+  bool                              m_StreamAnalysisValid;
+  EquivalencyTable::Pointer         m_StreamEquivalencies;
+  typename SegmentTreeType::Pointer m_StreamSegmentTree;
+
   bool m_LevelChanged;
   bool m_ThresholdChanged;
   bool m_InputChanged;
@@ -18,6 +18,8 @@
 #ifndef itkWatershedImageFilter_hxx
 #define itkWatershedImageFilter_hxx
 #include "itkWatershedImageFilter.h"
+#include "itkImageRegionSplitterSlowDimension.h"
+#include <map>
 
 namespace itk
 {
@@ -71,8 +73,32 @@ WatershedImageFilter< TInputImage >
 }
 
 template< typename TInputImage >
+void
 WatershedImageFilter< TInputImage >
-::WatershedImageFilter():m_Threshold(0.0), m_Level(0.0)
+::SetNumberOfStreamDivisions(unsigned int val)
+{
+  if ( val < 1 )
+    {
+    val = 1;
+    }
+
+  if ( val != m_NumberOfStreamDivisions )
+    {
+    m_NumberOfStreamDivisions = val;
+
+    m_StreamAnalysisValid = false;
+    this->Modified();
+    }
+}
+
+template< typename TInputImage >
+WatershedImageFilter< TInputImage >
+::WatershedImageFilter():m_Threshold(0.0), m_Level(0.0),
+  m_NumberOfStreamDivisions(1),
+  m_StreamMinimum( NumericTraits< ScalarType >::ZeroValue() ),
+  m_StreamMaximum( NumericTraits< ScalarType >::ZeroValue() ),
+  m_StreamFloodLevel(0.0),
+  m_StreamAnalysisValid(false)
 {
   // Set up the mini-pipeline for the first execution.
   m_Segmenter    = watershed::Segmenter< InputImageType >::New();
@@ -111,7 +137,12 @@ WatershedImageFilter< TInputImage >
 ::EnlargeOutputRequestedRegion(DataObject *data)
 {
   Superclass::EnlargeOutputRequestedRegion(data);
-  data->SetRequestedRegionToLargestPossibleRegion();
+
+  // When streaming, any output region can be produced on its own.
+  if ( m_NumberOfStreamDivisions <= 1 )
+    {
+    data->SetRequestedRegionToLargestPossibleRegion();
+    }
 }
 
 template< typename TInputImage >
@@ -143,6 +174,8 @@ WatershedImageFilter< TInputImage >
     m_Relabeler->PrepareOutputs();
 
     m_TreeGenerator->SetHighestCalculatedFloodLevel(0.0);
+
+    m_StreamAnalysisValid = false;
     }
 
   // If the flood level changed but is below the Tree
@@ -164,6 +197,13 @@ WatershedImageFilter< TInputImage >
       m_TreeGenerator->PrepareOutputs();
       m_Relabeler->PrepareOutputs();
       }
+
+    // The streamed merge tree must be generated again if the flood level
+    // rises above the level it was generated for.
+    if ( m_Level > m_StreamFloodLevel )
+      {
+      m_StreamAnalysisValid = false;
+      }
     }
 }
 
@@ -172,27 +212,35 @@ void
 WatershedImageFilter< TInputImage >
 ::GenerateData()
 {
-  // Set the largest possible region in the segmenter
-  m_Segmenter->SetLargestPossibleRegion( this->GetInput()
-                                         ->GetLargestPossibleRegion() );
-  m_Segmenter->GetOutputImage()
-  ->SetRequestedRegion( this->GetInput()->GetLargestPossibleRegion() );
+  if ( m_NumberOfStreamDivisions > 1 )
+    {
+    this->GenerateStreamedData();
+    }
+  else
+    {
+    // Set the largest possible region in the segmenter
+    m_Segmenter->SetLargestPossibleRegion( this->GetInput()
+                                           ->GetLargestPossibleRegion() );
+    m_Segmenter->GetOutputImage()
+    ->SetRequestedRegion( this->GetInput()->GetLargestPossibleRegion() );
 
-  // Setup the progress command
-  WatershedMiniPipelineProgressCommand::Pointer c =
-    dynamic_cast< WatershedMiniPipelineProgressCommand * >(
-      m_TreeGenerator->GetCommand(m_ObserverTag) );
-  c->SetCount(0.0);
-  c->SetNumberOfFilters(3);
+    // Setup the progress command
+    WatershedMiniPipelineProgressCommand::Pointer c =
+      dynamic_cast< WatershedMiniPipelineProgressCommand * >(
+        m_TreeGenerator->GetCommand(m_ObserverTag) );
+    c->SetCount(0.0);
+    c->SetNumberOfFilters(3);
 
-  // Graft our output on the relabeler
-  m_Relabeler->GraftOutput( this->GetOutput() );
+    // Graft our output on the relabeler
+    m_Relabeler->SetNumberOfThreads( this->GetNumberOfThreads() );
+    m_Relabeler->GraftOutput( this->GetOutput() );
 
-  // Update the mini-pipeline
-  m_Relabeler->Update();
+    // Update the mini-pipeline
+    m_Relabeler->Update();
 
-  // Graft the output of the relabeler back on this filter
-  this->GraftOutput( m_Relabeler->GetOutputImage() );
+    // Graft the output of the relabeler back on this filter
+    this->GraftOutput( m_Relabeler->GetOutputImage() );
+    }
 
   // Keep track of when we last executed
   m_GenerateDataMTime.Modified();
@@ -203,6 +251,337 @@ WatershedImageFilter< TInputImage >
   m_ThresholdChanged = false;
 }
 
+template< typename TInputImage >
+void
+WatershedImageFilter< TInputImage >
+::GenerateStreamedData()
+{
+  this->AllocateOutputs();
+
+  OutputImageType *output = this->GetOutput();
+  const RegionType outputRegion = output->GetRequestedRegion();
+
+  this->UpdateProgress(0.0);
+  if ( !m_StreamAnalysisValid )
+    {
+    this->AnalyzeStreamedChunks();
+    }
+  else
+    {
+    // Only the chunks that intersect the requested region are segmented
+    // again.  The segment table they produce is not needed.
+    typename SegmenterType::Pointer segmenter = this->MakeChunkSegmenter();
+    for ( unsigned int chunk = 0; chunk < m_StreamChunks.size(); ++chunk )
+      {
+      RegionType region = m_StreamChunks[chunk];
+      if ( region.Crop(outputRegion) )
+        {
+        segmenter->GetSegmentTable()->Clear();
+        this->SegmentStreamedChunk(segmenter, chunk);
+        }
+      this->UpdateProgress( 0.9f * ( chunk + 1 ) / m_StreamChunks.size() );
+      }
+    }
+
+  // Relabel with the equivalencies found across the chunk boundaries and
+  // the merges of the tree up to the flood level.  The merges are selected
+  // the same way watershed::Relabeler selects them.
+  EquivalencyTable::Pointer eqT = EquivalencyTable::New();
+  for ( EquivalencyTable::Iterator it = m_StreamEquivalencies->Begin();
+        it != m_StreamEquivalencies->End(); ++it )
+    {
+    eqT->Add( ( *it ).first, ( *it ).second );
+    }
+  if ( !m_StreamSegmentTree->Empty() )
+    {
+    const ScalarType mergeLimit =
+      static_cast< ScalarType >( m_Level * m_StreamSegmentTree->Back().saliency );
+    typename SegmentTreeType::Iterator it = m_StreamSegmentTree->Begin();
+    while ( it != m_StreamSegmentTree->End() && ( *it ).saliency <= mergeLimit )
+      {
+      eqT->Add( ( *it ).from, ( *it ).to );
+      ++it;
+      }
+    }
+  SegmenterType::RelabelImage(output, outputRegion, eqT);
+
+  this->UpdateProgress(1.0);
+}
+
+template< typename TInputImage >
+void
+WatershedImageFilter< TInputImage >
+::AnalyzeStreamedChunks()
+{
+  InputImageType *  input = const_cast< InputImageType * >( this->GetInput() );
+  const RegionType largestRegion = input->GetLargestPossibleRegion();
+
+  // Divide the input into slabs along its slowest varying dimension.  Facing
+  // chunks then share a whole face, as watershed::BoundaryResolver expects.
+  // The boundary analysis of the segmenter needs chunks that are at least
+  // two pixels thick, so fewer chunks are used if necessary.
+  ImageRegionSplitterSlowDimension::Pointer splitter =
+    ImageRegionSplitterSlowDimension::New();
+  unsigned int numberOfChunks = m_NumberOfStreamDivisions;
+  unsigned int splitAxis = 0;
+  for (;; )
+    {
+    numberOfChunks = splitter->GetNumberOfSplits(largestRegion, numberOfChunks);
+    m_StreamChunks.resize(numberOfChunks);
+    for ( unsigned int chunk = 0; chunk < numberOfChunks; ++chunk )
+      {
+      m_StreamChunks[chunk] = largestRegion;
+      splitter->GetSplit(chunk, numberOfChunks, m_StreamChunks[chunk]);
+      }
+    if ( numberOfChunks == 1 )
+      {
+      break;
+      }
+
+    splitAxis = 0;
+    while ( m_StreamChunks[1].GetIndex(splitAxis) == m_StreamChunks[0].GetIndex(splitAxis) )
+      {
+      ++splitAxis;
+      }
+    if ( m_StreamChunks[0].GetSize(splitAxis) >= 2
+         && m_StreamChunks[numberOfChunks - 1].GetSize(splitAxis) >= 2 )
+      {
+      break;
+      }
+    --numberOfChunks;
+    }
+  m_StreamChunkLabels.resize(numberOfChunks);
+
+  // Every chunk must be thresholded at the same level, so the range of the
+  // complete input is found first.
+  for ( unsigned int chunk = 0; chunk < numberOfChunks; ++chunk )
+    {
+    input->SetRequestedRegion(m_StreamChunks[chunk]);
+    input->PropagateRequestedRegion();
+    input->UpdateOutputData();
+
+    ImageRegionConstIterator< InputImageType > it(input, m_StreamChunks[chunk]);
+    if ( chunk == 0 )
+      {
+      m_StreamMinimum = it.Get();
+      m_StreamMaximum = it.Get();
+      }
+    for ( ; !it.IsAtEnd(); ++it )
+      {
+      const ScalarType value = it.Get();
+      if ( value < m_StreamMinimum )
+        {
+        m_StreamMinimum = value;
+        }
+      if ( m_StreamMaximum < value )
+        {
+        m_StreamMaximum = value;
+        }
+      }
+    }
+  this->UpdateProgress(0.1);
+
+  // The threshold level and the intensity adjustment applied by the
+  // segmenter, needed for the heights of the edges across chunk faces.
+  ScalarType maximum = m_StreamMaximum;
+  if ( NumericTraits< ScalarType >::is_integer
+       && maximum == NumericTraits< ScalarType >::max() )
+    {
+    maximum -= NumericTraits< ScalarType >::OneValue();
+    }
+  const ScalarType thresholdLevel =
+    static_cast< ScalarType >( ( m_Threshold * ( maximum - m_StreamMinimum ) ) + m_StreamMinimum );
+
+  typename SegmenterType::Pointer segmenter = this->MakeChunkSegmenter();
+  segmenter->SetCurrentLabel(1);
+
+  m_StreamEquivalencies = EquivalencyTable::New();
+
+  typedef std::pair< IdentifierType, IdentifierType > LabelPairType;
+  typedef std::map< LabelPairType, ScalarType >      SeamEdgeMapType;
+  SeamEdgeMapType seamEdges;
+
+  typename BoundaryType::Pointer previousBoundary;
+  std::vector< IdentifierType >  previousFaceLabels;
+  for ( unsigned int chunk = 0; chunk < numberOfChunks; ++chunk )
+    {
+    m_StreamChunkLabels[chunk] = segmenter->GetCurrentLabel();
+    this->SegmentStreamedChunk(segmenter, chunk);
+
+    // Keep the boundary of this chunk and give the segmenter a new one.
+    typename BoundaryType::Pointer boundary = segmenter->GetBoundary();
+    segmenter->SetBoundary( BoundaryType::New() );
+
+    const RegionType & region = m_StreamChunks[chunk];
+    if ( chunk > 0 )
+      {
+      // Join the labels that flow across the face shared with the previous
+      // chunk.
+      typename BoundaryResolverType::Pointer resolver = BoundaryResolverType::New();
+      resolver->SetBoundaryA(previousBoundary);
+      resolver->SetBoundaryB(boundary);
+      resolver->SetFace(splitAxis);
+      resolver->Update();
+
+      EquivalencyTable::Pointer eq = resolver->GetEquivalencyTable();
+      for ( EquivalencyTable::Iterator it = eq->Begin(); it != eq->End(); ++it )
+        {
+        m_StreamEquivalencies->Add( ( *it ).first, ( *it ).second );
+        }
+
+      // The segmenter does not see the adjacencies across the face.  Record
+      // them with the height the segmenter would give them, the maximum of
+      // the two thresholded pixel values.  The input holds the one pixel
+      // overlap with the previous chunk.
+      RegionType previousFace = region;
+      previousFace.SetIndex(splitAxis, region.GetIndex(splitAxis) - 1);
+      previousFace.SetSize(splitAxis, 1);
+      RegionType face = region;
+      face.SetSize(splitAxis, 1);
+
+      ImageRegionConstIterator< InputImageType > previousValueIt(input, previousFace);
+      ImageRegionConstIterator< InputImageType > valueIt(input, face);
+      ImageRegionConstIterator< OutputImageType > labelIt(segmenter->GetOutputImage(), face);
+      typename std::vector< IdentifierType >::const_iterator previousLabelIt =
+        previousFaceLabels.begin();
+      for ( ; !labelIt.IsAtEnd(); ++previousValueIt, ++valueIt, ++labelIt, ++previousLabelIt )
+        {
+        const IdentifierType a = *previousLabelIt;
+        const IdentifierType b = labelIt.Get();
+        if ( a == b || a == SegmenterType::NULL_LABEL || b == SegmenterType::NULL_LABEL )
+          {
+          continue;
+          }
+        const ScalarType height =
+          std::max( Self::ThresholdValue(previousValueIt.Get(), thresholdLevel),
+                    Self::ThresholdValue(valueIt.Get(), thresholdLevel) );
+        const std::pair< typename SeamEdgeMapType::iterator, bool > inserted =
+          seamEdges.insert( typename SeamEdgeMapType::value_type(LabelPairType(a, b), height) );
+        if ( !inserted.second && height < inserted.first->second )
+          {
+          inserted.first->second = height;
+          }
+        }
+      }
+
+    // Remember the labels of the high face for the next chunk.
+    if ( chunk + 1 < numberOfChunks )
+      {
+      RegionType face = region;
+      face.SetIndex( splitAxis, region.GetIndex(splitAxis) + region.GetSize(splitAxis) - 1 );
+      face.SetSize(splitAxis, 1);
+
+      previousFaceLabels.resize( face.GetNumberOfPixels() );
+      ImageRegionConstIterator< OutputImageType > labelIt(segmenter->GetOutputImage(), face);
+      typename std::vector< IdentifierType >::iterator previousLabelIt =
+        previousFaceLabels.begin();
+      for ( ; !labelIt.IsAtEnd(); ++labelIt, ++previousLabelIt )
+        {
+        *previousLabelIt = labelIt.Get();
+        }
+      }
+    previousBoundary = boundary;
+
+    this->UpdateProgress( 0.1f + 0.7f * ( chunk + 1 ) / numberOfChunks );
+    }
+
+  // Take over the segment table accumulated over all the chunks.
+  typename SegmentTableType::Pointer segments = segmenter->GetSegmentTable();
+  segmenter->SetSegmentTable( SegmentTableType::New() );
+
+  for ( typename SeamEdgeMapType::const_iterator it = seamEdges.begin();
+        it != seamEdges.end(); ++it )
+    {
+    typename SegmentTableType::segment_t *from = segments->Lookup(it->first.first);
+    typename SegmentTableType::segment_t *to = segments->Lookup(it->first.second);
+    if ( from == ITK_NULLPTR || to == ITK_NULLPTR )
+      {
+      itkExceptionMacro(<< "A label across a chunk face has no segment.");
+      }
+    from->edge_list.push_back( typename SegmentTableType::edge_pair_t(it->first.second, it->second) );
+    to->edge_list.push_back( typename SegmentTableType::edge_pair_t(it->first.first, it->second) );
+    }
+
+  // Generate a single merge tree, merging the segments joined across chunk
+  // faces first.
+  typename TreeGeneratorType::Pointer treeGenerator = TreeGeneratorType::New();
+  treeGenerator->SetInputSegmentTable(segments);
+  treeGenerator->SetInputEquivalencyTable(m_StreamEquivalencies);
+  treeGenerator->SetMerge(true);
+  treeGenerator->SetConsumeInput(true);
+  treeGenerator->SetFloodLevel(m_Level);
+  treeGenerator->Update();
+
+  m_StreamSegmentTree = treeGenerator->GetOutputSegmentTree();
+  m_StreamFloodLevel = m_Level;
+  m_StreamAnalysisValid = true;
+
+  this->UpdateProgress(0.9);
+}
+
+template< typename TInputImage >
+typename WatershedImageFilter< TInputImage >::SegmenterType::Pointer
+WatershedImageFilter< TInputImage >
+::MakeChunkSegmenter() const
+{
+  typename SegmenterType::Pointer segmenter = SegmenterType::New();
+
+  segmenter->SetInputImage( const_cast< InputImageType * >( this->GetInput() ) );
+  segmenter->SetLargestPossibleRegion( this->GetInput()->GetLargestPossibleRegion() );
+  segmenter->SetThreshold(m_Threshold);
+  segmenter->SetInputMinimum(m_StreamMinimum);
+  segmenter->SetInputMaximum(m_StreamMaximum);
+  segmenter->UseInputRangeOn();
+  segmenter->SetDoBoundaryAnalysis(true);
+  segmenter->SetSortEdgeLists(false);
+
+  return segmenter;
+}
+
+template< typename TInputImage >
+void
+WatershedImageFilter< TInputImage >
+::SegmentStreamedChunk(SegmenterType *segmenter, unsigned int chunk)
+{
+  // The segmenter needs a one pixel overlap with the facing chunks to
+  // analyze the flow across the chunk faces.
+  RegionType paddedRegion = m_StreamChunks[chunk];
+  paddedRegion.PadByRadius(1);
+  paddedRegion.Crop( this->GetInput()->GetLargestPossibleRegion() );
+
+  segmenter->SetCurrentLabel(m_StreamChunkLabels[chunk]);
+  segmenter->GetOutputImage()->SetRequestedRegion(paddedRegion);
+  segmenter->Update();
+
+  RegionType region = m_StreamChunks[chunk];
+  if ( region.Crop( this->GetOutput()->GetRequestedRegion() ) )
+    {
+    ImageRegionConstIterator< OutputImageType > labelIt(segmenter->GetOutputImage(), region);
+    ImageRegionIterator< OutputImageType >      outputIt(this->GetOutput(), region);
+    for ( ; !labelIt.IsAtEnd(); ++labelIt, ++outputIt )
+      {
+      outputIt.Set( labelIt.Get() );
+      }
+    }
+}
+
+template< typename TInputImage >
+typename WatershedImageFilter< TInputImage >::ScalarType
+WatershedImageFilter< TInputImage >
+::ThresholdValue(ScalarType value, ScalarType thresholdLevel)
+{
+  if ( value < thresholdLevel )
+    {
+    return thresholdLevel;
+    }
+  if ( NumericTraits< ScalarType >::is_integer
+       && value == NumericTraits< ScalarType >::max() )
+    {
+    return value - NumericTraits< ScalarType >::OneValue();
+    }
+  return value;
+}
+
 template< typename TInputImage >
 void
 WatershedImageFilter< TInputImage >
@@ -211,6 +590,7 @@ WatershedImageFilter< TInputImage >
   Superclass::PrintSelf(os, indent);
   os << indent << "Threshold: " << m_Threshold << std::endl;
   os << indent << "Level: " << m_Level << std::endl;
+  os << indent << "NumberOfStreamDivisions: " << m_NumberOfStreamDivisions << std::endl;
 }
 } // end namespace itk
 
@@ -54,6 +54,11 @@ namespace watershed
  * image.  FloodLevel controls which level in the segmentation hierarchy to
  * produce on the output.
  *
+ * \par
+ * The merges up to the FloodLevel are first resolved into a table indexed by
+ * segment label, so producing the output for any level is a single pass
+ * over the image.  That pass is divided among the threads of the filter.
+ *
  * \ingroup WatershedSegmentation
  * \sa itk::WatershedImageFilter
  * \sa itk::EquivalencyTable
@@ -126,7 +131,8 @@ public:
            ( this->ProcessObject::GetInput(1) );
   }
 
-  /** Standard non-threaded pipeline method */
+  /** Standard pipeline method.  Only the final pass over the image is
+   * threaded. */
   virtual void GenerateData() ITK_OVERRIDE;
 
   /** Set/Get the percentage of the maximum saliency level
@@ -150,6 +156,23 @@ protected:
   virtual void GenerateOutputRequestedRegion(DataObject *output) ITK_OVERRIDE;
 
   virtual void GenerateInputRequestedRegion() ITK_OVERRIDE;
+
+  /** Table of the label each segment label is relabeled to.  Labels beyond
+   * its end are not merged. */
+  typedef std::vector< IdentifierType > LabelTableType;
+
+private:
+  /** Internal structure used for passing the relabeling data to the
+   * threads. */
+  struct ThreadStruct {
+    Self *Filter;
+    const LabelTableType *LabelTable;
+    typename ImageType::RegionType Region;
+    unsigned int NumberOfPieces;
+  };
+
+  /** Static function used as a "callback" by the MultiThreader. */
+  static ITK_THREAD_RETURN_TYPE ThreaderCallback(void *arg);
 };
 } // end namespace watershed
 } // end namespace itk
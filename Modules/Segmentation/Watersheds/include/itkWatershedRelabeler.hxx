@@ -19,6 +19,7 @@
 #define itkWatershedRelabeler_hxx
 
 #include "itkImageRegionIterator.h"
+#include "itkImageRegionSplitterSlowDimension.h"
 #include "itkWatershedRelabeler.h"
 
 namespace itk
@@ -47,52 +48,123 @@ void Relabeler< TScalar, TImageDimension >
 ::GenerateData()
 {
   this->UpdateProgress(0.0);
-  typename ImageType::Pointer input  = this->GetInputImage();
   typename ImageType::Pointer output  = this->GetOutputImage();
 
   typename SegmentTreeType::Pointer tree = this->GetInputSegmentTree();
   typename SegmentTreeType::Iterator it;
-  EquivalencyTable::Pointer eqT = EquivalencyTable::New();
 
   output->SetBufferedRegion( output->GetRequestedRegion() );
   output->Allocate();
+
   //
-  // Copy input to output
+  // Extract the merges up the requested level and resolve them into a
+  // table indexed by label.  Every label ends up pointing to the smallest
+  // label it is merged with, which is the label an EquivalencyTable
+  // built from the same merges would give it.
   //
-  ImageRegionIterator< ImageType > it_a( input, output->GetRequestedRegion() );
-  ImageRegionIterator< ImageType > it_b( output, output->GetRequestedRegion() );
-  it_a.GoToBegin();
-  it_b.GoToBegin();
-  while ( !it_a.IsAtEnd() )
+  LabelTableType labelTable;
+  if ( tree->Empty() == false )
     {
-    it_b.Set( it_a.Get() );
-    ++it_a;
-    ++it_b;
+    ScalarType max = tree->Back().saliency;
+    ScalarType mergeLimit = static_cast< ScalarType >( m_FloodLevel * max );
+
+    IdentifierType maximumLabel = 0;
+    for ( it = tree->Begin(); it != tree->End() && ( *it ).saliency <= mergeLimit; ++it )
+      {
+      maximumLabel = std::max( maximumLabel, std::max( ( *it ).from, ( *it ).to ) );
+      }
+
+    if ( it != tree->Begin() )
+      {
+      labelTable.resize(maximumLabel + 1);
+      for ( IdentifierType i = 0; i <= maximumLabel; ++i )
+        {
+        labelTable[i] = i;
+        }
+
+      for ( it = tree->Begin(); it != tree->End() && ( *it ).saliency <= mergeLimit; ++it )
+        {
+        IdentifierType a = ( *it ).from;
+        while ( labelTable[a] != a )
+          {
+          a = labelTable[a] = labelTable[labelTable[a]];
+          }
+        IdentifierType b = ( *it ).to;
+        while ( labelTable[b] != b )
+          {
+          b = labelTable[b] = labelTable[labelTable[b]];
+          }
+        if ( a < b )
+          {
+          labelTable[b] = a;
+          }
+        else if ( b < a )
+          {
+          labelTable[a] = b;
+          }
+        }
+
+      // A label only ever points to a smaller one, so a single ascending
+      // sweep leaves every entry pointing to its final label.
+      for ( IdentifierType i = 0; i <= maximumLabel; ++i )
+        {
+        labelTable[i] = labelTable[labelTable[i]];
+        }
+      }
     }
 
   this->UpdateProgress(0.1);
+
   //
-  // Extract the merges up the requested level
+  // Copy the input to the output through the label table.
   //
-  if ( tree->Empty() == true )
+  ThreadStruct str;
+  str.Filter = this;
+  str.LabelTable = &labelTable;
+  str.Region = output->GetRequestedRegion();
+
+  ImageRegionSplitterSlowDimension::Pointer splitter =
+    ImageRegionSplitterSlowDimension::New();
+  str.NumberOfPieces = splitter->GetNumberOfSplits( str.Region, this->GetNumberOfThreads() );
+
+  this->GetMultiThreader()->SetNumberOfThreads(str.NumberOfPieces);
+  this->GetMultiThreader()->SetSingleMethod(this->ThreaderCallback, &str);
+  this->GetMultiThreader()->SingleMethodExecute();
+
+  this->UpdateProgress(1.0);
+}
+
+template< typename TScalar, unsigned int TImageDimension >
+ITK_THREAD_RETURN_TYPE
+Relabeler< TScalar, TImageDimension >
+::ThreaderCallback(void *arg)
+{
+  typedef MultiThreader::ThreadInfoStruct ThreadInfoType;
+  ThreadInfoType *info = static_cast< ThreadInfoType * >( arg );
+  ThreadStruct *  str = static_cast< ThreadStruct * >( info->UserData );
+
+  if ( info->ThreadID >= str->NumberOfPieces )
     {
-    // itkWarningMacro("Empty input.  No relabeling was done.");
-    return;
+    return ITK_THREAD_RETURN_VALUE;
     }
-  ScalarType max = tree->Back().saliency;
-  ScalarType mergeLimit = static_cast< ScalarType >( m_FloodLevel * max );
 
-  this->UpdateProgress(0.5);
+  typename ImageType::RegionType region = str->Region;
+  ImageRegionSplitterSlowDimension::Pointer splitter =
+    ImageRegionSplitterSlowDimension::New();
+  splitter->GetSplit(info->ThreadID, str->NumberOfPieces, region);
+
+  const LabelTableType & labelTable = *str->LabelTable;
+  const IdentifierType   tableSize = static_cast< IdentifierType >( labelTable.size() );
 
-  it = tree->Begin();
-  while ( it != tree->End() && ( *it ).saliency <= mergeLimit )
+  ImageRegionConstIterator< ImageType > it_a(str->Filter->GetInputImage(), region);
+  ImageRegionIterator< ImageType >      it_b(str->Filter->GetOutputImage(), region);
+  for ( ; !it_a.IsAtEnd(); ++it_a, ++it_b )
     {
-    eqT->Add( ( *it ).from, ( *it ).to );
-    it++;
+    const IdentifierType label = it_a.Get();
+    it_b.Set( label < tableSize ? labelTable[label] : label );
     }
 
-  SegmenterType::RelabelImage(output, output->GetRequestedRegion(), eqT);
-  this->UpdateProgress(1.0);
+  return ITK_THREAD_RETURN_VALUE;
 }
 
 template< typename TScalar, unsigned int VImageDimension >
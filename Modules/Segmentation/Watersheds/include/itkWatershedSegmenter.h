@@ -232,6 +232,20 @@ public:
   itkGetConstMacro(SortEdgeLists, bool);
   itkSetMacro(SortEdgeLists, bool);
 
+  /** Gets/Sets the minimum and maximum input values used to compute the
+   * threshold level and the maximum depth of the segment table.  These are
+   * only used when UseInputRange is true.  Streaming applications set them to
+   * the range of the complete volume so that every chunk is thresholded at
+   * the same level.  By default the range of the region being processed is
+   * used. */
+  itkSetMacro(InputMinimum, InputPixelType);
+  itkGetConstMacro(InputMinimum, InputPixelType);
+  itkSetMacro(InputMaximum, InputPixelType);
+  itkGetConstMacro(InputMaximum, InputPixelType);
+  itkSetMacro(UseInputRange, bool);
+  itkGetConstMacro(UseInputRange, bool);
+  itkBooleanMacro(UseInputRange);
+
 protected:
   /** Structure storing information about image flat regions.
    * Flat regions are connected pixels of the same value.  */
@@ -372,6 +386,9 @@ private:
 
   bool            m_SortEdgeLists;
   bool            m_DoBoundaryAnalysis;
+  bool            m_UseInputRange;
+  InputPixelType  m_InputMinimum;
+  InputPixelType  m_InputMaximum;
   double          m_Threshold;
   double          m_MaximumFloodLevel;
   IdentifierType  m_CurrentLabel;
@@ -173,7 +173,15 @@ void Segmenter< TInputImage >::GenerateData()
   //
   //
   InputPixelType minimum, maximum;
-  Self::MinMax(input, regionToProcess, minimum, maximum);
+  if ( m_UseInputRange )
+    {
+    minimum = m_InputMinimum;
+    maximum = m_InputMaximum;
+    }
+  else
+    {
+    Self::MinMax(input, regionToProcess, minimum, maximum);
+    }
   // cap the maximum in the image so that we can always define a pixel
   // value that is one greater than the maximum value in the image.
   if ( NumericTraits< InputPixelType >::is_integer
@@ -181,6 +189,16 @@ void Segmenter< TInputImage >::GenerateData()
     {
     maximum -= NumericTraits< InputPixelType >::OneValue();
     }
+  // When analyzing the boundaries, the flow at the chunk faces is traced
+  // before the retaining wall is built.  The pixels padded along the true
+  // data set boundary are read by that analysis, so give them the value of
+  // the wall now.
+  if ( m_DoBoundaryAnalysis == true )
+    {
+    Self::SetInputImageValues(thresholdImage, thresholdImage->GetBufferedRegion(),
+                              maximum + NumericTraits< InputPixelType >::One);
+    }
+
   // threshold the image.
   Self::Threshold( thresholdImage, input, regionToProcess, regionToProcess,
                    static_cast< InputPixelType >( ( m_Threshold * ( maximum - minimum ) ) + minimum ) );
@@ -469,16 +487,17 @@ void Segmenter< TInputImage >
       searchIt.GoToBegin();
       labelIt.GoToBegin();
 
+      // The connectivity lists the negative directions from the highest
+      // dimension down, then the positive directions from the lowest up.
       if ( ( idx ).second == 0 )
         {
         // Low face
-        cPos = m_Connectivity.index[( idx ).first];
+        cPos = m_Connectivity.index[( ImageDimension - 1 ) - ( idx ).first];
         }
       else
         {
         // High face
-        cPos = m_Connectivity.index[( ImageDimension - 1 )
-                                    + ( ImageDimension - ( idx ).first )];
+        cPos = m_Connectivity.index[ImageDimension + ( idx ).first];
         }
 
       while ( !searchIt.IsAtEnd() )
@@ -1352,6 +1371,9 @@ Segmenter< TInputImage >
   m_MaximumFloodLevel = 1.0;
   m_CurrentLabel = 1;
   m_DoBoundaryAnalysis = false;
+  m_UseInputRange = false;
+  m_InputMinimum = NumericTraits< InputPixelType >::ZeroValue();
+  m_InputMaximum = NumericTraits< InputPixelType >::ZeroValue();
   m_SortEdgeLists = true;
   m_Connectivity.direction = ITK_NULLPTR;
   m_Connectivity.index = ITK_NULLPTR;
@@ -1381,6 +1403,11 @@ Segmenter< TInputImage >
   Superclass::PrintSelf(os, indent);
   os << indent << "SortEdgeLists: " << m_SortEdgeLists << std::endl;
   os << indent << "DoBoundaryAnalysis: " << m_DoBoundaryAnalysis << std::endl;
+  os << indent << "UseInputRange: " << m_UseInputRange << std::endl;
+  os << indent << "InputMinimum: "
+     << static_cast< typename NumericTraits< InputPixelType >::PrintType >( m_InputMinimum ) << std::endl;
+  os << indent << "InputMaximum: "
+     << static_cast< typename NumericTraits< InputPixelType >::PrintType >( m_InputMaximum ) << std::endl;
   os << indent << "Threshold: " << m_Threshold << std::endl;
   os << indent << "MaximumFloodLevel: " << m_MaximumFloodLevel << std::endl;
   os << indent << "CurrentLabel: " << m_CurrentLabel << std::endl;
@@ -19,7 +19,10 @@
 #include "itkWatershedImageFilter.h"
 #include "itkWatershedEquivalenceRelabeler.h"
 #include "itkWatershedBoundaryResolver.h"
+#include "itkStreamingImageFilter.h"
 #include "itkFilterWatcher.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include <map>
 
 inline void println(const char *s) { std::cout << s << std::endl; }
 
@@ -126,5 +129,162 @@ int itkWatershedImageFilterTest(int, char* [] )
     return EXIT_FAILURE;
     }
 
+  println("Executing the filter in chunks");
+  // No merging, so that every segment split by a chunk face must be joined
+  // again by the boundary resolution.
+  itk::WatershedImageFilter<ImageType2D>::Pointer reference_filter =
+                  itk::WatershedImageFilter<ImageType2D>::New();
+  reference_filter->SetInput(image2D);
+  reference_filter->SetThreshold(.05f);
+  reference_filter->SetLevel(0.0f);
+
+  // A fresh chunked filter whose output is only ever requested piecewise.
+  itk::WatershedImageFilter<ImageType2D>::Pointer streamed_filter =
+                  itk::WatershedImageFilter<ImageType2D>::New();
+  streamed_filter->SetInput(image2D);
+  streamed_filter->SetThreshold(.05f);
+  streamed_filter->SetLevel(0.0f);
+  streamed_filter->SetNumberOfStreamDivisions(4);
+  if ( streamed_filter->GetNumberOfStreamDivisions() != 4 )
+    {
+    std::cerr << "NumberOfStreamDivisions was not set" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  typedef itk::StreamingImageFilter<LongImageType2D, LongImageType2D> StreamerType;
+  StreamerType::Pointer streamer = StreamerType::New();
+  streamer->SetInput(streamed_filter->GetOutput());
+  streamer->SetNumberOfStreamDivisions(7);
+  try
+    {
+    reference_filter->Update();
+    streamer->Update();
+    }
+  catch (...)
+    {
+    std::cerr << "WatershedImageFilter exception thrown while streaming" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // The streamed labels must describe the same segments as the labels of
+  // the filter that processes the whole image at once.  The segments are
+  // numbered differently, so the labels are matched one to one.
+  typedef std::map<itk::IdentifierType, itk::IdentifierType> LabelMapType;
+  LabelMapType referenceToStreamed;
+  LabelMapType streamedToReference;
+  itk::ImageRegionIterator<LongImageType2D>
+    referenceIt(reference_filter->GetOutput(), Region2D);
+  itk::ImageRegionIterator<LongImageType2D>
+    piecesIt(streamer->GetOutput(), Region2D);
+  for (; !referenceIt.IsAtEnd(); ++referenceIt, ++piecesIt)
+    {
+    std::pair<LabelMapType::iterator, bool> forward =
+      referenceToStreamed.insert(std::make_pair(referenceIt.Get(), piecesIt.Get()));
+    std::pair<LabelMapType::iterator, bool> backward =
+      streamedToReference.insert(std::make_pair(piecesIt.Get(), referenceIt.Get()));
+    if ( forward.first->second != piecesIt.Get()
+         || backward.first->second != referenceIt.Get() )
+      {
+      std::cerr << "Segments differ at " << referenceIt.GetIndex() << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+  if ( referenceToStreamed.size() < 2 )
+    {
+    std::cerr << "Expected several segments, got "
+              << referenceToStreamed.size() << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  println("Relabeling several flood levels");
+  // Bumps and noise give a deep merge tree.  Each level is relabeled with 1
+  // and 4 threads and compared with the basic segmentation relabeled
+  // through an EquivalencyTable of the merges, as the relabeler did before.
+  ImageType2D::Pointer bumps2D = ImageType2D::New();
+  bumps2D->SetRegions(Region2D);
+  bumps2D->Allocate();
+  unsigned int seed = 1999;
+  itk::ImageRegionIteratorWithIndex<ImageType2D> bumpsIt(bumps2D, Region2D);
+  for (; !bumpsIt.IsAtEnd(); ++bumpsIt)
+    {
+    const itk::Index<2> index = bumpsIt.GetIndex();
+    seed = seed * 1103515245u + 12345u;
+    bumpsIt.Set( static_cast<float>( std::sin(0.11 * index[0]) * std::cos(0.07 * index[1])
+                                     + 0.5 * std::sin(0.031 * (index[0] + index[1]))
+                                     + 0.02 * ((seed >> 16) % 100) ) );
+    }
+
+  itk::WatershedImageFilter<ImageType2D>::Pointer levels_filter =
+                  itk::WatershedImageFilter<ImageType2D>::New();
+  levels_filter->SetInput(bumps2D);
+  levels_filter->SetThreshold(.01f);
+
+  const double levels[] = { 1.0, 0.5, 0.2, 0.05, 0.0 };
+  for (unsigned int l = 0; l < sizeof(levels) / sizeof(levels[0]); ++l)
+    {
+    levels_filter->SetLevel(levels[l]);
+
+    LongImageType2D::Pointer outputs[2];
+    const itk::ThreadIdType threads[2] = { 1, 4 };
+    for (unsigned int t = 0; t < 2; ++t)
+      {
+      levels_filter->SetNumberOfThreads(threads[t]);
+      try
+        {
+        levels_filter->Update();
+        }
+      catch (...)
+        {
+        std::cerr << "WatershedImageFilter exception thrown at level " << levels[l] << std::endl;
+        return EXIT_FAILURE;
+        }
+      outputs[t] = levels_filter->GetOutput();
+      outputs[t]->DisconnectPipeline();
+      }
+
+    LongImageType2D::Pointer expected = LongImageType2D::New();
+    expected->SetRegions(Region2D);
+    expected->Allocate();
+    itk::ImageRegionConstIterator<LongImageType2D>
+      basicIt(levels_filter->GetBasicSegmentation(), Region2D);
+    itk::ImageRegionIterator<LongImageType2D> expectedIt(expected, Region2D);
+    for (; !basicIt.IsAtEnd(); ++basicIt, ++expectedIt)
+      {
+      expectedIt.Set(basicIt.Get());
+      }
+
+    typedef itk::watershed::SegmentTreeGenerator<float>::SegmentTreeType SegmentTreeType;
+    SegmentTreeType *tree = levels_filter->GetSegmentTree();
+    itk::EquivalencyTable::Pointer equivalencies = itk::EquivalencyTable::New();
+    if ( !tree->Empty() )
+      {
+      const float mergeLimit = static_cast<float>( levels[l] * tree->Back().saliency );
+      for (SegmentTreeType::Iterator treeIt = tree->Begin();
+           treeIt != tree->End() && ( *treeIt ).saliency <= mergeLimit; ++treeIt)
+        {
+        equivalencies->Add( ( *treeIt ).from, ( *treeIt ).to );
+        }
+      }
+    itk::watershed::Segmenter<ImageType2D>::RelabelImage(expected, Region2D, equivalencies);
+
+    std::map<itk::IdentifierType, bool> labels;
+    itk::ImageRegionConstIterator<LongImageType2D> oneIt(outputs[0], Region2D);
+    itk::ImageRegionConstIterator<LongImageType2D> fourIt(outputs[1], Region2D);
+    itk::ImageRegionConstIterator<LongImageType2D> tableIt(expected, Region2D);
+    for (; !oneIt.IsAtEnd(); ++oneIt, ++fourIt, ++tableIt)
+      {
+      if ( oneIt.Get() != tableIt.Get() || fourIt.Get() != tableIt.Get() )
+        {
+        std::cerr << "Level " << levels[l] << ": label " << oneIt.Get() << " with 1 thread and "
+                  << fourIt.Get() << " with 4 threads at " << oneIt.GetIndex()
+                  << " instead of " << tableIt.Get() << std::endl;
+        return EXIT_FAILURE;
+        }
+      labels[oneIt.Get()] = true;
+      }
+    std::cout << "Level " << levels[l] << ": " << tree->Size() << " merges, "
+              << labels.size() << " segments" << std::endl;
+    }
+
   return EXIT_SUCCESS;
 }